@@ -0,0 +1,134 @@
+#include "BlendTree.h"
+
+#include <algorithm>
+
+uint32_t SBlendTree::AddPose(uint32_t input)
+{
+    SBlendNode node;
+    node.type = EBlendNode::Pose;
+    node.input = input;
+    nodes.push_back(node);
+    heights.push_back(0);
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+uint32_t SBlendTree::AddBlend(const uint32_t* node_children, size_t count)
+{
+    uint32_t height = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (node_children[i] >= nodes.size())
+        {
+            return InvalidNode;
+        }
+        height = std::max(height, heights[node_children[i]]);
+    }
+
+    SBlendNode node;
+    node.type = EBlendNode::Blend;
+    node.first_child = static_cast<uint32_t>(children.size());
+    node.child_count = static_cast<uint32_t>(count);
+    children.insert(children.end(), node_children, node_children + count);
+    nodes.push_back(node);
+    heights.push_back(height + 1);
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void SBlendTree::SetWeight(uint32_t node, float weight)
+{
+    if (node < nodes.size())
+    {
+        nodes[node].weight = weight;
+    }
+}
+
+void SBlendTree::Clear()
+{
+    nodes.clear();
+    children.clear();
+    heights.clear();
+}
+
+bool SBlendTree::Evaluate(const SPose* evaluation_inputs, size_t evaluation_input_count, SPose& out)
+{
+    if (nodes.empty())
+    {
+        return false;
+    }
+
+    inputs = evaluation_inputs;
+    input_count = evaluation_input_count;
+    joint_count = input_count > 0 ? inputs[0].Size() : out.Size();
+
+    // buffers are sized up front, a pose buffer must not move while a blend above it holds it
+    const size_t height = heights[GetRoot()];
+    if (blenders.size() < height)
+    {
+        blenders.resize(height);
+        buffers.resize(height);
+    }
+
+    const SPose* result = EvaluateNode(GetRoot(), 0, out);
+    inputs = nullptr;
+    if (result == nullptr)
+    {
+        return false;
+    }
+    if (result != &out)
+    {
+        out = *result;
+    }
+    return true;
+}
+
+const SPose* SBlendTree::EvaluateNode(uint32_t node_index, size_t depth, SPose& target)
+{
+    const SBlendNode& node = nodes[node_index];
+    if (node.type == EBlendNode::Pose)
+    {
+        return node.input < input_count ? &inputs[node.input] : nullptr;
+    }
+
+    const uint32_t* node_children = children.data() + node.first_child;
+    uint32_t active_count = 0;
+    uint32_t active_child = InvalidNode;
+    for (uint32_t i = 0; i < node.child_count; ++i)
+    {
+        if (nodes[node_children[i]].weight > 0.f)
+        {
+            ++active_count;
+            active_child = node_children[i];
+        }
+    }
+
+    if (active_count == 0)
+    {
+        target.Resize(joint_count);
+        target.SetIdentity();
+        return &target;
+    }
+
+    // a single branch needs no blend, its pose is the pose of this node
+    if (active_count == 1)
+    {
+        return EvaluateNode(active_child, depth, target);
+    }
+
+    SPoseBlender& blender = blenders[depth];
+    blender.Begin(joint_count);
+    for (uint32_t i = 0; i < node.child_count; ++i)
+    {
+        const SBlendNode& child = nodes[node_children[i]];
+        if (child.weight > 0.f)
+        {
+            const SPose* pose = EvaluateNode(node_children[i], depth + 1, buffers[depth]);
+            if (pose == nullptr)
+            {
+                return nullptr;
+            }
+            blender.Add(*pose, child.weight);
+        }
+    }
+    blender.End(target);
+    return &target;
+}
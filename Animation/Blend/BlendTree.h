@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PoseBlend.h"
+
+enum class EBlendNode
+{
+    // one of the input poses of an evaluation
+    Pose,
+    // weighted nlerp of its children
+    Blend,
+};
+
+struct SBlendNode
+{
+    EBlendNode type{ EBlendNode::Pose };
+    // weight of the node among its siblings, zero skips the whole branch
+    float weight{ 1.f };
+    // input pose of a 'Pose' node
+    uint32_t input{ 0 };
+    // children of a 'Blend' node in 'SBlendTree' child list
+    uint32_t first_child{ 0 };
+    uint32_t child_count{ 0 };
+};
+
+/*
+* SBlendTree combines input poses, like the sampled clips of a locomotion blend space, into one pose.
+* Nodes are added bottom-up, a blend refers to nodes added before it, and the last node added is the root.
+* Weights change every frame with 'SetWeight' and are relative to the siblings of a node, they don't have to add up to 1.
+* Evaluation visits only branches with a positive weight; a blend with one such child passes the pose of that child through
+* without a copy, otherwise its children are summed by an 'SPoseBlender' of its depth into a pose buffer of its depth.
+* Blenders and buffers stay with the tree, so evaluations allocate nothing once the tree has seen its largest poses.
+*/
+struct SBlendTree
+{
+    constexpr static uint32_t InvalidNode{ 0xFFFFFFFFu };
+
+    // a leaf of the input pose 'input', returns its node
+    uint32_t AddPose(uint32_t input);
+
+    // a blend of 'count' nodes added before, returns its node or 'InvalidNode' for an unknown child
+    uint32_t AddBlend(const uint32_t* children, size_t count);
+
+    // weight of 'node' among its siblings, weights of zero or less skip the node
+    void SetWeight(uint32_t node, float weight);
+
+    void Clear();
+
+    size_t GetNodeCount() const { return nodes.size(); }
+    const SBlendNode& GetNode(uint32_t node) const { return nodes[node]; }
+    uint32_t GetRoot() const { return nodes.empty() ? InvalidNode : static_cast<uint32_t>(nodes.size() - 1); }
+
+    /*
+    * Evaluates the root into 'out', which must not be one of 'inputs'. Input poses have the same joint count.
+    * Returns false for an empty tree or a visited 'Pose' node past 'input_count'.
+    * A blend with no positive weight gives the identity pose.
+    */
+    bool Evaluate(const SPose* inputs, size_t input_count, SPose& out);
+
+private:
+    // pose of 'node' for depth 'depth', blended into 'target' or an input pose; nullptr for an unknown input
+    const SPose* EvaluateNode(uint32_t node, size_t depth, SPose& target);
+
+    std::vector<SBlendNode> nodes;
+    std::vector<uint32_t> children;
+    // levels of blends in the branch of every node, the buffers an evaluation of it needs
+    std::vector<uint32_t> heights;
+
+    // state of an evaluation
+    const SPose* inputs{ nullptr };
+    size_t input_count{ 0 };
+    size_t joint_count{ 0 };
+    // blender and child pose buffer of every depth
+    std::vector<SPoseBlender> blenders;
+    std::vector<SPose> buffers;
+};
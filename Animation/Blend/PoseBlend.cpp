@@ -0,0 +1,173 @@
+#include "PoseBlend.h"
+
+#include "../Profile/ProfileScope.h"
+#include "../Quaternion/QuaternionKernels.h"
+#include "../Simd/Simd.h"
+
+#include <cassert>
+#include <memory>
+
+namespace
+{
+    using QuaternionKernels::LoadQuaternions;
+    using QuaternionKernels::StoreQuaternions;
+
+#if defined(__AVX__)
+    // 8 rotations per iteration with AVX
+    using RotationPack = __m256;
+#else
+    // 4 rotations per iteration with SSE
+    using RotationPack = __m128;
+#endif
+
+    constexpr size_t RotationPackWidth{ Simd::SPackTraits<RotationPack>::Width };
+    using SRotations = QuaternionKernels::SQuaternionPack<RotationPack>;
+
+    // the rotation sums of 'SPoseBlender' at joint 'i', an array of 'padded_count' floats per component
+    SRotations LoadSums(const float* sums, size_t padded_count, size_t i)
+    {
+        return {{Simd::LoadUnaligned<RotationPack>(sums + i), Simd::LoadUnaligned<RotationPack>(sums + padded_count + i),
+                 Simd::LoadUnaligned<RotationPack>(sums + 2 * padded_count + i)}, Simd::LoadUnaligned<RotationPack>(sums + 3 * padded_count + i)};
+    }
+
+    void StoreSums(float* sums, size_t padded_count, size_t i, const SRotations& pack)
+    {
+        Simd::StoreUnaligned(sums + i, pack.axis.x);
+        Simd::StoreUnaligned(sums + padded_count + i, pack.axis.y);
+        Simd::StoreUnaligned(sums + 2 * padded_count + i, pack.axis.z);
+        Simd::StoreUnaligned(sums + 3 * padded_count + i, pack.w);
+    }
+
+    // sum += weight * values over 'count' floats
+    void AccumulateFloats(const float* values, float weight, float* sum, size_t count)
+    {
+        using Pack = Simd::FloatPack;
+        constexpr size_t width{ Simd::SPackTraits<Pack>::Width };
+
+        size_t i = 0;
+        const Pack pack_weight = Simd::Set<Pack>(weight);
+        for (; i + width <= count; i += width)
+        {
+            Simd::StoreUnaligned(sum + i, Simd::Add(Simd::LoadUnaligned<Pack>(sum + i), Simd::Mul(Simd::LoadUnaligned<Pack>(values + i), pack_weight)));
+        }
+
+        // streams are whole 'SVector', so the tail is a multiple of 4 floats
+        const __m128 tail_weight = _mm_set1_ps(weight);
+        for (; i < count; i += 4)
+        {
+            _mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), _mm_mul_ps(_mm_loadu_ps(values + i), tail_weight)));
+        }
+    }
+
+    // out = sum * scale over 'count' floats
+    void ScaleFloats(const float* sum, float scale, float* out, size_t count)
+    {
+        using Pack = Simd::FloatPack;
+        constexpr size_t width{ Simd::SPackTraits<Pack>::Width };
+
+        size_t i = 0;
+        const Pack pack_scale = Simd::Set<Pack>(scale);
+        for (; i + width <= count; i += width)
+        {
+            Simd::StoreUnaligned(out + i, Simd::Mul(Simd::LoadUnaligned<Pack>(sum + i), pack_scale));
+        }
+
+        const __m128 tail_scale = _mm_set1_ps(scale);
+        for (; i < count; i += 4)
+        {
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(sum + i), tail_scale));
+        }
+    }
+
+    float* AsFloats(SVector* vectors) { return reinterpret_cast<float*>(vectors); }
+    const float* AsFloats(const SVector* vectors) { return reinterpret_cast<const float*>(vectors); }
+}
+
+void SPoseBlender::Begin(size_t count)
+{
+    joint_count = count;
+    padded_count = (count + RotationPackWidth - 1) / RotationPackWidth * RotationPackWidth;
+    total_weight = 0.f;
+
+    if (arena != nullptr)
+    {
+        translations = arena->Allocate<SVector>(joint_count);
+        scales = arena->Allocate<SVector>(joint_count);
+        rotations = arena->Allocate<float>(4 * padded_count);
+        std::uninitialized_fill_n(translations, joint_count, SVector::ZeroVector);
+        std::uninitialized_fill_n(scales, joint_count, SVector::ZeroVector);
+        std::uninitialized_fill_n(rotations, 4 * padded_count, 0.f);
+        return;
+    }
+
+    translation_buffer.assign(joint_count, SVector::ZeroVector);
+    scale_buffer.assign(joint_count, SVector::ZeroVector);
+    rotation_buffer.assign(4 * padded_count, 0.f);
+    translations = translation_buffer.data();
+    scales = scale_buffer.data();
+    rotations = rotation_buffer.data();
+}
+
+void SPoseBlender::Add(const SPose& pose, float weight)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SPoseBlender::Add");
+    assert(pose.Size() == joint_count);
+    if (!(weight > 0.f))
+    {
+        return;
+    }
+    total_weight += weight;
+
+    AccumulateFloats(AsFloats(pose.GetTranslations()), weight, AsFloats(translations), 4 * joint_count);
+    AccumulateFloats(AsFloats(pose.GetScales()), weight, AsFloats(scales), 4 * joint_count);
+
+    /*            Rotations            */
+    const RotationPack pack_weight = Simd::Set<RotationPack>(weight);
+    for (size_t i = 0; i < joint_count; i += RotationPackWidth)
+    {
+        const SRotations rotation = LoadQuaternions(pose.GetRotations() + i, joint_count - i, RotationPack{});
+        const SRotations sum = LoadSums(rotations, padded_count, i);
+
+        // shortest path: the weight takes the sign of the dot product with the sum, a zero sum keeps the quaternion as is
+        const RotationPack signed_weight = Simd::Xor(pack_weight, Simd::SignBits(sum.Dot(rotation)));
+        StoreSums(rotations, padded_count, i, sum + rotation * signed_weight);
+    }
+}
+
+void SPoseBlender::End(SPose& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SPoseBlender::End");
+    out.Resize(joint_count);
+    if (!(total_weight > 0.f))
+    {
+        out.SetIdentity();
+        return;
+    }
+
+    const float scale = 1.f / total_weight;
+    ScaleFloats(AsFloats(translations), scale, AsFloats(out.GetTranslations()), 4 * joint_count);
+    ScaleFloats(AsFloats(scales), scale, AsFloats(out.GetScales()), 4 * joint_count);
+
+    /*            Rotations            */
+    for (size_t i = 0; i < joint_count; i += RotationPackWidth)
+    {
+        SRotations sum = LoadSums(rotations, padded_count, i);
+        const RotationPack length = Simd::Sqrt(sum.Dot(sum));
+        sum.axis.x = Simd::Div(sum.axis.x, length);
+        sum.axis.y = Simd::Div(sum.axis.y, length);
+        sum.axis.z = Simd::Div(sum.axis.z, length);
+        sum.w = Simd::Div(sum.w, length);
+        StoreQuaternions(out.GetRotations() + i, joint_count - i, sum);
+    }
+}
+
+void SPoseBlender::Blend(const SPose* const* poses, const float* weights, size_t count, SPose& out)
+{
+    ANIMATION_PROFILE_SCOPE("SPoseBlender::Blend");
+    Begin(count > 0 ? poses[0]->Size() : out.Size());
+    for (size_t i = 0; i < count; ++i)
+    {
+        Add(*poses[i], weights[i]);
+    }
+    End(out);
+}
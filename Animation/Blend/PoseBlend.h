@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+#include "../Memory/FrameArena.h"
+#include "../Skeleton/Pose.h"
+
+/*
+* SPoseBlender computes the weighted average of any number of poses, one whole pose per call:
+*     Begin(joint_count); Add(pose_a, weight_a); Add(pose_b, weight_b); ... End(out);
+* Translations and scales are summed as flat float streams, a kernel call is a multiply-add over every joint.
+* Rotations are summed as a Structure of Arrays (every X, Y, Z and W in its own array) with the sign of each quaternion
+* flipped towards the sum, and 'End' normalizes them: a weighted nlerp. For two poses with weights '1 - t' and 't' the rotations
+* are equal to 'SQuaternionInterpolation::Nlerp'.
+* Weights don't have to add up to 1, the sums are divided by the total weight. Poses with a weight of zero or less are skipped.
+* Sum buffers belong to the blender and keep their size, once it has seen the largest pose a blend allocates nothing.
+* With an 'arena' the sums of a blend come from it instead, from 'Begin' until the arena drops them.
+*/
+struct SPoseBlender
+{
+    // memory of the sums when set
+    SFrameArena* arena{ nullptr };
+
+    // starts a blend of poses with 'joint_count' joints
+    void Begin(size_t joint_count);
+
+    // adds 'pose' with 'weight', 'pose' has the joint count of 'Begin'
+    void Add(const SPose& pose, float weight);
+
+    // weighted average of added poses into 'out', which may be one of them; the identity pose when nothing was added
+    void End(SPose& out);
+
+    // Begin, Add for every pose and End in one call
+    void Blend(const SPose* const* poses, const float* weights, size_t count, SPose& out);
+
+    size_t GetJointCount() const { return joint_count; }
+    float GetTotalWeight() const { return total_weight; }
+
+private:
+    // sums of the current blend, in the arena or in the buffers below
+    SVector* translations{ nullptr };
+    SVector* scales{ nullptr };
+    // X, Y, Z and W arrays, each of 'padded_count' floats, accessed with unaligned loads
+    float* rotations{ nullptr };
+
+    std::vector<SVector> translation_buffer;
+    std::vector<SVector> scale_buffer;
+    std::vector<float> rotation_buffer;
+    size_t joint_count{ 0 };
+    size_t padded_count{ 0 };
+    float total_weight{ 0.f };
+};
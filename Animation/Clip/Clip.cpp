@@ -0,0 +1,49 @@
+#include "Clip.h"
+
+namespace
+{
+    template <typename TValue>
+    bool AppendTrack(SClipChannel<TValue>& channel, size_t joint, const float* times, const TValue* values, size_t count)
+    {
+        if (joint >= channel.tracks.size() || channel.tracks[joint].count != 0 || count == 0)
+        {
+            return false;
+        }
+
+        for (size_t key = 1; key < count; ++key)
+        {
+            if (!(times[key - 1] < times[key]))
+            {
+                return false;
+            }
+        }
+
+        channel.tracks[joint] = {static_cast<uint32_t>(channel.times.size()), static_cast<uint32_t>(count)};
+        channel.times.insert(channel.times.end(), times, times + count);
+        channel.values.insert(channel.values.end(), values, values + count);
+        return true;
+    }
+}
+
+SClip::SClip(size_t joint_count, float duration)
+    : duration(duration)
+{
+    translations.tracks.resize(joint_count);
+    rotations.tracks.resize(joint_count);
+    scales.tracks.resize(joint_count);
+}
+
+bool SClip::SetTranslations(size_t joint, const float* times, const SVector* values, size_t count)
+{
+    return AppendTrack(translations, joint, times, values, count);
+}
+
+bool SClip::SetRotations(size_t joint, const float* times, const SQuaternion* values, size_t count)
+{
+    return AppendTrack(rotations, joint, times, values, count);
+}
+
+bool SClip::SetScales(size_t joint, const float* times, const SVector* values, size_t count)
+{
+    return AppendTrack(scales, joint, times, values, count);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../Quaternion/Quaternion.h"
+#include "../Vector/Vector.h"
+
+// keys of one track: 'count' entries from 'first' in the arrays of its channel
+struct SClipTrack
+{
+    uint32_t first{ 0 };
+    uint32_t count{ 0 };
+};
+
+/*
+* Keys of every joint for one kind of value. Times and values of all tracks are packed into two arrays, a track is a range of both,
+* so a sampler reads a track from one contiguous block and a key search runs over plain floats.
+*/
+template <typename TValue>
+struct SClipChannel
+{
+    std::vector<float> times;
+    std::vector<TValue> values;
+    // one per joint
+    std::vector<SClipTrack> tracks;
+};
+
+/*
+* SClip is an animation clip: keyframe tracks of translations, rotations and scales for every joint of a skeleton.
+* Key times are in seconds and strictly increasing within a track; a track may start after zero and end before the duration,
+* samplers hold its first and last values outside of it. A joint without keys of a channel samples as the identity transform.
+*/
+struct SClip
+{
+    SClip() = default;
+    SClip(size_t joint_count, float duration);
+
+    size_t GetJointCount() const { return translations.tracks.size(); }
+    float GetDuration() const { return duration; }
+
+    // false when the track already has keys, 'count' is zero or 'times' aren't strictly increasing
+    bool SetTranslations(size_t joint, const float* times, const SVector* values, size_t count);
+    bool SetRotations(size_t joint, const float* times, const SQuaternion* values, size_t count);
+    bool SetScales(size_t joint, const float* times, const SVector* values, size_t count);
+
+    const SClipChannel<SVector>& GetTranslations() const { return translations; }
+    const SClipChannel<SQuaternion>& GetRotations() const { return rotations; }
+    const SClipChannel<SVector>& GetScales() const { return scales; }
+
+    // number of keys of every track
+    size_t GetKeyCount() const { return translations.times.size() + rotations.times.size() + scales.times.size(); }
+
+private:
+    SClipChannel<SVector> translations;
+    SClipChannel<SQuaternion> rotations;
+    SClipChannel<SVector> scales;
+    float duration{ 0.f };
+};
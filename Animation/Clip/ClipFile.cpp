@@ -0,0 +1,121 @@
+#include "ClipFile.h"
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+    constexpr char DurationTrack[]{ "duration" };
+    // tracks of a joint: values and times of translations, rotations and scales
+    constexpr size_t TracksPerJoint{ 6 };
+
+    std::string ClipTrackName(char channel, size_t joint, bool is_times)
+    {
+        return channel + std::to_string(joint) + (is_times ? ".times" : "");
+    }
+
+    template <typename TValue>
+    bool AddClipChannel(STrackFileWriter& writer, const SClipChannel<TValue>& channel, char name, size_t joint)
+    {
+        const SClipTrack& track = channel.tracks[joint];
+        const TValue* values = channel.values.data() + track.first;
+        const float* times = channel.times.data() + track.first;
+        bool is_added;
+        if constexpr (std::is_same_v<TValue, SQuaternion>)
+        {
+            is_added = writer.AddQuaternions(ClipTrackName(name, joint, false).c_str(), values, track.count);
+        }
+        else
+        {
+            is_added = writer.AddVectors(ClipTrackName(name, joint, false).c_str(), values, track.count);
+        }
+        return is_added && writer.AddFloats(ClipTrackName(name, joint, true).c_str(), times, track.count);
+    }
+
+    // the values and times tracks of a channel of 'joint' from 'track' on, through 'set' when they have keys
+    template <typename TValue, typename TSet>
+    bool ReadClipChannel(const STrackFile& file, size_t track, char name, size_t joint, const TSet& set)
+    {
+        const STrackFileEntry& values_entry = file.GetTrack(track);
+        const STrackFileEntry& times_entry = file.GetTrack(track + 1);
+        const TValue* values;
+        if constexpr (std::is_same_v<TValue, SQuaternion>)
+        {
+            values = file.GetQuaternions(track);
+        }
+        else
+        {
+            values = file.GetVectors(track);
+        }
+        const float* times = file.GetFloats(track + 1);
+
+        if (values == nullptr || times == nullptr || values_entry.count != times_entry.count ||
+            ClipTrackName(name, joint, false) != values_entry.name || ClipTrackName(name, joint, true) != times_entry.name)
+        {
+            return false;
+        }
+        return values_entry.count == 0 || set(times, values, static_cast<size_t>(values_entry.count));
+    }
+}
+
+ETrackFileStatus SClipFile::Write(const SClip& clip, const char* path)
+{
+    const float duration = clip.GetDuration();
+    STrackFileWriter writer;
+    writer.AddFloats(DurationTrack, &duration, 1);
+    for (size_t joint = 0; joint < clip.GetJointCount(); ++joint)
+    {
+        if (!AddClipChannel(writer, clip.GetTranslations(), 't', joint) || !AddClipChannel(writer, clip.GetRotations(), 'r', joint) ||
+            !AddClipChannel(writer, clip.GetScales(), 's', joint))
+        {
+            return ETrackFileStatus::InvalidName;
+        }
+    }
+    return writer.Write(path);
+}
+
+ETrackFileStatus SClipFile::Read(const char* path, SClip& clip, ETrackFileValidation validation)
+{
+    STrackFile file;
+    const ETrackFileStatus status = file.Open(path, validation);
+    return status == ETrackFileStatus::Ok ? Read(file, clip) : status;
+}
+
+ETrackFileStatus SClipFile::Read(const STrackFile& file, SClip& clip)
+{
+    const size_t track_count = file.GetTrackCount();
+    if (track_count == 0 || (track_count - 1) % TracksPerJoint != 0 || std::strcmp(file.GetTrack(0).name, DurationTrack) != 0 ||
+        file.GetFloats(0) == nullptr || file.GetTrack(0).count != 1)
+    {
+        return ETrackFileStatus::UnexpectedTracks;
+    }
+
+    const size_t joint_count = (track_count - 1) / TracksPerJoint;
+    SClip read(joint_count, *file.GetFloats(0));
+    for (size_t joint = 0; joint < joint_count; ++joint)
+    {
+        const size_t track = 1 + joint * TracksPerJoint;
+        const bool is_read =
+            ReadClipChannel<SVector>(file, track, 't', joint, [&](const float* times, const SVector* values, size_t count)
+            {
+                return read.SetTranslations(joint, times, values, count);
+            }) &&
+            ReadClipChannel<SQuaternion>(file, track + 2, 'r', joint, [&](const float* times, const SQuaternion* values, size_t count)
+            {
+                return read.SetRotations(joint, times, values, count);
+            }) &&
+            ReadClipChannel<SVector>(file, track + 4, 's', joint, [&](const float* times, const SVector* values, size_t count)
+            {
+                return read.SetScales(joint, times, values, count);
+            });
+        if (!is_read)
+        {
+            return ETrackFileStatus::UnexpectedTracks;
+        }
+    }
+
+    clip = std::move(read);
+    return ETrackFileStatus::Ok;
+}
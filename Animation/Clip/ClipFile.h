@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Clip.h"
+#include "../Track/TrackFile.h"
+
+/*
+* SClipFile keeps an 'SClip' in a track file. The first track is the float "duration", then every joint has six tracks in joint order:
+* translations "t<joint>" and their key times "t<joint>.times", rotations "r<joint>" and "r<joint>.times", scales "s<joint>" and
+* "s<joint>.times"; a joint without keys of a channel has two empty tracks. Sections are written straight from the arrays of the
+* clip and read back with one copy per track, the track file checks the rest.
+*/
+struct SClipFile
+{
+    static ETrackFileStatus Write(const SClip& clip, const char* path);
+
+    // 'clip' is replaced by the clip of 'path'; 'UnexpectedTracks' when the file holds no clip or keys a clip rejects
+    static ETrackFileStatus Read(const char* path, SClip& clip, ETrackFileValidation validation = ETrackFileValidation::Full);
+    static ETrackFileStatus Read(const STrackFile& file, SClip& clip);
+};
@@ -0,0 +1,309 @@
+#include "ClipSampler.h"
+
+#include "../Profile/ProfileScope.h"
+#include "../Simd/Simd.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <xmmintrin.h>
+
+namespace
+{
+    // blend factor of 'time' between keys 'key' and 'key + 1', 0 for a single key
+    float KeyAlpha(const float* times, uint32_t count, uint32_t key, float time)
+    {
+        if (count < 2)
+        {
+            return 0.f;
+        }
+
+        const float alpha = (time - times[key]) / (times[key + 1] - times[key]);
+        return std::min(std::max(alpha, 0.f), 1.f);
+    }
+
+    // 'SVector::Lerp' inlined, exact at both keys; zero unused lanes stay zero, so the register is stored as the whole vector
+    void LerpKeys(const __m128& a, const __m128& b, float alpha, SVector& out)
+    {
+        _mm_store_ps(reinterpret_cast<float*>(&out), Simd::Lerp(a, b, _mm_set1_ps(alpha)));
+    }
+
+    void SampleVectors(const SClipChannel<SVector>& channel, float time, uint32_t* keys, SVector* out, const SVector& identity)
+    {
+        const size_t joint_count = channel.tracks.size();
+        for (size_t joint = 0; joint < joint_count; ++joint)
+        {
+            const SClipTrack& track = channel.tracks[joint];
+            if (track.count == 0)
+            {
+                out[joint] = identity;
+                continue;
+            }
+
+            const float* times = channel.times.data() + track.first;
+            const SVector* values = channel.values.data() + track.first;
+            const uint32_t key = SClipSampler::FindKey(times, track.count, time, keys[joint]);
+            keys[joint] = key;
+
+            const uint32_t next = std::min(key + 1, track.count - 1);
+            LerpKeys(values[key].GetStorage(), values[next].GetStorage(), KeyAlpha(times, track.count, key, time), out[joint]);
+        }
+    }
+
+    /*
+    * Finds the key of every track of 'channel' at 'time' into 'keys' and its blend factor into 'alphas', and brings the intervals
+    * of 'decoded' to those keys: 'decode(group, keys, out)' decodes one key of every track of a group.
+    */
+    template <typename TGroup, typename TValue, typename TDecode>
+    void DecodeKeys(const SCompressedChannel<TGroup>& channel, float time, uint32_t* keys, float* alphas, SDecodedKeys<TValue>& decoded,
+                    TDecode decode)
+    {
+        constexpr size_t group_size = SCompressedClip::GroupSize;
+        const size_t joint_count = channel.tracks.size();
+        const size_t padded_count = channel.groups.size() * group_size;
+        if (decoded.from.size() != padded_count)
+        {
+            decoded.from.resize(padded_count, TValue(0.f));
+            decoded.to.resize(padded_count, TValue(0.f));
+            decoded.is_decoded = false;
+        }
+        const bool is_decoded = decoded.is_decoded;
+        decoded.is_decoded = true;
+
+        for (size_t group = 0; group < channel.groups.size(); ++group)
+        {
+            const size_t first_joint = group * group_size;
+            const size_t lane_count = std::min(group_size, joint_count - first_joint);
+            const SClipTrack* tracks = channel.tracks.data() + first_joint;
+
+            // tracks sampled alike share their times, one search serves the group
+            bool is_shared = true;
+            for (size_t lane = 1; lane < lane_count; ++lane)
+            {
+                is_shared = is_shared && tracks[lane].first == tracks[0].first && tracks[lane].count == tracks[0].count;
+            }
+
+            uint32_t from_keys[group_size]{};
+            uint32_t to_keys[group_size]{};
+            bool is_moved[group_size]{};
+            bool is_changed = !is_decoded;
+            bool is_step = is_decoded;
+            for (size_t lane = 0; lane < lane_count; ++lane)
+            {
+                const SClipTrack& track = tracks[lane];
+                const size_t joint = first_joint + lane;
+                const uint32_t cached = keys[joint];
+                if (lane > 0 && is_shared)
+                {
+                    from_keys[lane] = from_keys[0];
+                    to_keys[lane] = to_keys[0];
+                    alphas[joint] = alphas[first_joint];
+                }
+                else if (track.count > 0)
+                {
+                    const float* times = channel.times.data() + track.first;
+                    from_keys[lane] = SClipSampler::FindKey(times, track.count, time, cached);
+                    to_keys[lane] = std::min(from_keys[lane] + 1, track.count - 1);
+                    alphas[joint] = KeyAlpha(times, track.count, from_keys[lane], time);
+                }
+                else
+                {
+                    alphas[joint] = 0.f;
+                }
+                keys[joint] = from_keys[lane];
+
+                if (from_keys[lane] != cached)
+                {
+                    is_moved[lane] = true;
+                    is_changed = true;
+                    is_step = is_step && from_keys[lane] == cached + 1;
+                }
+            }
+            if (!is_changed)
+            {
+                continue;
+            }
+
+            __m128 values[group_size];
+            TValue* from = decoded.from.data() + first_joint;
+            TValue* to = decoded.to.data() + first_joint;
+            if (is_step)
+            {
+                // the next interval starts at the end of the last one
+                for (size_t lane = 0; lane < lane_count; ++lane)
+                {
+                    from[lane] = is_moved[lane] ? to[lane] : from[lane];
+                }
+            }
+            else
+            {
+                decode(channel.groups[group], from_keys, values);
+                for (size_t lane = 0; lane < group_size; ++lane)
+                {
+                    _mm_store_ps(reinterpret_cast<float*>(&from[lane]), values[lane]);
+                }
+            }
+            decode(channel.groups[group], to_keys, values);
+            for (size_t lane = 0; lane < group_size; ++lane)
+            {
+                _mm_store_ps(reinterpret_cast<float*>(&to[lane]), values[lane]);
+            }
+        }
+    }
+
+    void SampleVectors(const SCompressedChannel<SCompressedVectorGroup>& channel, float time, uint32_t* keys, float* alphas,
+                       SDecodedKeys<SVector>& decoded, SVector* out)
+    {
+        const uint8_t* stream = channel.stream.data();
+        DecodeKeys(channel, time, keys, alphas, decoded, [stream](const SCompressedVectorGroup& group, const uint32_t* group_keys, __m128 (&values)[4])
+        {
+            SCompressedClip::DecodeVectors(stream, group, group_keys, values);
+        });
+
+        const size_t joint_count = channel.tracks.size();
+        for (size_t joint = 0; joint < joint_count; ++joint)
+        {
+            LerpKeys(decoded.from[joint].GetStorage(), decoded.to[joint].GetStorage(), alphas[joint], out[joint]);
+        }
+    }
+
+    void ResetCursor(SClipCursor& cursor, const void* clip, size_t joint_count)
+    {
+        if (cursor.clip != clip || cursor.keys.size() != 3 * joint_count)
+        {
+            cursor.Reset();
+            cursor.clip = clip;
+            cursor.keys.assign(3 * joint_count, 0);
+        }
+    }
+}
+
+uint32_t SClipSampler::FindKey(const float* times, uint32_t count, float time, uint32_t cached)
+{
+    if (count < 2)
+    {
+        return 0;
+    }
+
+    const uint32_t last = count - 2;
+    uint32_t key = std::min(cached, last);
+    if (times[key] <= time)
+    {
+        // forward playback moves a few keys per sample at most
+        for (uint32_t step = 0; step <= MaxCursorSteps; ++step)
+        {
+            if (key == last || time < times[key + 1])
+            {
+                return key;
+            }
+            ++key;
+        }
+    }
+    else if (key == 0)
+    {
+        return 0;
+    }
+
+    // a seek: the first key after 'time', minus one
+    const uint32_t after = static_cast<uint32_t>(std::upper_bound(times, times + count, time) - times);
+    return after == 0 ? 0 : std::min(after - 1, last);
+}
+
+void SClipSampler::Sample(const SClip& clip, float time, SClipCursor& cursor, SPose& pose)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SClipSampler::Sample");
+    const size_t joint_count = clip.GetJointCount();
+    ResetCursor(cursor, &clip, joint_count);
+    pose.Resize(joint_count);
+    const SRotationPairs pairs = GetRotationPairs(joint_count);
+
+    uint32_t* translation_keys = cursor.keys.data();
+    uint32_t* rotation_keys = translation_keys + joint_count;
+    uint32_t* scale_keys = rotation_keys + joint_count;
+
+    SampleVectors(clip.GetTranslations(), time, translation_keys, pose.GetTranslations(), SVector::ZeroVector);
+    SampleVectors(clip.GetScales(), time, scale_keys, pose.GetScales(), SVector(1.f));
+
+    /*            Rotations            */
+    const SClipChannel<SQuaternion>& rotations = clip.GetRotations();
+    for (size_t joint = 0; joint < joint_count; ++joint)
+    {
+        const SClipTrack& track = rotations.tracks[joint];
+        if (track.count == 0)
+        {
+            pairs.from[joint] = SQuaternion::Identity;
+            pairs.to[joint] = SQuaternion::Identity;
+            pairs.alphas[joint] = 0.f;
+            continue;
+        }
+
+        const float* times = rotations.times.data() + track.first;
+        const SQuaternion* values = rotations.values.data() + track.first;
+        const uint32_t key = FindKey(times, track.count, time, rotation_keys[joint]);
+        rotation_keys[joint] = key;
+
+        pairs.from[joint] = values[key];
+        pairs.to[joint] = values[std::min(key + 1, track.count - 1)];
+        pairs.alphas[joint] = KeyAlpha(times, track.count, key, time);
+    }
+
+    SQuaternionInterpolation::Interpolate(interpolation, pairs.from, pairs.to, pairs.alphas, pose.GetRotations(), joint_count);
+}
+
+void SClipSampler::Sample(const SClip& clip, const float* times, SClipCursor* cursors, SPose* poses, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        Sample(clip, times[i], cursors[i], poses[i]);
+    }
+}
+
+void SClipSampler::Sample(const SCompressedClip& clip, float time, SClipCursor& cursor, SPose& pose)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SClipSampler::Sample(compressed)");
+    const size_t joint_count = clip.GetJointCount();
+    ResetCursor(cursor, &clip, joint_count);
+    pose.Resize(joint_count);
+    // only the blend factors, the pairs are in the cursor
+    float* alphas = GetRotationPairs(joint_count).alphas;
+
+    uint32_t* translation_keys = cursor.keys.data();
+    uint32_t* rotation_keys = translation_keys + joint_count;
+    uint32_t* scale_keys = rotation_keys + joint_count;
+
+    SampleVectors(clip.GetTranslations(), time, translation_keys, alphas, cursor.translations, pose.GetTranslations());
+    SampleVectors(clip.GetScales(), time, scale_keys, alphas, cursor.scales, pose.GetScales());
+
+    /*            Rotations            */
+    const SCompressedChannel<SCompressedRotationGroup>& rotations = clip.GetRotations();
+    const uint8_t* stream = rotations.stream.data();
+    DecodeKeys(rotations, time, rotation_keys, alphas, cursor.rotations, [stream](const SCompressedRotationGroup& group, const uint32_t* keys, __m128 (&values)[4])
+    {
+        SCompressedClip::DecodeRotations(stream, group, keys, values);
+    });
+
+    SQuaternionInterpolation::Interpolate(interpolation, cursor.rotations.from.data(), cursor.rotations.to.data(), alphas, pose.GetRotations(), joint_count);
+}
+
+void SClipSampler::Sample(const SCompressedClip& clip, const float* times, SClipCursor* cursors, SPose* poses, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        Sample(clip, times[i], cursors[i], poses[i]);
+    }
+}
+
+SClipSampler::SRotationPairs SClipSampler::GetRotationPairs(size_t joint_count)
+{
+    if (arena != nullptr)
+    {
+        return {arena->Allocate<SQuaternion>(joint_count), arena->Allocate<SQuaternion>(joint_count), arena->Allocate<float>(joint_count)};
+    }
+
+    if (from.size() < joint_count)
+    {
+        from.resize(joint_count, SQuaternion::Identity);
+        to.resize(joint_count, SQuaternion::Identity);
+        alphas.resize(joint_count);
+    }
+    return {from.data(), to.data(), alphas.data()};
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Clip.h"
+#include "CompressedClip.h"
+#include "../Memory/FrameArena.h"
+#include "../Quaternion/QuaternionInterpolation.h"
+#include "../Skeleton/Pose.h"
+
+// the decoded keys of the interval of every track of an 'SCompressedClip' channel, padded to whole groups
+template <typename TValue>
+struct SDecodedKeys
+{
+    std::vector<TValue> from;
+    std::vector<TValue> to;
+    // 'from' and 'to' hold the intervals of the keys of the cursor
+    bool is_decoded{ false };
+
+    void Reset() { is_decoded = false; }
+};
+
+/*
+* SClipCursor is the position of one playback instance in a clip: the key interval every track used last time.
+* Playing forward, the next sample starts from it and steps at most a few keys, O(1) per track instead of a binary search.
+* With an 'SCompressedClip' it also keeps the decoded keys of those intervals, so a group of tracks is decoded only when one of its
+* tracks moves to another key, and moving one key forward decodes just the new one.
+* A cursor belongs to one clip, the next sample of another clip resets it, raw or compressed. 'Reset' keeps the memory.
+*/
+struct SClipCursor
+{
+    void Reset()
+    {
+        clip = nullptr;
+        keys.clear();
+        translations.Reset();
+        rotations.Reset();
+        scales.Reset();
+    }
+
+    // the 'SClip' or 'SCompressedClip' the cursor sampled last, the decoded keys are its own
+    const void* clip{ nullptr };
+    // translation, rotation and scale key of every joint, in this order
+    std::vector<uint32_t> keys;
+
+    SDecodedKeys<SVector> translations;
+    SDecodedKeys<SQuaternion> rotations;
+    SDecodedKeys<SVector> scales;
+};
+
+/*
+* SClipSampler evaluates a clip at any time into a pose.
+* Translations and scales are lerped straight into the pose arrays; rotations are gathered into key pairs for every joint first
+* and blended by one 'SQuaternionInterpolation' call over the whole pose. The pair buffers belong to the sampler and keep their size,
+* so once a sampler has seen the largest clip, sampling allocates nothing. Use a sampler per thread.
+* An 'SCompressedClip' samples the same way from the keys its cursor keeps decoded, see 'SClipCursor'.
+* With an 'arena' the pair buffers of every sample come from it instead, until the arena drops them.
+*/
+struct SClipSampler
+{
+    // forward steps the cursor takes before it falls back to a binary search
+    constexpr static uint32_t MaxCursorSteps{ 4 };
+
+    // method of rotation blending between keys
+    EQuaternionInterpolation interpolation{ EQuaternionInterpolation::Nlerp };
+
+    // memory of the rotation pairs when set
+    SFrameArena* arena{ nullptr };
+
+    // 'pose' is resized to the joint count of 'clip', 'time' is clamped to the keys of every track
+    void Sample(const SClip& clip, float time, SClipCursor& cursor, SPose& pose);
+
+    // every playback instance of a clip: 'times[i]' with 'cursors[i]' into 'poses[i]'
+    void Sample(const SClip& clip, const float* times, SClipCursor* cursors, SPose* poses, size_t count);
+
+    void Sample(const SCompressedClip& clip, float time, SClipCursor& cursor, SPose& pose);
+    void Sample(const SCompressedClip& clip, const float* times, SClipCursor* cursors, SPose* poses, size_t count);
+
+    // interval of 'times' holding 'time': the last key at or before it, in [0, count - 2], starting the search from 'cached'
+    static uint32_t FindKey(const float* times, uint32_t count, float time, uint32_t cached);
+
+private:
+    // the two keys and the blend factor of every joint
+    struct SRotationPairs
+    {
+        SQuaternion* from;
+        SQuaternion* to;
+        float* alphas;
+    };
+
+    // pair buffers of a sample of 'joint_count' joints, in the arena or in the buffers below grown to 'joint_count'
+    SRotationPairs GetRotationPairs(size_t joint_count);
+
+    std::vector<SQuaternion> from;
+    std::vector<SQuaternion> to;
+    std::vector<float> alphas;
+};
@@ -0,0 +1,391 @@
+#include "CompressedClip.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+
+namespace
+{
+    // appends the low 'bits' bits of 'value' to a stream at 'bit'
+    void WriteBits(std::vector<uint8_t>& stream, uint64_t bit, uint64_t value, uint32_t bits)
+    {
+        stream.resize(std::max<size_t>(stream.size(), static_cast<size_t>((bit + bits + 7) / 8)));
+        for (uint32_t i = 0; i < bits; ++i, ++bit)
+        {
+            if ((value >> i) & 1)
+            {
+                stream[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+            }
+        }
+    }
+
+    // a decoder reads 8 bytes at the last key
+    void PadStream(std::vector<uint8_t>& stream)
+    {
+        stream.resize(stream.size() + sizeof(uint64_t), 0);
+    }
+
+    float Distance(const __m128& a, const __m128& b)
+    {
+        alignas(16) float difference[4];
+        _mm_store_ps(difference, _mm_sub_ps(a, b));
+        return std::sqrt(difference[0] * difference[0] + difference[1] * difference[1] + difference[2] * difference[2] + difference[3] * difference[3]);
+    }
+
+    // angle between rotations of two quaternions, either may be off unit length
+    float Angle(const __m128& a, const __m128& b)
+    {
+        alignas(16) float lhs[4], rhs[4];
+        _mm_store_ps(lhs, a);
+        _mm_store_ps(rhs, b);
+        double dot{ 0.0 }, lhs_length{ 0.0 }, rhs_length{ 0.0 };
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            dot += static_cast<double>(lhs[lane]) * rhs[lane];
+            lhs_length += static_cast<double>(lhs[lane]) * lhs[lane];
+            rhs_length += static_cast<double>(rhs[lane]) * rhs[lane];
+        }
+        const double cosine = std::min(1.0, std::fabs(dot) / std::sqrt(lhs_length * rhs_length));
+        return static_cast<float>(2.0 * std::acos(cosine));
+    }
+
+    // keys and tolerances of the tracks of a group, lanes past the last joint and tracks without keys have a count of zero
+    template <typename TValue>
+    struct SGroupSource
+    {
+        const TValue* values[SCompressedClip::GroupSize]{};
+        uint32_t counts[SCompressedClip::GroupSize]{};
+        float tolerances[SCompressedClip::GroupSize]{};
+    };
+
+    /*
+    * Largest error of every track of a candidate group against its source keys, with the decoder of the sampler: 'decode(keys, out)'
+    * decodes one key of every track, 'distance(value, decoded)' measures one.
+    */
+    template <typename TValue, typename TDecode, typename TDistance>
+    void MeasureGroup(const SGroupSource<TValue>& source, float (&errors)[SCompressedClip::GroupSize], TDecode decode, TDistance distance)
+    {
+        uint32_t key_count = 0;
+        for (size_t lane = 0; lane < SCompressedClip::GroupSize; ++lane)
+        {
+            errors[lane] = 0.f;
+            key_count = std::max(key_count, source.counts[lane]);
+        }
+
+        for (uint32_t key = 0; key < key_count; ++key)
+        {
+            uint32_t keys[SCompressedClip::GroupSize];
+            for (size_t lane = 0; lane < SCompressedClip::GroupSize; ++lane)
+            {
+                keys[lane] = std::min(key, std::max(source.counts[lane], 1u) - 1);
+            }
+            __m128 decoded[SCompressedClip::GroupSize];
+            decode(keys, decoded);
+            for (size_t lane = 0; lane < SCompressedClip::GroupSize; ++lane)
+            {
+                if (key < source.counts[lane])
+                {
+                    errors[lane] = std::max(errors[lane], distance(source.values[lane][key].GetStorage(), decoded[lane]));
+                }
+            }
+        }
+    }
+
+    // every track of the group within its tolerance
+    template <typename TValue>
+    bool IsGroupWithinBudget(const SGroupSource<TValue>& source, const float (&errors)[SCompressedClip::GroupSize])
+    {
+        for (size_t lane = 0; lane < SCompressedClip::GroupSize; ++lane)
+        {
+            if (errors[lane] > source.tolerances[lane])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*            Translations & Scales            */
+    // quantizes a group at every bit rate from zero up and keeps the first one within the tolerance of all its tracks
+    void CompressVectorGroup(const SGroupSource<SVector>& source, const SVector& identity, float (&errors)[SCompressedClip::GroupSize],
+                             SCompressedVectorGroup& group, std::vector<uint8_t>& stream)
+    {
+        float minimum[3][SCompressedClip::GroupSize], maximum[3][SCompressedClip::GroupSize];
+        for (size_t lane = 0; lane < SCompressedClip::GroupSize; ++lane)
+        {
+            const SVector first = source.counts[lane] > 0 ? source.values[lane][0] : identity;
+            const float components[3]{ first.GetX(), first.GetY(), first.GetZ() };
+            for (int c = 0; c < 3; ++c)
+            {
+                minimum[c][lane] = maximum[c][lane] = components[c];
+            }
+            for (uint32_t key = 1; key < source.counts[lane]; ++key)
+            {
+                const SVector& value = source.values[lane][key];
+                const float key_components[3]{ value.GetX(), value.GetY(), value.GetZ() };
+                for (int c = 0; c < 3; ++c)
+                {
+                    minimum[c][lane] = std::min(minimum[c][lane], key_components[c]);
+                    maximum[c][lane] = std::max(maximum[c][lane], key_components[c]);
+                }
+            }
+        }
+
+        std::vector<uint8_t> candidate;
+        for (uint32_t bits = 0; bits <= SCompressedClip::MaxVectorBits; ++bits)
+        {
+            const float levels = static_cast<float>((1u << bits) - 1);
+            SCompressedVectorGroup attempt;
+            attempt.bits = bits;
+            uint64_t bit_offset = 0;
+            for (size_t lane = 0; lane < SCompressedClip::GroupSize; ++lane)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    // a constant track decodes to the middle of its range, a track without keys to the identity
+                    const bool is_constant = bits == 0 || source.counts[lane] == 0;
+                    attempt.minimum[c][lane] = is_constant ? 0.5f * (minimum[c][lane] + maximum[c][lane]) : minimum[c][lane];
+                    attempt.scale[c][lane] = is_constant ? 0.f : (maximum[c][lane] - minimum[c][lane]) / levels;
+                }
+                attempt.bit_offsets[lane] = bit_offset;
+                bit_offset += uint64_t{ source.counts[lane] } * 3 * bits;
+            }
+
+            candidate.assign(static_cast<size_t>((bit_offset + 7) / 8) + sizeof(uint64_t), 0);
+            for (size_t lane = 0; lane < SCompressedClip::GroupSize && bits > 0; ++lane)
+            {
+                for (uint32_t key = 0; key < source.counts[lane]; ++key)
+                {
+                    const SVector& value = source.values[lane][key];
+                    const float components[3]{ value.GetX(), value.GetY(), value.GetZ() };
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        const float scale = attempt.scale[c][lane];
+                        const float quantized = scale > 0.f ? std::round((components[c] - attempt.minimum[c][lane]) / scale) : 0.f;
+                        WriteBits(candidate, attempt.bit_offsets[lane] + uint64_t{ key } * 3 * bits + c * bits,
+                                  static_cast<uint64_t>(std::min(std::max(quantized, 0.f), levels)), bits);
+                    }
+                }
+            }
+
+            // the errors of what a sampler decodes
+            MeasureGroup(source, errors, [&](const uint32_t* keys, __m128 (&decoded)[4])
+            {
+                SCompressedClip::DecodeVectors(candidate.data(), attempt, keys, decoded);
+            }, Distance);
+
+            if (IsGroupWithinBudget(source, errors) || bits == SCompressedClip::MaxVectorBits)
+            {
+                for (uint64_t& offset : attempt.bit_offsets)
+                {
+                    offset += uint64_t{ stream.size() } * 8;
+                }
+                group = attempt;
+                stream.insert(stream.end(), candidate.begin(), candidate.end() - sizeof(uint64_t));
+                break;
+            }
+        }
+    }
+
+    /*            Rotations            */
+    uint64_t EncodeRotation(const SQuaternion& rotation, uint32_t bits, float step)
+    {
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, rotation.Normal().GetStorage());
+
+        uint32_t dropped = 0;
+        for (uint32_t lane = 1; lane < 4; ++lane)
+        {
+            if (std::fabs(lanes[lane]) > std::fabs(lanes[dropped]))
+            {
+                dropped = lane;
+            }
+        }
+
+        // q and -q are the same rotation, a positive dropped component needs no sign bit
+        const float sign = lanes[dropped] < 0.f ? -1.f : 1.f;
+        const float levels = static_cast<float>((1u << bits) - 1);
+        uint64_t value = dropped;
+        uint32_t position = 2;
+        for (int lane = 3; lane >= 0; --lane)
+        {
+            if (static_cast<uint32_t>(lane) == dropped)
+            {
+                continue;
+            }
+            const float quantized = std::round((sign * lanes[lane] + SCompressedClip::RotationRange) / step);
+            value |= static_cast<uint64_t>(std::min(std::max(quantized, 0.f), levels)) << position;
+            position += bits;
+        }
+        return value;
+    }
+
+    // 32-bit keys when they meet the tolerance of every track, 47-bit keys otherwise
+    void CompressRotationGroup(const SGroupSource<SQuaternion>& source, const SQuaternion&, float (&errors)[SCompressedClip::GroupSize],
+                               SCompressedRotationGroup& group, std::vector<uint8_t>& stream)
+    {
+        std::vector<uint8_t> candidate;
+        for (const uint32_t bits : { SCompressedClip::SmallRotationBits, SCompressedClip::LargeRotationBits })
+        {
+            SCompressedRotationGroup attempt;
+            attempt.bits = bits;
+            // an even number of steps puts zero on the grid, so identity and axis rotations are exact
+            attempt.step = 2.f * SCompressedClip::RotationRange / static_cast<float>((1u << bits) - 2);
+
+            const uint32_t key_bits = 2 + 3 * bits;
+            uint64_t bit_offset = 0;
+            for (size_t lane = 0; lane < SCompressedClip::GroupSize; ++lane)
+            {
+                attempt.empty[lane] = source.counts[lane] == 0 ? ~0u : 0u;
+                attempt.bit_offsets[lane] = bit_offset;
+                bit_offset += uint64_t{ source.counts[lane] } * key_bits;
+            }
+
+            candidate.assign(static_cast<size_t>((bit_offset + 7) / 8) + sizeof(uint64_t), 0);
+            for (size_t lane = 0; lane < SCompressedClip::GroupSize; ++lane)
+            {
+                for (uint32_t key = 0; key < source.counts[lane]; ++key)
+                {
+                    WriteBits(candidate, attempt.bit_offsets[lane] + uint64_t{ key } * key_bits,
+                              EncodeRotation(source.values[lane][key], bits, attempt.step), key_bits);
+                }
+            }
+
+            MeasureGroup(source, errors, [&](const uint32_t* keys, __m128 (&decoded)[4])
+            {
+                SCompressedClip::DecodeRotations(candidate.data(), attempt, keys, decoded);
+            }, Angle);
+
+            if (IsGroupWithinBudget(source, errors) || bits == SCompressedClip::LargeRotationBits)
+            {
+                for (uint64_t& offset : attempt.bit_offsets)
+                {
+                    offset += uint64_t{ stream.size() } * 8;
+                }
+                group = attempt;
+                stream.insert(stream.end(), candidate.begin(), candidate.end() - sizeof(uint64_t));
+                break;
+            }
+        }
+    }
+
+    // 'compress(source, identity, errors, group, stream)' for every group of tracks, returns the largest error
+    template <typename TValue, typename TGroup, typename TCompress>
+    float CompressChannel(const SClipChannel<TValue>& source, const std::vector<float>& tolerances, const TValue& identity,
+                          SCompressedChannel<TGroup>& channel, size_t& tracks_over_budget, TCompress compress)
+    {
+        const size_t joint_count = source.tracks.size();
+        channel.tracks = source.tracks;
+        channel.groups.resize(SCompressedClip::GetGroupCount(joint_count));
+
+        // tracks with equal key times share them, so the sampler finds the keys of a group sampled alike once
+        channel.times.clear();
+        std::vector<size_t> owners;
+        for (size_t joint = 0; joint < joint_count; ++joint)
+        {
+            const SClipTrack& track = source.tracks[joint];
+            const float* times = source.times.data() + track.first;
+            const auto owner = std::find_if(owners.begin(), owners.end(), [&](size_t other)
+            {
+                const SClipTrack& other_track = source.tracks[other];
+                return other_track.count == track.count && std::equal(times, times + track.count, source.times.data() + other_track.first);
+            });
+            if (owner != owners.end())
+            {
+                channel.tracks[joint].first = channel.tracks[*owner].first;
+                continue;
+            }
+            channel.tracks[joint].first = static_cast<uint32_t>(channel.times.size());
+            channel.times.insert(channel.times.end(), times, times + track.count);
+            owners.push_back(joint);
+        }
+
+        float max_error{ 0.f };
+        for (size_t group = 0; group < channel.groups.size(); ++group)
+        {
+            SGroupSource<TValue> group_source;
+            for (size_t lane = 0; lane < SCompressedClip::GroupSize; ++lane)
+            {
+                const size_t joint = group * SCompressedClip::GroupSize + lane;
+                if (joint < joint_count)
+                {
+                    group_source.values[lane] = source.values.data() + source.tracks[joint].first;
+                    group_source.counts[lane] = source.tracks[joint].count;
+                    group_source.tolerances[lane] = tolerances[joint];
+                }
+            }
+
+            float errors[SCompressedClip::GroupSize];
+            compress(group_source, identity, errors, channel.groups[group], channel.stream);
+            for (size_t lane = 0; lane < SCompressedClip::GroupSize; ++lane)
+            {
+                max_error = std::max(max_error, errors[lane]);
+                tracks_over_budget += errors[lane] > group_source.tolerances[lane] ? 1 : 0;
+            }
+        }
+
+        PadStream(channel.stream);
+        return max_error;
+    }
+
+    template <typename TValue>
+    size_t GetRawSize(const SClipChannel<TValue>& channel)
+    {
+        return channel.times.size() * sizeof(float) + channel.values.size() * sizeof(TValue) + channel.tracks.size() * sizeof(SClipTrack);
+    }
+
+    template <typename TGroup>
+    size_t GetCompressedSize(const SCompressedChannel<TGroup>& channel)
+    {
+        return channel.times.size() * sizeof(float) + channel.stream.size() + channel.tracks.size() * sizeof(SClipTrack) +
+               channel.groups.size() * sizeof(TGroup);
+    }
+}
+
+SCompressedClip SCompressedClip::Compress(const SClip& clip, const SCompressionSettings& settings, SCompressionReport* report)
+{
+    const size_t joint_count = clip.GetJointCount();
+    std::vector<float> translation_tolerances(joint_count), rotation_tolerances(joint_count), scale_tolerances(joint_count);
+    for (size_t joint = 0; joint < joint_count; ++joint)
+    {
+        const SCompressionBudget& budget = settings.joint_budgets.size() == joint_count ? settings.joint_budgets[joint] : settings.budget;
+        translation_tolerances[joint] = budget.translation;
+        rotation_tolerances[joint] = budget.rotation;
+        scale_tolerances[joint] = budget.scale;
+    }
+
+    SCompressedClip result;
+    result.duration = clip.GetDuration();
+
+    SCompressionReport summary;
+    summary.max_translation_error = CompressChannel(clip.GetTranslations(), translation_tolerances, SVector::ZeroVector, result.translations,
+                                                    summary.tracks_over_budget, CompressVectorGroup);
+    summary.max_rotation_error = CompressChannel(clip.GetRotations(), rotation_tolerances, SQuaternion::Identity, result.rotations,
+                                                 summary.tracks_over_budget, CompressRotationGroup);
+    summary.max_scale_error = CompressChannel(clip.GetScales(), scale_tolerances, SVector(1.f), result.scales, summary.tracks_over_budget,
+                                              CompressVectorGroup);
+    summary.raw_bytes = GetRawSize(clip.GetTranslations()) + GetRawSize(clip.GetRotations()) + GetRawSize(clip.GetScales());
+    summary.compressed_bytes = result.GetMemorySize();
+
+    if (report != nullptr)
+    {
+        *report = summary;
+    }
+    return result;
+}
+
+size_t SCompressedClip::GetMemorySize() const
+{
+    return GetCompressedSize(translations) + GetCompressedSize(rotations) + GetCompressedSize(scales);
+}
+
+/*            Operator <<            */
+std::ostream& operator<<(std::ostream& os, const SCompressionReport& report)
+{
+    os << report.raw_bytes << " -> " << report.compressed_bytes << " bytes (" << std::fixed << std::setprecision(2) << report.Ratio() << "x), "
+       << std::scientific << std::setprecision(2) << "max error: translation " << report.max_translation_error << ", rotation "
+       << report.max_rotation_error << " rad, scale " << report.max_scale_error << ", tracks over budget: " << report.tracks_over_budget;
+    os.unsetf(std::ios::floatfield);
+    return os;
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <vector>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+#include "Clip.h"
+
+// largest error a joint accepts from quantization
+struct SCompressionBudget
+{
+    // distance in units of the clip
+    float translation{ 1e-4f };
+    // angle in radians
+    float rotation{ 1e-3f };
+    // difference of a scale component
+    float scale{ 1e-5f };
+};
+
+struct SCompressionSettings
+{
+    // budget of every joint without its own
+    SCompressionBudget budget;
+    // empty, or a budget for every joint
+    std::vector<SCompressionBudget> joint_budgets;
+};
+
+// memory and error of a compressed clip, errors are measured on every key after decompression
+struct SCompressionReport
+{
+    size_t raw_bytes{ 0 };
+    size_t compressed_bytes{ 0 };
+    float max_translation_error{ 0.f };
+    float max_rotation_error{ 0.f };
+    float max_scale_error{ 0.f };
+    // tracks over their budget even at the highest bit rate
+    size_t tracks_over_budget{ 0 };
+
+    // raw size over compressed size
+    float Ratio() const { return compressed_bytes > 0 ? static_cast<float>(raw_bytes) / static_cast<float>(compressed_bytes) : 0.f; }
+};
+
+std::ostream& operator<<(std::ostream& os, const SCompressionReport& report);
+
+/*
+* Four translation or scale tracks, joints 4g to 4g + 3 of group g, with one bit rate: range-reduced components quantized to 'bits'
+* bits each, 3 * 'bits' bits per key. Ranges are a Structure of Arrays, component first and track second, so a decoder converts the
+* keys of all four tracks at once. A component decodes as 'minimum + q * scale'; with no bits every key decodes to 'minimum'.
+* A track without keys has the identity of its channel as 'minimum' and no scale.
+*/
+struct SCompressedVectorGroup
+{
+    alignas(16) float minimum[3][4]{};
+    alignas(16) float scale[3][4]{};
+    // first key of every track in the stream
+    uint64_t bit_offsets[4]{};
+    uint32_t bits{ 0 };
+};
+
+/*
+* Four rotation tracks with the smallest-three encoding: the largest component is made positive and dropped, the other three lie in
+* [-1/sqrt(2), 1/sqrt(2)] and are quantized to 'bits' bits each. A key is its 2-bit lane of the dropped component followed by
+* three components in descending lane order: 32 bits with 10 bits per component, 47 bits with 15. All four tracks share the bit rate.
+*/
+struct SCompressedRotationGroup
+{
+    // ~0 for tracks without keys, they decode to the identity
+    alignas(16) uint32_t empty[4]{};
+    uint64_t bit_offsets[4]{};
+    // quantization step of a component
+    float step{ 0.f };
+    uint32_t bits{ 0 };
+};
+
+// key times and key ranges as in 'SClipChannel', tracks with equal times share them; values in a bit stream padded for 64-bit reads
+template <typename TGroup>
+struct SCompressedChannel
+{
+    std::vector<float> times;
+    std::vector<uint8_t> stream;
+    std::vector<SClipTrack> tracks;
+    // a group for every 'SCompressedClip::GroupSize' tracks, the last one padded with tracks without keys
+    std::vector<TGroup> groups;
+};
+
+/*
+* SCompressedClip is an 'SClip' with quantized keys, every group of four joints at the lowest bit rate that meets the error budgets
+* of its joints. Key times and key counts are those of the source clip, so 'SClipSampler' and 'SClipCursor' work with both.
+* A decoder reads the keys of a group with one unaligned 64-bit read per track and converts the four of them together in SSE
+* registers, the 'Decode' functions below.
+*/
+struct SCompressedClip
+{
+    // tracks decoded together, one per SSE lane
+    constexpr static size_t GroupSize{ 4 };
+    // bits per rotation component of 32-bit and 47-bit keys
+    constexpr static uint32_t SmallRotationBits{ 10 };
+    constexpr static uint32_t LargeRotationBits{ 15 };
+    // most bits per translation or scale component
+    constexpr static uint32_t MaxVectorBits{ 16 };
+    // bound of the three smallest components of a unit quaternion, 1 / sqrt(2)
+    constexpr static float RotationRange{ 0.707106781f };
+
+    static SCompressedClip Compress(const SClip& clip, const SCompressionSettings& settings = {}, SCompressionReport* report = nullptr);
+
+    static size_t GetGroupCount(size_t joint_count) { return (joint_count + GroupSize - 1) / GroupSize; }
+
+    size_t GetJointCount() const { return translations.tracks.size(); }
+    float GetDuration() const { return duration; }
+
+    // bytes of keys, times, tracks and groups
+    size_t GetMemorySize() const;
+
+    const SCompressedChannel<SCompressedVectorGroup>& GetTranslations() const { return translations; }
+    const SCompressedChannel<SCompressedRotationGroup>& GetRotations() const { return rotations; }
+    const SCompressedChannel<SCompressedVectorGroup>& GetScales() const { return scales; }
+
+    /*            Decode            */
+    static uint64_t ReadBits(const uint8_t* stream, uint64_t bit)
+    {
+        uint64_t word;
+        std::memcpy(&word, stream + (bit >> 3), sizeof(word));
+        return word >> (bit & 7);
+    }
+
+    // the key of every track of a group, two tracks per register in 64-bit lanes
+    static void ReadKeys(const uint8_t* stream, const uint64_t (&bit_offsets)[4], const uint32_t* keys, uint32_t key_bits, __m128i& low, __m128i& high)
+    {
+        uint64_t words[4];
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+            words[lane] = ReadBits(stream, bit_offsets[lane] + uint64_t{ keys[lane] } * key_bits);
+        }
+        low = _mm_set_epi64x(static_cast<long long>(words[1]), static_cast<long long>(words[0]));
+        high = _mm_set_epi64x(static_cast<long long>(words[3]), static_cast<long long>(words[2]));
+    }
+
+    // the bits at 'shift' of the four keys of 'ReadKeys' under 'mask', one track per 32-bit lane
+    static __m128i ExtractBits(const __m128i& low, const __m128i& high, uint32_t shift, const __m128i& mask)
+    {
+        const __m128i count = _mm_cvtsi32_si128(static_cast<int>(shift));
+        const __m128 packed = _mm_shuffle_ps(_mm_castsi128_ps(_mm_srl_epi64(low, count)), _mm_castsi128_ps(_mm_srl_epi64(high, count)),
+                                             _MM_SHUFFLE(2, 0, 2, 0));
+        return _mm_and_si128(_mm_castps_si128(packed), mask);
+    }
+
+    // lanes of 'mask' from 'a', the others from 'b'
+    static __m128 Select(const __m128& mask, const __m128& a, const __m128& b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // key 'keys[t]' of every track 't' of 'group' into 'out[t]', an 'SVector' register
+    static void DecodeVectors(const uint8_t* stream, const SCompressedVectorGroup& group, const uint32_t* keys, __m128 (&out)[4])
+    {
+        const uint32_t bits = group.bits;
+        __m128i low, high;
+        ReadKeys(stream, group.bit_offsets, keys, 3 * bits, low, high);
+        const __m128i mask = _mm_set1_epi32(static_cast<int>((1u << bits) - 1));
+
+        // components of the four tracks, X, Y and Z of 'SVector' become lanes 3, 2 and 1 after the transpose
+        __m128 components[3];
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            const __m128 quantized = _mm_cvtepi32_ps(ExtractBits(low, high, c * bits, mask));
+            components[c] = _mm_add_ps(_mm_load_ps(group.minimum[c]), _mm_mul_ps(quantized, _mm_load_ps(group.scale[c])));
+        }
+        out[0] = _mm_setzero_ps();
+        out[1] = components[2];
+        out[2] = components[1];
+        out[3] = components[0];
+        _MM_TRANSPOSE4_PS(out[0], out[1], out[2], out[3]);
+    }
+
+    // key 'keys[t]' of every track 't' of 'group' into 'out[t]', an 'SQuaternion' register
+    static void DecodeRotations(const uint8_t* stream, const SCompressedRotationGroup& group, const uint32_t* keys, __m128 (&out)[4])
+    {
+        const uint32_t bits = group.bits;
+        __m128i low, high;
+        ReadKeys(stream, group.bit_offsets, keys, 2 + 3 * bits, low, high);
+        const __m128i mask = _mm_set1_epi32(static_cast<int>((1u << bits) - 1));
+        const __m128 step = _mm_set1_ps(group.step);
+        const __m128 range = _mm_set1_ps(RotationRange);
+
+        const __m128 a = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(ExtractBits(low, high, 2, mask)), step), range);
+        const __m128 b = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(ExtractBits(low, high, 2 + bits, mask)), step), range);
+        const __m128 c = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(ExtractBits(low, high, 2 + 2 * bits, mask)), step), range);
+
+        // the dropped component from the unit length
+        const __m128 squares = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)), _mm_mul_ps(c, c));
+        const __m128 d = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(1.f), squares), _mm_setzero_ps()));
+
+        // a, b and c go to the kept lanes in descending order, d to the dropped one: masks per track instead of a branch, the
+        // dropped lane changes from key to key
+        const __m128i dropped = ExtractBits(low, high, 0, _mm_set1_epi32(3));
+        const __m128 at_w = _mm_castsi128_ps(_mm_cmpeq_epi32(dropped, _mm_setzero_si128()));
+        const __m128 at_z = _mm_castsi128_ps(_mm_cmpeq_epi32(dropped, _mm_set1_epi32(1)));
+        const __m128 at_y = _mm_castsi128_ps(_mm_cmpeq_epi32(dropped, _mm_set1_epi32(2)));
+        const __m128 at_x = _mm_castsi128_ps(_mm_cmpeq_epi32(dropped, _mm_set1_epi32(3)));
+        const __m128 empty = _mm_load_ps(reinterpret_cast<const float*>(group.empty));
+
+        out[3] = _mm_andnot_ps(empty, Select(at_x, d, a));
+        out[2] = _mm_andnot_ps(empty, Select(at_x, a, Select(at_y, d, b)));
+        out[1] = _mm_andnot_ps(empty, Select(_mm_or_ps(at_x, at_y), b, Select(at_z, d, c)));
+        out[0] = Select(empty, _mm_set1_ps(1.f), Select(at_w, d, c));
+        _MM_TRANSPOSE4_PS(out[0], out[1], out[2], out[3]);
+    }
+
+private:
+    SCompressedChannel<SCompressedVectorGroup> translations;
+    SCompressedChannel<SCompressedRotationGroup> rotations;
+    SCompressedChannel<SCompressedVectorGroup> scales;
+    float duration{ 0.f };
+};
@@ -0,0 +1,623 @@
+#include "KeyReduction.h"
+
+#include "ClipSampler.h"
+#include "../Jobs/JobSystem.h"
+#include "../Profile/ProfileScope.h"
+#include "../Quaternion/QuaternionKernels.h"
+#include "../Simd/Simd.h"
+#include "../Skeleton/Skeleton.h"
+#include "../Vector/VectorInterpolation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+#include <xmmintrin.h>
+
+namespace
+{
+    // batches of key times sampled by one job
+    constexpr size_t ReductionTimeBatch{ 32 };
+
+    // 'function(begin, end)' over [0, count), on 'jobs' when there are any
+    template <typename TFunction>
+    void ReductionFor(SJobSystem* jobs, size_t count, size_t batch_size, const TFunction& function)
+    {
+        if (jobs != nullptr)
+        {
+            jobs->ParallelFor(count, batch_size, function);
+        }
+        else if (count > 0)
+        {
+            function(0, count);
+        }
+    }
+
+    // a model transform, the one joint of an 'SPose'
+    struct SJointTransform
+    {
+        SVector translation;
+        SQuaternion rotation{ SQuaternion::Identity };
+        SVector scale;
+    };
+
+    // the rule of 'SSkeleton::LocalToModel' for one joint
+    SJointTransform ComposeJoint(const SJointTransform& parent, const SJointTransform& local)
+    {
+        return { parent.rotation.Rotate(parent.scale * local.translation) + parent.translation, parent.rotation * local.rotation,
+                 parent.scale * local.scale };
+    }
+
+    void SetJoint(SPose& pose, size_t joint, const SJointTransform& transform)
+    {
+        pose.GetTranslations()[joint] = transform.translation;
+        pose.GetRotations()[joint] = transform.rotation;
+        pose.GetScales()[joint] = transform.scale;
+    }
+
+    /*            Error kernel            */
+    // four vectors or rotations, a register per component and a key time per lane
+    using SVectors4 = QuaternionKernels::SVectorPack<__m128>;
+    using SRotations4 = QuaternionKernels::SQuaternionPack<__m128>;
+
+    // 'count' of up to four values from 'values', the last one repeated into the lanes past it
+    template <typename TValue>
+    void LoadLanes4(const TValue* values, size_t count, __m128& r0, __m128& r1, __m128& r2, __m128& r3)
+    {
+        r0 = values[0].GetStorage();
+        r1 = values[std::min<size_t>(1, count - 1)].GetStorage();
+        r2 = values[std::min<size_t>(2, count - 1)].GetStorage();
+        r3 = values[std::min<size_t>(3, count - 1)].GetStorage();
+        Simd::Transpose4(r0, r1, r2, r3);
+    }
+
+    // lanes 3, 2 and 1 of a vector are X, Y and Z, lane 0 of a quaternion is W
+    SVectors4 LoadVectors4(const SVector* values, size_t count)
+    {
+        __m128 u, z, y, x;
+        LoadLanes4(values, count, u, z, y, x);
+        return { x, y, z };
+    }
+
+    SRotations4 LoadRotations4(const SQuaternion* values, size_t count)
+    {
+        __m128 w, z, y, x;
+        LoadLanes4(values, count, w, z, y, x);
+        return { { x, y, z }, w };
+    }
+
+    __m128 SqrLength4(const SVectors4& a, const SVectors4& b)
+    {
+        const SVectors4 difference = a - b;
+        return difference.Dot(difference);
+    }
+
+    // model transforms of four key times
+    struct STransforms4
+    {
+        SVectors4 translations;
+        SRotations4 rotations;
+        SVectors4 scales;
+    };
+
+    // the rule of 'SSkeleton::LocalToModel'
+    STransforms4 Compose4(const STransforms4& parent, const STransforms4& local)
+    {
+        return { parent.rotations.Rotate(parent.scales * local.translations) + parent.translations, parent.rotations * local.rotations,
+                 parent.scales * local.scales };
+    }
+
+    // ends of the axes of a joint at 'shell' from its origin, scaled by its scale
+    void AxisEnds4(const STransforms4& transform, float shell, SVectors4 (&ends)[3])
+    {
+        SVectors4 axes[3];
+        transform.rotations.GetAxes(axes);
+        const SVectors4 lengths = transform.scales * _mm_set1_ps(shell);
+        ends[0] = transform.translations + axes[0] * lengths.x;
+        ends[1] = transform.translations + axes[1] * lengths.y;
+        ends[2] = transform.translations + axes[2] * lengths.z;
+    }
+
+    // a transform per key time of the clip, the arrays a joint is measured with
+    struct SJointFrames
+    {
+        // reduced model transforms of the parent, identities for a root
+        std::vector<SVector> parent_translations;
+        std::vector<SQuaternion> parent_rotations;
+        std::vector<SVector> parent_scales;
+        // model transforms of the source clip
+        std::vector<SVector> source_translations;
+        std::vector<SQuaternion> source_rotations;
+        std::vector<SVector> source_scales;
+        float shell{ 0.f };
+    };
+
+    // errors of a joint at four key times: squared distances at the joint and the largest at its points, the squared sine of half the angle
+    struct SErrors4
+    {
+        __m128 origin_squared;
+        __m128 points_squared;
+        __m128 sine_squared;
+    };
+
+    /*
+    * Errors of a joint at key times [first, first + count), up to four, with local transforms from the three arrays: a key time per
+    * lane, so distances of the joint and the ends of its axes are a few products per point for all of them. Lanes past 'count'
+    * repeat the last key time. The angle comes from the axis of the rotation between the two rotations, as long as the sine
+    * of half the angle, without the cancellation of '1 - cos^2' near zero.
+    */
+    SErrors4 MeasureJoint4(const SJointFrames& frames, size_t first, const SVector* translations, const SQuaternion* rotations,
+                           const SVector* scales, size_t count)
+    {
+        const STransforms4 parent{ LoadVectors4(frames.parent_translations.data() + first, count),
+                                   LoadRotations4(frames.parent_rotations.data() + first, count),
+                                   LoadVectors4(frames.parent_scales.data() + first, count) };
+        const STransforms4 local{ LoadVectors4(translations, count), LoadRotations4(rotations, count), LoadVectors4(scales, count) };
+        const STransforms4 source{ LoadVectors4(frames.source_translations.data() + first, count),
+                                   LoadRotations4(frames.source_rotations.data() + first, count),
+                                   LoadVectors4(frames.source_scales.data() + first, count) };
+        const STransforms4 model = Compose4(parent, local);
+
+        SVectors4 model_ends[3], source_ends[3];
+        AxisEnds4(model, frames.shell, model_ends);
+        AxisEnds4(source, frames.shell, source_ends);
+        const __m128 origin_squared = SqrLength4(model.translations, source.translations);
+        __m128 points_squared = origin_squared;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            points_squared = _mm_max_ps(points_squared, SqrLength4(model_ends[axis], source_ends[axis]));
+        }
+
+        // vector part of conjugate(source) * model
+        const SRotations4& a = source.rotations;
+        const SRotations4& b = model.rotations;
+        const SVectors4 axis = b.axis * a.w - a.axis * b.w - a.axis.Cross(b.axis);
+        const __m128 sine_squared = axis.Dot(axis);
+        return { origin_squared, points_squared, sine_squared };
+    }
+
+    void InterpolateKeys(EQuaternionInterpolation, const SVector* from, const SVector* to, const float* alphas, SVector* out, size_t count)
+    {
+        SVectorInterpolation::Lerp(from, to, alphas, out, count);
+    }
+
+    void InterpolateKeys(EQuaternionInterpolation method, const SQuaternion* from, const SQuaternion* to, const float* alphas, SQuaternion* out, size_t count)
+    {
+        SQuaternionInterpolation::Interpolate(method, from, to, alphas, out, count);
+    }
+
+    // a track at every key time of the clip while one of its intervals is tested
+    template <typename TValue>
+    struct STrackCandidates
+    {
+        std::vector<TValue> from;
+        std::vector<TValue> to;
+        std::vector<float> alphas;
+        std::vector<TValue> values;
+        // normalized errors of an interval, 1 at a tolerance; padded to whole registers with zeros
+        std::vector<float> errors;
+        // largest error a candidate may have at every key time: 1, or the error the joint has already with its ancestors reduced,
+        // which no key of this track can take back; padded for a register read at any key time
+        std::vector<float> limits;
+    };
+
+    // state of the reduction of one clip, shared by the jobs of its joints
+    struct SClipReduction
+    {
+        SClipReduction(const SClip& clip, const SSkeleton& skeleton, const SKeyReductionSettings& settings)
+            : clip(clip), skeleton(skeleton), settings(settings)
+        {
+        }
+
+        const SClip& clip;
+        const SSkeleton& skeleton;
+        const SKeyReductionSettings& settings;
+
+        // key times of every track, sorted, once each
+        std::vector<float> times;
+        std::vector<SPose> source_locals;
+        std::vector<SPose> source_models;
+        // model transforms of the reduced clip, filled joint by joint, parents first
+        std::vector<SPose> reduced_models;
+        std::vector<float> shells;
+
+        // kept keys of every track of every joint
+        std::vector<std::vector<uint32_t>> kept_translations;
+        std::vector<std::vector<uint32_t>> kept_rotations;
+        std::vector<std::vector<uint32_t>> kept_scales;
+
+        // largest errors of every joint at the joint, squared distance and squared sine of half the angle
+        std::vector<float> distances_squared;
+        std::vector<float> sines_squared;
+
+        // inverse squared tolerances, that scale errors to 1 at a tolerance
+        float position_scale{ 0.f };
+        float rotation_scale{ 0.f };
+    };
+
+    /*
+    * Simplifies one track of 'joint' into the indices of its 'kept' keys. 'measure(first, track, count, errors)' writes the normalized
+    * errors of the joint at 'count' key times from 'first' with this track at 'track' and its other tracks as they are, padded to
+    * whole registers. 'values' holds the track at every key time, accepted intervals write theirs.
+    */
+    template <typename TValue, typename TMeasure>
+    void ReduceTrack(const SClipReduction& reduction, const SClipChannel<TValue>& channel, size_t joint, std::vector<TValue>& values,
+                     STrackCandidates<TValue>& candidates, std::vector<uint32_t>& kept, const TMeasure& measure)
+    {
+        const SClipTrack& track = channel.tracks[joint];
+        kept.clear();
+        if (track.count < 2)
+        {
+            kept.assign(track.count, 0);
+            return;
+        }
+
+        const std::vector<float>& times = reduction.times;
+        const float* key_times = channel.times.data() + track.first;
+        const TValue* keys = channel.values.data() + track.first;
+
+        // key times of the clip in [begin, end) with the track interpolated between keys 'first' and 'last' as a sampler does,
+        // the first key held when they are the same; true when every time is within tolerance, 'worst' is then left alone
+        const auto test = [&](size_t begin, size_t end, uint32_t first, uint32_t last, size_t& worst)
+        {
+            const size_t count = end - begin;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float alpha = first == last ? 0.f : (times[begin + i] - key_times[first]) / (key_times[last] - key_times[first]);
+                candidates.alphas[i] = std::min(std::max(alpha, 0.f), 1.f);
+                candidates.from[i] = keys[first];
+                candidates.to[i] = keys[last];
+            }
+            InterpolateKeys(reduction.settings.interpolation, candidates.from.data(), candidates.to.data(), candidates.alphas.data(),
+                            candidates.values.data(), count);
+
+            measure(begin, candidates.values.data(), count, candidates.errors.data());
+            for (size_t i = count; i % 4 != 0; ++i)
+            {
+                candidates.errors[i] = 0.f;
+            }
+
+            // four errors per comparison, the worst one is looked for only in a failed interval
+            const float* limits = candidates.limits.data() + begin;
+            __m128 over = _mm_setzero_ps();
+            for (size_t i = 0; i < count; i += 4)
+            {
+                over = _mm_or_ps(over, _mm_cmpgt_ps(_mm_loadu_ps(candidates.errors.data() + i), _mm_loadu_ps(limits + i)));
+            }
+            if (_mm_movemask_ps(over) == 0)
+            {
+                std::copy(candidates.values.begin(), candidates.values.begin() + count, values.begin() + begin);
+                return true;
+            }
+            worst = 0;
+            for (size_t i = 1; i < count; ++i)
+            {
+                worst = candidates.errors[i] - limits[i] > candidates.errors[worst] - limits[worst] ? i : worst;
+            }
+            return false;
+        };
+
+        measure(0, values.data(), times.size(), candidates.limits.data());
+        for (size_t t = 0; t < times.size(); t += 4)
+        {
+            _mm_storeu_ps(candidates.limits.data() + t, _mm_max_ps(_mm_loadu_ps(candidates.limits.data() + t), _mm_set1_ps(1.f)));
+        }
+
+        size_t worst{ 0 };
+        if (test(0, times.size(), 0, 0, worst))
+        {
+            kept.push_back(0);
+            return;
+        }
+
+        std::vector<size_t> key_indices(track.count);
+        for (uint32_t key = 0; key < track.count; ++key)
+        {
+            key_indices[key] = static_cast<size_t>(std::lower_bound(times.begin(), times.end(), key_times[key]) - times.begin());
+        }
+
+        std::vector<uint8_t> is_kept(track.count, 0);
+        is_kept.front() = 1;
+        is_kept.back() = 1;
+        std::vector<std::pair<uint32_t, uint32_t>> intervals{ { 0, track.count - 1 } };
+        while (!intervals.empty())
+        {
+            const std::pair<uint32_t, uint32_t> interval = intervals.back();
+            intervals.pop_back();
+            // neighbouring keys have nothing to drop between them
+            if (interval.second - interval.first < 2)
+            {
+                continue;
+            }
+
+            const size_t begin = key_indices[interval.first] + 1;
+            if (test(begin, key_indices[interval.second], interval.first, interval.second, worst))
+            {
+                continue;
+            }
+
+            // the key at the worst time, or the last key before it
+            const size_t worst_index = begin + worst;
+            const uint32_t after = static_cast<uint32_t>(std::upper_bound(key_indices.begin() + interval.first, key_indices.begin() + interval.second, worst_index) - key_indices.begin());
+            const uint32_t split = std::min(std::max(after - 1, interval.first + 1), interval.second - 1);
+            is_kept[split] = 1;
+            intervals.push_back({ interval.first, split });
+            intervals.push_back({ split, interval.second });
+        }
+
+        for (uint32_t key = 0; key < track.count; ++key)
+        {
+            if (is_kept[key] != 0)
+            {
+                kept.push_back(key);
+            }
+        }
+    }
+
+    // the tracks of a joint whose ancestors are reduced, then its reduced model transforms at every key time
+    void ReduceJoint(SClipReduction& reduction, size_t joint)
+    {
+        const size_t time_count = reduction.times.size();
+        const int16_t parent = reduction.skeleton.GetParent(joint);
+
+        SJointFrames frames;
+        frames.shell = reduction.shells[joint];
+        frames.parent_translations.assign(time_count, SVector::ZeroVector);
+        frames.parent_rotations.assign(time_count, SQuaternion::Identity);
+        frames.parent_scales.assign(time_count, SVector(1.f));
+        frames.source_translations.resize(time_count);
+        frames.source_rotations.assign(time_count, SQuaternion::Identity);
+        frames.source_scales.resize(time_count);
+        std::vector<SVector> translations(time_count), scales(time_count);
+        std::vector<SQuaternion> rotations(time_count, SQuaternion::Identity);
+        for (size_t t = 0; t < time_count; ++t)
+        {
+            if (parent != SSkeleton::NoParent)
+            {
+                frames.parent_translations[t] = reduction.reduced_models[t].GetTranslations()[parent];
+                frames.parent_rotations[t] = reduction.reduced_models[t].GetRotations()[parent];
+                frames.parent_scales[t] = reduction.reduced_models[t].GetScales()[parent];
+            }
+            frames.source_translations[t] = reduction.source_models[t].GetTranslations()[joint];
+            frames.source_rotations[t] = reduction.source_models[t].GetRotations()[joint];
+            frames.source_scales[t] = reduction.source_models[t].GetScales()[joint];
+            translations[t] = reduction.source_locals[t].GetTranslations()[joint];
+            rotations[t] = reduction.source_locals[t].GetRotations()[joint];
+            scales[t] = reduction.source_locals[t].GetScales()[joint];
+        }
+
+        // normalized errors: the largest distance over the position tolerance or the angle over the rotation tolerance, squared
+        const __m128 position_scale = _mm_set1_ps(reduction.position_scale);
+        const __m128 rotation_scale = _mm_set1_ps(reduction.rotation_scale);
+        const auto measure = [&](size_t first, const SVector* track_translations, const SQuaternion* track_rotations, const SVector* track_scales,
+                                 size_t count, float* errors)
+        {
+            for (size_t i = 0; i < count; i += 4)
+            {
+                const SErrors4 joint_errors = MeasureJoint4(frames, first + i, track_translations + i, track_rotations + i, track_scales + i,
+                                                            std::min<size_t>(count - i, 4));
+                _mm_storeu_ps(errors + i, _mm_max_ps(_mm_mul_ps(joint_errors.points_squared, position_scale),
+                                                     _mm_mul_ps(joint_errors.sine_squared, rotation_scale)));
+            }
+        };
+
+        const size_t padded_count = (time_count + 3) / 4 * 4;
+        const auto resize = [&](auto& candidates, const auto& value)
+        {
+            candidates.from.assign(time_count, value);
+            candidates.to.assign(time_count, value);
+            candidates.alphas.assign(time_count, 0.f);
+            candidates.values.assign(time_count, value);
+            candidates.errors.assign(padded_count, 0.f);
+            candidates.limits.assign(padded_count + 4, 1.f);
+        };
+        STrackCandidates<SVector> vector_candidates;
+        STrackCandidates<SQuaternion> rotation_candidates;
+        resize(vector_candidates, SVector::ZeroVector);
+        resize(rotation_candidates, SQuaternion::Identity);
+
+        // rotations move the most, they go first and the other tracks are measured with them reduced
+        ReduceTrack(reduction, reduction.clip.GetRotations(), joint, rotations, rotation_candidates, reduction.kept_rotations[joint],
+                    [&](size_t first, const SQuaternion* track, size_t count, float* errors)
+                    { measure(first, translations.data() + first, track, scales.data() + first, count, errors); });
+        ReduceTrack(reduction, reduction.clip.GetTranslations(), joint, translations, vector_candidates, reduction.kept_translations[joint],
+                    [&](size_t first, const SVector* track, size_t count, float* errors)
+                    { measure(first, track, rotations.data() + first, scales.data() + first, count, errors); });
+        ReduceTrack(reduction, reduction.clip.GetScales(), joint, scales, vector_candidates, reduction.kept_scales[joint],
+                    [&](size_t first, const SVector* track, size_t count, float* errors)
+                    { measure(first, translations.data() + first, rotations.data() + first, track, count, errors); });
+
+        __m128 origin_squared = _mm_setzero_ps();
+        __m128 sine_squared = _mm_setzero_ps();
+        for (size_t t = 0; t < time_count; t += 4)
+        {
+            const SErrors4 joint_errors = MeasureJoint4(frames, t, translations.data() + t, rotations.data() + t, scales.data() + t,
+                                                        std::min<size_t>(time_count - t, 4));
+            origin_squared = _mm_max_ps(origin_squared, joint_errors.origin_squared);
+            sine_squared = _mm_max_ps(sine_squared, joint_errors.sine_squared);
+        }
+        alignas(16) float origin_lanes[4], sine_lanes[4];
+        _mm_store_ps(origin_lanes, origin_squared);
+        _mm_store_ps(sine_lanes, sine_squared);
+        reduction.distances_squared[joint] = *std::max_element(origin_lanes, origin_lanes + 4);
+        reduction.sines_squared[joint] = *std::max_element(sine_lanes, sine_lanes + 4);
+
+        for (size_t t = 0; t < time_count; ++t)
+        {
+            const SJointTransform parent_model{ frames.parent_translations[t], frames.parent_rotations[t], frames.parent_scales[t] };
+            SetJoint(reduction.reduced_models[t], joint, ComposeJoint(parent_model, { translations[t], rotations[t], scales[t] }));
+        }
+    }
+
+    template <typename TValue>
+    void AppendTimes(const SClipChannel<TValue>& channel, std::vector<float>& times)
+    {
+        times.insert(times.end(), channel.times.begin(), channel.times.end());
+    }
+
+    // the kept keys of every track of a channel, through 'set(joint, times, values, count)'
+    template <typename TValue, typename TSet>
+    void CopyKeptKeys(const SClipChannel<TValue>& channel, const std::vector<std::vector<uint32_t>>& kept, const TSet& set)
+    {
+        std::vector<float> times;
+        std::vector<TValue> values;
+        for (size_t joint = 0; joint < channel.tracks.size(); ++joint)
+        {
+            const SClipTrack& track = channel.tracks[joint];
+            times.clear();
+            values.clear();
+            for (const uint32_t key : kept[joint])
+            {
+                times.push_back(channel.times[track.first + key]);
+                values.push_back(channel.values[track.first + key]);
+            }
+            if (!times.empty())
+            {
+                set(joint, times.data(), values.data(), times.size());
+            }
+        }
+    }
+}
+
+SClip SKeyReducer::Reduce(const SClip& clip, const SSkeleton& skeleton, const SKeyReductionSettings& settings, SKeyReductionReport* report, SJobSystem* jobs)
+{
+    ANIMATION_PROFILE_SCOPE("SKeyReducer::Reduce");
+    assert(clip.GetJointCount() == skeleton.GetJointCount());
+    assert(settings.position_tolerance > 0.f && settings.rotation_tolerance > 0.f);
+    const size_t joint_count = clip.GetJointCount();
+
+    SClipReduction reduction(clip, skeleton, settings);
+    AppendTimes(clip.GetTranslations(), reduction.times);
+    AppendTimes(clip.GetRotations(), reduction.times);
+    AppendTimes(clip.GetScales(), reduction.times);
+    std::sort(reduction.times.begin(), reduction.times.end());
+    reduction.times.erase(std::unique(reduction.times.begin(), reduction.times.end()), reduction.times.end());
+    const size_t time_count = reduction.times.size();
+
+    const float half_rotation = std::sin(0.5f * std::min(settings.rotation_tolerance, 3.14159265f));
+    reduction.position_scale = 1.f / (settings.position_tolerance * settings.position_tolerance);
+    reduction.rotation_scale = 1.f / (half_rotation * half_rotation);
+
+    /*            Source            */
+    reduction.source_locals.assign(time_count, SPose(joint_count));
+    reduction.source_models.assign(time_count, SPose(joint_count));
+    reduction.reduced_models.assign(time_count, SPose(joint_count));
+    ReductionFor(jobs, time_count, ReductionTimeBatch, [&](size_t begin, size_t end)
+    {
+        SClipSampler sampler;
+        sampler.interpolation = settings.interpolation;
+        SClipCursor cursor;
+        for (size_t t = begin; t < end; ++t)
+        {
+            sampler.Sample(clip, reduction.times[t], cursor, reduction.source_locals[t]);
+            skeleton.LocalToModel(reduction.source_locals[t], reduction.source_models[t]);
+        }
+    });
+
+    // the shell of a joint covers the shells of its descendants: the longest chain of bones below it and the smallest shell, children first
+    reduction.shells.assign(joint_count, settings.shell_distance);
+    std::vector<float> reach(joint_count);
+    for (const SPose& model : reduction.source_models)
+    {
+        std::fill(reach.begin(), reach.end(), settings.shell_distance);
+        for (size_t joint = joint_count; joint-- > 0;)
+        {
+            const int16_t parent = skeleton.GetParent(joint);
+            if (parent != SSkeleton::NoParent)
+            {
+                const float bone = (model.GetTranslations()[joint] - model.GetTranslations()[parent]).Length();
+                reach[parent] = std::max(reach[parent], reach[joint] + bone);
+            }
+            reduction.shells[joint] = std::max(reduction.shells[joint], reach[joint]);
+        }
+    }
+
+    /*            Joints            */
+    // joints by depth, a depth depends only on the ones above it
+    std::vector<size_t> depths(joint_count, 0);
+    size_t depth_count = 0;
+    for (size_t joint = 0; joint < joint_count; ++joint)
+    {
+        const int16_t parent = skeleton.GetParent(joint);
+        depths[joint] = parent == SSkeleton::NoParent ? 0 : depths[parent] + 1;
+        depth_count = std::max(depth_count, depths[joint] + 1);
+    }
+    std::vector<std::vector<size_t>> levels(depth_count);
+    for (size_t joint = 0; joint < joint_count; ++joint)
+    {
+        levels[depths[joint]].push_back(joint);
+    }
+
+    reduction.kept_translations.resize(joint_count);
+    reduction.kept_rotations.resize(joint_count);
+    reduction.kept_scales.resize(joint_count);
+    reduction.distances_squared.assign(joint_count, 0.f);
+    reduction.sines_squared.assign(joint_count, 0.f);
+    for (const std::vector<size_t>& level : levels)
+    {
+        ReductionFor(jobs, level.size(), 1, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                ReduceJoint(reduction, level[i]);
+            }
+        });
+    }
+
+    /*            Clip            */
+    SClip result(joint_count, clip.GetDuration());
+    CopyKeptKeys(clip.GetTranslations(), reduction.kept_translations,
+                 [&](size_t joint, const float* times, const SVector* values, size_t count) { result.SetTranslations(joint, times, values, count); });
+    CopyKeptKeys(clip.GetRotations(), reduction.kept_rotations,
+                 [&](size_t joint, const float* times, const SQuaternion* values, size_t count) { result.SetRotations(joint, times, values, count); });
+    CopyKeptKeys(clip.GetScales(), reduction.kept_scales,
+                 [&](size_t joint, const float* times, const SVector* values, size_t count) { result.SetScales(joint, times, values, count); });
+
+    if (report != nullptr)
+    {
+        const float distance_squared = joint_count > 0 ? *std::max_element(reduction.distances_squared.begin(), reduction.distances_squared.end()) : 0.f;
+        const float sine_squared = joint_count > 0 ? *std::max_element(reduction.sines_squared.begin(), reduction.sines_squared.end()) : 0.f;
+        report->source_keys = clip.GetKeyCount();
+        report->reduced_keys = result.GetKeyCount();
+        report->max_position_error = std::sqrt(distance_squared);
+        report->max_rotation_error = 2.f * std::asin(std::min(std::sqrt(sine_squared), 1.f));
+    }
+    return result;
+}
+
+void SKeyReducer::Reduce(const SClip* clips, SClip* out, size_t count, const SSkeleton& skeleton, const SKeyReductionSettings& settings,
+                         SKeyReductionReport* report, SJobSystem* jobs)
+{
+    std::vector<SKeyReductionReport> reports(count);
+    ReductionFor(jobs, count, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            out[i] = Reduce(clips[i], skeleton, settings, &reports[i], jobs);
+        }
+    });
+
+    if (report != nullptr)
+    {
+        *report = {};
+        for (const SKeyReductionReport& clip_report : reports)
+        {
+            report->source_keys += clip_report.source_keys;
+            report->reduced_keys += clip_report.reduced_keys;
+            report->max_position_error = std::max(report->max_position_error, clip_report.max_position_error);
+            report->max_rotation_error = std::max(report->max_rotation_error, clip_report.max_rotation_error);
+        }
+    }
+}
+
+/*            Operator <<            */
+std::ostream& operator<<(std::ostream& os, const SKeyReductionReport& report)
+{
+    os << report.source_keys << " -> " << report.reduced_keys << " keys (" << std::fixed << std::setprecision(2) << report.Ratio() << "x), "
+       << std::scientific << std::setprecision(2) << "max error: position " << report.max_position_error << ", rotation "
+       << report.max_rotation_error << " rad";
+    os.unsetf(std::ios::floatfield);
+    return os;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+
+#include "Clip.h"
+#include "../Quaternion/QuaternionInterpolation.h"
+
+struct SJobSystem;
+struct SSkeleton;
+
+// largest model space error of a reduced clip against its source
+struct SKeyReductionSettings
+{
+    /*
+    * Distance in units of the clip between a joint of the two clips in model space. It is measured at the joint and at the ends
+    * of its axes scaled to its shell distance, so a rotation error counts with the lever of the joints it moves.
+    */
+    float position_tolerance{ 1e-3f };
+    // angle in radians between the model space rotations of a joint
+    float rotation_tolerance{ 1e-2f };
+    // shell distance of a leaf; the shell of a joint with descendants reaches the shells of all of them over the clip
+    float shell_distance{ 0.1f };
+    // method of the sampler that plays the reduced clip
+    EQuaternionInterpolation interpolation{ EQuaternionInterpolation::Nlerp };
+};
+
+// keys and error of reduced clips, errors are measured in model space at the joints, at every key time of the source
+struct SKeyReductionReport
+{
+    size_t source_keys{ 0 };
+    size_t reduced_keys{ 0 };
+    float max_position_error{ 0.f };
+    float max_rotation_error{ 0.f };
+
+    // source keys over reduced keys
+    float Ratio() const { return reduced_keys > 0 ? static_cast<float>(source_keys) / static_cast<float>(reduced_keys) : 0.f; }
+};
+
+std::ostream& operator<<(std::ostream& os, const SKeyReductionReport& report);
+
+/*
+* SKeyReducer drops the keys of a clip that interpolation between the keys around them reproduces within the tolerances of
+* 'SKeyReductionSettings', in model space: joints are reduced parents first, and every candidate is measured on the model
+* transforms of a joint composed with the already reduced transforms of its ancestors, so the error a parent leaves is part of
+* the budget of its children. A track is simplified as a polyline: the interval between two kept keys is accepted when every
+* key time of the clip inside it is within tolerance, otherwise it is split at its worst key, keeping the first and last key;
+* a track within tolerance of its first key keeps only that key. Candidates interpolate as 'SClipSampler' does, with the
+* batch kernels of 'SVectorInterpolation' and 'SQuaternionInterpolation', and are measured and compared four key times per register.
+* Joints of one depth in the hierarchy are independent and are reduced in parallel, clips of a batch as well. It runs offline
+* or at load time; without a job system everything runs on the calling thread, with the same result.
+*/
+struct SKeyReducer
+{
+    // 'clip' has a track per joint of 'skeleton'
+    static SClip Reduce(const SClip& clip, const SSkeleton& skeleton, const SKeyReductionSettings& settings = {},
+                        SKeyReductionReport* report = nullptr, SJobSystem* jobs = nullptr);
+
+    // 'clips[i]' into 'out[i]', the report sums keys and keeps the largest errors of all clips
+    static void Reduce(const SClip* clips, SClip* out, size_t count, const SSkeleton& skeleton, const SKeyReductionSettings& settings = {},
+                       SKeyReductionReport* report = nullptr, SJobSystem* jobs = nullptr);
+};
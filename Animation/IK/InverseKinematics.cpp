@@ -0,0 +1,337 @@
+#include "InverseKinematics.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "../Profile/ProfileScope.h"
+#include "../Quaternion/QuaternionKernels.h"
+#include "../Simd/Simd.h"
+
+namespace
+{
+    using IKPack = Simd::FloatPack;
+    using IKMask = Simd::SPackTraits<IKPack>::Mask;
+    constexpr size_t IKPackWidth{ Simd::SPackTraits<IKPack>::Width };
+
+    // lengths below this are treated as zero: directions of coincident points, rotations between them
+    constexpr float IKMinLength{ 1e-6f };
+    constexpr float IKMinSqrLength{ IKMinLength * IKMinLength };
+
+    // a vector of every chain of a pack, one component of all of them per register, and unit quaternions of every chain of a pack
+    using SIKVectorPack = QuaternionKernels::SVectorPack<IKPack>;
+    using SIKRotationPack = QuaternionKernels::SQuaternionPack<IKPack>;
+
+    SIKVectorPack LoadPack(const SVectorSoA& vectors, size_t chain)
+    {
+        return {Simd::Load<IKPack>(vectors.GetX() + chain), Simd::Load<IKPack>(vectors.GetY() + chain), Simd::Load<IKPack>(vectors.GetZ() + chain)};
+    }
+
+    void StorePack(const SIKVectorPack& pack, SVectorSoA& vectors, size_t chain)
+    {
+        Simd::Store(vectors.GetX() + chain, pack.x);
+        Simd::Store(vectors.GetY() + chain, pack.y);
+        Simd::Store(vectors.GetZ() + chain, pack.z);
+    }
+
+    // a vector perpendicular to 'v', zero only for a zero vector
+    SIKVectorPack Perpendicular(const SIKVectorPack& v)
+    {
+        const IKPack zero = Simd::Zero<IKPack>();
+        const IKMask x_larger = Simd::CmpGt(Simd::Abs(v.x), Simd::Abs(v.z));
+        return SIKVectorPack::Select(x_larger, {Simd::Sub(zero, v.y), v.x, zero}, {zero, Simd::Sub(zero, v.z), v.y});
+    }
+
+    /*
+    * The shortest rotation from direction 'from' to direction 'to': (|from| |to| + from . to, from x to) normalized.
+    * Opposite directions give half a turn about an axis perpendicular to 'from', a zero direction gives the identity.
+    */
+    SIKRotationPack RotationFromTo(const SIKVectorPack& from, const SIKVectorPack& to)
+    {
+        const IKPack zero = Simd::Zero<IKPack>();
+        const IKPack norms = Simd::Sqrt(Simd::Mul(from.Dot(from), to.Dot(to)));
+        SIKRotationPack result{from.Cross(to), Simd::Add(norms, from.Dot(to))};
+
+        const IKMask opposite = Simd::CmpLt(result.w, Simd::Mul(norms, Simd::Set<IKPack>(1e-6f)));
+        result.axis = SIKVectorPack::Select(opposite, Perpendicular(from), result.axis);
+        result.w = Simd::Select(opposite, zero, result.w);
+
+        const IKMask degenerate = Simd::CmpLt(norms, Simd::Set<IKPack>(IKMinSqrLength));
+        result.axis = SIKVectorPack::Select(degenerate, {zero, zero, zero}, result.axis);
+        result.w = Simd::Select(degenerate, Simd::Set<IKPack>(1.f), result.w);
+
+        const IKPack magnitude = Simd::Sqrt(Simd::Add(Simd::Mul(result.w, result.w), result.axis.Dot(result.axis)));
+        result.axis = result.axis * Simd::Div(Simd::Set<IKPack>(1.f), magnitude);
+        result.w = Simd::Div(result.w, magnitude);
+        return result;
+    }
+
+    // 'to' scaled to 'length', a zero 'to' stays zero
+    SIKVectorPack ScaledTo(const SIKVectorPack& to, const IKPack& length)
+    {
+        const IKPack magnitude = Simd::Max(to.Magnitude(), Simd::Set<IKPack>(IKMinLength));
+        return to * Simd::Div(length, magnitude);
+    }
+
+    // errors and iteration counts of a pack of chains at 'chain'
+    void StoreResults(float* errors, uint32_t* iterations, size_t chain, const IKPack& error, const IKPack& iteration_count)
+    {
+        Simd::StoreUnaligned(errors + chain, error);
+
+        alignas(SVectorSoA::Alignment) float counts[IKPackWidth];
+        Simd::Store(counts, iteration_count);
+        for (size_t lane = 0; lane < IKPackWidth; ++lane)
+        {
+            iterations[chain + lane] = static_cast<uint32_t>(counts[lane]);
+        }
+    }
+
+    // positions of every joint of a pack of chains
+    void LoadJoints(const std::vector<SVectorSoA>& joints, size_t chain, std::vector<SIKVectorPack>& positions)
+    {
+        for (size_t joint = 0; joint < joints.size(); ++joint)
+        {
+            positions[joint] = LoadPack(joints[joint], chain);
+        }
+    }
+
+    void StoreJoints(const std::vector<SIKVectorPack>& positions, size_t chain, std::vector<SVectorSoA>& joints)
+    {
+        for (size_t joint = 0; joint < joints.size(); ++joint)
+        {
+            StorePack(positions[joint], joints[joint], chain);
+        }
+    }
+}
+
+SIKChains::SIKChains(size_t chain_count, size_t joint_count)
+{
+    Resize(chain_count, joint_count);
+}
+
+void SIKChains::Resize(size_t chain_count, size_t joint_count)
+{
+    joints.resize(joint_count);
+    for (SVectorSoA& positions : joints)
+    {
+        positions.Resize(chain_count);
+    }
+    targets.Resize(chain_count);
+    poles.Resize(chain_count);
+    errors.resize(targets.PaddedSize(), 0.f);
+    iterations.resize(targets.PaddedSize(), 0);
+}
+
+void SIKChains::SetChain(size_t chain, const SVector* positions, const SVector& target)
+{
+    SetChain(chain, positions, target, positions[joints.size() / 2]);
+}
+
+void SIKChains::SetChain(size_t chain, const SVector* positions, const SVector& target, const SVector& pole)
+{
+    for (size_t joint = 0; joint < joints.size(); ++joint)
+    {
+        joints[joint].Set(chain, positions[joint]);
+    }
+    targets.Set(chain, target);
+    poles.Set(chain, pole);
+}
+
+void SIKChains::GetChain(size_t chain, SVector* positions) const
+{
+    for (size_t joint = 0; joint < joints.size(); ++joint)
+    {
+        positions[joint] = joints[joint].Get(chain);
+    }
+}
+
+/*            Two-bone            */
+void SIKSolver::SolveTwoBone(SIKChains& chains) const
+{
+    ANIMATION_PROFILE_SCOPE("SIKSolver::SolveTwoBone");
+    assert(chains.GetJointCount() == 3);
+
+    const IKPack zero = Simd::Zero<IKPack>();
+    const IKPack one = Simd::Set<IKPack>(1.f);
+    const IKPack min_sqr_length = Simd::Set<IKPack>(IKMinSqrLength);
+    const size_t count = chains.targets.PaddedSize();
+    for (size_t chain = 0; chain < count; chain += IKPackWidth)
+    {
+        const SIKVectorPack root = LoadPack(chains.joints[0], chain);
+        const SIKVectorPack mid = LoadPack(chains.joints[1], chain);
+        const SIKVectorPack end = LoadPack(chains.joints[2], chain);
+        const SIKVectorPack target = LoadPack(chains.targets, chain);
+        const SIKVectorPack pole = LoadPack(chains.poles, chain);
+
+        const IKPack upper = (mid - root).Magnitude();
+        const IKPack lower = (end - mid).Magnitude();
+
+        // direction to the target, or to the current end effector for a target on the root
+        const SIKVectorPack to_target = target - root;
+        const IKPack sqr_distance = to_target.Dot(to_target);
+        const SIKVectorPack direction = ScaledTo(SIKVectorPack::Select(Simd::CmpLt(sqr_distance, min_sqr_length), end - root, to_target), one);
+
+        // the distance the chain can span, and the angle at the root by the law of cosines
+        const IKPack reach = Simd::Max(Simd::Min(Simd::Sqrt(sqr_distance), Simd::Add(upper, lower)), Simd::Abs(Simd::Sub(upper, lower)));
+        const IKPack cosine = Simd::Div(Simd::Sub(Simd::Add(Simd::Mul(upper, upper), Simd::Mul(reach, reach)), Simd::Mul(lower, lower)),
+                                        Simd::Max(Simd::Mul(Simd::Add(upper, upper), reach), min_sqr_length));
+        const IKPack clamped_cosine = Simd::Max(Simd::Min(cosine, one), Simd::Sub(zero, one));
+        const IKPack sine = Simd::Sqrt(Simd::Max(Simd::Sub(one, Simd::Mul(clamped_cosine, clamped_cosine)), zero));
+
+        // the bend plane: the pole without its part along the direction, else the current middle joint, else any perpendicular
+        const SIKVectorPack to_pole = pole - root;
+        const SIKVectorPack to_mid = mid - root;
+        SIKVectorPack bend = to_pole - direction * to_pole.Dot(direction);
+        const SIKVectorPack mid_bend = to_mid - direction * to_mid.Dot(direction);
+        bend = SIKVectorPack::Select(Simd::CmpLt(bend.Dot(bend), min_sqr_length), mid_bend, bend);
+        bend = SIKVectorPack::Select(Simd::CmpLt(bend.Dot(bend), min_sqr_length), Perpendicular(direction), bend);
+        bend = ScaledTo(bend, one);
+
+        const SIKVectorPack solved_mid = root + (direction * clamped_cosine + bend * sine) * upper;
+        const SIKVectorPack solved_end = root + direction * reach;
+        StorePack(solved_mid, chains.joints[1], chain);
+        StorePack(solved_end, chains.joints[2], chain);
+        StoreResults(chains.errors.data(), chains.iterations.data(), chain, (solved_end - target).Magnitude(), one);
+    }
+}
+
+/*            CCD            */
+void SIKSolver::SolveCCD(SIKChains& chains) const
+{
+    ANIMATION_PROFILE_SCOPE("SIKSolver::SolveCCD");
+    assert(chains.GetJointCount() >= 2);
+
+    const size_t joint_count = chains.GetJointCount();
+    const size_t end = joint_count - 1;
+    const IKPack tolerance_pack = Simd::Set<IKPack>(tolerance);
+    std::vector<SIKVectorPack> positions(joint_count);
+
+    const size_t count = chains.targets.PaddedSize();
+    for (size_t chain = 0; chain < count; chain += IKPackWidth)
+    {
+        LoadJoints(chains.joints, chain, positions);
+        const SIKVectorPack target = LoadPack(chains.targets, chain);
+
+        IKPack error = (positions[end] - target).Magnitude();
+        IKMask active = Simd::CmpGt(error, tolerance_pack);
+        IKPack iteration_count = Simd::Zero<IKPack>();
+        for (size_t iteration = 0; iteration < max_iterations && Simd::Any(active); ++iteration)
+        {
+            // from the last bone to the root, every joint turns the rest of the chain towards the target
+            for (size_t joint = end; joint-- > 0;)
+            {
+                const SIKVectorPack& pivot = positions[joint];
+                const SIKRotationPack rotation = RotationFromTo(positions[end] - pivot, target - pivot);
+                for (size_t child = joint + 1; child < joint_count; ++child)
+                {
+                    const SIKVectorPack rotated = pivot + rotation.Rotate(positions[child] - pivot);
+                    positions[child] = SIKVectorPack::Select(active, rotated, positions[child]);
+                }
+            }
+
+            iteration_count = Simd::Add(iteration_count, Simd::Select(active, Simd::Set<IKPack>(1.f), Simd::Zero<IKPack>()));
+            error = (positions[end] - target).Magnitude();
+            active = Simd::MaskAnd(active, Simd::CmpGt(error, tolerance_pack));
+        }
+
+        StoreJoints(positions, chain, chains.joints);
+        StoreResults(chains.errors.data(), chains.iterations.data(), chain, error, iteration_count);
+    }
+}
+
+/*            FABRIK            */
+void SIKSolver::SolveFabrik(SIKChains& chains) const
+{
+    ANIMATION_PROFILE_SCOPE("SIKSolver::SolveFabrik");
+    assert(chains.GetJointCount() >= 2);
+
+    const size_t joint_count = chains.GetJointCount();
+    const size_t end = joint_count - 1;
+    const IKPack zero = Simd::Zero<IKPack>();
+    const IKPack one = Simd::Set<IKPack>(1.f);
+    const IKPack tolerance_pack = Simd::Set<IKPack>(tolerance);
+    std::vector<SIKVectorPack> positions(joint_count);
+    std::vector<SIKVectorPack> solved(joint_count);
+    std::vector<IKPack> lengths(end);
+
+    const size_t count = chains.targets.PaddedSize();
+    for (size_t chain = 0; chain < count; chain += IKPackWidth)
+    {
+        LoadJoints(chains.joints, chain, positions);
+        const SIKVectorPack target = LoadPack(chains.targets, chain);
+        const SIKVectorPack root = positions[0];
+
+        IKPack total_length = zero;
+        for (size_t bone = 0; bone < end; ++bone)
+        {
+            lengths[bone] = (positions[bone + 1] - positions[bone]).Magnitude();
+            total_length = Simd::Add(total_length, lengths[bone]);
+        }
+
+        // a target out of reach gives a straight chain pointing at it, in a single pass
+        const SIKVectorPack to_target = target - root;
+        const IKMask reachable = Simd::CmpGt(total_length, to_target.Magnitude());
+        const SIKVectorPack direction = ScaledTo(to_target, one);
+        for (size_t bone = 0; bone < end; ++bone)
+        {
+            const SIKVectorPack straight = positions[bone] + direction * lengths[bone];
+            positions[bone + 1] = SIKVectorPack::Select(reachable, positions[bone + 1], straight);
+        }
+
+        IKPack error = (positions[end] - target).Magnitude();
+        IKMask active = Simd::MaskAnd(reachable, Simd::CmpGt(error, tolerance_pack));
+        IKPack iteration_count = Simd::Select(reachable, zero, one);
+        for (size_t iteration = 0; iteration < max_iterations && Simd::Any(active); ++iteration)
+        {
+            // backward: the end effector onto the target, every joint pulled after its child
+            solved[end] = target;
+            for (size_t joint = end; joint-- > 0;)
+            {
+                solved[joint] = solved[joint + 1] + ScaledTo(positions[joint] - solved[joint + 1], lengths[joint]);
+            }
+
+            // forward: the root back in place, every joint pushed out from its parent
+            solved[0] = root;
+            for (size_t joint = 0; joint < end; ++joint)
+            {
+                solved[joint + 1] = solved[joint] + ScaledTo(solved[joint + 1] - solved[joint], lengths[joint]);
+            }
+
+            for (size_t joint = 1; joint < joint_count; ++joint)
+            {
+                positions[joint] = SIKVectorPack::Select(active, solved[joint], positions[joint]);
+            }
+
+            iteration_count = Simd::Add(iteration_count, Simd::Select(active, one, zero));
+            error = (positions[end] - target).Magnitude();
+            active = Simd::MaskAnd(active, Simd::CmpGt(error, tolerance_pack));
+        }
+
+        StoreJoints(positions, chain, chains.joints);
+        StoreResults(chains.errors.data(), chains.iterations.data(), chain, error, iteration_count);
+    }
+}
+
+/*            Rotations            */
+void SIKSolver::SwingRotations(const SIKChains& before, const SIKChains& after, size_t bone, SQuaternion* out)
+{
+    assert(before.GetChainCount() == after.GetChainCount() && bone + 1 < before.GetJointCount() && bone + 1 < after.GetJointCount());
+
+    alignas(SVectorSoA::Alignment) float x[IKPackWidth], y[IKPackWidth], z[IKPackWidth], w[IKPackWidth];
+    const size_t count = before.GetChainCount();
+    for (size_t chain = 0; chain < count; chain += IKPackWidth)
+    {
+        const SIKVectorPack from = LoadPack(before.joints[bone + 1], chain) - LoadPack(before.joints[bone], chain);
+        const SIKVectorPack to = LoadPack(after.joints[bone + 1], chain) - LoadPack(after.joints[bone], chain);
+        const SIKRotationPack rotation = RotationFromTo(from, to);
+        Simd::Store(x, rotation.axis.x);
+        Simd::Store(y, rotation.axis.y);
+        Simd::Store(z, rotation.axis.z);
+        Simd::Store(w, rotation.w);
+
+        const size_t lanes = std::min(IKPackWidth, count - chain);
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            out[chain + lane] = SQuaternion(x[lane], y[lane], z[lane], w[lane]);
+        }
+    }
+}
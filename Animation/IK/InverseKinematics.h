@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../Quaternion/Quaternion.h"
+#include "../Vector/VectorSoA.h"
+
+/*
+* SIKChains keeps a batch of independent joint chains with the same number of joints, like the legs of every character in a crowd,
+* as Structures of Arrays: the positions of joint 'j' of every chain in one 'SVectorSoA', and the target and the pole of every chain
+* in two more. Joint 0 is the root, the last joint is the end effector the solvers move onto the target.
+* Solvers work on model space positions in place and report the distance left to the target and the iterations they ran per chain.
+*/
+struct SIKChains
+{
+    SIKChains() = default;
+    // 'chain_count' chains of 'joint_count' joints, every position at the origin
+    SIKChains(size_t chain_count, size_t joint_count);
+
+    // keeps the joints of existing chains, new joints and chains are at the origin
+    void Resize(size_t chain_count, size_t joint_count);
+
+    size_t GetChainCount() const { return targets.Size(); }
+    size_t GetJointCount() const { return joints.size(); }
+
+    // positions of joint 'joint' of every chain
+    SVectorSoA& GetJoints(size_t joint) { return joints[joint]; }
+    const SVectorSoA& GetJoints(size_t joint) const { return joints[joint]; }
+
+    SVectorSoA& GetTargets() { return targets; }
+    const SVectorSoA& GetTargets() const { return targets; }
+
+    /*
+    * A point the middle joint of a two-bone chain bends towards, like a point in front of the knee; unused by CCD and FABRIK.
+    * A pole on the line from the root to the target keeps the plane the chain bends in.
+    */
+    SVectorSoA& GetPoles() { return poles; }
+    const SVectorSoA& GetPoles() const { return poles; }
+
+    // joint positions, target and pole of one chain; without a pole the middle joint is the pole, the chain keeps bending the same way
+    void SetChain(size_t chain, const SVector* positions, const SVector& target);
+    void SetChain(size_t chain, const SVector* positions, const SVector& target, const SVector& pole);
+    void GetChain(size_t chain, SVector* positions) const;
+
+    // distance from the end effector to the target and the number of iterations of the last solve, for every chain
+    const float* GetErrors() const { return errors.data(); }
+    const uint32_t* GetIterations() const { return iterations.data(); }
+
+private:
+    friend struct SIKSolver;
+
+    std::vector<SVectorSoA> joints;
+    SVectorSoA targets;
+    SVectorSoA poles;
+    // 'PaddedSize()' of the targets long
+    std::vector<float> errors;
+    std::vector<uint32_t> iterations;
+};
+
+/*
+* SIKSolver moves the chains of an 'SIKChains' batch so their end effectors reach the targets, keeping the root in place and every
+* bone at its length. Chains are solved side by side, one chain per lane of 'Simd::FloatPack', so a batch of 8 chains costs about
+* as much as a single one; a chain that has converged keeps its lane unchanged while its neighbours iterate, so every chain
+* gets the result it gets when solved alone, bit for bit.
+*   SolveTwoBone - analytic, for chains of 3 joints: the law of cosines gives the angle at the root, the pole picks the bend plane;
+*   SolveCCD     - cyclic coordinate descent: from the last bone to the root, rotates the rest of the chain about each joint so
+*                  the end effector points at the target;
+*   SolveFabrik  - forward and backward reaching: moves the end effector onto the target and pulls the chain after it, then moves
+*                  the root back and pushes the chain out again; an unreachable target gives a straight chain pointing at it.
+* Iterative solvers stop for a chain when its end effector is within 'tolerance' of the target or after 'max_iterations'.
+* Solvers don't know about joint limits or twist, 'SwingRotations' turns the moved positions into rotations for a pose.
+*/
+struct SIKSolver
+{
+    constexpr static size_t DefaultMaxIterations{ 16 };
+    constexpr static float DefaultTolerance{ 1e-3f };
+
+    size_t max_iterations{ DefaultMaxIterations };
+    float tolerance{ DefaultTolerance };
+
+    // chains of exactly 3 joints: root, middle and end; a target out of reach gives a straight chain pointing at it
+    void SolveTwoBone(SIKChains& chains) const;
+
+    // chains of 2 or more joints
+    void SolveCCD(SIKChains& chains) const;
+    void SolveFabrik(SIKChains& chains) const;
+
+    /*
+    * The shortest model space rotation of bone 'bone' (from joint 'bone' to joint 'bone + 1') of every chain from its direction in
+    * 'before' to its direction in 'after', a batch with the same chains. Applied on the left of the model space rotation of the joint,
+    * as 'rotation * model_rotation'. A bone that turned around exactly gets a half turn about an axis perpendicular to it.
+    */
+    static void SwingRotations(const SIKChains& before, const SIKChains& after, size_t bone, SQuaternion* out);
+};
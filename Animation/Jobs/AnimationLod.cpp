@@ -0,0 +1,174 @@
+#include "AnimationLod.h"
+
+#include "AnimationUpdate.h"
+#include "../Profile/ProfileScope.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+    // adds 'cost' to the frames of the cycle a character of 'level' and 'phase' evaluates on
+    void AddLodLoad(size_t (&loads)[SAnimationLodScheduler::Cycle], EAnimationLod level, size_t phase, size_t cost)
+    {
+        const size_t interval = SAnimationLodScheduler::GetInterval(level);
+        for (size_t slot = phase; slot < SAnimationLodScheduler::Cycle; slot += interval)
+        {
+            loads[slot] += cost;
+        }
+    }
+
+    // the phase of 'level' with the least load on its frames, the first of equal ones
+    size_t FindLodPhase(const size_t (&loads)[SAnimationLodScheduler::Cycle], EAnimationLod level)
+    {
+        const size_t interval = SAnimationLodScheduler::GetInterval(level);
+        size_t best_phase = 0;
+        size_t best_load = SIZE_MAX;
+        for (size_t phase = 0; phase < interval; ++phase)
+        {
+            size_t load = 0;
+            for (size_t slot = phase; slot < SAnimationLodScheduler::Cycle; slot += interval)
+            {
+                load += loads[slot];
+            }
+            if (load < best_load)
+            {
+                best_phase = phase;
+                best_load = load;
+            }
+        }
+        return best_phase;
+    }
+
+    // joints times layers with weight, a character without layers still takes a pass
+    size_t GetJointSamples(const SAnimatedCharacter& character)
+    {
+        size_t layer_count = 0;
+        for (const SAnimationLayer& layer : character.layers)
+        {
+            layer_count += layer.clip != nullptr && layer.weight > 0.f ? 1 : 0;
+        }
+        return character.skeleton->GetJointCount() * std::max<size_t>(layer_count, 1);
+    }
+}
+
+EAnimationLod SAnimationLodScheduler::GetLevel(float importance, EAnimationLod current, bool is_scheduled) const
+{
+    constexpr size_t level_count = sizeof(settings.thresholds) / sizeof(settings.thresholds[0]);
+    size_t level = 0;
+    while (level < level_count && importance < settings.thresholds[level])
+    {
+        ++level;
+    }
+
+    const size_t current_level = static_cast<size_t>(current);
+    if (is_scheduled && level > current_level)
+    {
+        size_t lowered = 0;
+        while (lowered < level_count && importance < settings.thresholds[lowered] * (1.f - settings.hysteresis))
+        {
+            ++lowered;
+        }
+        level = std::max(lowered, current_level);
+    }
+    return static_cast<EAnimationLod>(level);
+}
+
+void SAnimationLodScheduler::Schedule(SAnimatedCharacter* characters, size_t count)
+{
+    ANIMATION_PROFILE_SCOPE("SAnimationLodScheduler::Schedule");
+    stats = {};
+    costs.resize(count);
+    rephased.clear();
+    due.clear();
+
+    /*            Levels            */
+    size_t loads[Cycle]{};
+    for (size_t i = 0; i < count; ++i)
+    {
+        SAnimationLodState& state = characters[i].lod;
+        costs[i] = GetJointSamples(characters[i]);
+        const EAnimationLod level = GetLevel(characters[i].importance, state.level, state.is_scheduled);
+        if (state.is_scheduled && level == state.level)
+        {
+            AddLodLoad(loads, level, state.phase, costs[i]);
+        }
+        else
+        {
+            state.level = level;
+            rephased.push_back(i);
+        }
+        ++stats.characters[static_cast<size_t>(level)];
+    }
+
+    /*            Phases            */
+    for (const size_t i : rephased)
+    {
+        SAnimationLodState& state = characters[i].lod;
+        state.phase = static_cast<uint8_t>(FindLodPhase(loads, state.level));
+        state.is_scheduled = true;
+        AddLodLoad(loads, state.level, state.phase, costs[i]);
+    }
+
+    /*            Due            */
+    const size_t slot = static_cast<size_t>(frame % Cycle);
+    for (size_t i = 0; i < count; ++i)
+    {
+        SAnimationLodState& state = characters[i].lod;
+        const size_t interval = GetInterval(state.level);
+        state.is_evaluated = false;
+        if (!state.has_pose || slot % interval == state.phase || state.frames_since_evaluation >= interval)
+        {
+            due.push_back(i);
+        }
+    }
+
+    /*            Budget            */
+    if (settings.evaluation_budget > 0 && due.size() > 1)
+    {
+        // frames a character is past its evaluation frame, 0 on its phase
+        const auto lateness = [&](size_t i)
+        {
+            const SAnimationLodState& state = characters[i].lod;
+            const size_t waited = size_t{ state.frames_since_evaluation } + 1;
+            const size_t interval = GetInterval(state.level);
+            return !state.has_pose ? SIZE_MAX : waited > interval ? waited - interval : 0;
+        };
+        std::sort(due.begin(), due.end(), [&](size_t lhs, size_t rhs)
+        {
+            const size_t lhs_lateness = lateness(lhs);
+            const size_t rhs_lateness = lateness(rhs);
+            if (lhs_lateness != rhs_lateness)
+            {
+                return lhs_lateness > rhs_lateness;
+            }
+            if (characters[lhs].importance != characters[rhs].importance)
+            {
+                return characters[lhs].importance > characters[rhs].importance;
+            }
+            return lhs < rhs;
+        });
+
+        size_t accepted = 0;
+        size_t spent = 0;
+        for (; accepted < due.size(); ++accepted)
+        {
+            const size_t i = due[accepted];
+            if (accepted > 0 && characters[i].lod.has_pose && spent + costs[i] > settings.evaluation_budget)
+            {
+                break;
+            }
+            spent += costs[i];
+        }
+        stats.deferred = due.size() - accepted;
+        due.resize(accepted);
+    }
+
+    for (const size_t i : due)
+    {
+        characters[i].lod.is_evaluated = true;
+        stats.joint_samples += costs[i];
+    }
+    stats.evaluated = due.size();
+    ++frame;
+}
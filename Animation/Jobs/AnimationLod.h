@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Skeleton/Pose.h"
+
+struct SAnimatedCharacter;
+
+// update rate of a character, a fraction of the frame rate
+enum class EAnimationLod : uint8_t
+{
+    Full,
+    Half,
+    Quarter,
+    Eighth,
+};
+
+/*
+* What 'SAnimationLodScheduler' keeps of a character, in 'SAnimatedCharacter'. A character evaluates its layers on one frame of
+* every cycle of its level, the frame of its 'phase', and keeps the palettes of its last two evaluations, in model space with the
+* inverse bind pose; the frames in between show their interpolation, so the skin of a character of 1/n rate is n - 1 frames late
+* but moves every frame. A full rate character keeps nothing, its palette is its last evaluation.
+*/
+struct SAnimationLodState
+{
+    EAnimationLod level{ EAnimationLod::Full };
+    // frame of the cycle of the level the character evaluates on
+    uint8_t phase{ 0 };
+    // level and phase are assigned
+    bool is_scheduled{ false };
+    // the scheduler picked the character for this frame
+    bool is_evaluated{ false };
+    // the character was evaluated once, before it the scheduler evaluates it on any frame
+    bool has_pose{ false };
+    // 'previous' and 'current' hold the last two evaluations, the first one twice after an evaluation at full rate
+    bool is_kept{ false };
+    // frames since the last evaluation
+    uint32_t frames_since_evaluation{ 0 };
+
+    SPose previous;
+    SPose current;
+};
+
+struct SAnimationLodSettings
+{
+    // importance a character needs for the 'Full', 'Half' and 'Quarter' levels, below the last it is 'Eighth'
+    float thresholds[3]{ 0.5f, 0.25f, 0.1f };
+    // a character goes to a lower level only below its threshold times 1 - 'hysteresis', so importance near one doesn't flicker
+    float hysteresis{ 0.1f };
+    /*
+    * Joint samples evaluated per frame, joints times active layers of every evaluated character, 0 for no limit. Characters past
+    * the budget wait for the next frame, the ones that waited longest go first; a character without a pose and the first
+    * character of a frame are evaluated over the budget.
+    */
+    size_t evaluation_budget{ 0 };
+};
+
+// what the last 'Schedule' did
+struct SAnimationLodStats
+{
+    size_t characters[4]{};
+    size_t evaluated{ 0 };
+    // due characters left for the next frame by the budget
+    size_t deferred{ 0 };
+    size_t joint_samples{ 0 };
+};
+
+/*
+* SAnimationLodScheduler throttles the evaluation of characters by importance, for 'SAnimationUpdate'. Every frame it:
+*  - puts every character in the level of its 'importance', see 'SAnimationLodSettings';
+*  - gives a character that changes level the phase with the least load over the 8-frame cycle, joint samples of the characters
+*    already on it counted, so every frame of a cycle evaluates about the same work and there are no spikes every 8th frame;
+*  - picks the characters due this frame, the ones on their phase and the ones the budget deferred before, and cuts the list
+*    at the budget, in order of frames waited and importance.
+* Characters are identified by their index in the array, they keep their index from frame to frame. It runs on the calling
+* thread before the parallel stages, over flat arrays of characters, and allocates nothing after the first frames.
+*/
+struct SAnimationLodScheduler
+{
+    // frames of the slowest level
+    constexpr static size_t Cycle{ 8 };
+
+    SAnimationLodSettings settings;
+
+    // frames between evaluations of 'level'
+    static size_t GetInterval(EAnimationLod level) { return size_t{ 1 } << static_cast<size_t>(level); }
+
+    // the level of 'importance' for a character now at 'current', or a new character when 'is_scheduled' is false
+    EAnimationLod GetLevel(float importance, EAnimationLod current, bool is_scheduled) const;
+
+    // marks the characters to evaluate this frame with 'SAnimationLodState::is_evaluated' and starts the next frame
+    void Schedule(SAnimatedCharacter* characters, size_t count);
+
+    uint64_t GetFrame() const { return frame; }
+    const SAnimationLodStats& GetStats() const { return stats; }
+
+private:
+    uint64_t frame{ 0 };
+    SAnimationLodStats stats;
+
+    // scratch of 'Schedule'
+    std::vector<size_t> costs;
+    std::vector<size_t> rephased;
+    std::vector<size_t> due;
+};
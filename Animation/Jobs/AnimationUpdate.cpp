@@ -0,0 +1,202 @@
+#include "AnimationUpdate.h"
+
+#include "../Profile/ProfileScope.h"
+#include "../Quaternion/QuaternionInterpolation.h"
+#include "../Vector/VectorInterpolation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+void SAnimationUpdate::Update(SJobSystem& jobs, SAnimatedCharacter* characters, size_t count, float delta_time)
+{
+    ANIMATION_PROFILE_SCOPE("SAnimationUpdate::Update");
+    if (contexts.size() < jobs.GetThreadCount())
+    {
+        contexts.resize(jobs.GetThreadCount());
+    }
+    // a frame boundary: nothing of the last update is in use, and contexts may have moved
+    for (SThreadContext& context : contexts)
+    {
+        context.arena.Reset();
+        context.sampler.arena = &context.arena;
+        context.blender.arena = &context.arena;
+    }
+
+    const bool is_scheduled = scheduler != nullptr;
+    if (is_scheduled)
+    {
+        scheduler->Schedule(characters, count);
+    }
+
+    jobs.ParallelFor(count, batch_size, [&](size_t begin, size_t end)
+    {
+        ANIMATION_PROFILE_SCOPE("SAnimationUpdate::UpdateBatch");
+        SThreadContext& context = contexts[jobs.GetThreadIndex()];
+        for (size_t i = begin; i < end; ++i)
+        {
+            UpdateCharacter(characters[i], delta_time, is_scheduled, context);
+        }
+    });
+}
+
+size_t SAnimationUpdate::GetArenaHeapAllocationCount() const
+{
+    size_t count = 0;
+    for (const SThreadContext& context : contexts)
+    {
+        count += context.arena.GetHeapAllocationCount();
+    }
+    return count;
+}
+
+size_t SAnimationUpdate::AdvanceLayers(SAnimatedCharacter& character, float delta_time)
+{
+    size_t active_count = 0;
+    for (SAnimationLayer& layer : character.layers)
+    {
+        if (layer.clip != nullptr && layer.weight > 0.f)
+        {
+            const float duration = layer.clip->GetDuration();
+            layer.time = duration > 0.f ? std::fmod(layer.time + delta_time * layer.speed, duration) : 0.f;
+            layer.time += layer.time < 0.f ? duration : 0.f;
+            ++active_count;
+        }
+    }
+    return active_count;
+}
+
+void SAnimationUpdate::EvaluateLocal(SAnimatedCharacter& character, size_t active_count, SThreadContext& context)
+{
+    const size_t joint_count = character.skeleton->GetJointCount();
+    if (active_count == 0)
+    {
+        character.local.Resize(joint_count);
+        character.local.SetIdentity();
+    }
+    else if (active_count == 1)
+    {
+        for (SAnimationLayer& layer : character.layers)
+        {
+            if (layer.clip != nullptr && layer.weight > 0.f)
+            {
+                context.sampler.Sample(*layer.clip, layer.time, layer.cursor, character.local);
+            }
+        }
+    }
+    else
+    {
+        SPose sampled(context.arena, joint_count);
+        context.blender.Begin(joint_count);
+        for (SAnimationLayer& layer : character.layers)
+        {
+            if (layer.clip != nullptr && layer.weight > 0.f)
+            {
+                context.sampler.Sample(*layer.clip, layer.time, layer.cursor, sampled);
+                context.blender.Add(sampled, layer.weight);
+            }
+        }
+        context.blender.End(character.local);
+    }
+}
+
+bool SAnimationUpdate::IsInterpolated(const SAnimationLodState& lod)
+{
+    return !lod.is_evaluated && lod.is_kept && SAnimationLodScheduler::GetInterval(lod.level) > 1;
+}
+
+void SAnimationUpdate::UpdateLod(SAnimatedCharacter& character, SThreadContext& context)
+{
+    SAnimationLodState& lod = character.lod;
+    if (lod.is_evaluated)
+    {
+        lod.has_pose = true;
+        lod.frames_since_evaluation = 0;
+    }
+    else
+    {
+        ++lod.frames_since_evaluation;
+    }
+
+    // at full rate the palette is the one of the last evaluation until the next one
+    const size_t interval = SAnimationLodScheduler::GetInterval(lod.level);
+    if (interval == 1)
+    {
+        lod.is_kept = false;
+        return;
+    }
+    if (!lod.is_kept)
+    {
+        // the palette is the one of the last evaluation: this frame's, or one at full rate
+        lod.previous = character.palette;
+        lod.current = character.palette;
+        lod.is_kept = true;
+    }
+    else if (lod.is_evaluated)
+    {
+        // the older palette takes the new one, in place
+        std::swap(lod.previous, lod.current);
+        lod.current = character.palette;
+    }
+
+    // a frame of the interval after the evaluation of 'current', it is reached on the frame before the next evaluation
+    const float alpha = std::min(static_cast<float>(lod.frames_since_evaluation + 1) / static_cast<float>(interval), 1.f);
+    if (alpha < 1.f)
+    {
+        // the nlerp of 'SPoseBlender' for two poses, without its sums
+        const size_t joint_count = lod.current.Size();
+        float* alphas = context.arena.Allocate<float>(joint_count);
+        std::fill(alphas, alphas + joint_count, alpha);
+        character.palette.Resize(joint_count);
+        SVectorInterpolation::Lerp(lod.previous.GetTranslations(), lod.current.GetTranslations(), alpha,
+                                   character.palette.GetTranslations(), joint_count);
+        SQuaternionInterpolation::Nlerp(lod.previous.GetRotations(), lod.current.GetRotations(), alphas,
+                                        character.palette.GetRotations(), joint_count);
+        SVectorInterpolation::Lerp(lod.previous.GetScales(), lod.current.GetScales(), alpha, character.palette.GetScales(), joint_count);
+    }
+    else if (!lod.is_evaluated)
+    {
+        character.palette = lod.current;
+    }
+}
+
+void SAnimationUpdate::UpdateCharacter(SAnimatedCharacter& character, float delta_time, bool is_scheduled, SThreadContext& context)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SAnimationUpdate::UpdateCharacter");
+    const size_t arena_marker = context.arena.GetMarker();
+
+    /*            Sample and Blend            */
+    const size_t active_count = AdvanceLayers(character, delta_time);
+    if (!is_scheduled || character.lod.is_evaluated)
+    {
+        EvaluateLocal(character, active_count, context);
+    }
+
+    // a frame between evaluations takes its palette from the kept ones, the local and model poses stay those of the last evaluation
+    if (!is_scheduled || !IsInterpolated(character.lod))
+    {
+        /*            Local To Model            */
+        character.skeleton->LocalToModel(character.local, character.model);
+
+        /*            Palette            */
+        if (character.inverse_bind != nullptr)
+        {
+            SSkeleton::Compose(character.model, *character.inverse_bind, character.palette);
+        }
+        else
+        {
+            character.palette = character.model;
+        }
+    }
+    if (is_scheduled)
+    {
+        UpdateLod(character, context);
+    }
+
+    const size_t joint_count = character.skeleton->GetJointCount();
+    character.palette_matrices.resize(joint_count);
+    SMatrix::FromTransforms(character.palette.GetRotations(), character.palette.GetTranslations(), character.palette.GetScales(),
+                            character.palette_matrices.data(), joint_count);
+
+    context.arena.Rewind(arena_marker);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+
+#include "AnimationLod.h"
+#include "JobSystem.h"
+#include "../Blend/PoseBlend.h"
+#include "../Clip/ClipSampler.h"
+#include "../Matrix/Matrix.h"
+#include "../Skeleton/Skeleton.h"
+
+// a looping clip playing on a character
+struct SAnimationLayer
+{
+    // a track per joint of the character skeleton
+    const SClip* clip{ nullptr };
+    float time{ 0.f };
+    float speed{ 1.f };
+    // weight among the layers of the character, zero skips the layer
+    float weight{ 1.f };
+    SClipCursor cursor;
+};
+
+/*
+* SAnimatedCharacter is the input and output of one character in 'SAnimationUpdate': its layers in, the local pose, the model pose
+* and the skinning palette out, as transforms and as matrices for skinning kernels. 'inverse_bind' is the inverse of the bind pose
+* in model space, see 'SSkeleton::Invert'; without it the palette is the model pose. 'importance', like the screen size of the
+* character, sets its update rate when the update has an 'SAnimationLodScheduler'.
+*/
+struct SAnimatedCharacter
+{
+    const SSkeleton* skeleton{ nullptr };
+    const SPose* inverse_bind{ nullptr };
+    std::vector<SAnimationLayer> layers;
+    float importance{ 1.f };
+    SAnimationLodState lod;
+
+    SPose local;
+    SPose model;
+    SPose palette;
+    std::vector<SMatrix> palette_matrices;
+};
+
+/*
+* SAnimationUpdate advances and evaluates characters on an 'SJobSystem', in batches of 'batch_size' characters.
+* Every character goes through the stages in order:
+*     Sample: every layer with weight is advanced by its speed and sampled at its time, looping over its clip
+*     Blend: layers are blended by 'SPoseBlender' into the local pose, a single layer is sampled into it directly
+*     LocalToModel: the model pose from the local one with the skeleton of the character
+*     Palette: the model pose composed with the inverse bind pose, then converted to matrices by 'SMatrix::FromTransforms'
+* Characters don't share state, a batch runs all stages for its characters one after another while their poses are in cache.
+* Samplers, blenders and pose buffers belong to the thread running a batch, so results don't depend on the thread count
+* or the batch size and single-threaded mode gives the same poses as any other.
+* Temporary buffers of a character, the poses of blended layers, the blend sums and the key pairs of samples, come from an
+* 'SFrameArena' of the thread: it is reset at the start of every 'Update' and rewound after every character, so all characters
+* of a thread share the same few cache lines. Once the arenas have grown to the largest character, an update takes nothing
+* from the heap.
+* With a 'scheduler', characters it doesn't pick for a frame skip Sample and Blend, LocalToModel and the composition of the
+* Palette: their layers only advance, the local and model poses stay those of the last evaluation, and the palette is the
+* interpolation of the last two evaluated ones, lerp and nlerp over the joints, converted to matrices. Evaluated frames run
+* every stage, then interpolate the palette the same way.
+*/
+struct SAnimationUpdate
+{
+    constexpr static size_t DefaultBatchSize{ 16 };
+
+    size_t batch_size{ DefaultBatchSize };
+
+    // evaluates every character on every frame when null
+    SAnimationLodScheduler* scheduler{ nullptr };
+
+    void Update(SJobSystem& jobs, SAnimatedCharacter* characters, size_t count, float delta_time);
+
+    // blocks the frame arenas of all threads took from the heap, it stays still once updates reach a steady state
+    size_t GetArenaHeapAllocationCount() const;
+
+private:
+    struct alignas(64) SThreadContext
+    {
+        SFrameArena arena;
+        SClipSampler sampler;
+        SPoseBlender blender;
+    };
+
+    // all stages for one character
+    static void UpdateCharacter(SAnimatedCharacter& character, float delta_time, bool is_scheduled, SThreadContext& context);
+
+    // the local pose from the layers advanced by 'AdvanceLayers', 'active_count' of them with weight
+    static void EvaluateLocal(SAnimatedCharacter& character, size_t active_count, SThreadContext& context);
+
+    // advances every layer with weight and returns how many there are
+    static size_t AdvanceLayers(SAnimatedCharacter& character, float delta_time);
+
+    // keeps an evaluated palette, or interpolates the kept ones into it
+    static void UpdateLod(SAnimatedCharacter& character, SThreadContext& context);
+
+    // the palette of this frame is interpolated from the kept ones alone, without the layers of the character
+    static bool IsInterpolated(const SAnimationLodState& lod);
+
+    // one per job system thread, each on its own cache lines
+    std::vector<SThreadContext> contexts;
+};
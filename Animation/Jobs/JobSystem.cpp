@@ -0,0 +1,237 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace
+{
+    // rounds an idle worker polls the deques before it sleeps, a short wait costs less than a wake-up
+    constexpr size_t IdleRounds{ 64 };
+
+    // system and index of the calling thread
+    struct SThreadSlot
+    {
+        const SJobSystem* system{ nullptr };
+        size_t index{ 0 };
+    };
+
+    thread_local SThreadSlot ThreadSlot;
+}
+
+SJobSystem::SJobSystem(size_t thread_count)
+{
+    if (thread_count == 0)
+    {
+        thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+        queues.push_back(std::make_unique<SQueue>());
+    }
+    for (size_t i = 1; i < thread_count; ++i)
+    {
+        workers.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+SJobSystem::~SJobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        is_stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+size_t SJobSystem::GetThreadIndex() const
+{
+    return ThreadSlot.system == this ? ThreadSlot.index : 0;
+}
+
+void SJobSystem::Submit(const SJob& job)
+{
+    if (job.counter != nullptr)
+    {
+        job.counter->pending.fetch_add(1);
+    }
+    if (IsSingleThreaded())
+    {
+        Run(job);
+        return;
+    }
+
+    SQueue& queue = *queues[GetThreadIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.PushBack(job);
+    }
+    queued.fetch_add(1);
+
+    if (sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        wake.notify_one();
+    }
+}
+
+void SJobSystem::Wait(SJobCounter& counter)
+{
+    const size_t index = GetThreadIndex();
+    while (counter.pending.load(std::memory_order_acquire) > 0)
+    {
+        SJob job;
+        if (TryGetJob(index, job))
+        {
+            Run(job);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SJobSystem::Dispatch(size_t count, size_t batch_size, JobFunction function, void* context)
+{
+    batch_size = std::max<size_t>(batch_size, 1);
+    if (IsSingleThreaded())
+    {
+        for (size_t begin = 0; begin < count; begin += batch_size)
+        {
+            function(context, begin, std::min(begin + batch_size, count));
+        }
+        return;
+    }
+
+    // every batch goes to the deque of this thread at once: this thread works from the last batch, thieves from the first
+    SJobCounter counter;
+    const size_t batch_count = (count + batch_size - 1) / batch_size;
+    counter.pending.store(batch_count);
+    {
+        SQueue& queue = *queues[GetThreadIndex()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (size_t begin = 0; begin < count; begin += batch_size)
+        {
+            queue.PushBack({function, context, begin, std::min(begin + batch_size, count), &counter});
+        }
+    }
+    queued.fetch_add(batch_count);
+
+    if (sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        wake.notify_all();
+    }
+    Wait(counter);
+}
+
+void SJobSystem::WorkerLoop(size_t index)
+{
+    ThreadSlot = {this, index};
+
+    size_t idle_rounds = 0;
+    while (true)
+    {
+        SJob job;
+        if (TryGetJob(index, job))
+        {
+            Run(job);
+            idle_rounds = 0;
+            continue;
+        }
+        if (++idle_rounds < IdleRounds)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleeping.fetch_add(1);
+        wake.wait(lock, [this]() { return is_stopping || queued.load() > 0; });
+        sleeping.fetch_sub(1);
+        if (is_stopping)
+        {
+            return;
+        }
+        idle_rounds = 0;
+    }
+}
+
+bool SJobSystem::TryGetJob(size_t index, SJob& job)
+{
+    if (queued.load() == 0)
+    {
+        return false;
+    }
+
+    {
+        SQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.IsEmpty())
+        {
+            job = own.PopBack();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // victims in a fixed order after this thread, so thieves spread over the deques
+    const size_t count = queues.size();
+    for (size_t offset = 1; offset < count; ++offset)
+    {
+        SQueue& victim = *queues[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.IsEmpty())
+        {
+            job = victim.PopFront();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void SJobSystem::Run(const SJob& job)
+{
+    job.function(job.context, job.begin, job.end);
+    if (job.counter != nullptr)
+    {
+        job.counter->pending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+/*            Deque            */
+void SJobSystem::SQueue::PushBack(const SJob& job)
+{
+    if (count == jobs.size())
+    {
+        // twice the size, with the jobs in order from the start
+        std::vector<SJob> grown(std::max<size_t>(2 * jobs.size(), 64));
+        for (size_t i = 0; i < count; ++i)
+        {
+            grown[i] = jobs[(first + i) % jobs.size()];
+        }
+        jobs.swap(grown);
+        first = 0;
+    }
+    jobs[(first + count) % jobs.size()] = job;
+    ++count;
+}
+
+SJob SJobSystem::SQueue::PopBack()
+{
+    --count;
+    return jobs[(first + count) % jobs.size()];
+}
+
+SJob SJobSystem::SQueue::PopFront()
+{
+    const SJob job = jobs[first];
+    first = (first + 1) % jobs.size();
+    --count;
+    return job;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// function of a job: the index range [begin, end) of 'context'
+using JobFunction = void (*)(void* context, size_t begin, size_t end);
+
+// jobs of a counter not done yet, 'SJobSystem::Wait' returns when it reaches zero
+struct SJobCounter
+{
+    std::atomic<size_t> pending{ 0 };
+};
+
+struct SJob
+{
+    JobFunction function{ nullptr };
+    void* context{ nullptr };
+    size_t begin{ 0 };
+    size_t end{ 0 };
+    SJobCounter* counter{ nullptr };
+};
+
+/*
+* SJobSystem runs jobs on a fixed set of threads with work stealing.
+* Every thread owns a deque: it pushes and pops its own jobs at the back, last in first out, while the cache still holds their data,
+* and idle threads steal from the front of other deques, taking the oldest and usually largest pieces of work.
+* A deque is a ring buffer that only grows, so once it has held the most jobs of a workload submitting a job allocates nothing.
+* Thread 0 is the thread that calls 'Wait' or 'ParallelFor' and works on jobs while it waits; threads 1 and up are workers that sleep
+* when no deque has work. Jobs may submit and wait for jobs of their own.
+* With one thread there are no workers and every job runs on the calling thread in submission order: a deterministic mode for tests.
+*/
+struct SJobSystem
+{
+    // 'thread_count' threads including the calling one, 0 for one per hardware thread
+    explicit SJobSystem(size_t thread_count = 0);
+    ~SJobSystem();
+
+    SJobSystem(const SJobSystem&) = delete;
+    SJobSystem& operator=(const SJobSystem&) = delete;
+
+    size_t GetThreadCount() const { return queues.size(); }
+    bool IsSingleThreaded() const { return queues.size() == 1; }
+
+    // index of the calling thread in [0, GetThreadCount()), 0 for threads outside of the system
+    size_t GetThreadIndex() const;
+
+    // adds 'job' to the deque of the calling thread and counts it in 'job.counter'; runs it at once in single-threaded mode
+    void Submit(const SJob& job);
+
+    // runs jobs until every job of 'counter' is done
+    void Wait(SJobCounter& counter);
+
+    /*
+    * Calls 'function(begin, end)' over [0, count) in batches of 'batch_size' indices and returns when all of them are done.
+    * In single-threaded mode batches run in index order.
+    */
+    template <typename TFunction>
+    void ParallelFor(size_t count, size_t batch_size, const TFunction& function)
+    {
+        const JobFunction trampoline = [](void* context, size_t begin, size_t end) { (*static_cast<const TFunction*>(context))(begin, end); };
+        Dispatch(count, batch_size, trampoline, const_cast<TFunction*>(&function));
+    }
+
+private:
+    // a deque of jobs in a ring buffer, locked by 'mutex'
+    struct SQueue
+    {
+        std::mutex mutex;
+        std::vector<SJob> jobs;
+        size_t first{ 0 };
+        size_t count{ 0 };
+
+        bool IsEmpty() const { return count == 0; }
+        void PushBack(const SJob& job);
+        SJob PopBack();
+        SJob PopFront();
+    };
+
+    void Dispatch(size_t count, size_t batch_size, JobFunction function, void* context);
+    void WorkerLoop(size_t index);
+
+    // pops a job of deque 'index' or steals one from another deque
+    bool TryGetJob(size_t index, SJob& job);
+    void Run(const SJob& job);
+
+    std::vector<std::unique_ptr<SQueue>> queues;
+    std::vector<std::thread> workers;
+
+    // jobs in all deques, sleeping workers wake up when it grows
+    std::atomic<size_t> queued{ 0 };
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<size_t> sleeping{ 0 };
+    bool is_stopping{ false };
+};
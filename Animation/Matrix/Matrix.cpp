@@ -0,0 +1,221 @@
+#include "Matrix.h"
+
+#include "../Profile/ProfileScope.h"
+#include "../Quaternion/QuaternionKernels.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+    // 'value' lane 'Lane' in every lane
+    template <int Lane>
+    inline __m128 Broadcast(const __m128& value)
+    {
+        return _mm_shuffle_ps(value, value, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+    }
+
+    // x * x_axis + y * y_axis + z * z_axis with 'v' in the lane layout of 'SVector'
+    inline __m128 Combine(const __m128& v, const __m128& x_axis, const __m128& y_axis, const __m128& z_axis)
+    {
+        __m128 result = _mm_mul_ps(Broadcast<SVector::X_INDEX>(v), x_axis);
+        result = _mm_add_ps(result, _mm_mul_ps(Broadcast<SVector::Y_INDEX>(v), y_axis));
+        result = _mm_add_ps(result, _mm_mul_ps(Broadcast<SVector::Z_INDEX>(v), z_axis));
+        return result;
+    }
+
+    // W column of an affine matrix: 1 in the unused lane of the translation row
+    inline __m128 WithW(const __m128& value, float w)
+    {
+        return _mm_move_ss(value, _mm_set_ss(w));
+    }
+
+    /*
+    * Four transforms to four matrices. After the transposes every register holds one quantity of four transforms, and the
+    * 3x3 part is the rotation matrix of each quaternion, 'SQuaternionPack::GetAxes', with its rows scaled by the scale components.
+    * Rows are transposed back with a zero W register, and translations only get their W lane set, so they skip both transposes.
+    */
+    inline void FromTransforms4(const SQuaternion* rotations, const SVector* translations, const SVector* scales, SMatrix* out)
+    {
+        // lanes of the transposed registers are transforms, registers are components in the lane order of 'SVector'
+        __m128 w = rotations[0].GetStorage(), z = rotations[1].GetStorage(), y = rotations[2].GetStorage(), x = rotations[3].GetStorage();
+        _MM_TRANSPOSE4_PS(w, z, y, x);
+        __m128 unused = scales[0].GetStorage(), sz = scales[1].GetStorage(), sy = scales[2].GetStorage(), sx = scales[3].GetStorage();
+        _MM_TRANSPOSE4_PS(unused, sz, sy, sx);
+
+        QuaternionKernels::SVectorPack<__m128> axes[3];
+        const QuaternionKernels::SQuaternionPack<__m128> rotation{ { x, y, z }, w };
+        rotation.GetAxes(axes);
+        const __m128 row_scales[3]{ sx, sy, sz };
+
+        // W, Z, Y and X of every row, transposed to a row per transform
+        __m128 rows[3][4];
+        for (size_t row = 0; row < 3; ++row)
+        {
+            const QuaternionKernels::SVectorPack<__m128> scaled = axes[row] * row_scales[row];
+            rows[row][0] = _mm_setzero_ps();
+            rows[row][1] = scaled.z;
+            rows[row][2] = scaled.y;
+            rows[row][3] = scaled.x;
+            _MM_TRANSPOSE4_PS(rows[row][0], rows[row][1], rows[row][2], rows[row][3]);
+        }
+
+        for (size_t i = 0; i < 4; ++i)
+        {
+            out[i] = SMatrix(rows[0][i], rows[1][i], rows[2][i], WithW(translations[i].GetStorage(), 1.f));
+        }
+    }
+}
+
+const SMatrix SMatrix::Identity{};
+
+SMatrix::SMatrix()
+    : rows{ _mm_set_ps(1.f, 0.f, 0.f, 0.f), _mm_set_ps(0.f, 1.f, 0.f, 0.f), _mm_set_ps(0.f, 0.f, 1.f, 0.f), _mm_set_ps(0.f, 0.f, 0.f, 1.f) }
+{
+}
+
+SMatrix::SMatrix(const __m128& x_axis, const __m128& y_axis, const __m128& z_axis, const __m128& translation)
+    : rows{ x_axis, y_axis, z_axis, translation }
+{
+}
+
+SMatrix SMatrix::FromTransform(const SQuaternion& rotation, const SVector& translation, const SVector& scale)
+{
+    SMatrix result;
+    FromTransforms(&rotation, &translation, &scale, &result, 1);
+    return result;
+}
+
+void SMatrix::FromTransforms(const SQuaternion* rotations, const SVector* translations, const SVector* scales, SMatrix* out, size_t count)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SMatrix::FromTransforms");
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        FromTransforms4(rotations + i, translations + i, scales + i, out + i);
+    }
+    if (i == count)
+    {
+        return;
+    }
+
+    // the tail through the same kernel, padded with identity transforms, so every matrix has the same arithmetic
+    SQuaternion tail_rotations[4]{ SQuaternion::Identity, SQuaternion::Identity, SQuaternion::Identity, SQuaternion::Identity };
+    SVector tail_translations[4];
+    SVector tail_scales[4]{ 1.f, 1.f, 1.f, 1.f };
+    SMatrix tail[4];
+    const size_t rest = count - i;
+    std::copy(rotations + i, rotations + count, tail_rotations);
+    std::copy(translations + i, translations + count, tail_translations);
+    std::copy(scales + i, scales + count, tail_scales);
+    FromTransforms4(tail_rotations, tail_translations, tail_scales, tail);
+    std::copy(tail, tail + rest, out + i);
+}
+
+float SMatrix::Get(size_t row, size_t column) const
+{
+    assert(row < 4 && column < 4);
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, rows[row]);
+    return lanes[SVector::X_INDEX - column];
+}
+
+/*            Equality            */
+bool SMatrix::operator==(const SMatrix& rhs) const
+{
+    const __m128 equal = _mm_and_ps(_mm_and_ps(_mm_cmpeq_ps(rows[0], rhs.rows[0]), _mm_cmpeq_ps(rows[1], rhs.rows[1])),
+                                    _mm_and_ps(_mm_cmpeq_ps(rows[2], rhs.rows[2]), _mm_cmpeq_ps(rows[3], rhs.rows[3])));
+    return _mm_movemask_ps(equal) == 0xF;
+}
+
+bool SMatrix::operator!=(const SMatrix& rhs) const
+{
+    return !(*this == rhs);
+}
+
+/*            Product            */
+SMatrix& SMatrix::operator*=(const SMatrix& rhs)
+{
+    *this = *this * rhs;
+    return *this;
+}
+
+SMatrix operator*(const SMatrix& lhs, const SMatrix& rhs)
+{
+    // every row of the product is the row of 'lhs' transformed by 'rhs', W column included
+    const __m128 x_axis = rhs.rows[0], y_axis = rhs.rows[1], z_axis = rhs.rows[2], translation = rhs.rows[3];
+    __m128 rows[4];
+    for (size_t i = 0; i < 4; ++i)
+    {
+        const __m128& row = lhs.rows[i];
+        rows[i] = _mm_add_ps(Combine(row, x_axis, y_axis, z_axis), _mm_mul_ps(Broadcast<SVector::U_INDEX>(row), translation));
+    }
+    return SMatrix(rows[0], rows[1], rows[2], rows[3]);
+}
+
+/*            Transpose            */
+void SMatrix::Transpose()
+{
+    // the register of lane X collects the X column, so rows go in reverse to come out in the lane order of 'SVector'
+    __m128 w = rows[3], z = rows[2], y = rows[1], x = rows[0];
+    _MM_TRANSPOSE4_PS(w, z, y, x);
+    rows[0] = x;
+    rows[1] = y;
+    rows[2] = z;
+    rows[3] = w;
+}
+
+SMatrix SMatrix::Transposition() const
+{
+    SMatrix result = *this;
+    result.Transpose();
+    return result;
+}
+
+/*            Inverse            */
+void SMatrix::InvertAffine()
+{
+    // the inverse of a 3x3 matrix with rows a, b and c has columns b ^ c, c ^ a and a ^ b divided by the determinant
+    const __m128 a = WithW(rows[0], 0.f), b = WithW(rows[1], 0.f), c = WithW(rows[2], 0.f);
+    __m128 zero = _mm_setzero_ps(), ab = QuaternionKernels::Cross(a, b), ca = QuaternionKernels::Cross(c, a), bc = QuaternionKernels::Cross(b, c);
+
+    const __m128 products = _mm_mul_ps(a, bc);
+    const __m128 sums = _mm_add_ps(products, _mm_movehl_ps(products, products));
+    const __m128 determinant = _mm_add_ss(sums, _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(0, 0, 0, SVector::Z_INDEX)));
+    const __m128 reciprocal = _mm_div_ps(_mm_set1_ps(1.f), _mm_shuffle_ps(determinant, determinant, _MM_SHUFFLE(0, 0, 0, 0)));
+
+    _MM_TRANSPOSE4_PS(zero, ab, ca, bc);
+    const __m128 x_axis = _mm_mul_ps(bc, reciprocal);
+    const __m128 y_axis = _mm_mul_ps(ca, reciprocal);
+    const __m128 z_axis = _mm_mul_ps(ab, reciprocal);
+
+    const __m128 translation = Combine(_mm_xor_ps(rows[3], _mm_set1_ps(-0.f)), x_axis, y_axis, z_axis);
+    rows[0] = x_axis;
+    rows[1] = y_axis;
+    rows[2] = z_axis;
+    rows[3] = WithW(translation, 1.f);
+}
+
+SMatrix SMatrix::AffineInverse() const
+{
+    SMatrix result = *this;
+    result.InvertAffine();
+    return result;
+}
+
+/*            Transformation            */
+SVector SMatrix::TransformPoint(const SVector& v) const
+{
+    SVector result;
+    const __m128 point = _mm_add_ps(Combine(v.GetStorage(), rows[0], rows[1], rows[2]), rows[3]);
+    _mm_store_ps(reinterpret_cast<float*>(&result), WithW(point, 0.f));
+    return result;
+}
+
+SVector SMatrix::TransformDirection(const SVector& v) const
+{
+    SVector result;
+    const __m128 direction = Combine(v.GetStorage(), rows[0], rows[1], rows[2]);
+    _mm_store_ps(reinterpret_cast<float*>(&result), WithW(direction, 0.f));
+    return result;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <xmmintrin.h>
+
+#include "../Quaternion/Quaternion.h"
+#include "../Vector/Vector.h"
+
+/*
+* SMatrix is a 4x4 matrix of four 128bit SIMD rows, each row with the lane layout of 'SVector': columns X, Y and Z share lanes
+* with the vector axes and column W takes the lane 'SVector' leaves unused.
+* Vectors are rows multiplied on the left, 'v * M', so the rows of a transform are the images of the X, Y and Z axes and
+* the translation, and a point is transformed by broadcasting its components over the rows: no transposes in the hot path.
+* 'lhs * rhs' applies 'lhs' first and 'rhs' second, the order of 'SSkeleton::Compose' arguments reversed.
+*/
+struct alignas(16) SMatrix
+{
+    // rows of a transform
+    constexpr static size_t X_AXIS{ 0 };
+    constexpr static size_t Y_AXIS{ 1 };
+    constexpr static size_t Z_AXIS{ 2 };
+    constexpr static size_t TRANSLATION{ 3 };
+
+    // identity matrix
+    SMatrix();
+    SMatrix(const __m128& x_axis, const __m128& y_axis, const __m128& z_axis, const __m128& translation);
+
+    const static SMatrix Identity;
+
+    /*
+    * Matrix of a transform that applies 'scale' first, 'rotation' second and 'translation' last, like a joint of 'SPose':
+    *   TransformPoint(v) == rotation.Rotate(scale * v) + translation
+    * 'rotation' is a unit quaternion.
+    */
+    static SMatrix FromTransform(const SQuaternion& rotation, const SVector& translation, const SVector& scale);
+
+    /*
+    * 'FromTransform' for 'count' transforms given as three arrays, four at a time: four quaternions are transposed into X, Y, Z and W
+    * registers so every matrix entry of four matrices is one register operation, and the entries are transposed back into rows.
+    * Results are equal to 'FromTransform' bit for bit. Builds a matrix skinning palette from an 'SPose'.
+    */
+    static void FromTransforms(const SQuaternion* rotations, const SVector* translations, const SVector* scales, SMatrix* out, size_t count);
+
+    const __m128& GetRow(size_t row) const { return rows[row]; }
+    void SetRow(size_t row, const __m128& value) { rows[row] = value; }
+
+    // entry at 'row' and 'column', columns 0 to 3 are X, Y, Z and W
+    float Get(size_t row, size_t column) const;
+
+    // Equality
+    bool operator==(const SMatrix& rhs) const;
+
+    // Inequality
+    bool operator!=(const SMatrix& rhs) const;
+
+    // Product, 'lhs * rhs' applies 'lhs' first and 'rhs' second
+    SMatrix& operator*=(const SMatrix& rhs);
+    friend SMatrix operator*(const SMatrix& lhs, const SMatrix& rhs);
+
+    // Transpose
+    void Transpose();
+    SMatrix Transposition() const;
+
+    /*
+    * Inverse of an affine matrix, a matrix with a W column of (0, 0, 0, 1): the 3x3 part is inverted from cross products of its rows,
+    * so non-uniform scales are inverted exactly, and the translation is moved back through it. A singular 3x3 part gives infinities.
+    */
+    void InvertAffine();
+    SMatrix AffineInverse() const;
+
+    // 'v' as a point: rows scaled by its components plus the translation row
+    SVector TransformPoint(const SVector& v) const;
+
+    // 'v' as a direction: rows scaled by its components, the translation is ignored
+    SVector TransformDirection(const SVector& v) const;
+
+private:
+    __m128 rows[4];
+};
@@ -0,0 +1,99 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <xmmintrin.h>
+
+namespace
+{
+    // the block grows in pages, so a workload that grows a little at a time doesn't replace it every frame
+    constexpr size_t ArenaPageSize{ 4096 };
+
+    size_t AlignArenaSize(size_t bytes, size_t alignment)
+    {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+}
+
+SFrameArena::SFrameArena(size_t capacity)
+{
+    if (capacity > 0)
+    {
+        this->capacity = AlignArenaSize(capacity, Alignment);
+        block = static_cast<uint8_t*>(_mm_malloc(this->capacity, Alignment));
+        ++heap_allocation_count;
+    }
+}
+
+SFrameArena::SFrameArena(SFrameArena&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+SFrameArena& SFrameArena::operator=(SFrameArena&& other) noexcept
+{
+    std::swap(block, other.block);
+    std::swap(capacity, other.capacity);
+    std::swap(offset, other.offset);
+    std::swap(overflow, other.overflow);
+    std::swap(overflow_bytes, other.overflow_bytes);
+    std::swap(peak, other.peak);
+    std::swap(heap_allocation_count, other.heap_allocation_count);
+    return *this;
+}
+
+SFrameArena::~SFrameArena()
+{
+    for (void* memory : overflow)
+    {
+        _mm_free(memory);
+    }
+    _mm_free(block);
+}
+
+void* SFrameArena::Allocate(size_t bytes)
+{
+    // sizes in whole alignment units keep the offset aligned and make the peak the size of a block that fits every allocation
+    bytes = AlignArenaSize(bytes, Alignment);
+    void* memory;
+    if (offset + bytes <= capacity)
+    {
+        memory = block + offset;
+        offset += bytes;
+    }
+    else
+    {
+        memory = _mm_malloc(std::max<size_t>(bytes, Alignment), Alignment);
+        overflow.push_back(memory);
+        overflow_bytes += bytes;
+        ++heap_allocation_count;
+    }
+    peak = std::max(peak, offset + overflow_bytes);
+    return memory;
+}
+
+void SFrameArena::Rewind(size_t marker)
+{
+    assert(marker <= offset);
+    offset = marker;
+}
+
+void SFrameArena::Reset()
+{
+    for (void* memory : overflow)
+    {
+        _mm_free(memory);
+    }
+    overflow.clear();
+    overflow_bytes = 0;
+    offset = 0;
+
+    if (peak > capacity)
+    {
+        _mm_free(block);
+        capacity = AlignArenaSize(peak, ArenaPageSize);
+        block = static_cast<uint8_t*>(_mm_malloc(capacity, Alignment));
+        ++heap_allocation_count;
+    }
+}
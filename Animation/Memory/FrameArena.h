@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/*
+* SFrameArena hands out memory for the temporary buffers of a frame: poses sampled before a blend, blend sums, key pairs of a sample.
+* An allocation bumps an offset in a single block and is aligned to 'Alignment', so every buffer starts on a cache line and the same
+* few cache lines serve every character a thread updates. Nothing is freed one by one: 'Rewind' drops everything allocated after a
+* marker, like the buffers of one character, and 'Reset' drops everything at a frame boundary.
+* Allocations that don't fit the block get blocks of their own from the heap until the next 'Reset', which replaces the block by one
+* as large as the most the arena held at once. After the first frames of a workload an arena takes nothing from the heap, and
+* 'GetHeapAllocationCount' stays still. An arena belongs to one thread.
+*/
+struct SFrameArena
+{
+    // alignment of every allocation in bytes
+    constexpr static size_t Alignment{ 64 };
+
+    constexpr static size_t DefaultCapacity{ 64 * 1024 };
+
+    explicit SFrameArena(size_t capacity = DefaultCapacity);
+    SFrameArena(SFrameArena&& other) noexcept;
+    SFrameArena& operator=(SFrameArena&& other) noexcept;
+    ~SFrameArena();
+
+    SFrameArena(const SFrameArena&) = delete;
+    SFrameArena& operator=(const SFrameArena&) = delete;
+
+    // 'bytes' of uninitialized memory, valid until a 'Rewind' to a marker before it or a 'Reset'
+    void* Allocate(size_t bytes);
+
+    // 'count' uninitialized elements of a type without a destructor
+    template <typename T>
+    T* Allocate(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T> && alignof(T) <= Alignment, "arena memory is never destroyed");
+        return static_cast<T*>(Allocate(count * sizeof(T)));
+    }
+
+    // position of the next allocation in the block
+    size_t GetMarker() const { return offset; }
+
+    // drops the allocations of the block made after 'marker', blocks of allocations that didn't fit stay until 'Reset'
+    void Rewind(size_t marker);
+
+    // drops every allocation, and grows the block to the most the arena held since the last reset
+    void Reset();
+
+    size_t GetCapacity() const { return capacity; }
+    // bytes held by allocations now and at most since the arena was made, alignment padding included
+    size_t GetUsed() const { return offset + overflow_bytes; }
+    size_t GetPeak() const { return peak; }
+
+    // number of blocks taken from the heap since the arena was made
+    size_t GetHeapAllocationCount() const { return heap_allocation_count; }
+
+private:
+    uint8_t* block{ nullptr };
+    size_t capacity{ 0 };
+    size_t offset{ 0 };
+
+    // allocations that didn't fit the block, freed by 'Reset'
+    std::vector<void*> overflow;
+    size_t overflow_bytes{ 0 };
+
+    size_t peak{ 0 };
+    size_t heap_allocation_count{ 0 };
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+/*
+* Scopes of the library, compiled only in builds that define the macros of the CMake options of the same names:
+*   ANIMATION_PROFILE_SCOPE        - ANIMATION_PROFILE, stages that run a few times per frame or per job: the update, a batch
+*                                    of characters, skinning, IK;
+*   ANIMATION_PROFILE_KERNEL_SCOPE - ANIMATION_PROFILE_KERNELS as well, the work of one character and the batch kernels inside
+*                                    it: the update of a character, sampling of a clip, 'SVectorSoA' operations, quaternion
+*                                    interpolation, blend sums, the hierarchy and palette conversions. Every one is a short
+*                                    call, their scopes multiply the cost of a capture several times.
+* Without ANIMATION_PROFILE this header is the empty macros alone, the sources of the library don't see 'SProfiler'.
+*/
+#if defined(ANIMATION_PROFILE)
+#include "Profiler.h"
+
+#define ANIMATION_PROFILE_JOIN_IMPL(lhs, rhs) lhs##rhs
+#define ANIMATION_PROFILE_JOIN(lhs, rhs) ANIMATION_PROFILE_JOIN_IMPL(lhs, rhs)
+#define ANIMATION_PROFILE_SCOPE(name) const SProfileScope ANIMATION_PROFILE_JOIN(profile_scope_, __LINE__)(name)
+#else
+#define ANIMATION_PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#if defined(ANIMATION_PROFILE) && defined(ANIMATION_PROFILE_KERNELS)
+#define ANIMATION_PROFILE_KERNEL_SCOPE(name) const SProfileScope ANIMATION_PROFILE_JOIN(profile_scope_, __LINE__)(name)
+#else
+#define ANIMATION_PROFILE_KERNEL_SCOPE(name) ((void)0)
+#endif
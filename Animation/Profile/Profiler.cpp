@@ -0,0 +1,287 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <ostream>
+
+namespace
+{
+    // nearest rank of 'fraction' in sorted values
+    double ProfilePercentile(const std::vector<double>& sorted, double fraction)
+    {
+        if (sorted.empty())
+        {
+            return 0.0;
+        }
+        const size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+        return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+    }
+
+    SProfileStageSummary SummarizeStage(std::string name, std::vector<double> frame_times, size_t calls)
+    {
+        std::sort(frame_times.begin(), frame_times.end());
+        SProfileStageSummary summary;
+        summary.name = std::move(name);
+        summary.calls_per_frame = frame_times.empty() ? 0.0 : static_cast<double>(calls) / static_cast<double>(frame_times.size());
+        summary.p50 = ProfilePercentile(frame_times, .5);
+        summary.p90 = ProfilePercentile(frame_times, .9);
+        summary.p99 = ProfilePercentile(frame_times, .99);
+        summary.max = frame_times.empty() ? 0.0 : frame_times.back();
+        return summary;
+    }
+
+    void WriteJsonString(std::ostream& stream, const char* text)
+    {
+        stream << '"';
+        for (; *text != '\0'; ++text)
+        {
+            if (*text == '"' || *text == '\\')
+            {
+                stream << '\\';
+            }
+            stream << *text;
+        }
+        stream << '"';
+    }
+
+    void WriteCompleteEvent(std::ostream& stream, const char* name, size_t thread, double begin, double duration)
+    {
+        stream << ",\n{\"name\":";
+        WriteJsonString(stream, name);
+        stream << ",\"cat\":\"Animation\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread << ",\"ts\":" << begin << ",\"dur\":" << duration << '}';
+    }
+
+    void WriteThreadName(std::ostream& stream, size_t thread, const std::string& name)
+    {
+        stream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread << ",\"args\":{\"name\":";
+        WriteJsonString(stream, name.c_str());
+        stream << "}}";
+    }
+}
+
+SProfiler& SProfiler::Get()
+{
+    static SProfiler profiler;
+    return profiler;
+}
+
+void SProfiler::Start(size_t capacity)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        event_capacity = capacity;
+        for (const std::unique_ptr<SThreadBuffer>& buffer : buffers)
+        {
+            buffer->events.resize(event_capacity);
+            buffer->next = buffer->events.data();
+            buffer->end = buffer->next + buffer->events.size();
+            buffer->dropped = 0;
+        }
+    }
+    frame_ends.clear();
+    start_time = std::chrono::steady_clock::now();
+    start_ticks = Now();
+    Recording.store(true, std::memory_order_relaxed);
+}
+
+void SProfiler::Stop()
+{
+    Recording.store(false, std::memory_order_relaxed);
+    {
+        // no free part left, a later scope goes to 'RecordOverflow' and finds the profiler stopped
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::unique_ptr<SThreadBuffer>& buffer : buffers)
+        {
+            buffer->end = buffer->next;
+        }
+    }
+    stop_ticks = Now();
+    stop_time = std::chrono::steady_clock::now();
+}
+
+void SProfiler::EndFrame()
+{
+    if (IsRecording())
+    {
+        frame_ends.push_back(Now());
+    }
+}
+
+void SProfiler::RecordOverflow(const char* name, uint64_t begin, uint64_t end)
+{
+    if (!IsRecording())
+    {
+        return;
+    }
+
+    SThreadBuffer* buffer = thread_buffer;
+    if (buffer == nullptr)
+    {
+        buffer = &AddThreadBuffer();
+        thread_buffer = buffer;
+    }
+
+    if (buffer->next != buffer->end)
+    {
+        *buffer->next++ = {name, begin, end};
+    }
+    else
+    {
+        ++buffer->dropped;
+    }
+}
+
+SProfiler::SThreadBuffer& SProfiler::AddThreadBuffer()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    buffers.push_back(std::make_unique<SThreadBuffer>());
+    SThreadBuffer& buffer = *buffers.back();
+    buffer.events.resize(event_capacity);
+    buffer.next = buffer.events.data();
+    buffer.end = buffer.next + buffer.events.size();
+    buffer.thread_index = buffers.size() - 1;
+    return buffer;
+}
+
+size_t SProfiler::GetEventCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (const std::unique_ptr<SThreadBuffer>& buffer : buffers)
+    {
+        count += buffer->GetCount();
+    }
+    return count;
+}
+
+size_t SProfiler::GetDroppedEventCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (const std::unique_ptr<SThreadBuffer>& buffer : buffers)
+    {
+        count += buffer->dropped;
+    }
+    return count;
+}
+
+double SProfiler::GetTicksPerMicrosecond() const
+{
+    const bool running = IsRecording();
+    const uint64_t end_ticks = running ? Now() : stop_ticks;
+    const std::chrono::steady_clock::time_point end_time = running ? std::chrono::steady_clock::now() : stop_time;
+    const double microseconds = std::chrono::duration<double, std::micro>(end_time - start_time).count();
+    return microseconds > 0.0 && end_ticks > start_ticks ? static_cast<double>(end_ticks - start_ticks) / microseconds : 1.0;
+}
+
+std::vector<SProfileStageSummary> SProfiler::Summarize() const
+{
+    std::vector<SProfileStageSummary> summaries;
+    const size_t frame_count = frame_ends.size();
+    const double microseconds_per_tick = 1.0 / GetTicksPerMicrosecond();
+
+    std::vector<double> frame_times(frame_count);
+    for (size_t frame = 0; frame < frame_count; ++frame)
+    {
+        const uint64_t frame_begin = frame == 0 ? start_ticks : frame_ends[frame - 1];
+        frame_times[frame] = static_cast<double>(frame_ends[frame] - frame_begin) * microseconds_per_tick;
+    }
+    summaries.push_back(SummarizeStage("Frame", std::move(frame_times), frame_count));
+
+    // stages by name, a name may come from string literals at different addresses
+    struct SStage
+    {
+        std::vector<double> frame_times;
+        size_t calls{ 0 };
+    };
+    std::map<std::string, SStage> stages;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::unique_ptr<SThreadBuffer>& buffer : buffers)
+        {
+            for (size_t i = 0; i < buffer->GetCount(); ++i)
+            {
+                const SProfileEvent& event = buffer->events[i];
+                // scopes begun after the last frame ended belong to no frame
+                const size_t frame = static_cast<size_t>(std::upper_bound(frame_ends.begin(), frame_ends.end(), event.begin) - frame_ends.begin());
+                if (frame == frame_count || event.begin < start_ticks)
+                {
+                    continue;
+                }
+
+                SStage& stage = stages[event.name];
+                stage.frame_times.resize(frame_count, 0.0);
+                stage.frame_times[frame] += static_cast<double>(event.end - event.begin) * microseconds_per_tick;
+                ++stage.calls;
+            }
+        }
+    }
+
+    const size_t first_stage = summaries.size();
+    for (std::pair<const std::string, SStage>& stage : stages)
+    {
+        summaries.push_back(SummarizeStage(stage.first, std::move(stage.second.frame_times), stage.second.calls));
+    }
+    std::stable_sort(summaries.begin() + first_stage, summaries.end(), [](const SProfileStageSummary& lhs, const SProfileStageSummary& rhs)
+    {
+        return lhs.p50 > rhs.p50;
+    });
+    return summaries;
+}
+
+void SProfiler::WriteSummary(std::ostream& stream) const
+{
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-48s %11s %10s %10s %10s %10s\n", "stage", "calls/frame", "p50 us", "p90 us", "p99 us", "max us");
+    stream << line;
+    for (const SProfileStageSummary& summary : Summarize())
+    {
+        std::snprintf(line, sizeof(line), "%-48s %11.2f %10.2f %10.2f %10.2f %10.2f\n", summary.name.c_str(), summary.calls_per_frame,
+                      summary.p50, summary.p90, summary.p99, summary.max);
+        stream << line;
+    }
+    std::snprintf(line, sizeof(line), "%zu frames, %zu scopes, %zu dropped\n", GetFrameCount(), GetEventCount(), GetDroppedEventCount());
+    stream << line;
+}
+
+void SProfiler::WriteChromeTrace(std::ostream& stream) const
+{
+    const double microseconds_per_tick = 1.0 / GetTicksPerMicrosecond();
+    const auto microseconds = [&](uint64_t ticks) { return static_cast<double>(ticks - start_ticks) * microseconds_per_tick; };
+
+    std::lock_guard<std::mutex> lock(mutex);
+    // frames get a track after the last thread
+    const size_t frame_track = buffers.size();
+
+    const std::ios_base::fmtflags flags = stream.flags();
+    const std::streamsize precision = stream.precision(3);
+    stream.setf(std::ios_base::fixed, std::ios_base::floatfield);
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Animation\"}}";
+    for (const std::unique_ptr<SThreadBuffer>& buffer : buffers)
+    {
+        WriteThreadName(stream, buffer->thread_index, "Thread " + std::to_string(buffer->thread_index));
+        for (size_t i = 0; i < buffer->GetCount(); ++i)
+        {
+            const SProfileEvent& event = buffer->events[i];
+            if (event.begin >= start_ticks)
+            {
+                WriteCompleteEvent(stream, event.name, buffer->thread_index, microseconds(event.begin), static_cast<double>(event.end - event.begin) * microseconds_per_tick);
+            }
+        }
+    }
+
+    WriteThreadName(stream, frame_track, "Frames");
+    for (size_t frame = 0; frame < frame_ends.size(); ++frame)
+    {
+        const uint64_t frame_begin = frame == 0 ? start_ticks : frame_ends[frame - 1];
+        WriteCompleteEvent(stream, "Frame", frame_track, microseconds(frame_begin), static_cast<double>(frame_ends[frame] - frame_begin) * microseconds_per_tick);
+    }
+    stream << "\n]}\n";
+
+    stream.precision(precision);
+    stream.flags(flags);
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+// one timed scope on one thread, in ticks of 'SProfiler::Now'
+struct SProfileEvent
+{
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+// times of one stage over the frames of a capture, in microseconds
+struct SProfileStageSummary
+{
+    std::string name;
+    // scopes of the stage per frame, on every thread
+    double calls_per_frame{ 0.0 };
+    // percentiles of the time of the stage in a frame, the sum of its scopes on every thread
+    double p50{ 0.0 };
+    double p90{ 0.0 };
+    double p99{ 0.0 };
+    double max{ 0.0 };
+};
+
+/*
+* SProfiler collects the scopes of 'ANIMATION_PROFILE_SCOPE' between 'Start' and 'Stop'. Every thread writes its scopes into a buffer
+* of its own, sized by 'Start', without locks or allocations: a scope is two reads of the clock and a store through a thread local
+* pointer. A thread takes the lock only once, to make its buffer on its first scope. Scopes that don't fit a full buffer are counted
+* and dropped. The library includes 'ProfileScope.h', this header only in builds that profile.
+* Time is the time stamp counter, converted to microseconds with the steady clock measured at 'Start' and 'Stop', so a capture
+* assumes an invariant TSC, one that ticks at a constant rate in every power state.
+* 'EndFrame' splits a capture into frames for 'Summarize': for every stage, the percentiles of its time per frame over the frames.
+* Nested scopes count in full in both stages. 'WriteChromeTrace' writes the whole capture for chrome://tracing or ui.perfetto.dev.
+* 'Start', 'Stop', 'EndFrame' and the exports run between frames, when no thread is inside a scope.
+*/
+struct SProfiler
+{
+    constexpr static size_t DefaultEventCapacity{ 64 * 1024 };
+
+    // the profiler of the process, every scope records into it
+    static SProfiler& Get();
+
+    // ticks of the time stamp counter
+    static uint64_t Now() { return __rdtsc(); }
+
+    // drops the last capture and records up to 'event_capacity' scopes per thread
+    void Start(size_t event_capacity = DefaultEventCapacity);
+    void Stop();
+    static bool IsRecording() { return Recording.load(std::memory_order_relaxed); }
+
+    // ends the current frame at this moment, the next one starts
+    void EndFrame();
+
+    // records a scope of the calling thread, nothing while the profiler is stopped
+    static void Record(const char* name, uint64_t begin, uint64_t end);
+
+    size_t GetEventCount() const;
+    size_t GetDroppedEventCount() const;
+    size_t GetFrameCount() const { return frame_ends.size(); }
+    // of the last capture, or of the running one up to now
+    double GetTicksPerMicrosecond() const;
+
+    // the frame time first, then every stage from the longest to the shortest median time per frame
+    std::vector<SProfileStageSummary> Summarize() const;
+    // the summary as a table
+    void WriteSummary(std::ostream& stream) const;
+    // Trace Event Format JSON: a complete event per scope, a track per thread and a track of frames
+    void WriteChromeTrace(std::ostream& stream) const;
+
+private:
+    struct SThreadBuffer
+    {
+        std::vector<SProfileEvent> events;
+        // the free part of 'events', empty while the profiler is stopped
+        SProfileEvent* next{ nullptr };
+        SProfileEvent* end{ nullptr };
+        size_t dropped{ 0 };
+        size_t thread_index{ 0 };
+
+        size_t GetCount() const { return static_cast<size_t>(next - events.data()); }
+    };
+
+    SProfiler() = default;
+
+    SThreadBuffer& AddThreadBuffer();
+
+    // a scope that doesn't fit the buffer of its thread: the first one of the thread, one past a full buffer or one while stopped
+    void RecordOverflow(const char* name, uint64_t begin, uint64_t end);
+
+    // the buffer of the calling thread, made on its first scope; defined here so a scope reads it without a call
+    static inline thread_local SThreadBuffer* thread_buffer{ nullptr };
+
+    // of the one profiler, a scope reads it without 'Get'
+    static inline std::atomic<bool> Recording{ false };
+
+    size_t event_capacity{ DefaultEventCapacity };
+
+    // guards 'buffers', the list only grows and every buffer keeps its address
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<SThreadBuffer>> buffers;
+
+    std::vector<uint64_t> frame_ends;
+
+    uint64_t start_ticks{ 0 };
+    uint64_t stop_ticks{ 0 };
+    std::chrono::steady_clock::time_point start_time;
+    std::chrono::steady_clock::time_point stop_time;
+};
+
+inline void SProfiler::Record(const char* name, uint64_t begin, uint64_t end)
+{
+    SThreadBuffer* buffer = thread_buffer;
+    if (buffer != nullptr && buffer->next != buffer->end)
+    {
+        *buffer->next++ = { name, begin, end };
+        return;
+    }
+    Get().RecordOverflow(name, begin, end);
+}
+
+// times the rest of the enclosing block, 'name' must outlive the capture, like a string literal; costs two reads of the clock while recording
+struct SProfileScope
+{
+    explicit SProfileScope(const char* name) : name(name), begin(SProfiler::IsRecording() ? SProfiler::Now() : 0) {}
+    ~SProfileScope()
+    {
+        // 0 for a scope begun while the profiler was stopped
+        if (begin != 0)
+        {
+            SProfiler::Record(name, begin, SProfiler::Now());
+        }
+    }
+
+    SProfileScope(const SProfileScope&) = delete;
+    SProfileScope& operator=(const SProfileScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t begin;
+};
@@ -0,0 +1,150 @@
+#include "DualQuaternion.h"
+
+#include "../Profile/ProfileScope.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    /*
+    * Four transforms to four dual quaternions. The real part is the rotation as it is; the dual part is half the product of the
+    * translation (W = 0) and the rotation, computed on transposed registers, one component of four transforms per register:
+    *   x = (tx * rw + ty * rz - tz * ry) / 2
+    *   y = (ty * rw + tz * rx - tx * rz) / 2
+    *   z = (tz * rw + tx * ry - ty * rx) / 2
+    *   w = -(tx * rx + ty * ry + tz * rz) / 2
+    */
+    inline void FromTransforms4(const SQuaternion* rotations, const SVector* translations, SDualQuaternion* out)
+    {
+        __m128 rw = rotations[0].GetStorage(), rz = rotations[1].GetStorage(), ry = rotations[2].GetStorage(), rx = rotations[3].GetStorage();
+        _MM_TRANSPOSE4_PS(rw, rz, ry, rx);
+        __m128 unused = translations[0].GetStorage(), tz = translations[1].GetStorage(), ty = translations[2].GetStorage(), tx = translations[3].GetStorage();
+        _MM_TRANSPOSE4_PS(unused, tz, ty, tx);
+
+        const __m128 half = _mm_set1_ps(.5f);
+        __m128 x = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(tx, rw), _mm_mul_ps(ty, rz)), _mm_mul_ps(tz, ry)), half);
+        __m128 y = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(ty, rw), _mm_mul_ps(tz, rx)), _mm_mul_ps(tx, rz)), half);
+        __m128 z = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(tz, rw), _mm_mul_ps(tx, ry)), _mm_mul_ps(ty, rx)), half);
+        __m128 w = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, rx), _mm_mul_ps(ty, ry)), _mm_mul_ps(tz, rz)), _mm_set1_ps(-.5f));
+
+        // back to one register per dual part: lane W from 'w' and so on, in the lane order of 'SQuaternion'
+        _MM_TRANSPOSE4_PS(w, z, y, x);
+        out[0] = SDualQuaternion(rotations[0], SQuaternion(w));
+        out[1] = SDualQuaternion(rotations[1], SQuaternion(z));
+        out[2] = SDualQuaternion(rotations[2], SQuaternion(y));
+        out[3] = SDualQuaternion(rotations[3], SQuaternion(x));
+    }
+}
+
+const SDualQuaternion SDualQuaternion::Identity{};
+
+SDualQuaternion::SDualQuaternion(const SQuaternion& real, const SQuaternion& dual)
+    : real{ real }
+    , dual{ dual }
+{
+}
+
+SDualQuaternion SDualQuaternion::FromTransform(const SQuaternion& rotation, const SVector& translation)
+{
+    SDualQuaternion result;
+    FromTransforms(&rotation, &translation, &result, 1);
+    return result;
+}
+
+void SDualQuaternion::FromTransforms(const SQuaternion* rotations, const SVector* translations, SDualQuaternion* out, size_t count)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SDualQuaternion::FromTransforms");
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        FromTransforms4(rotations + i, translations + i, out + i);
+    }
+    if (i == count)
+    {
+        return;
+    }
+
+    // the tail through the same kernel, padded with identity transforms, so every result has the same arithmetic
+    SQuaternion tail_rotations[4]{ SQuaternion::Identity, SQuaternion::Identity, SQuaternion::Identity, SQuaternion::Identity };
+    SVector tail_translations[4];
+    SDualQuaternion tail[4];
+    std::copy(rotations + i, rotations + count, tail_rotations);
+    std::copy(translations + i, translations + count, tail_translations);
+    FromTransforms4(tail_rotations, tail_translations, tail);
+    std::copy(tail, tail + (count - i), out + i);
+}
+
+SDualQuaternion SDualQuaternion::Blend(const SDualQuaternion* dual_quaternions, const float* weights, size_t count)
+{
+    __m128 real = _mm_setzero_ps(), dual = _mm_setzero_ps();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float sign = (dual_quaternions[i].real | dual_quaternions[0].real) < 0.f ? -1.f : 1.f;
+        const __m128 weight = _mm_set1_ps(sign * weights[i]);
+        real = _mm_add_ps(real, _mm_mul_ps(weight, dual_quaternions[i].real.GetStorage()));
+        dual = _mm_add_ps(dual, _mm_mul_ps(weight, dual_quaternions[i].dual.GetStorage()));
+    }
+    return SDualQuaternion(SQuaternion(real), SQuaternion(dual));
+}
+
+/*            Equality            */
+bool SDualQuaternion::operator==(const SDualQuaternion& rhs) const
+{
+    return real == rhs.real && dual == rhs.dual;
+}
+
+bool SDualQuaternion::operator!=(const SDualQuaternion& rhs) const
+{
+    return !(*this == rhs);
+}
+
+/*            Product            */
+SDualQuaternion& SDualQuaternion::operator*=(const SDualQuaternion& rhs)
+{
+    *this = *this * rhs;
+    return *this;
+}
+
+SDualQuaternion operator*(const SDualQuaternion& lhs, const SDualQuaternion& rhs)
+{
+    // (a + e b)(c + e d) = ac + e (ad + bc), the square of e is zero
+    const SQuaternion real = lhs.real * rhs.real;
+    const SQuaternion dual(_mm_add_ps((lhs.real * rhs.dual).GetStorage(), (lhs.dual * rhs.real).GetStorage()));
+    return SDualQuaternion(real, dual);
+}
+
+/*            Normalization            */
+void SDualQuaternion::Normalize()
+{
+    const __m128 magnitude = _mm_set1_ps(real.Magnitude());
+    real = SQuaternion(_mm_div_ps(real.GetStorage(), magnitude));
+    dual = SQuaternion(_mm_div_ps(dual.GetStorage(), magnitude));
+}
+
+SDualQuaternion SDualQuaternion::Normal() const
+{
+    SDualQuaternion result(*this);
+    result.Normalize();
+    return result;
+}
+
+/*            Transformation            */
+SVector SDualQuaternion::GetTranslation() const
+{
+    // twice the vector part of 'dual * conjugate(real)'
+    const __m128 product = (dual * real.Conjugation()).GetStorage();
+    SVector result;
+    _mm_store_ps(reinterpret_cast<float*>(&result), _mm_move_ss(_mm_add_ps(product, product), _mm_setzero_ps()));
+    return result;
+}
+
+SVector SDualQuaternion::TransformPoint(const SVector& v) const
+{
+    return real.Rotate(v) + GetTranslation();
+}
+
+SVector SDualQuaternion::TransformDirection(const SVector& v) const
+{
+    return real.Rotate(v);
+}
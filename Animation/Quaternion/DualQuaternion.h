@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Quaternion.h"
+
+/*
+* SDualQuaternion is a rigid transform, a rotation followed by a translation, as two quaternions: 'real' is the rotation and
+* 'dual' is half the translation (as a quaternion with W = 0) times the rotation. Unlike matrices, dual quaternions blend
+* without losing volume: the normalized weighted sum of two of them is a screw motion between the transforms, so vertices
+* skinned to a twisting joint keep their distance to the bone where a blend of matrices collapses them.
+* Scale has no place in a dual quaternion, transforms built from poses drop it.
+*/
+struct alignas(16) SDualQuaternion
+{
+    SQuaternion real{ SQuaternion::Identity };
+    SQuaternion dual{ 0.f };
+
+    // identity transform
+    SDualQuaternion() = default;
+    SDualQuaternion(const SQuaternion& real, const SQuaternion& dual);
+
+    const static SDualQuaternion Identity;
+
+    // 'rotation' first, 'translation' second; 'rotation' is a unit quaternion
+    static SDualQuaternion FromTransform(const SQuaternion& rotation, const SVector& translation);
+
+    /*
+    * 'FromTransform' for 'count' transforms given as two arrays, like the rotations and translations of an 'SPose', four at a time
+    * on transposed registers. Results are equal to 'FromTransform' bit for bit.
+    */
+    static void FromTransforms(const SQuaternion* rotations, const SVector* translations, SDualQuaternion* out, size_t count);
+
+    /*
+    * Weighted sum of 'count' dual quaternions, not normalized. Each one is added with the sign that puts its real part in the
+    * hemisphere of the first one, so the blend takes the short way around like 'SPoseBlender' rotations.
+    */
+    static SDualQuaternion Blend(const SDualQuaternion* dual_quaternions, const float* weights, size_t count);
+
+    // Equality
+    bool operator==(const SDualQuaternion& rhs) const;
+
+    // Inequality
+    bool operator!=(const SDualQuaternion& rhs) const;
+
+    // Product, 'lhs * rhs' applies 'rhs' first and 'lhs' second like 'SQuaternion'
+    SDualQuaternion& operator*=(const SDualQuaternion& rhs);
+    friend SDualQuaternion operator*(const SDualQuaternion& lhs, const SDualQuaternion& rhs);
+
+    // Normalization: both parts divided by the magnitude of the real part, a zero real part gives infinities
+    void Normalize();
+    SDualQuaternion Normal() const;
+
+    // transform of a normalized dual quaternion
+    const SQuaternion& GetRotation() const { return real; }
+    SVector GetTranslation() const;
+
+    // 'v' rotated and translated, for a normalized dual quaternion
+    SVector TransformPoint(const SVector& v) const;
+
+    // 'v' rotated, for a normalized dual quaternion
+    SVector TransformDirection(const SVector& v) const;
+};
@@ -1,6 +1,10 @@
 ﻿#include "Quaternion.h"
+#include "QuaternionKernels.h"
 
 #include <immintrin.h>
+#include <cmath>
+
+#include "../Simd/Trigonometry.h"
 
 
 SQuaternion::SQuaternion(float value)
@@ -24,28 +28,131 @@ SQuaternion::SQuaternion(float roll, float pitch, float yaw)
     const __m128 angles = _mm_set_ps(roll, pitch, yaw, 0.f);
     const __m128 halves = _mm_mul_ps(angles, _mm_set_ps1(.5f));
 
-    const union
-    {
-        __m128 v;
-        float angles[4];
-    } cosines = {_mm_cos_ps(halves)};
+    // one shared range reduction for all sines and cosines, no SVML and no round trip through memory
+    __m128 sines, cosines;
+    Simd::SinCos(halves, sines, cosines);
+
+    /*
+    * Every component is a sum of two products of three factors, one factor per angle:
+    *   x = sr * cp * cy - cr * sp * sy
+    *   y = cr * sp * cy + sr * cp * sy
+    *   z = cr * cp * sy - sr * sp * cy
+    *   w = cr * cp * cy + sr * sp * sy
+    * 'cos_sin' holds the cosine of an angle in lane 0 and its sine in lane 3, shuffles spread them into the factors of all components.
+    */
+    const __m128 roll_cos_sin = _mm_shuffle_ps(cosines, sines, _MM_SHUFFLE(ROLL_INDEX, ROLL_INDEX, ROLL_INDEX, ROLL_INDEX));
+    const __m128 pitch_cos_sin = _mm_shuffle_ps(cosines, sines, _MM_SHUFFLE(PITCH_INDEX, PITCH_INDEX, PITCH_INDEX, PITCH_INDEX));
+    const __m128 yaw_cos_sin = _mm_shuffle_ps(cosines, sines, _MM_SHUFFLE(YAW_INDEX, YAW_INDEX, YAW_INDEX, YAW_INDEX));
+
+    const __m128 first = _mm_mul_ps(_mm_mul_ps(
+        _mm_shuffle_ps(roll_cos_sin, roll_cos_sin, _MM_SHUFFLE(3, 0, 0, 0)),
+        _mm_shuffle_ps(pitch_cos_sin, pitch_cos_sin, _MM_SHUFFLE(0, 3, 0, 0))),
+        _mm_shuffle_ps(yaw_cos_sin, yaw_cos_sin, _MM_SHUFFLE(0, 0, 3, 0)));
+
+    const __m128 second = _mm_mul_ps(_mm_mul_ps(
+        _mm_shuffle_ps(roll_cos_sin, roll_cos_sin, _MM_SHUFFLE(0, 3, 3, 3)),
+        _mm_shuffle_ps(pitch_cos_sin, pitch_cos_sin, _MM_SHUFFLE(3, 0, 3, 3))),
+        _mm_shuffle_ps(yaw_cos_sin, yaw_cos_sin, _MM_SHUFFLE(3, 3, 0, 3)));
+
+    // subtracted in X and Z, added in Y and W
+    const __m128 signs = _mm_set_ps(-0.f, 0.f, -0.f, 0.f);
+    storage = _mm_add_ps(first, _mm_xor_ps(second, signs));
+}
+
+
+const SQuaternion SQuaternion::Identity{ 0.f, 0.f, 0.f, 1.f };
+
+/*            Equality            */
+bool SQuaternion::operator==(const SQuaternion& rhs) const
+{
+    const __m128 result = _mm_cmpeq_ps(storage, rhs.storage);
+    return _mm_movemask_ps(result) == 0x0F;
+}
+
+/*            Inequality            */
+bool SQuaternion::operator!=(const SQuaternion& rhs) const
+{
+    return !(*this == rhs);
+}
+
+/*            Hamilton Product            */
+SQuaternion& SQuaternion::operator*=(const SQuaternion& rhs)
+{
+    *this = *this * rhs;
+    return *this;
+}
+
+SQuaternion operator*(const SQuaternion& lhs, const SQuaternion& rhs)
+{
+    return SQuaternion(QuaternionKernels::Multiply(lhs.storage, rhs.storage));
+}
+
+/*            Dot Product            */
+float SQuaternion::operator|(const SQuaternion& rhs) const
+{
+    __m128 value = _mm_mul_ps(storage, rhs.storage);
+    value = _mm_hadd_ps(value, value);  // {w + z, y + x, w + z, y + x}
+    value = _mm_hadd_ps(value, value);  // {w + z + y + x, ...}
+
+    return _mm_cvtss_f32(value);
+}
+
+/*            Magnitude            */
+float SQuaternion::Magnitude() const
+{
+    return sqrtf(SqrMagnitude());
+}
+
+float SQuaternion::SqrMagnitude() const
+{
+    return *this | *this;
+}
+
+/*            Normalization            */
+void SQuaternion::Normalize()
+{
+    storage = _mm_div_ps(storage, _mm_set1_ps(Magnitude()));
+}
 
-    const union
-    {
-        __m128 v;
-        float angles[4];
-    } sines = {_mm_sin_ps(halves)};
+SQuaternion SQuaternion::Normal() const
+{
+    SQuaternion result(*this);
+    result.Normalize();
+    return result;
+}
 
-    components[X_INDEX] = sines.angles[ROLL_INDEX] * cosines.angles[PITCH_INDEX] * cosines.angles[YAW_INDEX] -
-        cosines.angles[ROLL_INDEX] * sines.angles[PITCH_INDEX] * sines.angles[YAW_INDEX];
+/*            Conjugate            */
+void SQuaternion::Conjugate()
+{
+    // flip signs of X, Y and Z, keep W
+    storage = _mm_xor_ps(storage, _mm_set_ps(-0.f, -0.f, -0.f, 0.f));
+}
 
-    components[Y_INDEX] = cosines.angles[ROLL_INDEX] * sines.angles[PITCH_INDEX] * cosines.angles[YAW_INDEX] +
-        sines.angles[ROLL_INDEX] * cosines.angles[PITCH_INDEX] * sines.angles[YAW_INDEX];
+SQuaternion SQuaternion::Conjugation() const
+{
+    SQuaternion result(*this);
+    result.Conjugate();
+    return result;
+}
 
-    components[Z_INDEX] = cosines.angles[ROLL_INDEX] * cosines.angles[PITCH_INDEX] * sines.angles[YAW_INDEX] -
-        sines.angles[ROLL_INDEX] * sines.angles[PITCH_INDEX] * cosines.angles[YAW_INDEX];
+/*            Inverse            */
+void SQuaternion::Invert()
+{
+    const __m128 sqr_magnitude = _mm_set1_ps(SqrMagnitude());
+    Conjugate();
+    storage = _mm_div_ps(storage, sqr_magnitude);
+}
 
-    components[W_INDEX] = cosines.angles[ROLL_INDEX] * cosines.angles[PITCH_INDEX] * cosines.angles[YAW_INDEX] +
-        sines.angles[ROLL_INDEX] * sines.angles[PITCH_INDEX] * sines.angles[YAW_INDEX];
+SQuaternion SQuaternion::Inverse() const
+{
+    SQuaternion result(*this);
+    result.Invert();
+    return result;
 }
 
+/*            Rotation            */
+SVector SQuaternion::Rotate(const SVector& v) const
+{
+    // X, Y and Z of the quaternion share lanes with 'SVector', so its register is the vector part once W is cleared
+    return SVector(QuaternionKernels::Rotate(storage, v.GetStorage()));
+}
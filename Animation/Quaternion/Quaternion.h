@@ -1,7 +1,13 @@
 ﻿#pragma once
 #include <xmmintrin.h>
+#include "../Vector/Vector.h"
 
 
+/*
+* SQuaternion represents a rotation in a 3-Dimensional Space.
+* Components are kept in a single 128bit SIMD register with the same layout as 'SVector': X, Y and Z share lanes with the vector axes,
+* and W takes the lane that 'SVector' leaves unused. Thanks to this, a vector part of the quaternion is a valid 'SVector' register.
+*/
 struct SQuaternion
 {
 private:
@@ -11,6 +17,8 @@ private:
         float components[4];
         __m128 storage{ _mm_setzero_ps() };
     };
+
+public:
     
     // index of X component
     constexpr static size_t X_INDEX{ 3 };
@@ -32,11 +40,54 @@ private:
     
     // index of Yaw component
     constexpr static size_t YAW_INDEX{ 1 };
-
-public:
     
     explicit SQuaternion(float value);
     SQuaternion(float x, float y, float z, float w);
     explicit SQuaternion(const __m128& value);
     SQuaternion(float roll, float pitch, float yaw);
+
+    float GetX() const { return components[X_INDEX]; }
+    float GetY() const { return components[Y_INDEX]; }
+    float GetZ() const { return components[Z_INDEX]; }
+    float GetW() const { return components[W_INDEX]; }
+
+    // 128bit SIMD register of the quaternion
+    const __m128& GetStorage() const { return storage; }
+
+    // rotation by zero angle: (0, 0, 0, 1)
+    const static SQuaternion Identity;
+
+    // Equality
+    bool operator==(const SQuaternion& rhs) const;
+
+    // Inequality
+    bool operator!=(const SQuaternion& rhs) const;
+
+    // Hamilton Product, 'lhs * rhs' applies 'rhs' rotation first and 'lhs' rotation second
+    SQuaternion& operator*=(const SQuaternion& rhs);
+    friend SQuaternion operator*(const SQuaternion& lhs, const SQuaternion& rhs);
+
+    // Dot Product
+    float operator|(const SQuaternion& rhs) const;
+    static float DotProduct(const SQuaternion& lhs, const SQuaternion& rhs) { return lhs | rhs; }
+
+    // Magnitude & Length
+    float Magnitude() const;
+    float Length() const { return Magnitude(); }
+    float SqrMagnitude() const;
+
+    // Normalization
+    void Normalize();
+    SQuaternion Normal() const;
+
+    // Conjugate (-x, -y, -z, w)
+    void Conjugate();
+    SQuaternion Conjugation() const;
+
+    // Inverse, for a unit quaternion it equals to the conjugate
+    void Invert();
+    SQuaternion Inverse() const;
+
+    // rotation of a vector by a unit quaternion
+    SVector Rotate(const SVector& v) const;
 };
@@ -0,0 +1,210 @@
+#include "QuaternionInterpolation.h"
+
+#include "QuaternionKernels.h"
+#include "../Profile/ProfileScope.h"
+#include "../Simd/Simd.h"
+
+namespace
+{
+    using QuaternionKernels::LoadQuaternions;
+    using QuaternionKernels::SQuaternionPack;
+    using QuaternionKernels::StoreQuaternions;
+
+#if defined(__AVX__)
+    // 8 quaternions per iteration with AVX
+    using QuaternionPack = __m256;
+#else
+    // 4 quaternions per iteration with SSE
+    using QuaternionPack = __m128;
+#endif
+
+    constexpr size_t QuaternionPackWidth{ Simd::SPackTraits<QuaternionPack>::Width };
+
+    // arc cosine for [0, 1], Abramowitz and Stegun 4.4.46, absolute error is below 2e-8
+    template <typename TPack>
+    TPack AcosPositive(const TPack& x)
+    {
+        TPack polynomial = Simd::Set<TPack>(-0.0012624911f);
+        polynomial = Simd::Add(Simd::Mul(polynomial, x), Simd::Set<TPack>(0.0066700901f));
+        polynomial = Simd::Add(Simd::Mul(polynomial, x), Simd::Set<TPack>(-0.0170881256f));
+        polynomial = Simd::Add(Simd::Mul(polynomial, x), Simd::Set<TPack>(0.0308918810f));
+        polynomial = Simd::Add(Simd::Mul(polynomial, x), Simd::Set<TPack>(-0.0501743046f));
+        polynomial = Simd::Add(Simd::Mul(polynomial, x), Simd::Set<TPack>(0.0889789874f));
+        polynomial = Simd::Add(Simd::Mul(polynomial, x), Simd::Set<TPack>(-0.2145988016f));
+        polynomial = Simd::Add(Simd::Mul(polynomial, x), Simd::Set<TPack>(1.5707963050f));
+        return Simd::Mul(Simd::Sqrt(Simd::Sub(Simd::Set<TPack>(1.f), x)), polynomial);
+    }
+
+    // sine for [0, Pi / 2], Taylor series up to x^11, absolute error is below 6e-8
+    template <typename TPack>
+    TPack SinQuadrant(const TPack& x)
+    {
+        const TPack x2 = Simd::Mul(x, x);
+        TPack polynomial = Simd::Set<TPack>(-2.5052108e-8f);
+        polynomial = Simd::Add(Simd::Mul(polynomial, x2), Simd::Set<TPack>(2.7557319e-6f));
+        polynomial = Simd::Add(Simd::Mul(polynomial, x2), Simd::Set<TPack>(-1.9841270e-4f));
+        polynomial = Simd::Add(Simd::Mul(polynomial, x2), Simd::Set<TPack>(8.3333333e-3f));
+        polynomial = Simd::Add(Simd::Mul(polynomial, x2), Simd::Set<TPack>(-1.6666667e-1f));
+        polynomial = Simd::Add(Simd::Mul(polynomial, x2), Simd::Set<TPack>(1.f));
+        return Simd::Mul(polynomial, x);
+    }
+
+    /*
+    * Weights of spherical linear interpolation: sin((1 - t) * angle) / sin(angle) and sin(t * angle) / sin(angle).
+    * When quaternions are almost equal the angle is too small for a division, linear weights are selected instead.
+    */
+    struct SSlerpWeights
+    {
+        constexpr static bool Normalize{ false };
+
+        template <typename TPack>
+        static void Compute(const TPack& cosine, const TPack& t, TPack& from_weight, TPack& to_weight)
+        {
+            const TPack one = Simd::Set<TPack>(1.f);
+            const TPack angle = AcosPositive(cosine);
+            const TPack sine = SinQuadrant(angle);
+            const TPack from_slerp = Simd::Div(SinQuadrant(Simd::Mul(Simd::Sub(one, t), angle)), sine);
+            const TPack to_slerp = Simd::Div(SinQuadrant(Simd::Mul(t, angle)), sine);
+
+            const auto is_close = Simd::CmpGt(cosine, Simd::Set<TPack>(0.999999f));
+            from_weight = Simd::Select(is_close, Simd::Sub(one, t), from_slerp);
+            to_weight = Simd::Select(is_close, t, to_slerp);
+        }
+    };
+
+    // weights of linear interpolation, the result is normalized
+    struct SNlerpWeights
+    {
+        constexpr static bool Normalize{ true };
+
+        template <typename TPack>
+        static void Compute(const TPack&, const TPack& t, TPack& from_weight, TPack& to_weight)
+        {
+            from_weight = Simd::Sub(Simd::Set<TPack>(1.f), t);
+            to_weight = t;
+        }
+    };
+
+    /*
+    * Linear interpolation with a corrected blend factor, the result is normalized.
+    * Nlerp moves too slow near the ends and too fast in the middle, a cubic in 't' with coefficients fitted over the cosine
+    * of the angle between quaternions moves 't' towards the slerp angle: t' = t + t * (t - 0.5) * (t - 1) * k.
+    * Coefficients come from the "Approximating slerp" article by Arseny Kapoulkine.
+    */
+    struct SFastSlerpWeights
+    {
+        constexpr static bool Normalize{ true };
+
+        template <typename TPack>
+        static void Compute(const TPack& cosine, const TPack& t, TPack& from_weight, TPack& to_weight)
+        {
+            const TPack d = cosine;
+            TPack a = Simd::Add(Simd::Mul(d, Simd::Set<TPack>(-1.43519f)), Simd::Set<TPack>(3.55645f));
+            a = Simd::Add(Simd::Mul(d, a), Simd::Set<TPack>(-3.2452f));
+            a = Simd::Add(Simd::Mul(d, a), Simd::Set<TPack>(1.0904f));
+            TPack b = Simd::Add(Simd::Mul(d, Simd::Set<TPack>(0.215638f)), Simd::Set<TPack>(-1.06021f));
+            b = Simd::Add(Simd::Mul(d, b), Simd::Set<TPack>(0.848013f));
+
+            const TPack one = Simd::Set<TPack>(1.f);
+            const TPack centered = Simd::Sub(t, Simd::Set<TPack>(0.5f));
+            const TPack k = Simd::Add(Simd::Mul(a, Simd::Mul(centered, centered)), b);
+            const TPack correction = Simd::Mul(Simd::Mul(t, centered), Simd::Mul(Simd::Sub(t, one), k));
+            const TPack corrected = Simd::Add(t, correction);
+
+            from_weight = Simd::Sub(one, corrected);
+            to_weight = corrected;
+        }
+    };
+
+    template <typename TWeights, typename TPack>
+    SQuaternionPack<TPack> Interpolate(const SQuaternionPack<TPack>& from, SQuaternionPack<TPack> to, const TPack& t)
+    {
+        // shortest path: flip the sign of 'to' where the dot product is negative, without a branch
+        const TPack dot = from.Dot(to);
+        const TPack sign = Simd::SignBits(dot);
+        to.axis.x = Simd::Xor(to.axis.x, sign);
+        to.axis.y = Simd::Xor(to.axis.y, sign);
+        to.axis.z = Simd::Xor(to.axis.z, sign);
+        to.w = Simd::Xor(to.w, sign);
+        const TPack cosine = Simd::Min(Simd::Xor(dot, sign), Simd::Set<TPack>(1.f));
+
+        TPack from_weight, to_weight;
+        TWeights::Compute(cosine, t, from_weight, to_weight);
+
+        SQuaternionPack<TPack> result = from * from_weight + to * to_weight;
+        if constexpr (TWeights::Normalize)
+        {
+            const TPack length = Simd::Sqrt(result.Dot(result));
+            result.axis.x = Simd::Div(result.axis.x, length);
+            result.axis.y = Simd::Div(result.axis.y, length);
+            result.axis.z = Simd::Div(result.axis.z, length);
+            result.w = Simd::Div(result.w, length);
+        }
+
+        return result;
+    }
+
+    template <typename TWeights>
+    void InterpolateAll(const SQuaternion* from, const SQuaternion* to, const float* alphas, SQuaternion* out, size_t count)
+    {
+        size_t i = 0;
+        for (; i + QuaternionPackWidth <= count; i += QuaternionPackWidth)
+        {
+            const SQuaternionPack<QuaternionPack> a = LoadQuaternions(from + i, QuaternionPackWidth, QuaternionPack{});
+            const SQuaternionPack<QuaternionPack> b = LoadQuaternions(to + i, QuaternionPackWidth, QuaternionPack{});
+            const QuaternionPack t = Simd::LoadUnaligned<QuaternionPack>(alphas + i);
+            StoreQuaternions(out + i, QuaternionPackWidth, Interpolate<TWeights>(a, b, t));
+        }
+
+        // the tail is padded with identities and zero blend factors
+        if (i < count)
+        {
+            const size_t available = count - i;
+            alignas(32) float tail_alphas[QuaternionPackWidth]{};
+            for (size_t j = 0; j < available; ++j)
+            {
+                tail_alphas[j] = alphas[i + j];
+            }
+
+            const SQuaternionPack<QuaternionPack> a = LoadQuaternions(from + i, available, QuaternionPack{});
+            const SQuaternionPack<QuaternionPack> b = LoadQuaternions(to + i, available, QuaternionPack{});
+            const QuaternionPack t = Simd::Load<QuaternionPack>(tail_alphas);
+            StoreQuaternions(out + i, available, Interpolate<TWeights>(a, b, t));
+        }
+    }
+}
+
+void SQuaternionInterpolation::Slerp(const SQuaternion* from, const SQuaternion* to, const float* alphas, SQuaternion* out, size_t count)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SQuaternionInterpolation::Slerp");
+    InterpolateAll<SSlerpWeights>(from, to, alphas, out, count);
+}
+
+void SQuaternionInterpolation::Nlerp(const SQuaternion* from, const SQuaternion* to, const float* alphas, SQuaternion* out, size_t count)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SQuaternionInterpolation::Nlerp");
+    InterpolateAll<SNlerpWeights>(from, to, alphas, out, count);
+}
+
+void SQuaternionInterpolation::FastSlerp(const SQuaternion* from, const SQuaternion* to, const float* alphas, SQuaternion* out, size_t count)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SQuaternionInterpolation::FastSlerp");
+    InterpolateAll<SFastSlerpWeights>(from, to, alphas, out, count);
+}
+
+void SQuaternionInterpolation::Interpolate(EQuaternionInterpolation method, const SQuaternion* from, const SQuaternion* to,
+                                           const float* alphas, SQuaternion* out, size_t count)
+{
+    switch (method)
+    {
+    case EQuaternionInterpolation::Slerp:
+        Slerp(from, to, alphas, out, count);
+        break;
+    case EQuaternionInterpolation::Nlerp:
+        Nlerp(from, to, alphas, out, count);
+        break;
+    case EQuaternionInterpolation::FastSlerp:
+        FastSlerp(from, to, alphas, out, count);
+        break;
+    }
+}
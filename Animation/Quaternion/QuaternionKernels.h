@@ -0,0 +1,226 @@
+#pragma once
+
+#include "Quaternion.h"
+#include "../Simd/Simd.h"
+
+/*
+* Quaternion and vector arithmetic of the batch passes, in two layouts:
+*   - registers, a quaternion or a vector per register in the lanes of 'SQuaternion' and 'SVector', for passes over joints;
+*   - packs, a register per component and a quaternion or a vector per lane, over any pack type of 'Simd'.
+* 'SQuaternion' itself multiplies and rotates through the register kernels, and the packs repeat their arithmetic in the same order,
+* so a pass in either layout matches a loop over 'SQuaternion::operator*' and 'SQuaternion::Rotate' bit for bit.
+*/
+namespace QuaternionKernels
+{
+    /*            Registers            */
+    // 'SVector::operator^', the unused lane of the result is zero
+    inline __m128 Cross(const __m128& a, const __m128& b)
+    {
+        constexpr int X = SQuaternion::X_INDEX, Y = SQuaternion::Y_INDEX, Z = SQuaternion::Z_INDEX, W = SQuaternion::W_INDEX;
+        const __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(Y, Z, X, W));
+        const __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(Y, Z, X, W));
+        const __m128 c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(Y, Z, X, W));
+    }
+
+    /*
+    * The Hamilton product: each component of 'a' multiplies a permutation of 'b' with its own signs, summed w1 first:
+    *   x: w1 * x2 + x1 * w2 + y1 * z2 - z1 * y2
+    *   y: w1 * y2 - x1 * z2 + y1 * w2 + z1 * x2
+    *   z: w1 * z2 + x1 * y2 - y1 * x2 + z1 * w2
+    *   w: w1 * w2 - x1 * x2 - y1 * y2 - z1 * z2
+    */
+    inline __m128 Multiply(const __m128& a, const __m128& b)
+    {
+        constexpr int X = SQuaternion::X_INDEX, Y = SQuaternion::Y_INDEX, Z = SQuaternion::Z_INDEX, W = SQuaternion::W_INDEX;
+        const __m128 a_x = _mm_shuffle_ps(a, a, _MM_SHUFFLE(X, X, X, X));
+        const __m128 a_y = _mm_shuffle_ps(a, a, _MM_SHUFFLE(Y, Y, Y, Y));
+        const __m128 a_z = _mm_shuffle_ps(a, a, _MM_SHUFFLE(Z, Z, Z, Z));
+        const __m128 a_w = _mm_shuffle_ps(a, a, _MM_SHUFFLE(W, W, W, W));
+
+        // {w2, z2, y2, x2} with signs {+, -, +, -} in {x, y, z, w} lanes
+        const __m128 b_wzyx = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(W, Z, Y, X)), _mm_set_ps(0.f, -0.f, 0.f, -0.f));
+        // {z2, w2, x2, y2} with signs {+, +, -, -}
+        const __m128 b_zwxy = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(Z, W, X, Y)), _mm_set_ps(0.f, 0.f, -0.f, -0.f));
+        // {y2, x2, w2, z2} with signs {-, +, +, -}
+        const __m128 b_yxwz = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(Y, X, W, Z)), _mm_set_ps(-0.f, 0.f, 0.f, -0.f));
+
+        __m128 result = _mm_mul_ps(a_w, b);
+        result = _mm_add_ps(result, _mm_mul_ps(a_x, b_wzyx));
+        result = _mm_add_ps(result, _mm_mul_ps(a_y, b_zwxy));
+        result = _mm_add_ps(result, _mm_mul_ps(a_z, b_yxwz));
+        return result;
+    }
+
+    /*
+    * v' = q * v * q^-1 of a unit quaternion expanded with two cross products instead of a matrix:
+    *   t = 2 * (q.xyz ^ v)
+    *   v' = v + w * t + (q.xyz ^ t)
+    * The unused lane of 'v' is zero and stays zero.
+    */
+    inline __m128 Rotate(const __m128& q, const __m128& v)
+    {
+        constexpr int W = SQuaternion::W_INDEX;
+        const __m128 axis = _mm_move_ss(q, _mm_setzero_ps());
+        const __m128 t = _mm_mul_ps(_mm_set1_ps(2.f), Cross(axis, v));
+        const __m128 w = _mm_shuffle_ps(q, q, _MM_SHUFFLE(W, W, W, W));
+        return _mm_add_ps(_mm_add_ps(v, _mm_mul_ps(w, t)), Cross(axis, t));
+    }
+
+    /*            Packs            */
+    template <typename TPack>
+    struct SVectorPack
+    {
+        TPack x, y, z;
+
+        SVectorPack operator+(const SVectorPack& rhs) const { return {Simd::Add(x, rhs.x), Simd::Add(y, rhs.y), Simd::Add(z, rhs.z)}; }
+        SVectorPack operator-(const SVectorPack& rhs) const { return {Simd::Sub(x, rhs.x), Simd::Sub(y, rhs.y), Simd::Sub(z, rhs.z)}; }
+        SVectorPack operator*(const SVectorPack& rhs) const { return {Simd::Mul(x, rhs.x), Simd::Mul(y, rhs.y), Simd::Mul(z, rhs.z)}; }
+        SVectorPack operator*(const TPack& scale) const { return {Simd::Mul(x, scale), Simd::Mul(y, scale), Simd::Mul(z, scale)}; }
+
+        // (x + y) + z, the order of 'SVectorSoA::Dot'
+        TPack Dot(const SVectorPack& rhs) const
+        {
+            return Simd::Add(Simd::Add(Simd::Mul(x, rhs.x), Simd::Mul(y, rhs.y)), Simd::Mul(z, rhs.z));
+        }
+
+        // 'SVector::operator^'
+        SVectorPack Cross(const SVectorPack& rhs) const
+        {
+            return {Simd::Sub(Simd::Mul(y, rhs.z), Simd::Mul(z, rhs.y)),
+                    Simd::Sub(Simd::Mul(z, rhs.x), Simd::Mul(x, rhs.z)),
+                    Simd::Sub(Simd::Mul(x, rhs.y), Simd::Mul(y, rhs.x))};
+        }
+
+        TPack Magnitude() const { return Simd::Sqrt(Dot(*this)); }
+
+        // lanes of 'if_true' where 'mask' is set and of 'if_false' everywhere else
+        static SVectorPack Select(const typename Simd::SPackTraits<TPack>::Mask& mask, const SVectorPack& if_true, const SVectorPack& if_false)
+        {
+            return {Simd::Select(mask, if_true.x, if_false.x), Simd::Select(mask, if_true.y, if_false.y), Simd::Select(mask, if_true.z, if_false.z)};
+        }
+    };
+
+    template <typename TPack>
+    struct SQuaternionPack
+    {
+        SVectorPack<TPack> axis;
+        TPack w;
+
+        SQuaternionPack operator+(const SQuaternionPack& rhs) const { return {axis + rhs.axis, Simd::Add(w, rhs.w)}; }
+        SQuaternionPack operator*(const TPack& scale) const { return {axis * scale, Simd::Mul(w, scale)}; }
+
+        // (xx + yy) + (zz + ww), the four components as one vector
+        TPack Dot(const SQuaternionPack& rhs) const
+        {
+            return Simd::Add(Simd::Add(Simd::Mul(axis.x, rhs.axis.x), Simd::Mul(axis.y, rhs.axis.y)),
+                             Simd::Add(Simd::Mul(axis.z, rhs.axis.z), Simd::Mul(w, rhs.w)));
+        }
+
+        // 'Multiply' a lane at a time, the products summed in the same order
+        SQuaternionPack operator*(const SQuaternionPack& rhs) const
+        {
+            const SVectorPack<TPack>& a = axis;
+            const SVectorPack<TPack>& b = rhs.axis;
+            return {{Simd::Sub(Simd::Add(Simd::Add(Simd::Mul(w, b.x), Simd::Mul(a.x, rhs.w)), Simd::Mul(a.y, b.z)), Simd::Mul(a.z, b.y)),
+                     Simd::Add(Simd::Add(Simd::Sub(Simd::Mul(w, b.y), Simd::Mul(a.x, b.z)), Simd::Mul(a.y, rhs.w)), Simd::Mul(a.z, b.x)),
+                     Simd::Add(Simd::Sub(Simd::Add(Simd::Mul(w, b.z), Simd::Mul(a.x, b.y)), Simd::Mul(a.y, b.x)), Simd::Mul(a.z, rhs.w))},
+                    Simd::Sub(Simd::Sub(Simd::Sub(Simd::Mul(w, rhs.w), Simd::Mul(a.x, b.x)), Simd::Mul(a.y, b.y)), Simd::Mul(a.z, b.z))};
+        }
+
+        // 'Rotate' a lane at a time: v + w t + axis x t, with t = 2 axis x v
+        SVectorPack<TPack> Rotate(const SVectorPack<TPack>& v) const
+        {
+            const SVectorPack<TPack> t = axis.Cross(v) * Simd::Set<TPack>(2.f);
+            return v + t * w + axis.Cross(t);
+        }
+
+        /*
+        * Images of the unit axes under a unit quaternion, the rows of its rotation matrix in 'SMatrix':
+        *   x axis = (1 - 2 (yy + zz),  2 (xy + wz),      2 (xz - wy))
+        *   y axis = (2 (xy - wz),      1 - 2 (xx + zz),  2 (yz + wx))
+        *   z axis = (2 (xz + wy),      2 (yz - wx),      1 - 2 (xx + yy))
+        */
+        void GetAxes(SVectorPack<TPack> (&axes)[3]) const
+        {
+            const TPack one = Simd::Set<TPack>(1.f);
+            const TPack x2 = Simd::Add(axis.x, axis.x), y2 = Simd::Add(axis.y, axis.y), z2 = Simd::Add(axis.z, axis.z);
+            const TPack xx = Simd::Mul(axis.x, x2), yy = Simd::Mul(axis.y, y2), zz = Simd::Mul(axis.z, z2);
+            const TPack xy = Simd::Mul(axis.x, y2), xz = Simd::Mul(axis.x, z2), yz = Simd::Mul(axis.y, z2);
+            const TPack wx = Simd::Mul(w, x2), wy = Simd::Mul(w, y2), wz = Simd::Mul(w, z2);
+            axes[0] = {Simd::Sub(one, Simd::Add(yy, zz)), Simd::Add(xy, wz), Simd::Sub(xz, wy)};
+            axes[1] = {Simd::Sub(xy, wz), Simd::Sub(one, Simd::Add(xx, zz)), Simd::Add(yz, wx)};
+            axes[2] = {Simd::Add(xz, wy), Simd::Sub(yz, wx), Simd::Sub(one, Simd::Add(xx, yy))};
+        }
+    };
+
+    /*            Loads and Stores            */
+    // 'available' quaternions, quaternion 'i' in lane 'i' and identities in the lanes past them, the tag picks the pack type
+    inline SQuaternionPack<__m128> LoadQuaternions(const SQuaternion* quaternions, size_t available, __m128)
+    {
+        __m128 rows[4];
+        for (size_t i = 0; i < 4; ++i)
+        {
+            rows[i] = i < available ? quaternions[i].GetStorage() : SQuaternion::Identity.GetStorage();
+        }
+
+        // rows are {W, Z, Y, X}, after the transpose every register keeps one component of four quaternions
+        Simd::Transpose4(rows[0], rows[1], rows[2], rows[3]);
+        return {{rows[SQuaternion::X_INDEX], rows[SQuaternion::Y_INDEX], rows[SQuaternion::Z_INDEX]}, rows[SQuaternion::W_INDEX]};
+    }
+
+    // the first 'available' lanes of 'pack'
+    inline void StoreQuaternions(SQuaternion* quaternions, size_t available, const SQuaternionPack<__m128>& pack)
+    {
+        __m128 rows[4];
+        rows[SQuaternion::X_INDEX] = pack.axis.x;
+        rows[SQuaternion::Y_INDEX] = pack.axis.y;
+        rows[SQuaternion::Z_INDEX] = pack.axis.z;
+        rows[SQuaternion::W_INDEX] = pack.w;
+        Simd::Transpose4(rows[0], rows[1], rows[2], rows[3]);
+
+        for (size_t i = 0; i < 4 && i < available; ++i)
+        {
+            quaternions[i] = SQuaternion(rows[i]);
+        }
+    }
+
+#if defined(__AVX__)
+    // quaternion 'i' goes to the lower half of row 'i' and quaternion 'i + 4' to the upper half, so lane 'i' holds quaternion 'i'
+    inline SQuaternionPack<__m256> LoadQuaternions(const SQuaternion* quaternions, size_t available, __m256)
+    {
+        __m256 rows[4];
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const __m128 lower = i < available ? quaternions[i].GetStorage() : SQuaternion::Identity.GetStorage();
+            const __m128 upper = i + 4 < available ? quaternions[i + 4].GetStorage() : SQuaternion::Identity.GetStorage();
+            rows[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(lower), upper, 1);
+        }
+
+        Simd::Transpose4(rows[0], rows[1], rows[2], rows[3]);
+        return {{rows[SQuaternion::X_INDEX], rows[SQuaternion::Y_INDEX], rows[SQuaternion::Z_INDEX]}, rows[SQuaternion::W_INDEX]};
+    }
+
+    inline void StoreQuaternions(SQuaternion* quaternions, size_t available, const SQuaternionPack<__m256>& pack)
+    {
+        __m256 rows[4];
+        rows[SQuaternion::X_INDEX] = pack.axis.x;
+        rows[SQuaternion::Y_INDEX] = pack.axis.y;
+        rows[SQuaternion::Z_INDEX] = pack.axis.z;
+        rows[SQuaternion::W_INDEX] = pack.w;
+        Simd::Transpose4(rows[0], rows[1], rows[2], rows[3]);
+
+        for (size_t i = 0; i < 4; ++i)
+        {
+            if (i < available)
+            {
+                quaternions[i] = SQuaternion(_mm256_castps256_ps128(rows[i]));
+            }
+            if (i + 4 < available)
+            {
+                quaternions[i + 4] = SQuaternion(_mm256_extractf128_ps(rows[i], 1));
+            }
+        }
+    }
+#endif
+}
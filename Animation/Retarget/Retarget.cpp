@@ -0,0 +1,303 @@
+#include "Retarget.h"
+
+#include "../Clip/ClipFile.h"
+#include "../Profile/ProfileScope.h"
+#include "../Skeleton/Skeleton.h"
+
+#include <algorithm>
+#include <cassert>
+#include <xmmintrin.h>
+
+namespace
+{
+    // shorter source bones take a proportion of 1
+    constexpr float MinProportionLength{ 1e-6f };
+
+    using SRetargetVectors = QuaternionKernels::SVectorPack<__m128>;
+    using SRetargetRotations = QuaternionKernels::SQuaternionPack<__m128>;
+
+    // quaternions of four bones to a register per component
+    SRetargetRotations TransposeRotations(const SQuaternion& q0, const SQuaternion& q1, const SQuaternion& q2, const SQuaternion& q3)
+    {
+        __m128 w = q0.GetStorage(), z = q1.GetStorage(), y = q2.GetStorage(), x = q3.GetStorage();
+        Simd::Transpose4(w, z, y, x);
+        return { { x, y, z }, w };
+    }
+
+    SRetargetVectors TransposeVectors(const SVector& v0, const SVector& v1, const SVector& v2, const SVector& v3)
+    {
+        __m128 u = v0.GetStorage(), z = v1.GetStorage(), y = v2.GetStorage(), x = v3.GetStorage();
+        Simd::Transpose4(u, z, y, x);
+        return { x, y, z };
+    }
+
+    // a vector or a quaternion is its register and nothing else, so a store writes the whole object
+    template <typename T>
+    inline void StoreRetargeted(T& out, const __m128& value)
+    {
+        _mm_store_ps(reinterpret_cast<float*>(&out), value);
+    }
+
+    // rotation of the parent of 'joint' in 'model', the identity for a root
+    SQuaternion ParentRotation(const SSkeleton& skeleton, const SPose& model, size_t joint)
+    {
+        const int16_t parent = skeleton.GetParent(joint);
+        return parent == SSkeleton::NoParent ? SQuaternion::Identity : model.GetRotations()[parent];
+    }
+
+    // keys of the track of 'joint' in 'channel' through 'convert', or one key at zero of 'convert(fallback)' for a joint without keys
+    template <typename TValue, typename TConvert, typename TSet>
+    void RetargetTrack(const SClipChannel<TValue>& channel, size_t joint, const TValue& fallback, const TConvert& convert, const TSet& set)
+    {
+        const SClipTrack& track = channel.tracks[joint];
+        if (track.count == 0)
+        {
+            const float time = 0.f;
+            const TValue value = convert(fallback);
+            set(&time, &value, 1);
+            return;
+        }
+
+        std::vector<TValue> values;
+        values.reserve(track.count);
+        for (uint32_t key = 0; key < track.count; ++key)
+        {
+            values.push_back(convert(channel.values[track.first + key]));
+        }
+        set(channel.times.data() + track.first, values.data(), values.size());
+    }
+}
+
+SRetargetMap::SRetargetMap(const SSkeleton& source, const SPose& source_rest, const SSkeleton& target, const SPose& target_rest)
+    : target_rest(target_rest)
+{
+    std::vector<SRetargetBone> bones;
+    for (size_t joint = 0; joint < target.GetJointCount(); ++joint)
+    {
+        const size_t source_joint = source.FindJoint(target.GetName(joint));
+        if (source_joint < source.GetJointCount())
+        {
+            const bool is_root = target.GetParent(joint) == SSkeleton::NoParent;
+            bones.push_back({joint, source_joint, is_root ? ERetargetTranslation::Offset : ERetargetTranslation::Rest});
+        }
+    }
+    Build(source, source_rest, target, bones);
+}
+
+SRetargetMap::SRetargetMap(const SSkeleton& source, const SPose& source_rest, const SSkeleton& target, const SPose& target_rest,
+                           const std::vector<SRetargetBone>& bones)
+    : target_rest(target_rest)
+{
+    Build(source, source_rest, target, bones);
+}
+
+void SRetargetMap::Build(const SSkeleton& source, const SPose& source_rest, const SSkeleton& target, const std::vector<SRetargetBone>& bones)
+{
+    const size_t target_joint_count = target.GetJointCount();
+    source_joint_count = source.GetJointCount();
+    sources.assign(target_joint_count, NoSource);
+
+    is_valid = source.IsValid() && target.IsValid() && source_rest.Size() == source_joint_count && target_rest.Size() == target_joint_count;
+    for (const SRetargetBone& bone : bones)
+    {
+        is_valid = is_valid && bone.target < target_joint_count && bone.source < source_joint_count && sources[bone.target] == NoSource;
+        if (!is_valid)
+        {
+            break;
+        }
+        sources[bone.target] = static_cast<int16_t>(bone.source);
+    }
+    if (!is_valid)
+    {
+        sources.clear();
+        return;
+    }
+
+    SPose source_model;
+    SPose target_model;
+    source.LocalToModel(source_rest, source_model);
+    target.LocalToModel(target_rest, target_model);
+
+    std::vector<SRetargetBone> sorted = bones;
+    std::sort(sorted.begin(), sorted.end(), [](const SRetargetBone& lhs, const SRetargetBone& rhs) { return lhs.target < rhs.target; });
+
+    for (const SRetargetBone& bone : sorted)
+    {
+        const SVector& source_translation = source_rest.GetTranslations()[bone.source];
+        const SVector& target_translation = target_rest.GetTranslations()[bone.target];
+
+        // parent frames of the rest poses, and joint frames, of the source to the ones of the target
+        const SQuaternion pre = ParentRotation(target, target_model, bone.target).Conjugation() * ParentRotation(source, source_model, bone.source);
+        const SQuaternion post = source_model.GetRotations()[bone.source].Conjugation() * target_model.GetRotations()[bone.target];
+
+        float proportion = bone.proportion;
+        if (proportion == SRetargetBone::AutomaticProportion)
+        {
+            const float source_length = source_translation.Length();
+            proportion = source_length > MinProportionLength ? target_translation.Length() / source_length : 1.f;
+        }
+
+        SVector offset;
+        switch (bone.translation)
+        {
+        case ERetargetTranslation::Rest:
+            proportion = 0.f;
+            offset = target_translation;
+            break;
+        case ERetargetTranslation::Scaled:
+            break;
+        case ERetargetTranslation::Offset:
+            offset = target_translation - SVector(proportion) * pre.Rotate(source_translation);
+            break;
+        }
+
+        bone_targets.push_back(static_cast<int16_t>(bone.target));
+        bone_sources.push_back(static_cast<int16_t>(bone.source));
+        pre_rotations.push_back(pre);
+        post_rotations.push_back(post);
+        translation_offsets.push_back(offset);
+        proportions.push_back(SVector(proportion));
+        scale_factors.push_back(target_rest.GetScales()[bone.target] / source_rest.GetScales()[bone.source]);
+    }
+
+    const size_t bone_count = bone_targets.size();
+    bone_groups.resize((bone_count + BoneGroupSize - 1) / BoneGroupSize);
+    for (size_t first = 0; first < bone_count; first += BoneGroupSize)
+    {
+        const size_t last = std::min(first + BoneGroupSize, bone_count) - 1;
+        const size_t b0 = first, b1 = std::min(first + 1, last), b2 = std::min(first + 2, last), b3 = std::min(first + 3, last);
+        SBoneGroup& group = bone_groups[first / BoneGroupSize];
+        group.pre = TransposeRotations(pre_rotations[b0], pre_rotations[b1], pre_rotations[b2], pre_rotations[b3]);
+        group.post = TransposeRotations(post_rotations[b0], post_rotations[b1], post_rotations[b2], post_rotations[b3]);
+        group.offset = TransposeVectors(translation_offsets[b0], translation_offsets[b1], translation_offsets[b2], translation_offsets[b3]);
+        group.proportion = _mm_set_ps(proportions[b3].GetX(), proportions[b2].GetX(), proportions[b1].GetX(), proportions[b0].GetX());
+    }
+}
+
+/*            Poses            */
+void SRetargetMap::Retarget(const SPose& source, SPose& target) const
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SRetargetMap::Retarget");
+    assert(is_valid && source.Size() == source_joint_count && &source != &target);
+
+    // joints without a bone keep their rest transforms
+    const size_t bone_count = bone_targets.size();
+    if (bone_count < sources.size())
+    {
+        target = target_rest;
+    }
+    else
+    {
+        target.Resize(sources.size());
+    }
+
+    const SVector* source_translations = source.GetTranslations();
+    const SQuaternion* source_rotations = source.GetRotations();
+    const SVector* source_scales = source.GetScales();
+    SVector* target_translations = target.GetTranslations();
+    SQuaternion* target_rotations = target.GetRotations();
+    SVector* target_scales = target.GetScales();
+
+    for (size_t first = 0; first < bone_count; first += BoneGroupSize)
+    {
+        const SBoneGroup& group = bone_groups[first / BoneGroupSize];
+        const size_t lane_count = std::min(BoneGroupSize, bone_count - first);
+        const size_t last = first + lane_count - 1;
+        const int16_t from[BoneGroupSize]{ bone_sources[first], bone_sources[std::min(first + 1, last)], bone_sources[std::min(first + 2, last)],
+                                           bone_sources[std::min(first + 3, last)] };
+
+        // the same products as 'Retarget(const SClip&)' on a bone per lane
+        const SRetargetRotations source_rotation = TransposeRotations(source_rotations[from[0]], source_rotations[from[1]],
+                                                                      source_rotations[from[2]], source_rotations[from[3]]);
+        const SRetargetVectors source_translation = TransposeVectors(source_translations[from[0]], source_translations[from[1]],
+                                                                     source_translations[from[2]], source_translations[from[3]]);
+        const SRetargetRotations rotation = group.pre * source_rotation * group.post;
+        const SRetargetVectors translation = group.offset + group.pre.Rotate(source_translation) * group.proportion;
+
+        __m128 rotations[BoneGroupSize]{ rotation.w, rotation.axis.z, rotation.axis.y, rotation.axis.x };
+        Simd::Transpose4(rotations[0], rotations[1], rotations[2], rotations[3]);
+        __m128 translations[BoneGroupSize]{ _mm_setzero_ps(), translation.z, translation.y, translation.x };
+        Simd::Transpose4(translations[0], translations[1], translations[2], translations[3]);
+
+        for (size_t lane = 0; lane < lane_count; ++lane)
+        {
+            const size_t bone = first + lane;
+            const int16_t to = bone_targets[bone];
+            StoreRetargeted(target_translations[to], translations[lane]);
+            StoreRetargeted(target_rotations[to], rotations[lane]);
+            StoreRetargeted(target_scales[to], _mm_mul_ps(scale_factors[bone].GetStorage(), source_scales[from[lane]].GetStorage()));
+        }
+    }
+}
+
+void SRetargetMap::Retarget(const SPose* sources, SPose* targets, size_t count) const
+{
+    ANIMATION_PROFILE_SCOPE("SRetargetMap::Retarget");
+    for (size_t i = 0; i < count; ++i)
+    {
+        Retarget(sources[i], targets[i]);
+    }
+}
+
+/*            Clips            */
+SClip SRetargetMap::Retarget(const SClip& clip) const
+{
+    assert(is_valid && clip.GetJointCount() == source_joint_count);
+
+    const size_t joint_count = sources.size();
+    SClip out(joint_count, clip.GetDuration());
+    const auto set_translations = [&](size_t joint)
+    {
+        return [&out, joint](const float* times, const SVector* values, size_t count) { out.SetTranslations(joint, times, values, count); };
+    };
+    const auto set_rotations = [&](size_t joint)
+    {
+        return [&out, joint](const float* times, const SQuaternion* values, size_t count) { out.SetRotations(joint, times, values, count); };
+    };
+    const auto set_scales = [&](size_t joint)
+    {
+        return [&out, joint](const float* times, const SVector* values, size_t count) { out.SetScales(joint, times, values, count); };
+    };
+
+    const float zero_time = 0.f;
+    size_t bone = 0;
+    for (size_t joint = 0; joint < joint_count; ++joint)
+    {
+        if (sources[joint] == NoSource)
+        {
+            out.SetTranslations(joint, &zero_time, &target_rest.GetTranslations()[joint], 1);
+            out.SetRotations(joint, &zero_time, &target_rest.GetRotations()[joint], 1);
+            out.SetScales(joint, &zero_time, &target_rest.GetScales()[joint], 1);
+            continue;
+        }
+
+        const size_t source = static_cast<size_t>(bone_sources[bone]);
+        const SQuaternion& pre = pre_rotations[bone];
+        const SQuaternion& post = post_rotations[bone];
+        const SVector& offset = translation_offsets[bone];
+        const SVector& proportion = proportions[bone];
+        const SVector& scale_factor = scale_factors[bone];
+
+        // a translation that doesn't follow the source is one key
+        if (proportion.IsZero())
+        {
+            out.SetTranslations(joint, &zero_time, &offset, 1);
+        }
+        else
+        {
+            RetargetTrack(clip.GetTranslations(), source, SVector::ZeroVector,
+                          [&](const SVector& value) { return offset + proportion * pre.Rotate(value); }, set_translations(joint));
+        }
+        RetargetTrack(clip.GetRotations(), source, SQuaternion::Identity,
+                      [&](const SQuaternion& value) { return pre * value * post; }, set_rotations(joint));
+        RetargetTrack(clip.GetScales(), source, SVector(1.f),
+                      [&](const SVector& value) { return scale_factor * value; }, set_scales(joint));
+        ++bone;
+    }
+    return out;
+}
+
+ETrackFileStatus SRetargetMap::Bake(const SClip& clip, const char* path) const
+{
+    return SClipFile::Write(Retarget(clip), path);
+}
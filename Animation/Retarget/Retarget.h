@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Clip/Clip.h"
+#include "../Quaternion/QuaternionKernels.h"
+#include "../Skeleton/Pose.h"
+#include "../Track/TrackFile.h"
+
+struct SSkeleton;
+
+// where a retargeted joint gets its translation from
+enum class ERetargetTranslation : uint8_t
+{
+    // the rest translation of the target joint, bones keep the lengths of the target
+    Rest,
+    // the source translation scaled by the proportion
+    Scaled,
+    // the rest translation of the target plus the motion of the source away from its rest translation, scaled by the proportion
+    Offset,
+};
+
+// a target joint driven by a source joint
+struct SRetargetBone
+{
+    // proportion of a bone from the rest translations: target length over source length
+    constexpr static float AutomaticProportion{ 0.f };
+
+    size_t target{ 0 };
+    size_t source{ 0 };
+    ERetargetTranslation translation{ ERetargetTranslation::Rest };
+    float proportion{ AutomaticProportion };
+};
+
+/*
+* SRetargetMap moves the animation of one skeleton onto another with other proportions and other joint frames.
+* A bone takes the rotation of its source joint away from the source rest pose, in model space, and applies it to the target rest pose:
+*   rotation    = pre * source.rotation * post
+*   translation = offset + proportion * pre.Rotate(source.translation)
+*   scale       = scale_factor * source.scale
+* where 'pre' takes the parent frame of the source rest pose to the parent frame of the target rest pose, 'post' the source joint frame
+* to the target joint frame, and the translation mode sets 'offset' and 'proportion'. The rotation is exact when the parents of both
+* joints are bones of each other, or both roots; a chain with joints only one skeleton has moves as if they kept their rest rotations.
+* Target joints without a bone keep their rest transforms. Every constant is computed once, when the map is built, and kept as
+* arrays of bones sorted by target joint, and again as groups of four bones with a register per component. Retargeting a pose
+* is one sweep over the groups: the source transforms of four bones are gathered and transposed, the two quaternion products and
+* the rotation run on the four at once, and the results are transposed back. A library of clips can be retargeted once offline
+* with 'Retarget(const SClip&)' and baked to a track file with 'Bake'.
+*/
+struct SRetargetMap
+{
+    // source joint of a target joint without a bone
+    constexpr static int16_t NoSource{ -1 };
+
+    SRetargetMap() = default;
+
+    /*
+    * Bones between joints of the same name; target roots take 'Offset' translations, so the character moves with the source
+    * scaled to its size, and other joints keep their rest translations. Rest poses are local poses of the skeletons.
+    */
+    SRetargetMap(const SSkeleton& source, const SPose& source_rest, const SSkeleton& target, const SPose& target_rest);
+
+    // 'IsValid' is false when a joint of 'bones' is out of range or a target joint has two bones
+    SRetargetMap(const SSkeleton& source, const SPose& source_rest, const SSkeleton& target, const SPose& target_rest,
+                 const std::vector<SRetargetBone>& bones);
+
+    bool IsValid() const { return is_valid; }
+    size_t GetSourceJointCount() const { return source_joint_count; }
+    size_t GetTargetJointCount() const { return sources.size(); }
+    size_t GetBoneCount() const { return bone_targets.size(); }
+
+    // source joint of 'target_joint', 'NoSource' when it keeps its rest transform
+    int16_t GetSource(size_t target_joint) const { return sources[target_joint]; }
+    const SPose& GetTargetRest() const { return target_rest; }
+
+    // local pose of the source skeleton to a local pose of the target skeleton, 'target' is resized and must not be 'source'
+    void Retarget(const SPose& source, SPose& target) const;
+
+    // the stage for many characters, 'sources[i]' to 'targets[i]', a pose at a time through the four bone kernel
+    void Retarget(const SPose* sources, SPose* targets, size_t count) const;
+
+    /*
+    * Key by key retargeting of a clip of the source skeleton: the rules are linear in the keys, so the clip samples as the retargeted
+    * samples of 'clip', within rounding. A bone track keeps the key times of its source track, a source track without keys
+    * becomes one key of the retargeted identity transform, and target joints without a bone get one key of their rest transform.
+    */
+    SClip Retarget(const SClip& clip) const;
+
+    // the offline mode: 'Retarget(clip)' written to 'path' with 'SClipFile'
+    ETrackFileStatus Bake(const SClip& clip, const char* path) const;
+
+private:
+    // bones of a group of the pose kernel
+    constexpr static size_t BoneGroupSize{ 4 };
+
+    // constants of four bones, a bone per lane; a partial last group repeats its last bone
+    struct SBoneGroup
+    {
+        QuaternionKernels::SQuaternionPack<__m128> pre;
+        QuaternionKernels::SQuaternionPack<__m128> post;
+        QuaternionKernels::SVectorPack<__m128> offset;
+        __m128 proportion;
+    };
+
+    void Build(const SSkeleton& source, const SPose& source_rest, const SSkeleton& target, const std::vector<SRetargetBone>& bones);
+
+    // per bone, sorted by target joint
+    std::vector<int16_t> bone_targets;
+    std::vector<int16_t> bone_sources;
+    std::vector<SQuaternion> pre_rotations;
+    std::vector<SQuaternion> post_rotations;
+    std::vector<SVector> translation_offsets;
+    // the proportion in every used lane
+    std::vector<SVector> proportions;
+    std::vector<SVector> scale_factors;
+    std::vector<SBoneGroup> bone_groups;
+
+    // per target joint
+    std::vector<int16_t> sources;
+    SPose target_rest;
+    size_t source_joint_count{ 0 };
+    bool is_valid{ false };
+};
@@ -0,0 +1,88 @@
+#include "CpuFeatures.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace
+{
+    struct SCpuidRegisters
+    {
+        unsigned eax{ 0 };
+        unsigned ebx{ 0 };
+        unsigned ecx{ 0 };
+        unsigned edx{ 0 };
+    };
+
+    SCpuidRegisters Cpuid(unsigned leaf, unsigned subleaf)
+    {
+        SCpuidRegisters registers;
+#if defined(_MSC_VER)
+        int values[4];
+        __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+        registers = {static_cast<unsigned>(values[0]), static_cast<unsigned>(values[1]), static_cast<unsigned>(values[2]), static_cast<unsigned>(values[3])};
+#else
+        __cpuid_count(leaf, subleaf, registers.eax, registers.ebx, registers.ecx, registers.edx);
+#endif
+        return registers;
+    }
+
+    // XCR0, the register states the operating system saves
+    unsigned long long ExtendedControlRegister()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        unsigned eax, edx;
+        __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+    }
+
+    bool Bit(unsigned value, unsigned index)
+    {
+        return ((value >> index) & 1u) != 0;
+    }
+}
+
+const SCpuFeatures& SCpuFeatures::Get()
+{
+    static const SCpuFeatures features = Detect();
+    return features;
+}
+
+SCpuFeatures SCpuFeatures::Detect()
+{
+    SCpuFeatures features;
+
+    const unsigned max_leaf = Cpuid(0, 0).eax;
+    if (max_leaf < 1)
+    {
+        return features;
+    }
+
+    const SCpuidRegisters leaf1 = Cpuid(1, 0);
+    features.sse3 = Bit(leaf1.ecx, 0);
+    features.ssse3 = Bit(leaf1.ecx, 9);
+    features.sse41 = Bit(leaf1.ecx, 19);
+    features.sse42 = Bit(leaf1.ecx, 20);
+
+    // XMM and YMM states must be enabled by the OS (OSXSAVE, XCR0 bits 1 and 2), otherwise AVX instructions fault
+    const bool os_saves_ymm = Bit(leaf1.ecx, 27) && (ExtendedControlRegister() & 0x6) == 0x6;
+    // opmask and ZMM states, XCR0 bits 5, 6 and 7
+    const bool os_saves_zmm = os_saves_ymm && (ExtendedControlRegister() & 0xE0) == 0xE0;
+
+    features.avx = os_saves_ymm && Bit(leaf1.ecx, 28);
+    features.fma = os_saves_ymm && Bit(leaf1.ecx, 12);
+
+    if (max_leaf >= 7)
+    {
+        const SCpuidRegisters leaf7 = Cpuid(7, 0);
+        features.avx2 = os_saves_ymm && Bit(leaf7.ebx, 5);
+        features.avx512f = os_saves_zmm && Bit(leaf7.ebx, 16);
+    }
+
+    return features;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+/*
+* Instruction sets of the running CPU, detected once with 'cpuid'.
+* A binary built for a baseline instruction set uses it to switch to faster code paths on newer CPUs.
+* AVX, FMA and AVX-512 are reported only when the operating system saves their registers on a context switch.
+*/
+struct SCpuFeatures
+{
+    bool sse3{ false };
+    bool ssse3{ false };
+    bool sse41{ false };
+    bool sse42{ false };
+    bool avx{ false };
+    bool avx2{ false };
+    bool fma{ false };
+    bool avx512f{ false };
+
+    // features of this CPU, detected on the first call
+    static const SCpuFeatures& Get();
+
+private:
+    static SCpuFeatures Detect();
+};
+
+// compiles a function for an instruction set above the build flags, callers check 'SCpuFeatures' before calling it
+#if defined(_MSC_VER) && !defined(__clang__)
+#define ANIMATION_TARGET(isa)
+#else
+#define ANIMATION_TARGET(isa) __attribute__((target(isa)))
+#endif
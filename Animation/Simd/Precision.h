@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cfloat>
+
+#include "Simd.h"
+
+/*
+* Precision policies of magnitudes and normalization, a template argument of 'SVector' and 'SVectorSoA' methods.
+* A policy turns a squared magnitude into a factor once and applies it to every component, so vector types only sum squares.
+*
+*  - SPrecisionExact:       'sqrt' and a division, correctly rounded, the behaviour of the methods without a policy;
+*  - SPrecisionFast:        'rsqrt' refined with one Newton-Raphson step and a multiplication, relative error below 3.5e-7 (3 ULP of 1);
+*  - SPrecisionApproximate: 'rsqrt' alone, relative error below 3.5e-4 (6.1e-5 with AVX-512), for shading and debug drawing.
+*
+* 'rsqrt' treats denormal inputs as zero, so Fast and Approximate normalize only vectors with a squared magnitude above FLT_MIN.
+* Safe methods compare the squared magnitude with 'MinSqrMagnitude' and keep smaller vectors unchanged, without a branch.
+*/
+struct SPrecisionExact
+{
+    // vectors with a squared magnitude up to this value are zero for safe methods
+    constexpr static float MinSqrMagnitude{ 0.f };
+
+    // magnitude, components are divided by it
+    template <typename TPack>
+    static TPack NormalizationFactor(const TPack& sqr_magnitude) { return Simd::Sqrt(sqr_magnitude); }
+
+    template <typename TPack>
+    static TPack Normalize(const TPack& component, const TPack& factor) { return Simd::Div(component, factor); }
+
+    template <typename TPack>
+    static TPack Magnitude(const TPack& sqr_magnitude) { return Simd::Sqrt(sqr_magnitude); }
+};
+
+struct SPrecisionFast
+{
+    constexpr static float MinSqrMagnitude{ FLT_MIN };
+
+    // reciprocal of the magnitude: y = y0 * (1.5 - 0.5 * x * y0 * y0) roughly doubles the correct bits of y0
+    template <typename TPack>
+    static TPack NormalizationFactor(const TPack& sqr_magnitude)
+    {
+        const TPack estimate = Simd::Rsqrt(sqr_magnitude);
+        const TPack half_x = Simd::Mul(sqr_magnitude, Simd::Set<TPack>(0.5f));
+        const TPack correction = Simd::Sub(Simd::Set<TPack>(1.5f), Simd::Mul(Simd::Mul(half_x, estimate), estimate));
+        return Simd::Mul(estimate, correction);
+    }
+
+    template <typename TPack>
+    static TPack Normalize(const TPack& component, const TPack& factor) { return Simd::Mul(component, factor); }
+
+    // x * rsqrt(x), zero for zero instead of 0 * inf
+    template <typename TPack>
+    static TPack Magnitude(const TPack& sqr_magnitude)
+    {
+        const auto is_positive = Simd::CmpGt(sqr_magnitude, Simd::Set<TPack>(MinSqrMagnitude));
+        return Simd::Select(is_positive, Simd::Mul(sqr_magnitude, NormalizationFactor(sqr_magnitude)), Simd::Zero<TPack>());
+    }
+};
+
+struct SPrecisionApproximate
+{
+    constexpr static float MinSqrMagnitude{ FLT_MIN };
+
+    template <typename TPack>
+    static TPack NormalizationFactor(const TPack& sqr_magnitude) { return Simd::Rsqrt(sqr_magnitude); }
+
+    template <typename TPack>
+    static TPack Normalize(const TPack& component, const TPack& factor) { return Simd::Mul(component, factor); }
+
+    template <typename TPack>
+    static TPack Magnitude(const TPack& sqr_magnitude)
+    {
+        const auto is_positive = Simd::CmpGt(sqr_magnitude, Simd::Set<TPack>(MinSqrMagnitude));
+        return Simd::Select(is_positive, Simd::Mul(sqr_magnitude, Simd::Rsqrt(sqr_magnitude)), Simd::Zero<TPack>());
+    }
+};
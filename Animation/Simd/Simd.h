@@ -0,0 +1,273 @@
+#pragma once
+
+#include <immintrin.h>
+#include <cmath>
+#include <cstddef>
+
+// fused multiply-add instructions: FMA3 of x86-64-v3, implied by AVX-512; MSVC defines only '__AVX2__' for '/arch:AVX2'
+#if defined(__FMA__) || defined(__AVX512F__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define ANIMATION_SIMD_FMA
+#endif
+
+/*
+* Thin overloads over SSE, AVX and AVX-512 registers, so batch kernels can be written once as a template over a pack type.
+* 'Simd::FloatPack' is the widest register enabled by the compiler flags: __m512 (16 floats), __m256 (8 floats) or __m128 (4 floats).
+* Every overload maps to one or two intrinsics, the optimizer sees through them completely.
+*/
+namespace Simd
+{
+    template <typename TPack>
+    struct SPackTraits;
+
+    template <>
+    struct SPackTraits<__m128>
+    {
+        // number of floats in a register
+        constexpr static size_t Width{ 4 };
+        // result type of comparisons
+        using Mask = __m128;
+    };
+
+    /*            SSE            */
+    inline __m128 Load(const float* source, __m128) { return _mm_load_ps(source); }
+    inline __m128 LoadUnaligned(const float* source, __m128) { return _mm_loadu_ps(source); }
+    inline void Store(float* destination, const __m128& value) { _mm_store_ps(destination, value); }
+    inline void StoreUnaligned(float* destination, const __m128& value) { _mm_storeu_ps(destination, value); }
+    inline __m128 Set(const float& value, __m128) { return _mm_set1_ps(value); }
+    inline __m128 Zero(__m128) { return _mm_setzero_ps(); }
+
+    inline __m128 Add(const __m128& lhs, const __m128& rhs) { return _mm_add_ps(lhs, rhs); }
+    inline __m128 Sub(const __m128& lhs, const __m128& rhs) { return _mm_sub_ps(lhs, rhs); }
+    inline __m128 Mul(const __m128& lhs, const __m128& rhs) { return _mm_mul_ps(lhs, rhs); }
+    inline __m128 Div(const __m128& lhs, const __m128& rhs) { return _mm_div_ps(lhs, rhs); }
+    // a * b + c, a * b - c and c - a * b: rounded once with FMA, a rounded product and a rounded sum without it
+#if defined(ANIMATION_SIMD_FMA)
+    inline __m128 MulAdd(const __m128& a, const __m128& b, const __m128& c) { return _mm_fmadd_ps(a, b, c); }
+    inline __m128 MulSub(const __m128& a, const __m128& b, const __m128& c) { return _mm_fmsub_ps(a, b, c); }
+    inline __m128 NegativeMulAdd(const __m128& a, const __m128& b, const __m128& c) { return _mm_fnmadd_ps(a, b, c); }
+#else
+    inline __m128 MulAdd(const __m128& a, const __m128& b, const __m128& c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    inline __m128 MulSub(const __m128& a, const __m128& b, const __m128& c) { return _mm_sub_ps(_mm_mul_ps(a, b), c); }
+    inline __m128 NegativeMulAdd(const __m128& a, const __m128& b, const __m128& c) { return _mm_sub_ps(c, _mm_mul_ps(a, b)); }
+#endif
+    inline __m128 Sqrt(const __m128& value) { return _mm_sqrt_ps(value); }
+    // approximate 1 / sqrt(value), relative error below 1.5 * 2^-12
+    inline __m128 Rsqrt(const __m128& value) { return _mm_rsqrt_ps(value); }
+    inline __m128 Min(const __m128& lhs, const __m128& rhs) { return _mm_min_ps(lhs, rhs); }
+    inline __m128 Max(const __m128& lhs, const __m128& rhs) { return _mm_max_ps(lhs, rhs); }
+
+    inline __m128 CmpEq(const __m128& lhs, const __m128& rhs) { return _mm_cmpeq_ps(lhs, rhs); }
+    inline __m128 CmpLt(const __m128& lhs, const __m128& rhs) { return _mm_cmplt_ps(lhs, rhs); }
+    inline __m128 CmpGt(const __m128& lhs, const __m128& rhs) { return _mm_cmpgt_ps(lhs, rhs); }
+    inline __m128 MaskAnd(const __m128& lhs, const __m128& rhs) { return _mm_and_ps(lhs, rhs); }
+    inline __m128 MaskOr(const __m128& lhs, const __m128& rhs) { return _mm_or_ps(lhs, rhs); }
+    // true when any lane of 'mask' is set
+    inline bool Any(const __m128& mask) { return _mm_movemask_ps(mask) != 0; }
+
+    inline __m128 And(const __m128& lhs, const __m128& rhs) { return _mm_and_ps(lhs, rhs); }
+    inline __m128 Xor(const __m128& lhs, const __m128& rhs) { return _mm_xor_ps(lhs, rhs); }
+
+    // returns 'if_true' lanes where 'mask' is set and 'if_false' lanes everywhere else
+    inline __m128 Select(const __m128& mask, const __m128& if_true, const __m128& if_false)
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return _mm_blendv_ps(if_false, if_true, mask);
+#else
+        return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+#endif
+    }
+
+    // transposes four registers as a 4x4 matrix, the same as '_MM_TRANSPOSE4_PS'
+    inline void Transpose4(__m128& r0, __m128& r1, __m128& r2, __m128& r3)
+    {
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    }
+
+#if defined(__AVX__)
+    template <>
+    struct SPackTraits<__m256>
+    {
+        constexpr static size_t Width{ 8 };
+        using Mask = __m256;
+    };
+
+    /*            AVX            */
+    inline __m256 Load(const float* source, __m256) { return _mm256_load_ps(source); }
+    inline __m256 LoadUnaligned(const float* source, __m256) { return _mm256_loadu_ps(source); }
+    inline void Store(float* destination, const __m256& value) { _mm256_store_ps(destination, value); }
+    inline void StoreUnaligned(float* destination, const __m256& value) { _mm256_storeu_ps(destination, value); }
+    inline __m256 Set(const float& value, __m256) { return _mm256_set1_ps(value); }
+    inline __m256 Zero(__m256) { return _mm256_setzero_ps(); }
+
+    inline __m256 Add(const __m256& lhs, const __m256& rhs) { return _mm256_add_ps(lhs, rhs); }
+    inline __m256 Sub(const __m256& lhs, const __m256& rhs) { return _mm256_sub_ps(lhs, rhs); }
+    inline __m256 Mul(const __m256& lhs, const __m256& rhs) { return _mm256_mul_ps(lhs, rhs); }
+    inline __m256 Div(const __m256& lhs, const __m256& rhs) { return _mm256_div_ps(lhs, rhs); }
+#if defined(ANIMATION_SIMD_FMA)
+    inline __m256 MulAdd(const __m256& a, const __m256& b, const __m256& c) { return _mm256_fmadd_ps(a, b, c); }
+    inline __m256 MulSub(const __m256& a, const __m256& b, const __m256& c) { return _mm256_fmsub_ps(a, b, c); }
+    inline __m256 NegativeMulAdd(const __m256& a, const __m256& b, const __m256& c) { return _mm256_fnmadd_ps(a, b, c); }
+#else
+    inline __m256 MulAdd(const __m256& a, const __m256& b, const __m256& c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+    inline __m256 MulSub(const __m256& a, const __m256& b, const __m256& c) { return _mm256_sub_ps(_mm256_mul_ps(a, b), c); }
+    inline __m256 NegativeMulAdd(const __m256& a, const __m256& b, const __m256& c) { return _mm256_sub_ps(c, _mm256_mul_ps(a, b)); }
+#endif
+    inline __m256 Sqrt(const __m256& value) { return _mm256_sqrt_ps(value); }
+    inline __m256 Rsqrt(const __m256& value) { return _mm256_rsqrt_ps(value); }
+    inline __m256 Min(const __m256& lhs, const __m256& rhs) { return _mm256_min_ps(lhs, rhs); }
+    inline __m256 Max(const __m256& lhs, const __m256& rhs) { return _mm256_max_ps(lhs, rhs); }
+
+    inline __m256 CmpEq(const __m256& lhs, const __m256& rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_EQ_OQ); }
+    inline __m256 CmpLt(const __m256& lhs, const __m256& rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ); }
+    inline __m256 CmpGt(const __m256& lhs, const __m256& rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_GT_OQ); }
+    inline __m256 MaskAnd(const __m256& lhs, const __m256& rhs) { return _mm256_and_ps(lhs, rhs); }
+    inline __m256 MaskOr(const __m256& lhs, const __m256& rhs) { return _mm256_or_ps(lhs, rhs); }
+    inline bool Any(const __m256& mask) { return _mm256_movemask_ps(mask) != 0; }
+
+    inline __m256 And(const __m256& lhs, const __m256& rhs) { return _mm256_and_ps(lhs, rhs); }
+    inline __m256 Xor(const __m256& lhs, const __m256& rhs) { return _mm256_xor_ps(lhs, rhs); }
+
+    inline __m256 Select(const __m256& mask, const __m256& if_true, const __m256& if_false)
+    {
+        return _mm256_blendv_ps(if_false, if_true, mask);
+    }
+
+    // transposes both 128bit halves independently, every half as '_MM_TRANSPOSE4_PS'
+    inline void Transpose4(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+    {
+        const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+        const __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+        const __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+        const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+        r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+#endif
+
+#if defined(__AVX512F__)
+    template <>
+    struct SPackTraits<__m512>
+    {
+        constexpr static size_t Width{ 16 };
+        using Mask = __mmask16;
+    };
+
+    /*            AVX-512            */
+    inline __m512 Load(const float* source, __m512) { return _mm512_load_ps(source); }
+    inline __m512 LoadUnaligned(const float* source, __m512) { return _mm512_loadu_ps(source); }
+    inline void Store(float* destination, const __m512& value) { _mm512_store_ps(destination, value); }
+    inline void StoreUnaligned(float* destination, const __m512& value) { _mm512_storeu_ps(destination, value); }
+    inline __m512 Set(const float& value, __m512) { return _mm512_set1_ps(value); }
+    inline __m512 Zero(__m512) { return _mm512_setzero_ps(); }
+
+    inline __m512 Add(const __m512& lhs, const __m512& rhs) { return _mm512_add_ps(lhs, rhs); }
+    inline __m512 Sub(const __m512& lhs, const __m512& rhs) { return _mm512_sub_ps(lhs, rhs); }
+    inline __m512 Mul(const __m512& lhs, const __m512& rhs) { return _mm512_mul_ps(lhs, rhs); }
+    inline __m512 Div(const __m512& lhs, const __m512& rhs) { return _mm512_div_ps(lhs, rhs); }
+    inline __m512 MulAdd(const __m512& a, const __m512& b, const __m512& c) { return _mm512_fmadd_ps(a, b, c); }
+    inline __m512 MulSub(const __m512& a, const __m512& b, const __m512& c) { return _mm512_fmsub_ps(a, b, c); }
+    inline __m512 NegativeMulAdd(const __m512& a, const __m512& b, const __m512& c) { return _mm512_fnmadd_ps(a, b, c); }
+    inline __m512 Sqrt(const __m512& value) { return _mm512_sqrt_ps(value); }
+    // relative error below 2^-14, more precise than SSE and AVX
+    inline __m512 Rsqrt(const __m512& value) { return _mm512_rsqrt14_ps(value); }
+    inline __m512 Min(const __m512& lhs, const __m512& rhs) { return _mm512_min_ps(lhs, rhs); }
+    inline __m512 Max(const __m512& lhs, const __m512& rhs) { return _mm512_max_ps(lhs, rhs); }
+
+    inline __mmask16 CmpEq(const __m512& lhs, const __m512& rhs) { return _mm512_cmp_ps_mask(lhs, rhs, _CMP_EQ_OQ); }
+    inline __mmask16 CmpLt(const __m512& lhs, const __m512& rhs) { return _mm512_cmp_ps_mask(lhs, rhs, _CMP_LT_OQ); }
+    inline __mmask16 CmpGt(const __m512& lhs, const __m512& rhs) { return _mm512_cmp_ps_mask(lhs, rhs, _CMP_GT_OQ); }
+    inline __mmask16 MaskAnd(const __mmask16& lhs, const __mmask16& rhs) { return static_cast<__mmask16>(lhs & rhs); }
+    inline __mmask16 MaskOr(const __mmask16& lhs, const __mmask16& rhs) { return static_cast<__mmask16>(lhs | rhs); }
+    inline bool Any(const __mmask16& mask) { return mask != 0; }
+
+    inline __m512 And(const __m512& lhs, const __m512& rhs)
+    {
+        return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(lhs), _mm512_castps_si512(rhs)));
+    }
+
+    inline __m512 Xor(const __m512& lhs, const __m512& rhs)
+    {
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(lhs), _mm512_castps_si512(rhs)));
+    }
+
+    inline __m512 Select(const __mmask16& mask, const __m512& if_true, const __m512& if_false)
+    {
+        return _mm512_mask_blend_ps(mask, if_false, if_true);
+    }
+#endif
+
+    /*            Scalar            */
+    // the lanes of the register overloads one float at a time, rounded the same way, for the tails of kernels and scalar code
+#if defined(ANIMATION_SIMD_FMA)
+    inline float MulAdd(const float& a, const float& b, const float& c) { return std::fma(a, b, c); }
+    inline float MulSub(const float& a, const float& b, const float& c) { return std::fma(a, b, -c); }
+    inline float NegativeMulAdd(const float& a, const float& b, const float& c) { return std::fma(-a, b, c); }
+#else
+    inline float MulAdd(const float& a, const float& b, const float& c) { return a * b + c; }
+    inline float MulSub(const float& a, const float& b, const float& c) { return a * b - c; }
+    inline float NegativeMulAdd(const float& a, const float& b, const float& c) { return c - a * b; }
+#endif
+
+    // fused multiply-adds are single instructions in this build
+#if defined(ANIMATION_SIMD_FMA)
+    constexpr bool HasFusedMultiplyAdd{ true };
+#else
+    constexpr bool HasFusedMultiplyAdd{ false };
+#endif
+
+    // the widest register enabled by the compiler flags
+#if defined(__AVX512F__)
+    using FloatPack = __m512;
+#elif defined(__AVX__)
+    using FloatPack = __m256;
+#else
+    using FloatPack = __m128;
+#endif
+
+    // typed helpers, so a kernel can write 'Simd::Load<TPack>(pointer)' instead of passing a dummy register
+    template <typename TPack>
+    TPack Load(const float* source) { return Load(source, TPack{}); }
+
+    template <typename TPack>
+    TPack LoadUnaligned(const float* source) { return LoadUnaligned(source, TPack{}); }
+
+    template <typename TPack>
+    TPack Set(const float& value) { return Set(value, TPack{}); }
+
+    template <typename TPack>
+    TPack Zero() { return Zero(TPack{}); }
+
+    // sign bits of 'value', the rest of bits are cleared
+    template <typename TPack>
+    TPack SignBits(const TPack& value) { return And(value, Set<TPack>(-0.f)); }
+
+    // absolute value by clearing the sign bit
+    template <typename TPack>
+    TPack Abs(const TPack& value) { return Xor(value, SignBits(value)); }
+
+    /*
+    * (1 - alpha) * a + alpha * b, exact at both ends: 'a' for alpha 0 and 'b' for alpha 1.
+    * With FMA: alpha * b + (a - alpha * a), two fused multiply-adds; without: a * (1 - alpha) + b * alpha, two products and a sum.
+    * The forms can differ in the last bits between builds; within a build the 'float' overload gives the same bits as a lane.
+    */
+    template <typename TPack>
+    TPack Lerp(const TPack& a, const TPack& b, const TPack& alpha)
+    {
+#if defined(ANIMATION_SIMD_FMA)
+        return MulAdd(alpha, b, NegativeMulAdd(alpha, a, a));
+#else
+        return Add(Mul(a, Sub(Set<TPack>(1.f), alpha)), Mul(b, alpha));
+#endif
+    }
+
+    inline float Lerp(const float& a, const float& b, const float& alpha)
+    {
+#if defined(ANIMATION_SIMD_FMA)
+        return MulAdd(alpha, b, NegativeMulAdd(alpha, a, a));
+#else
+        return a * (1.f - alpha) + b * alpha;
+#endif
+    }
+}
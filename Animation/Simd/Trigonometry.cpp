@@ -0,0 +1,72 @@
+#include "Trigonometry.h"
+
+namespace
+{
+    using TrigonometryPack = Simd::FloatPack;
+    constexpr size_t TrigonometryPackWidth{ Simd::SPackTraits<TrigonometryPack>::Width };
+
+    // runs 'kernel' over full registers and pads the tail with zero angles
+    template <typename TKernel>
+    void ForEachAngle(const float* angles, size_t count, TKernel kernel)
+    {
+        size_t i = 0;
+        for (; i + TrigonometryPackWidth <= count; i += TrigonometryPackWidth)
+        {
+            kernel(i, Simd::LoadUnaligned<TrigonometryPack>(angles + i), TrigonometryPackWidth);
+        }
+
+        if (i < count)
+        {
+            alignas(64) float tail[TrigonometryPackWidth]{};
+            for (size_t j = 0; j < count - i; ++j)
+            {
+                tail[j] = angles[i + j];
+            }
+            kernel(i, Simd::Load<TrigonometryPack>(tail), count - i);
+        }
+    }
+
+    // stores 'available' lanes of a register
+    void StoreLanes(float* destination, const TrigonometryPack& value, size_t available)
+    {
+        if (available == TrigonometryPackWidth)
+        {
+            Simd::StoreUnaligned(destination, value);
+            return;
+        }
+
+        alignas(64) float lanes[TrigonometryPackWidth];
+        Simd::Store(lanes, value);
+        for (size_t i = 0; i < available; ++i)
+        {
+            destination[i] = lanes[i];
+        }
+    }
+}
+
+void Simd::SinCos(const float* angles, float* sines, float* cosines, size_t count)
+{
+    ForEachAngle(angles, count, [sines, cosines](size_t index, const TrigonometryPack& values, size_t available)
+    {
+        TrigonometryPack sine, cosine;
+        SinCos(values, sine, cosine);
+        StoreLanes(sines + index, sine, available);
+        StoreLanes(cosines + index, cosine, available);
+    });
+}
+
+void Simd::Sin(const float* angles, float* sines, size_t count)
+{
+    ForEachAngle(angles, count, [sines](size_t index, const TrigonometryPack& values, size_t available)
+    {
+        StoreLanes(sines + index, Sin(values), available);
+    });
+}
+
+void Simd::Cos(const float* angles, float* cosines, size_t count)
+{
+    ForEachAngle(angles, count, [cosines](size_t index, const TrigonometryPack& values, size_t available)
+    {
+        StoreLanes(cosines + index, Cos(values), available);
+    });
+}
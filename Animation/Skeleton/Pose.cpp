@@ -0,0 +1,122 @@
+#include "Pose.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <xmmintrin.h>
+
+#include "../Memory/FrameArena.h"
+
+SPose::SPose(size_t joint_count)
+{
+    Resize(joint_count);
+}
+
+SPose::SPose(SFrameArena& arena, size_t joint_count)
+    : arena{ &arena }
+{
+    Resize(joint_count);
+}
+
+SPose::SPose(const SPose& other)
+{
+    *this = other;
+}
+
+SPose::SPose(SPose&& other) noexcept
+{
+    std::swap(translations, other.translations);
+    std::swap(rotations, other.rotations);
+    std::swap(scales, other.scales);
+    std::swap(size, other.size);
+    std::swap(capacity, other.capacity);
+    std::swap(arena, other.arena);
+}
+
+SPose::~SPose()
+{
+    if (arena == nullptr)
+    {
+        _mm_free(translations);
+    }
+}
+
+SPose& SPose::operator=(const SPose& other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    size = 0;
+    if (capacity < other.size)
+    {
+        Reallocate(other.size);
+    }
+    size = other.size;
+    std::uninitialized_copy_n(other.translations, size, translations);
+    std::uninitialized_copy_n(other.rotations, size, rotations);
+    std::uninitialized_copy_n(other.scales, size, scales);
+    return *this;
+}
+
+SPose& SPose::operator=(SPose&& other) noexcept
+{
+    if (arena != other.arena)
+    {
+        return *this = other;
+    }
+
+    std::swap(translations, other.translations);
+    std::swap(rotations, other.rotations);
+    std::swap(scales, other.scales);
+    std::swap(size, other.size);
+    std::swap(capacity, other.capacity);
+    return *this;
+}
+
+/*            Size            */
+void SPose::Reallocate(size_t count)
+{
+    // translations, rotations and scales one after another, every element is one 16-byte register
+    const size_t bytes = 3 * count * sizeof(SVector);
+    void* block = arena != nullptr ? arena->Allocate(bytes) : _mm_malloc(std::max<size_t>(bytes, SFrameArena::Alignment), SFrameArena::Alignment);
+
+    SVector* new_translations = static_cast<SVector*>(block);
+    SQuaternion* new_rotations = reinterpret_cast<SQuaternion*>(new_translations + count);
+    SVector* new_scales = reinterpret_cast<SVector*>(new_rotations + count);
+    std::uninitialized_copy_n(translations, size, new_translations);
+    std::uninitialized_copy_n(rotations, size, new_rotations);
+    std::uninitialized_copy_n(scales, size, new_scales);
+
+    if (arena == nullptr)
+    {
+        _mm_free(translations);
+    }
+    translations = new_translations;
+    rotations = new_rotations;
+    scales = new_scales;
+    capacity = count;
+}
+
+void SPose::Resize(size_t joint_count)
+{
+    if (joint_count > capacity)
+    {
+        Reallocate(joint_count);
+    }
+    if (joint_count > size)
+    {
+        std::uninitialized_fill(translations + size, translations + joint_count, SVector::ZeroVector);
+        std::uninitialized_fill(rotations + size, rotations + joint_count, SQuaternion::Identity);
+        std::uninitialized_fill(scales + size, scales + joint_count, SVector(1.f));
+    }
+    size = joint_count;
+}
+
+void SPose::SetIdentity()
+{
+    std::fill(translations, translations + size, SVector::ZeroVector);
+    std::fill(rotations, rotations + size, SQuaternion::Identity);
+    std::fill(scales, scales + size, SVector(1.f));
+}
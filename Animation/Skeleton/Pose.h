@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../Quaternion/Quaternion.h"
+#include "../Vector/Vector.h"
+
+struct SFrameArena;
+
+/*
+* SPose keeps a transform per joint of a skeleton as a Structure of Arrays: every translation in one array, every rotation in another
+* and every scale in the third. A pass that touches one channel, like blending rotations, reads a single contiguous array,
+* and elements are 16-byte registers, so kernels load them with no conversion.
+* A transform applies scale first, rotation second and translation last. Whether a pose is local (relative to parents) or model
+* (relative to the skeleton root) depends on where it comes from, see 'SSkeleton::LocalToModel'.
+* The three arrays share one 64-byte aligned block from the heap, or from an 'SFrameArena' for a temporary pose of a frame.
+* A pose keeps where its memory comes from: an arena pose grows in its arena and is valid until the arena drops it, a copy of
+* any pose is a heap pose, and a copy assigned to a pose keeps the storage of the target.
+*/
+struct SPose
+{
+    SPose() = default;
+    // 'joint_count' identity transforms
+    explicit SPose(size_t joint_count);
+    // 'joint_count' identity transforms in 'arena'
+    SPose(SFrameArena& arena, size_t joint_count);
+    SPose(const SPose& other);
+    SPose(SPose&& other) noexcept;
+    ~SPose();
+
+    SPose& operator=(const SPose& other);
+    // swaps the memory of poses with the same storage and copies otherwise
+    SPose& operator=(SPose&& other) noexcept;
+
+    size_t Size() const { return size; }
+    bool IsEmpty() const { return size == 0; }
+    bool IsArenaPose() const { return arena != nullptr; }
+
+    // keeps existing transforms, new joints get identity transforms
+    void Resize(size_t joint_count);
+    void SetIdentity();
+
+    SVector* GetTranslations() { return translations; }
+    SQuaternion* GetRotations() { return rotations; }
+    SVector* GetScales() { return scales; }
+    const SVector* GetTranslations() const { return translations; }
+    const SQuaternion* GetRotations() const { return rotations; }
+    const SVector* GetScales() const { return scales; }
+
+private:
+    // moves the first 'size' transforms to a block for 'count' joints
+    void Reallocate(size_t count);
+
+    SVector* translations{ nullptr };
+    SQuaternion* rotations{ nullptr };
+    SVector* scales{ nullptr };
+    size_t size{ 0 };
+    size_t capacity{ 0 };
+    // memory comes from the heap when null
+    SFrameArena* arena{ nullptr };
+};
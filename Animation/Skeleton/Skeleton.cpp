@@ -0,0 +1,144 @@
+#include "Skeleton.h"
+
+#include "../Profile/ProfileScope.h"
+#include "../Quaternion/QuaternionKernels.h"
+
+#include <cassert>
+#include <utility>
+#include <xmmintrin.h>
+
+namespace
+{
+    // the register kernels of 'SQuaternion::operator*' and 'SQuaternion::Rotate', so the pass matches a per-joint loop over them
+    // bit for bit but inlines into a single loop body on registers
+    using QuaternionKernels::Multiply;
+    using QuaternionKernels::Rotate;
+
+    // a vector or a quaternion is its register and nothing else, so a store writes the whole object
+    template <typename T>
+    inline void Store(T& out, const __m128& value)
+    {
+        _mm_store_ps(reinterpret_cast<float*>(&out), value);
+    }
+}
+
+SSkeleton::SSkeleton(std::vector<int16_t> parents, std::vector<std::string> names)
+    : parents(std::move(parents))
+    , names(std::move(names))
+{
+    is_valid = this->parents.size() <= MaxJoints && (this->names.empty() || this->names.size() == this->parents.size()) &&
+               IsParentFirst(this->parents.data(), this->parents.size());
+}
+
+bool SSkeleton::IsParentFirst(const int16_t* parents, size_t count)
+{
+    for (size_t joint = 0; joint < count; ++joint)
+    {
+        if (parents[joint] != NoParent && (parents[joint] < 0 || static_cast<size_t>(parents[joint]) >= joint))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const std::string& SSkeleton::GetName(size_t joint) const
+{
+    static const std::string empty;
+    return names.empty() ? empty : names[joint];
+}
+
+size_t SSkeleton::FindJoint(const std::string& name) const
+{
+    for (size_t joint = 0; joint < names.size(); ++joint)
+    {
+        if (names[joint] == name)
+        {
+            return joint;
+        }
+    }
+    return GetJointCount();
+}
+
+/*            Local To Model            */
+void SSkeleton::LocalToModel(const SPose& local, SPose& model) const
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SSkeleton::LocalToModel");
+    assert(is_valid && local.Size() == parents.size() && &local != &model);
+    model.Resize(parents.size());
+
+    const SVector* local_translations = local.GetTranslations();
+    const SQuaternion* local_rotations = local.GetRotations();
+    const SVector* local_scales = local.GetScales();
+    SVector* model_translations = model.GetTranslations();
+    SQuaternion* model_rotations = model.GetRotations();
+    SVector* model_scales = model.GetScales();
+
+    const size_t count = parents.size();
+    for (size_t joint = 0; joint < count; ++joint)
+    {
+        const int16_t parent = parents[joint];
+        if (parent == NoParent)
+        {
+            model_translations[joint] = local_translations[joint];
+            model_rotations[joint] = local_rotations[joint];
+            model_scales[joint] = local_scales[joint];
+            continue;
+        }
+
+        const __m128 parent_rotation = model_rotations[parent].GetStorage();
+        const __m128 parent_scale = model_scales[parent].GetStorage();
+        const __m128 scaled = _mm_mul_ps(parent_scale, local_translations[joint].GetStorage());
+
+        Store(model_translations[joint], _mm_add_ps(Rotate(parent_rotation, scaled), model_translations[parent].GetStorage()));
+        Store(model_rotations[joint], Multiply(parent_rotation, local_rotations[joint].GetStorage()));
+        Store(model_scales[joint], _mm_mul_ps(parent_scale, local_scales[joint].GetStorage()));
+    }
+}
+
+void SSkeleton::LocalToModel(const SPose* locals, SPose* models, size_t count) const
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        LocalToModel(locals[i], models[i]);
+    }
+}
+
+void SSkeleton::Compose(const SPose& outer, const SPose& inner, SPose& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SSkeleton::Compose");
+    assert(outer.Size() == inner.Size());
+    const size_t count = outer.Size();
+    out.Resize(count);
+
+    for (size_t joint = 0; joint < count; ++joint)
+    {
+        const __m128 outer_rotation = outer.GetRotations()[joint].GetStorage();
+        const __m128 outer_scale = outer.GetScales()[joint].GetStorage();
+        const __m128 scaled = _mm_mul_ps(outer_scale, inner.GetTranslations()[joint].GetStorage());
+        const __m128 translation = _mm_add_ps(Rotate(outer_rotation, scaled), outer.GetTranslations()[joint].GetStorage());
+        const __m128 rotation = Multiply(outer_rotation, inner.GetRotations()[joint].GetStorage());
+        const __m128 scale = _mm_mul_ps(outer_scale, inner.GetScales()[joint].GetStorage());
+
+        Store(out.GetTranslations()[joint], translation);
+        Store(out.GetRotations()[joint], rotation);
+        Store(out.GetScales()[joint], scale);
+    }
+}
+
+void SSkeleton::Invert(const SPose& pose, SPose& inverse)
+{
+    const size_t count = pose.Size();
+    inverse.Resize(count);
+
+    for (size_t joint = 0; joint < count; ++joint)
+    {
+        const SQuaternion rotation = pose.GetRotations()[joint].Conjugation();
+        const SVector scale = SVector(1.f) / pose.GetScales()[joint];
+        const SVector translation = rotation.Rotate(pose.GetTranslations()[joint]) * scale * -1.f;
+
+        inverse.GetTranslations()[joint] = translation;
+        inverse.GetRotations()[joint] = rotation;
+        inverse.GetScales()[joint] = scale;
+    }
+}
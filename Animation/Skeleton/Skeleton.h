@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Pose.h"
+
+/*
+* SSkeleton is a joint hierarchy stored as an array of parent indices, sorted so every parent comes before its children.
+* The order turns hierarchy passes into one linear sweep: when a joint is reached, its parent is already done, and the sweep
+* reads parents, local transforms and model transforms front to back, the access pattern hardware prefetchers follow best.
+*/
+struct SSkeleton
+{
+    // parent index of root joints
+    constexpr static int16_t NoParent{ -1 };
+
+    // joint indices fit 'int16_t'
+    constexpr static size_t MaxJoints{ 32767 };
+
+    SSkeleton() = default;
+    // 'names' is empty or has a name per joint; 'IsValid' is false when 'parents' isn't sorted parents first
+    explicit SSkeleton(std::vector<int16_t> parents, std::vector<std::string> names = {});
+
+    // every parent is 'NoParent' or the index of an earlier joint
+    static bool IsParentFirst(const int16_t* parents, size_t count);
+
+    bool IsValid() const { return is_valid; }
+    size_t GetJointCount() const { return parents.size(); }
+
+    const int16_t* GetParents() const { return parents.data(); }
+    int16_t GetParent(size_t joint) const { return parents[joint]; }
+
+    // empty for a skeleton without names
+    const std::string& GetName(size_t joint) const;
+
+    // index of the joint called 'name', 'GetJointCount()' when there is none
+    size_t FindJoint(const std::string& name) const;
+
+    /*
+    * Local-to-model pass: model transforms relative to the skeleton root from local transforms relative to parents.
+    * A model transform is the parent model transform applied to the local one, with scale kept separate from rotation:
+    *   rotation    = parent.rotation * local.rotation
+    *   scale       = parent.scale * local.scale
+    *   translation = parent.rotation.Rotate(parent.scale * local.translation) + parent.translation
+    * This is exact for uniform scales; with non-uniform scales under rotated joints it drops the shear a matrix product would keep.
+    * 'model' is resized to the joint count and must not be 'local'.
+    */
+    void LocalToModel(const SPose& local, SPose& model) const;
+
+    // the pass for many characters of this skeleton, 'locals[i]' to 'models[i]'
+    void LocalToModel(const SPose* locals, SPose* models, size_t count) const;
+
+    /*
+    * 'outer' applied to 'inner' joint by joint with the rule of 'LocalToModel'. A skinning palette is the model pose composed with
+    * the inverse bind pose: the transform from the bind pose to the animated pose of every joint, in model space.
+    * 'out' is resized to the joint count and may be either input.
+    */
+    static void Compose(const SPose& outer, const SPose& inner, SPose& out);
+
+    // inverse transforms: 'Compose(pose, inverse)' is the identity; 'inverse' may be 'pose'
+    static void Invert(const SPose& pose, SPose& inverse);
+
+private:
+    std::vector<int16_t> parents;
+    std::vector<std::string> names;
+    bool is_valid{ true };
+};
@@ -0,0 +1,410 @@
+#include "Skinning.h"
+
+#include <algorithm>
+#include <cassert>
+#include <immintrin.h>
+
+#include "../Profile/ProfileScope.h"
+#include "../Quaternion/QuaternionKernels.h"
+#include "../Simd/CpuFeatures.h"
+
+namespace
+{
+    // input and output arrays of one skinning call, every array has at least the padded vertex count of elements
+    struct SSkinningStreams
+    {
+        const float* positions[3];
+        const float* normals[3];
+        const uint16_t* bones[SSkinnedMesh::MaxInfluences];
+        const float* weights[SSkinnedMesh::MaxInfluences];
+        const SMatrix* matrices;
+        const SDualQuaternion* dual_quaternions;
+        float* skinned_positions[3];
+        float* skinned_normals[3];
+        bool has_normals;
+    };
+
+    // streams of 'mesh' and the outputs, the caller sets the palette
+    SSkinningStreams MakeStreams(const SSkinnedMesh& mesh, SVectorSoA& positions, SVectorSoA& normals)
+    {
+        SSkinningStreams streams{};
+        const SVectorSoA& mesh_positions = mesh.GetPositions();
+        const SVectorSoA& mesh_normals = mesh.GetNormals();
+        streams.positions[0] = mesh_positions.GetX(); streams.positions[1] = mesh_positions.GetY(); streams.positions[2] = mesh_positions.GetZ();
+        streams.normals[0] = mesh_normals.GetX(); streams.normals[1] = mesh_normals.GetY(); streams.normals[2] = mesh_normals.GetZ();
+        for (size_t slot = 0; slot < SSkinnedMesh::MaxInfluences; ++slot)
+        {
+            streams.bones[slot] = mesh.GetBones(slot);
+            streams.weights[slot] = mesh.GetWeights(slot);
+        }
+        streams.skinned_positions[0] = positions.GetX(); streams.skinned_positions[1] = positions.GetY(); streams.skinned_positions[2] = positions.GetZ();
+        streams.skinned_normals[0] = normals.GetX(); streams.skinned_normals[1] = normals.GetY(); streams.skinned_normals[2] = normals.GetZ();
+        streams.has_normals = mesh.HasNormals();
+        return streams;
+    }
+
+    // four skinned vectors, one per register in the lane layout of 'SVector', transposed into the X, Y and Z arrays at 'vertex'
+    template <bool Streaming>
+    inline void StoreSkinned(float* const* out, size_t vertex, __m128 v0, __m128 v1, __m128 v2, __m128 v3)
+    {
+        // after the transpose the register in the place of 'v3' holds lane X of all four vectors, 'v2' lane Y and 'v1' lane Z
+        _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+        if (Streaming)
+        {
+            _mm_stream_ps(out[0] + vertex, v3);
+            _mm_stream_ps(out[1] + vertex, v2);
+            _mm_stream_ps(out[2] + vertex, v1);
+        }
+        else
+        {
+            _mm_store_ps(out[0] + vertex, v3);
+            _mm_store_ps(out[1] + vertex, v2);
+            _mm_store_ps(out[2] + vertex, v1);
+        }
+    }
+
+    /*            Sse            */
+    template <bool Streaming>
+    void SkinLinearSse(const SSkinningStreams& streams, size_t begin, size_t end)
+    {
+        for (size_t vertex = begin; vertex < end; vertex += 4)
+        {
+            __m128 positions[4], normals[4];
+            for (size_t i = 0; i < 4; ++i)
+            {
+                // rows of the blended matrix
+                __m128 x_axis = _mm_setzero_ps(), y_axis = _mm_setzero_ps(), z_axis = _mm_setzero_ps(), translation = _mm_setzero_ps();
+                for (size_t slot = 0; slot < SSkinnedMesh::MaxInfluences; ++slot)
+                {
+                    const SMatrix& matrix = streams.matrices[streams.bones[slot][vertex + i]];
+                    const __m128 weight = _mm_set1_ps(streams.weights[slot][vertex + i]);
+                    x_axis = _mm_add_ps(x_axis, _mm_mul_ps(weight, matrix.GetRow(SMatrix::X_AXIS)));
+                    y_axis = _mm_add_ps(y_axis, _mm_mul_ps(weight, matrix.GetRow(SMatrix::Y_AXIS)));
+                    z_axis = _mm_add_ps(z_axis, _mm_mul_ps(weight, matrix.GetRow(SMatrix::Z_AXIS)));
+                    translation = _mm_add_ps(translation, _mm_mul_ps(weight, matrix.GetRow(SMatrix::TRANSLATION)));
+                }
+
+                positions[i] = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(_mm_set1_ps(streams.positions[0][vertex + i]), x_axis),
+                    _mm_mul_ps(_mm_set1_ps(streams.positions[1][vertex + i]), y_axis)),
+                    _mm_mul_ps(_mm_set1_ps(streams.positions[2][vertex + i]), z_axis)),
+                    translation);
+                if (streams.has_normals)
+                {
+                    normals[i] = _mm_add_ps(_mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(streams.normals[0][vertex + i]), x_axis),
+                        _mm_mul_ps(_mm_set1_ps(streams.normals[1][vertex + i]), y_axis)),
+                        _mm_mul_ps(_mm_set1_ps(streams.normals[2][vertex + i]), z_axis));
+                }
+            }
+
+            StoreSkinned<Streaming>(streams.skinned_positions, vertex, positions[0], positions[1], positions[2], positions[3]);
+            if (streams.has_normals)
+            {
+                StoreSkinned<Streaming>(streams.skinned_normals, vertex, normals[0], normals[1], normals[2], normals[3]);
+            }
+        }
+    }
+
+    /*            Fma            */
+    template <bool Streaming>
+    ANIMATION_TARGET("avx,fma") void SkinLinearFma(const SSkinningStreams& streams, size_t begin, size_t end)
+    {
+        // a matrix is 16 floats: X and Y axes in the first 8, Z axis and translation in the last 8
+        const float* palette = reinterpret_cast<const float*>(streams.matrices);
+        const __m256 zero = _mm256_setzero_ps();
+        for (size_t vertex = begin; vertex < end; vertex += 4)
+        {
+            __m128 positions[4], normals[4];
+            for (size_t i = 0; i < 4; ++i)
+            {
+                __m256 xy_axes = zero, z_axis_translation = zero;
+                for (size_t slot = 0; slot < SSkinnedMesh::MaxInfluences; ++slot)
+                {
+                    const float* matrix = palette + 16 * static_cast<size_t>(streams.bones[slot][vertex + i]);
+                    const __m256 weight = _mm256_set1_ps(streams.weights[slot][vertex + i]);
+                    xy_axes = _mm256_fmadd_ps(weight, _mm256_loadu_ps(matrix), xy_axes);
+                    z_axis_translation = _mm256_fmadd_ps(weight, _mm256_loadu_ps(matrix + 8), z_axis_translation);
+                }
+
+                // (x * X axis | y * Y axis) + (z * Z axis | 1 * translation), then the halves summed
+                const __m256 x_y = _mm256_set_m128(_mm_set1_ps(streams.positions[1][vertex + i]), _mm_set1_ps(streams.positions[0][vertex + i]));
+                const __m256 z_one = _mm256_set_m128(_mm_set1_ps(1.f), _mm_set1_ps(streams.positions[2][vertex + i]));
+                const __m256 position = _mm256_fmadd_ps(x_y, xy_axes, _mm256_mul_ps(z_one, z_axis_translation));
+                positions[i] = _mm_add_ps(_mm256_castps256_ps128(position), _mm256_extractf128_ps(position, 1));
+                if (streams.has_normals)
+                {
+                    const __m256 nx_ny = _mm256_set_m128(_mm_set1_ps(streams.normals[1][vertex + i]), _mm_set1_ps(streams.normals[0][vertex + i]));
+                    const __m256 nz_zero = _mm256_set_m128(_mm_setzero_ps(), _mm_set1_ps(streams.normals[2][vertex + i]));
+                    const __m256 normal = _mm256_fmadd_ps(nx_ny, xy_axes, _mm256_mul_ps(nz_zero, z_axis_translation));
+                    normals[i] = _mm_add_ps(_mm256_castps256_ps128(normal), _mm256_extractf128_ps(normal, 1));
+                }
+            }
+
+            StoreSkinned<Streaming>(streams.skinned_positions, vertex, positions[0], positions[1], positions[2], positions[3]);
+            if (streams.has_normals)
+            {
+                StoreSkinned<Streaming>(streams.skinned_normals, vertex, normals[0], normals[1], normals[2], normals[3]);
+            }
+        }
+    }
+
+    /*            Dual Quaternion            */
+
+    // 'value' with its sign flipped where the dot product of two quaternions is negative
+    inline __m128 CopySignOfDot(const __m128& value, const __m128& lhs, const __m128& rhs)
+    {
+        const __m128 products = _mm_mul_ps(lhs, rhs);
+        const __m128 pairs = _mm_add_ps(products, _mm_movehl_ps(products, products));
+        const __m128 dot = _mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1)));
+        const __m128 sign = _mm_and_ps(dot, _mm_set_ss(-0.f));
+        return _mm_xor_ps(value, _mm_shuffle_ps(sign, sign, _MM_SHUFFLE(0, 0, 0, 0)));
+    }
+
+    using SSkinningVectors = QuaternionKernels::SVectorPack<__m128>;
+    using SSkinningRotations = QuaternionKernels::SQuaternionPack<__m128>;
+
+    template <bool Streaming>
+    inline void StorePacks(float* const* out, size_t vertex, const SSkinningVectors& packs)
+    {
+        const __m128 components[3]{ packs.x, packs.y, packs.z };
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            if (Streaming)
+            {
+                _mm_stream_ps(out[axis] + vertex, components[axis]);
+            }
+            else
+            {
+                _mm_store_ps(out[axis] + vertex, components[axis]);
+            }
+        }
+    }
+
+    /*
+    * Four blended dual quaternions, one per register, to the skinned vertices at 'vertex'. They are transposed to one register per
+    * component, normalized, and rotate and translate the vertex streams as they are loaded, so results go out with no transpose.
+    * A vertex without influences has a zero real part, it is left where it is.
+    */
+    template <bool Streaming>
+    inline void SkinDualQuaternions4(const SSkinningStreams& streams, size_t vertex, const __m128* reals, const __m128* duals)
+    {
+        __m128 rw = reals[0], rz = reals[1], ry = reals[2], rx = reals[3];
+        __m128 dw = duals[0], dz = duals[1], dy = duals[2], dx = duals[3];
+        _MM_TRANSPOSE4_PS(rw, rz, ry, rx);
+        _MM_TRANSPOSE4_PS(dw, dz, dy, dx);
+        // x, y, z and w of four vertices
+        const __m128 sqr_magnitude = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_add_ps(_mm_mul_ps(rz, rz), _mm_mul_ps(rw, rw)));
+        const __m128 inverse = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(sqr_magnitude)), _mm_cmpgt_ps(sqr_magnitude, _mm_setzero_ps()));
+        const SSkinningRotations real{ SSkinningVectors{ rx, ry, rz } * inverse, _mm_mul_ps(rw, inverse) };
+        const SSkinningRotations dual{ SSkinningVectors{ dx, dy, dz } * inverse, _mm_mul_ps(dw, inverse) };
+
+        // translation = 2 * (rw * d.xyz - dw * r.xyz + r.xyz ^ d.xyz)
+        const SSkinningVectors translation = (dual.axis * real.w - real.axis * dual.w + real.axis.Cross(dual.axis)) * _mm_set1_ps(2.f);
+
+        const SSkinningVectors position{ _mm_load_ps(streams.positions[0] + vertex), _mm_load_ps(streams.positions[1] + vertex), _mm_load_ps(streams.positions[2] + vertex) };
+        const SSkinningVectors skinned = real.Rotate(position) + translation;
+        StorePacks<Streaming>(streams.skinned_positions, vertex, skinned);
+
+        if (streams.has_normals)
+        {
+            const SSkinningVectors normal{ _mm_load_ps(streams.normals[0] + vertex), _mm_load_ps(streams.normals[1] + vertex), _mm_load_ps(streams.normals[2] + vertex) };
+            StorePacks<Streaming>(streams.skinned_normals, vertex, real.Rotate(normal));
+        }
+    }
+
+    template <bool Streaming>
+    void SkinDualQuaternionSse(const SSkinningStreams& streams, size_t begin, size_t end)
+    {
+        for (size_t vertex = begin; vertex < end; vertex += 4)
+        {
+            __m128 reals[4], duals[4];
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const __m128 first = streams.dual_quaternions[streams.bones[0][vertex + i]].real.GetStorage();
+                __m128 real = _mm_setzero_ps(), dual = _mm_setzero_ps();
+                for (size_t slot = 0; slot < SSkinnedMesh::MaxInfluences; ++slot)
+                {
+                    const SDualQuaternion& dual_quaternion = streams.dual_quaternions[streams.bones[slot][vertex + i]];
+                    const __m128 weight = CopySignOfDot(_mm_set1_ps(streams.weights[slot][vertex + i]), dual_quaternion.real.GetStorage(), first);
+                    real = _mm_add_ps(real, _mm_mul_ps(weight, dual_quaternion.real.GetStorage()));
+                    dual = _mm_add_ps(dual, _mm_mul_ps(weight, dual_quaternion.dual.GetStorage()));
+                }
+                reals[i] = real;
+                duals[i] = dual;
+            }
+            SkinDualQuaternions4<Streaming>(streams, vertex, reals, duals);
+        }
+    }
+
+    template <bool Streaming>
+    ANIMATION_TARGET("avx,fma") void SkinDualQuaternionFma(const SSkinningStreams& streams, size_t begin, size_t end)
+    {
+        // a dual quaternion is 8 floats: the real part in the low half of a 256bit register, the dual part in the high half
+        const float* palette = reinterpret_cast<const float*>(streams.dual_quaternions);
+        for (size_t vertex = begin; vertex < end; vertex += 4)
+        {
+            __m128 reals[4], duals[4];
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const __m128 first = _mm_load_ps(palette + 8 * static_cast<size_t>(streams.bones[0][vertex + i]));
+                __m256 sum = _mm256_setzero_ps();
+                for (size_t slot = 0; slot < SSkinnedMesh::MaxInfluences; ++slot)
+                {
+                    const float* dual_quaternion = palette + 8 * static_cast<size_t>(streams.bones[slot][vertex + i]);
+                    const __m256 value = _mm256_loadu_ps(dual_quaternion);
+                    const __m128 weight = CopySignOfDot(_mm_set1_ps(streams.weights[slot][vertex + i]), _mm256_castps256_ps128(value), first);
+                    sum = _mm256_fmadd_ps(_mm256_set_m128(weight, weight), value, sum);
+                }
+                reals[i] = _mm256_castps256_ps128(sum);
+                duals[i] = _mm256_extractf128_ps(sum, 1);
+            }
+            SkinDualQuaternions4<Streaming>(streams, vertex, reals, duals);
+        }
+    }
+
+    // a kernel over [begin, end) of the padded vertices, both multiples of 4
+    using SkinningKernel = void (*)(const SSkinningStreams& streams, size_t begin, size_t end);
+
+    // indexed by blending (linear, dual quaternion), 'ESkinningPath' and 'ESkinningStore'
+    const SkinningKernel SkinningKernels[2][2][2]{
+        { { SkinLinearSse<false>, SkinLinearSse<true> }, { SkinLinearFma<false>, SkinLinearFma<true> } },
+        { { SkinDualQuaternionSse<false>, SkinDualQuaternionSse<true> }, { SkinDualQuaternionFma<false>, SkinDualQuaternionFma<true> } },
+    };
+
+    void SkinRange(SkinningKernel kernel, ESkinningStore store, const SSkinningStreams& streams, size_t begin, size_t end)
+    {
+        kernel(streams, begin, end);
+        if (store == ESkinningStore::Streaming)
+        {
+            // non-temporal stores aren't ordered by the release of the job counter, the fence makes them visible first
+            _mm_sfence();
+        }
+    }
+}
+
+/*            Mesh            */
+SSkinnedMesh::SSkinnedMesh(size_t vertex_count, bool has_normals)
+{
+    Resize(vertex_count, has_normals);
+}
+
+void SSkinnedMesh::Resize(size_t vertex_count, bool has_normals)
+{
+    positions.Resize(vertex_count);
+    normals.Resize(has_normals ? vertex_count : 0);
+    this->has_normals = has_normals;
+
+    // padding vertices of the streams have no influences too
+    const size_t padded_count = positions.PaddedSize();
+    for (size_t slot = 0; slot < MaxInfluences; ++slot)
+    {
+        bones[slot].resize(vertex_count, 0);
+        weights[slot].resize(vertex_count, 0.f);
+        bones[slot].resize(padded_count, 0);
+        weights[slot].resize(padded_count, 0.f);
+    }
+}
+
+void SSkinnedMesh::SetInfluences(size_t vertex, const uint16_t* vertex_bones, const float* vertex_weights, size_t count)
+{
+    assert(vertex < GetVertexCount() && count <= MaxInfluences);
+    for (size_t slot = 0; slot < MaxInfluences; ++slot)
+    {
+        bones[slot][vertex] = slot < count ? vertex_bones[slot] : 0;
+        weights[slot][vertex] = slot < count ? vertex_weights[slot] : 0.f;
+    }
+}
+
+bool SSkinnedMesh::IsValid(size_t bone_count) const
+{
+    if (normals.Size() != (has_normals ? positions.Size() : 0))
+    {
+        return false;
+    }
+    for (size_t slot = 0; slot < MaxInfluences; ++slot)
+    {
+        if (bones[slot].size() != positions.PaddedSize() ||
+            std::any_of(bones[slot].begin(), bones[slot].end(), [bone_count](uint16_t bone) { return bone >= bone_count; }))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*            Skinning            */
+bool SSkinning::IsSupported(ESkinningPath path)
+{
+    const SCpuFeatures& features = SCpuFeatures::Get();
+    switch (path)
+    {
+    case ESkinningPath::Sse:
+        return true;
+    case ESkinningPath::Fma:
+        return features.avx && features.fma;
+    }
+    return false;
+}
+
+ESkinningPath SSkinning::DefaultPath()
+{
+    return IsSupported(ESkinningPath::Fma) ? ESkinningPath::Fma : ESkinningPath::Sse;
+}
+
+size_t SSkinning::GetChunkSize() const
+{
+    const size_t granularity = SVectorSoA::PaddingGranularity;
+    return std::max<size_t>((chunk_size + granularity - 1) / granularity * granularity, granularity);
+}
+
+void SSkinning::SkinLinear(const SSkinnedMesh& mesh, const SMatrix* palette, SVectorSoA& positions, SVectorSoA& normals) const
+{
+    Skin(nullptr, mesh, palette, nullptr, positions, normals);
+}
+
+void SSkinning::SkinLinear(SJobSystem& jobs, const SSkinnedMesh& mesh, const SMatrix* palette, SVectorSoA& positions, SVectorSoA& normals) const
+{
+    Skin(&jobs, mesh, palette, nullptr, positions, normals);
+}
+
+void SSkinning::SkinDualQuaternion(const SSkinnedMesh& mesh, const SDualQuaternion* palette, SVectorSoA& positions, SVectorSoA& normals) const
+{
+    Skin(nullptr, mesh, nullptr, palette, positions, normals);
+}
+
+void SSkinning::SkinDualQuaternion(SJobSystem& jobs, const SSkinnedMesh& mesh, const SDualQuaternion* palette, SVectorSoA& positions, SVectorSoA& normals) const
+{
+    Skin(&jobs, mesh, nullptr, palette, positions, normals);
+}
+
+void SSkinning::Skin(SJobSystem* jobs, const SSkinnedMesh& mesh, const SMatrix* matrices, const SDualQuaternion* dual_quaternions,
+                     SVectorSoA& positions, SVectorSoA& normals) const
+{
+    ANIMATION_PROFILE_SCOPE("SSkinning::Skin");
+    assert(IsSupported(path) && &positions != &mesh.GetPositions() && &normals != &mesh.GetNormals());
+    positions.Resize(mesh.GetVertexCount());
+    normals.Resize(mesh.HasNormals() ? mesh.GetVertexCount() : 0);
+    if (mesh.GetVertexCount() == 0)
+    {
+        return;
+    }
+
+    SSkinningStreams streams = MakeStreams(mesh, positions, normals);
+    streams.matrices = matrices;
+    streams.dual_quaternions = dual_quaternions;
+    const SkinningKernel kernel = SkinningKernels[dual_quaternions != nullptr][static_cast<size_t>(path)][static_cast<size_t>(store)];
+    const size_t padded_count = mesh.GetPositions().PaddedSize();
+    if (jobs == nullptr)
+    {
+        SkinRange(kernel, store, streams, 0, padded_count);
+        return;
+    }
+
+    const size_t chunk = GetChunkSize();
+    jobs->ParallelFor((padded_count + chunk - 1) / chunk, 1, [&](size_t begin, size_t end)
+    {
+        ANIMATION_PROFILE_SCOPE("SSkinning::SkinChunk");
+        SkinRange(kernel, store, streams, begin * chunk, std::min(end * chunk, padded_count));
+    });
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../Jobs/JobSystem.h"
+#include "../Matrix/Matrix.h"
+#include "../Quaternion/DualQuaternion.h"
+#include "../Vector/VectorSoA.h"
+
+/*
+* SSkinnedMesh keeps the vertex streams of a skinned mesh as Structures of Arrays: positions and normals in 'SVectorSoA' containers,
+* and up to 'MaxInfluences' bone influences per vertex, each influence slot in its own bone index array and weight array.
+* Influence arrays are padded like the vertex streams, padding vertices have bone 0 with weight 0.
+* A vertex with fewer influences leaves the remaining slots at weight 0; weights are used as given and should add up to 1.
+*/
+struct SSkinnedMesh
+{
+    constexpr static size_t MaxInfluences{ 4 };
+
+    SSkinnedMesh() = default;
+    // 'vertex_count' vertices at the origin with no influences, normals when 'has_normals'
+    explicit SSkinnedMesh(size_t vertex_count, bool has_normals = true);
+
+    // keeps existing vertices, new vertices are at the origin with no influences
+    void Resize(size_t vertex_count, bool has_normals = true);
+
+    size_t GetVertexCount() const { return positions.Size(); }
+    bool HasNormals() const { return has_normals; }
+
+    SVectorSoA& GetPositions() { return positions; }
+    SVectorSoA& GetNormals() { return normals; }
+    const SVectorSoA& GetPositions() const { return positions; }
+    const SVectorSoA& GetNormals() const { return normals; }
+
+    // influence 'slot' of every vertex, 'PaddedSize()' of the positions long
+    uint16_t* GetBones(size_t slot) { return bones[slot].data(); }
+    float* GetWeights(size_t slot) { return weights[slot].data(); }
+    const uint16_t* GetBones(size_t slot) const { return bones[slot].data(); }
+    const float* GetWeights(size_t slot) const { return weights[slot].data(); }
+
+    // sets 'count' influences of 'vertex', up to 'MaxInfluences', and clears the other slots
+    void SetInfluences(size_t vertex, const uint16_t* vertex_bones, const float* vertex_weights, size_t count);
+
+    // every bone index is below 'bone_count'
+    bool IsValid(size_t bone_count) const;
+
+private:
+    SVectorSoA positions;
+    SVectorSoA normals;
+    std::vector<uint16_t> bones[MaxInfluences];
+    std::vector<float> weights[MaxInfluences];
+    bool has_normals{ true };
+};
+
+// implementation of the skinning kernels
+enum class ESkinningPath
+{
+    // one vertex at a time on 128bit rows, plain SSE
+    Sse,
+    // one vertex at a time with two rows per 256bit register and fused multiply-adds, AVX and FMA3; results differ from Sse in the last bits
+    Fma,
+};
+
+// how skinned streams are written
+enum class ESkinningStore
+{
+    // regular stores, the output stays in cache for a pass that reads it next
+    Cached,
+    // non-temporal stores straight to memory, for outputs larger than the cache that are read much later, like hit detection meshes
+    Streaming,
+};
+
+/*
+* SSkinning transforms the vertex streams of an 'SSkinnedMesh' by a palette of skinning matrices, see 'SAnimatedCharacter::palette_matrices'.
+* Linear blend skinning blends the matrices of the influences of a vertex by their weights and transforms the vertex by the result:
+*   position = position * sum(weight * palette[bone]), normal = normal * sum(weight * palette[bone]) without the translation
+* Matrix rows are used in the lane layout they are stored in: a row scaled by a weight is added to a register, and the blended rows
+* are combined by broadcasting the vertex components over them, so the palette is never repacked. Every four skinned vertices are
+* transposed into the X, Y and Z arrays of the outputs.
+* Normals keep the scale of the bones and aren't renormalized.
+* Dual quaternion skinning blends the dual quaternions of the influences instead, see 'SDualQuaternion::Blend', normalizes the sum and
+* rotates and translates the vertex by it: no candy wrapper collapse on twisting joints, no scale. Every four blended dual quaternions
+* are transposed and applied to the vertex streams component-wise, so the skinned streams are written as they are computed.
+* Both modes take the same mesh and write the same outputs, so they can be compared on one mesh. Vertices are processed in chunks of
+* 'chunk_size' (rounded up to 'SVectorSoA::PaddingGranularity'), so chunks start on cache lines of every output array and jobs never share one.
+*/
+struct SSkinning
+{
+    constexpr static size_t DefaultChunkSize{ 1024 };
+
+    ESkinningPath path{ DefaultPath() };
+    ESkinningStore store{ ESkinningStore::Cached };
+    size_t chunk_size{ DefaultChunkSize };
+
+    // returns false when the running CPU lacks instructions of 'path'
+    static bool IsSupported(ESkinningPath path);
+
+    // the fastest path of the running CPU
+    static ESkinningPath DefaultPath();
+
+    /*
+    * Linear blend skinning of 'mesh' into 'positions' and 'normals', resized to the vertex count (normals to 0 for a mesh without them).
+    * 'palette' has a matrix for every bone 'mesh' refers to, outputs are not streams of 'mesh'.
+    */
+    void SkinLinear(const SSkinnedMesh& mesh, const SMatrix* palette, SVectorSoA& positions, SVectorSoA& normals) const;
+
+    // the same with chunks as jobs of 'jobs'; results are equal to the single-threaded call
+    void SkinLinear(SJobSystem& jobs, const SSkinnedMesh& mesh, const SMatrix* palette, SVectorSoA& positions, SVectorSoA& normals) const;
+
+    /*
+    * Dual quaternion skinning of 'mesh' with the outputs of 'SkinLinear'. 'palette' has a dual quaternion for every bone, like
+    * 'SDualQuaternion::FromTransforms' of 'SAnimatedCharacter::palette'; a vertex without influences keeps its position.
+    */
+    void SkinDualQuaternion(const SSkinnedMesh& mesh, const SDualQuaternion* palette, SVectorSoA& positions, SVectorSoA& normals) const;
+    void SkinDualQuaternion(SJobSystem& jobs, const SSkinnedMesh& mesh, const SDualQuaternion* palette, SVectorSoA& positions, SVectorSoA& normals) const;
+
+private:
+    size_t GetChunkSize() const;
+
+    // one of the palettes is given, 'jobs' is null for the calling thread
+    void Skin(SJobSystem* jobs, const SSkinnedMesh& mesh, const SMatrix* matrices, const SDualQuaternion* dual_quaternions,
+              SVectorSoA& positions, SVectorSoA& normals) const;
+};
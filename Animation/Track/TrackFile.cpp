@@ -0,0 +1,538 @@
+#include "TrackFile.h"
+#include "../Simd/CpuFeatures.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <nmmintrin.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // bytes of an element of a track, 0 for an unknown type
+    size_t GetElementSize(ETrackType type)
+    {
+        switch (type)
+        {
+        case ETrackType::Vector:
+        case ETrackType::Quaternion:
+            return sizeof(__m128);
+        case ETrackType::Float:
+            return sizeof(float);
+        }
+        return 0;
+    }
+
+    /*            Checksum            */
+    // reflected CRC-32C polynomial, the one of the SSE4.2 'crc32' instruction
+    constexpr uint32_t Polynomial{ 0x82F63B78u };
+
+    constexpr std::array<uint32_t, 256> MakeChecksumTable()
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ (crc & 1u ? Polynomial : 0u);
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    constexpr std::array<uint32_t, 256> ChecksumTable = MakeChecksumTable();
+
+    uint32_t UpdateChecksumTable(uint32_t crc, const unsigned char* bytes, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            crc = (crc >> 8) ^ ChecksumTable[(crc ^ bytes[i]) & 0xFFu];
+        }
+        return crc;
+    }
+
+    // eight bytes per instruction, about 8 GB/s on one core
+    ANIMATION_TARGET("sse4.2") uint32_t UpdateChecksumCrc32(uint32_t crc, const unsigned char* bytes, size_t size)
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        uint64_t crc64 = crc;
+        for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), bytes += sizeof(uint64_t))
+        {
+            uint64_t value;
+            std::memcpy(&value, bytes, sizeof(value));
+            crc64 = _mm_crc32_u64(crc64, value);
+        }
+        crc = static_cast<uint32_t>(crc64);
+#endif
+        for (; size > 0; --size, ++bytes)
+        {
+            crc = _mm_crc32_u8(crc, *bytes);
+        }
+        return crc;
+    }
+
+    size_t AlignUp(size_t offset, size_t alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    /*            Mapping            */
+    const unsigned char* MapFile(const char* path, size_t& size, ETrackFileStatus& status)
+    {
+#if defined(_WIN32)
+        const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER file_size{};
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &file_size))
+        {
+            if (file != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(file);
+            }
+            status = ETrackFileStatus::OpenFailed;
+            return nullptr;
+        }
+
+        size = static_cast<size_t>(file_size.QuadPart);
+        if (size < sizeof(STrackFileHeader))
+        {
+            CloseHandle(file);
+            status = ETrackFileStatus::TooSmall;
+            return nullptr;
+        }
+
+        // the view keeps the mapping and the file open
+        const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+        {
+            status = ETrackFileStatus::MapFailed;
+            return nullptr;
+        }
+
+        const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (view == nullptr)
+        {
+            status = ETrackFileStatus::MapFailed;
+            return nullptr;
+        }
+        return static_cast<const unsigned char*>(view);
+#else
+        const int descriptor = open(path, O_RDONLY | O_CLOEXEC);
+        struct stat file_status{};
+        if (descriptor < 0 || fstat(descriptor, &file_status) != 0)
+        {
+            if (descriptor >= 0)
+            {
+                close(descriptor);
+            }
+            status = ETrackFileStatus::OpenFailed;
+            return nullptr;
+        }
+
+        size = static_cast<size_t>(file_status.st_size);
+        if (size < sizeof(STrackFileHeader))
+        {
+            close(descriptor);
+            status = ETrackFileStatus::TooSmall;
+            return nullptr;
+        }
+
+        // the mapping keeps the file open
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        close(descriptor);
+        if (mapping == MAP_FAILED)
+        {
+            status = ETrackFileStatus::MapFailed;
+            return nullptr;
+        }
+        return static_cast<const unsigned char*>(mapping);
+#endif
+    }
+
+    void UnmapFile(const unsigned char* data, size_t size)
+    {
+#if defined(_WIN32)
+        (void)size;
+        UnmapViewOfFile(data);
+#else
+        munmap(const_cast<unsigned char*>(data), size);
+#endif
+    }
+
+    uint32_t HeaderChecksum(STrackFileHeader header)
+    {
+        header.header_checksum = 0;
+        return STrackFile::Checksum(&header, sizeof(header));
+    }
+}
+
+/*            STrackFile            */
+STrackFile::~STrackFile()
+{
+    Close();
+}
+
+STrackFile::STrackFile(STrackFile&& other) noexcept
+    : data(other.data)
+    , size(other.size)
+{
+    other.data = nullptr;
+    other.size = 0;
+}
+
+STrackFile& STrackFile::operator=(STrackFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        data = other.data;
+        size = other.size;
+        other.data = nullptr;
+        other.size = 0;
+    }
+    return *this;
+}
+
+ETrackFileStatus STrackFile::Open(const char* path, ETrackFileValidation validation)
+{
+    Close();
+
+    ETrackFileStatus status{ ETrackFileStatus::Ok };
+    size_t file_size{ 0 };
+    const unsigned char* mapping = MapFile(path, file_size, status);
+    if (mapping == nullptr)
+    {
+        return status;
+    }
+
+    status = Validate(mapping, file_size, validation);
+    if (status != ETrackFileStatus::Ok)
+    {
+        UnmapFile(mapping, file_size);
+        return status;
+    }
+
+    data = mapping;
+    size = file_size;
+    return ETrackFileStatus::Ok;
+}
+
+void STrackFile::Close()
+{
+    if (data != nullptr)
+    {
+        UnmapFile(data, size);
+        data = nullptr;
+        size = 0;
+    }
+}
+
+size_t STrackFile::GetTrackCount() const
+{
+    return data != nullptr ? reinterpret_cast<const STrackFileHeader*>(data)->track_count : 0;
+}
+
+const STrackFileEntry& STrackFile::GetTrack(size_t track) const
+{
+    const STrackFileHeader& header = *reinterpret_cast<const STrackFileHeader*>(data);
+    return reinterpret_cast<const STrackFileEntry*>(data + header.index_offset)[track];
+}
+
+size_t STrackFile::FindTrack(const char* name) const
+{
+    const size_t count = GetTrackCount();
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (std::strcmp(GetTrack(i).name, name) == 0)
+        {
+            return i;
+        }
+    }
+    return count;
+}
+
+const SVector* STrackFile::GetVectors(size_t track) const
+{
+    const STrackFileEntry& entry = GetTrack(track);
+    return entry.type == ETrackType::Vector ? reinterpret_cast<const SVector*>(data + entry.offset) : nullptr;
+}
+
+const SQuaternion* STrackFile::GetQuaternions(size_t track) const
+{
+    const STrackFileEntry& entry = GetTrack(track);
+    return entry.type == ETrackType::Quaternion ? reinterpret_cast<const SQuaternion*>(data + entry.offset) : nullptr;
+}
+
+const float* STrackFile::GetFloats(size_t track) const
+{
+    const STrackFileEntry& entry = GetTrack(track);
+    return entry.type == ETrackType::Float ? reinterpret_cast<const float*>(data + entry.offset) : nullptr;
+}
+
+ETrackFileStatus STrackFile::Validate(const void* image, size_t size, ETrackFileValidation validation)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(image);
+    if (reinterpret_cast<uintptr_t>(bytes) % alignof(__m128) != 0)
+    {
+        return ETrackFileStatus::Misaligned;
+    }
+
+    if (bytes == nullptr || size < sizeof(STrackFileHeader))
+    {
+        return ETrackFileStatus::TooSmall;
+    }
+
+    /*            Header            */
+    STrackFileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+    {
+        return ETrackFileStatus::BadMagic;
+    }
+
+    if (header.version == 0 || header.version > Version || header.header_size != sizeof(STrackFileHeader) || header.entry_size != sizeof(STrackFileEntry))
+    {
+        return ETrackFileStatus::UnsupportedVersion;
+    }
+
+    if (HeaderChecksum(header) != header.header_checksum)
+    {
+        return ETrackFileStatus::HeaderChecksumMismatch;
+    }
+
+    if (header.file_size > size)
+    {
+        return ETrackFileStatus::TooSmall;
+    }
+
+    /*            Index            */
+    const uint64_t index_size = uint64_t{ header.track_count } * sizeof(STrackFileEntry);
+    if (header.index_offset % SectionAlignment != 0 || header.index_offset > header.file_size || index_size > header.file_size - header.index_offset)
+    {
+        return ETrackFileStatus::BadSection;
+    }
+
+    const STrackFileEntry* entries = reinterpret_cast<const STrackFileEntry*>(bytes + header.index_offset);
+    if (Checksum(entries, static_cast<size_t>(index_size)) != header.index_checksum)
+    {
+        return ETrackFileStatus::IndexChecksumMismatch;
+    }
+
+    for (uint32_t i = 0; i < header.track_count; ++i)
+    {
+        const STrackFileEntry& entry = entries[i];
+        const size_t element_size = GetElementSize(entry.type);
+        if (element_size == 0 || entry.element_size != element_size || std::memchr(entry.name, '\0', sizeof(entry.name)) == nullptr ||
+            entry.offset % SectionAlignment != 0 || entry.offset > header.file_size || entry.count > (header.file_size - entry.offset) / element_size)
+        {
+            return ETrackFileStatus::BadSection;
+        }
+    }
+
+    if (validation == ETrackFileValidation::Header)
+    {
+        return ETrackFileStatus::Ok;
+    }
+
+    /*            Data            */
+    for (uint32_t i = 0; i < header.track_count; ++i)
+    {
+        const STrackFileEntry& entry = entries[i];
+        const unsigned char* section = bytes + entry.offset;
+        if (Checksum(section, static_cast<size_t>(entry.count) * entry.element_size) != entry.checksum)
+        {
+            return ETrackFileStatus::DataChecksumMismatch;
+        }
+
+        // 'SVector' methods rely on a zero unused lane
+        if (entry.type == ETrackType::Vector)
+        {
+            for (uint64_t element = 0; element < entry.count; ++element)
+            {
+                uint32_t unused;
+                std::memcpy(&unused, section + element * sizeof(SVector) + SVector::U_INDEX * sizeof(float), sizeof(unused));
+                if (unused != 0)
+                {
+                    return ETrackFileStatus::UnusedLaneNotZero;
+                }
+            }
+        }
+    }
+
+    return ETrackFileStatus::Ok;
+}
+
+uint32_t STrackFile::Checksum(const void* bytes, size_t size, uint32_t crc)
+{
+    static const bool has_crc32 = SCpuFeatures::Get().sse42;
+
+    const unsigned char* input = static_cast<const unsigned char*>(bytes);
+    crc = ~crc;
+    crc = has_crc32 ? UpdateChecksumCrc32(crc, input, size) : UpdateChecksumTable(crc, input, size);
+    return ~crc;
+}
+
+const char* STrackFile::GetStatusName(ETrackFileStatus status)
+{
+    switch (status)
+    {
+    case ETrackFileStatus::Ok:
+        return "Ok";
+    case ETrackFileStatus::OpenFailed:
+        return "OpenFailed";
+    case ETrackFileStatus::MapFailed:
+        return "MapFailed";
+    case ETrackFileStatus::WriteFailed:
+        return "WriteFailed";
+    case ETrackFileStatus::InvalidName:
+        return "InvalidName";
+    case ETrackFileStatus::TooSmall:
+        return "TooSmall";
+    case ETrackFileStatus::Misaligned:
+        return "Misaligned";
+    case ETrackFileStatus::BadMagic:
+        return "BadMagic";
+    case ETrackFileStatus::UnsupportedVersion:
+        return "UnsupportedVersion";
+    case ETrackFileStatus::HeaderChecksumMismatch:
+        return "HeaderChecksumMismatch";
+    case ETrackFileStatus::IndexChecksumMismatch:
+        return "IndexChecksumMismatch";
+    case ETrackFileStatus::BadSection:
+        return "BadSection";
+    case ETrackFileStatus::DataChecksumMismatch:
+        return "DataChecksumMismatch";
+    case ETrackFileStatus::UnusedLaneNotZero:
+        return "UnusedLaneNotZero";
+    case ETrackFileStatus::UnexpectedTracks:
+        return "UnexpectedTracks";
+    }
+    return "Unknown";
+}
+
+/*            STrackFileWriter            */
+bool STrackFileWriter::AddVectors(const char* name, const SVector* vectors, size_t count)
+{
+    return Add(name, ETrackType::Vector, vectors, count);
+}
+
+bool STrackFileWriter::AddQuaternions(const char* name, const SQuaternion* quaternions, size_t count)
+{
+    return Add(name, ETrackType::Quaternion, quaternions, count);
+}
+
+bool STrackFileWriter::AddFloats(const char* name, const float* floats, size_t count)
+{
+    return Add(name, ETrackType::Float, floats, count);
+}
+
+bool STrackFileWriter::Add(const char* name, ETrackType type, const void* elements, size_t count)
+{
+    const size_t length = name != nullptr ? std::strlen(name) : 0;
+    if (length == 0 || length > STrackFile::MaxNameLength)
+    {
+        return false;
+    }
+
+    for (const STrack& track : tracks)
+    {
+        if (track.name == name)
+        {
+            return false;
+        }
+    }
+
+    tracks.push_back({name, type, elements, count});
+    return true;
+}
+
+ETrackFileStatus STrackFileWriter::Write(const char* path) const
+{
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr)
+    {
+        return ETrackFileStatus::OpenFailed;
+    }
+
+    STrackFileHeader header{};
+    std::memcpy(header.magic, STrackFile::Magic, sizeof(header.magic));
+    header.version = STrackFile::Version;
+    header.header_size = sizeof(STrackFileHeader);
+    header.entry_size = sizeof(STrackFileEntry);
+    header.track_count = static_cast<uint32_t>(tracks.size());
+    header.index_offset = sizeof(STrackFileHeader);
+
+    // header and index are written last, once checksums of the sections are known
+    std::vector<STrackFileEntry> entries(tracks.size(), STrackFileEntry{});
+    const size_t data_offset = AlignUp(sizeof(STrackFileHeader) + entries.size() * sizeof(STrackFileEntry), STrackFile::SectionAlignment);
+    const std::vector<unsigned char> zeros(data_offset, 0);
+    bool is_written = std::fwrite(zeros.data(), 1, data_offset, file) == data_offset;
+
+    // sections go through a staging buffer, which zeroes unused lanes of vectors
+    constexpr size_t chunk_bytes{ 4096 * sizeof(SVector) };
+    std::vector<unsigned char> chunk(chunk_bytes);
+    size_t offset = data_offset;
+    for (size_t i = 0; i < tracks.size() && is_written; ++i)
+    {
+        const STrack& track = tracks[i];
+        STrackFileEntry& entry = entries[i];
+        const size_t element_size = GetElementSize(track.type);
+        const size_t chunk_elements = chunk_bytes / element_size;
+        std::memcpy(entry.name, track.name.c_str(), track.name.size() + 1);
+        entry.type = track.type;
+        entry.element_size = static_cast<uint32_t>(element_size);
+        entry.offset = offset;
+        entry.count = track.count;
+
+        const unsigned char* elements = static_cast<const unsigned char*>(track.elements);
+        for (size_t first = 0; first < track.count && is_written; first += chunk_elements)
+        {
+            const size_t count = std::min(chunk_elements, track.count - first);
+            std::memcpy(chunk.data(), elements + first * element_size, count * element_size);
+            if (track.type == ETrackType::Vector)
+            {
+                for (size_t element = 0; element < count; ++element)
+                {
+                    std::memset(chunk.data() + element * element_size + SVector::U_INDEX * sizeof(float), 0, sizeof(float));
+                }
+            }
+
+            entry.checksum = STrackFile::Checksum(chunk.data(), count * element_size, entry.checksum);
+            is_written = std::fwrite(chunk.data(), element_size, count, file) == count;
+        }
+
+        const size_t end = offset + track.count * element_size;
+        offset = AlignUp(end, STrackFile::SectionAlignment);
+        is_written = is_written && std::fwrite(zeros.data(), 1, offset - end, file) == offset - end;
+    }
+
+    header.file_size = offset;
+    header.index_checksum = STrackFile::Checksum(entries.data(), entries.size() * sizeof(STrackFileEntry));
+    header.header_checksum = HeaderChecksum(header);
+
+    is_written = is_written && std::fseek(file, 0, SEEK_SET) == 0 &&
+                 std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 std::fwrite(entries.data(), sizeof(STrackFileEntry), entries.size(), file) == entries.size();
+    is_written = std::fclose(file) == 0 && is_written;
+
+    if (!is_written)
+    {
+        std::remove(path);
+        return ETrackFileStatus::WriteFailed;
+    }
+    return ETrackFileStatus::Ok;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Quaternion/Quaternion.h"
+#include "../Vector/Vector.h"
+
+/*
+* Binary container of keyframe tracks, arrays of 'SVector', 'SQuaternion' or floats, loaded with a memory mapping and used in place.
+*
+* Layout of version 1, little-endian:
+*   STrackFileHeader               64 bytes at offset 0;
+*   STrackFileEntry[track_count]   64 bytes each, the index, right after the header;
+*   track data                     16-byte elements in 'SVector'/'SQuaternion' lane order or 4-byte floats, like key times,
+*                                  every section at a 64-byte aligned offset.
+* The header, the index and every section carry a CRC-32C. A mapping starts at a page boundary, so sections are aligned
+* for '__m128' loads and for cache lines, and a track is a plain array of vectors: there is no parsing and no copying on load.
+*/
+
+// kind of elements of a track
+enum class ETrackType : uint32_t
+{
+    Vector = 1,
+    Quaternion = 2,
+    Float = 3,
+};
+
+// how much of a file is checked before it is used
+enum class ETrackFileValidation
+{
+    // header, index and section bounds, reads no track data
+    Header,
+    // also checksums of every section and zero unused lanes of vectors, reads the whole file
+    Full,
+};
+
+enum class ETrackFileStatus
+{
+    Ok,
+    OpenFailed,
+    MapFailed,
+    WriteFailed,
+    InvalidName,
+    TooSmall,
+    Misaligned,
+    BadMagic,
+    UnsupportedVersion,
+    HeaderChecksumMismatch,
+    IndexChecksumMismatch,
+    BadSection,
+    DataChecksumMismatch,
+    UnusedLaneNotZero,
+    // a valid file without the tracks a reader of it expects, like 'SClipFile'
+    UnexpectedTracks,
+};
+
+struct STrackFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t entry_size;
+    uint32_t track_count;
+    uint64_t index_offset;
+    uint64_t file_size;
+    uint32_t index_checksum;
+    // checksum of the header with this field set to zero
+    uint32_t header_checksum;
+    uint8_t reserved[16];
+};
+
+struct STrackFileEntry
+{
+    // zero terminated
+    char name[32];
+    ETrackType type;
+    uint32_t element_size;
+    uint64_t offset;
+    uint64_t count;
+    uint32_t checksum;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(STrackFileHeader) == 64 && sizeof(STrackFileEntry) == 64, "track file records are 64 bytes");
+static_assert(sizeof(SVector) == 16 && sizeof(SQuaternion) == 16, "track elements are single 128bit registers");
+
+/*
+* STrackFile is a read-only mapping of a track file. Pointers to tracks stay valid until the file is closed.
+*/
+struct STrackFile
+{
+    constexpr static char Magic[8]{ 'A', 'N', 'I', 'M', 'T', 'R', 'K', '\0' };
+    constexpr static uint32_t Version{ 1 };
+    // alignment of sections in the file
+    constexpr static size_t SectionAlignment{ 64 };
+    // longest track name, without the terminating zero
+    constexpr static size_t MaxNameLength{ sizeof(STrackFileEntry::name) - 1 };
+
+    STrackFile() = default;
+    ~STrackFile();
+
+    STrackFile(const STrackFile&) = delete;
+    STrackFile& operator=(const STrackFile&) = delete;
+    STrackFile(STrackFile&& other) noexcept;
+    STrackFile& operator=(STrackFile&& other) noexcept;
+
+    // maps 'path' and validates it, the file stays closed on failure
+    ETrackFileStatus Open(const char* path, ETrackFileValidation validation = ETrackFileValidation::Full);
+    void Close();
+    bool IsOpen() const { return data != nullptr; }
+
+    size_t GetTrackCount() const;
+    const STrackFileEntry& GetTrack(size_t track) const;
+    // index of the track called 'name', 'GetTrackCount()' when there is none
+    size_t FindTrack(const char* name) const;
+
+    // elements of a track, nullptr when the track holds another type
+    const SVector* GetVectors(size_t track) const;
+    const SQuaternion* GetQuaternions(size_t track) const;
+    const float* GetFloats(size_t track) const;
+
+    // checks a file image of 'size' bytes at 16-byte aligned 'image'
+    static ETrackFileStatus Validate(const void* image, size_t size, ETrackFileValidation validation);
+
+    // CRC-32C (Castagnoli), with SSE4.2 'crc32' when the CPU has it
+    static uint32_t Checksum(const void* bytes, size_t size, uint32_t crc = 0);
+
+    static const char* GetStatusName(ETrackFileStatus status);
+
+private:
+    const unsigned char* data{ nullptr };
+    size_t size{ 0 };
+};
+
+/*
+* STrackFileWriter collects tracks and writes them as a track file.
+* Tracks reference the arrays passed to it, the arrays have to live until 'Write' returns.
+*/
+struct STrackFileWriter
+{
+    // false when 'name' is empty, longer than 'STrackFile::MaxNameLength' or already used
+    bool AddVectors(const char* name, const SVector* vectors, size_t count);
+    bool AddQuaternions(const char* name, const SQuaternion* quaternions, size_t count);
+    bool AddFloats(const char* name, const float* floats, size_t count);
+
+    // writes every track added so far; unused lanes of vectors are written as zero
+    ETrackFileStatus Write(const char* path) const;
+
+private:
+    struct STrack
+    {
+        std::string name;
+        ETrackType type;
+        const void* elements;
+        size_t count;
+    };
+
+    bool Add(const char* name, ETrackType type, const void* elements, size_t count);
+
+    std::vector<STrack> tracks;
+};
@@ -1,4 +1,6 @@
 #include "Vector.h"
+#include "../Simd/Simd.h"
+#include <cmath>
 #include <pmmintrin.h>
 #include <sstream>
 #include <iomanip>
@@ -20,12 +22,6 @@ SVector::SVector(const float& x, const float& y, const float& z)
 {
 }
 
-SVector::SVector(const __m128& value)
-    : storage{value}
-{
-    ResetUnusedAxis();
-}
-
 /*            Equality            */
 bool SVector::operator==(const SVector& rhs) const
 {
@@ -165,41 +161,17 @@ SVector operator/(const float& value, const SVector& vec)
 /*            Magnitude            */
 float SVector::Magnitude() const
 {
-    const __m128 squares = _mm_mul_ps(storage, storage);
-    
-    __m128 sums = _mm_hadd_ps(squares, squares);      // {0.0f + z, y + x, 0.0f + z, y + x }
-    sums = _mm_hadd_ps(sums, sums);                   // {0.0f + z + y + x, y + x + 0.0f + z, 0.0f + z + y + x, y + x + 0.0f + z}
-    
-    // extract the lowest component
-    const float result = _mm_cvtss_f32(sums); 
-    
-    return sqrtf(result);
+    return sqrtf(SqrMagnitude());
 }
 
 float SVector::MagnitudeXY() const
 {
-    const __m128 squares = _mm_mul_ps(storage, storage);
-
-    const __m128 sums = _mm_hadd_ps(squares, squares);      // {0.0f + z, y + x, 0.0f + z, y + x }
-
-    // let's move 1th element to 0th place in register
-    const __m128 shuffled = _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 0, 2, 3));
-    
-    const float result = _mm_cvtss_f32(shuffled);
-
-    return sqrtf(result);
+    return sqrtf(SReductionKernels::Active().dot_xy(storage, storage));
 }
 
 float SVector::SqrMagnitude() const
 {
-    const __m128 squares = _mm_mul_ps(storage, storage);
-    __m128 sums = _mm_hadd_ps(squares, squares);      // {0.0f + z, y + x, 0.0f + z, y + x }
-    sums = _mm_hadd_ps(sums, sums);                 // {0.0f + z + y + x, y + x + 0.0f + z, 0.0f + z + y + x, y + x + 0.0f + z}
-
-    // let's extract the lowest component
-    const float result = _mm_cvtss_f32(sums);
-
-    return result;
+    return SReductionKernels::Active().dot(storage, storage);
 }
 
 /*            Normalization            */
@@ -212,45 +184,93 @@ bool SVector::IsZero() const
 
 void SVector::Normalize()
 {
-    const float length = Length();
-    storage = _mm_div_ps(storage, MakeDivisor(length));
+    Normalize<SPrecisionExact>();
 }
 
 void SVector::NormalizeSafe()
 {
-    if (!IsZero())
-    {
-        Normalize();
-    }
+    NormalizeSafe<SPrecisionExact>();
+}
+
+SVector SVector::Normal() const
+{
+    return Normal<SPrecisionExact>();
+}
+
+SVector SVector::NormalSafe() const
+{
+    return NormalSafe<SPrecisionExact>();
+}
+
+/*            Precision Policies            */
+template <typename TPrecision>
+float SVector::Magnitude() const
+{
+    return _mm_cvtss_f32(TPrecision::Magnitude(_mm_set1_ps(SqrMagnitude())));
+}
+
+template <typename TPrecision>
+void SVector::Normalize()
+{
+    const __m128 factor = TPrecision::NormalizationFactor(_mm_set1_ps(SqrMagnitude()));
+
+    // the unused axis is kept as it is
+    storage = _mm_move_ss(TPrecision::Normalize(storage, factor), storage);
+}
+
+template <typename TPrecision>
+void SVector::NormalizeSafe()
+{
+    const __m128 sqr_magnitude = _mm_set1_ps(SqrMagnitude());
+    const __m128 is_positive = _mm_cmpgt_ps(sqr_magnitude, _mm_set1_ps(TPrecision::MinSqrMagnitude));
+    const __m128 normal = _mm_move_ss(TPrecision::Normalize(storage, TPrecision::NormalizationFactor(sqr_magnitude)), storage);
+    storage = Simd::Select(is_positive, normal, storage);
 }
 
+template <typename TPrecision>
 SVector SVector::Normal() const
 {
     SVector result(*this);
-    result.Normalize();
+    result.Normalize<TPrecision>();
     return result;
 }
 
+template <typename TPrecision>
 SVector SVector::NormalSafe() const
 {
-    if (!IsZero())
-    {
-        return Normal();
-    }
-    return *this;
+    SVector result(*this);
+    result.NormalizeSafe<TPrecision>();
+    return result;
 }
 
+#define INSTANTIATE_PRECISION(TPrecision) \
+    template float SVector::Magnitude<TPrecision>() const; \
+    template void SVector::Normalize<TPrecision>(); \
+    template void SVector::NormalizeSafe<TPrecision>(); \
+    template SVector SVector::Normal<TPrecision>() const; \
+    template SVector SVector::NormalSafe<TPrecision>() const;
+
+INSTANTIATE_PRECISION(SPrecisionExact)
+INSTANTIATE_PRECISION(SPrecisionFast)
+INSTANTIATE_PRECISION(SPrecisionApproximate)
+
+#undef INSTANTIATE_PRECISION
+
 /*            Dot Product            */
 float SVector::operator|(const SVector& rhs) const
 {
-    __m128 value = _mm_mul_ps(storage, rhs.storage);
-    value = _mm_hadd_ps(value, value);  // {0.0f + z, y + x, 0.0f + z, y + x }
-    value = _mm_hadd_ps(value, value);  // {0.0f + z + y + x, y + x + 0.0f + z, 0.0f + z + y + x, y + x + 0.0f + z}
+    return SReductionKernels::Active().dot(storage, rhs.storage);
+}
 
-    // extract the lowest component from register
-    const float result = _mm_cvtss_f32(value);
-    
-    return result;
+/*            Reduction Path            */
+EReductionPath SVector::GetReductionPath()
+{
+    return SReductionKernels::GetActivePath();
+}
+
+bool SVector::SetReductionPath(EReductionPath path)
+{
+    return SReductionKernels::SetActivePath(path);
 }
 
 /*            Cross Product            */
@@ -459,3 +479,30 @@ SVector SVector::RejectionToNormal(const SVector& n) const
 {
     return *this - this->ProjectionOnToNormal(n);
 }
+
+/*          Interpolation          */
+SVector SVector::Lerp(const SVector& a, const SVector& b, const float& alpha)
+{
+    return {Simd::Lerp(a.storage, b.storage, _mm_set1_ps(alpha))};
+}
+
+/*          Multiply-Add          */
+SVector SVector::MulAdd(const SVector& a, const SVector& b, const SVector& c)
+{
+    return {Simd::MulAdd(a.storage, b.storage, c.storage)};
+}
+
+SVector SVector::MulAdd(const SVector& a, const float& b, const SVector& c)
+{
+    return {Simd::MulAdd(a.storage, MakeStorage(b), c.storage)};
+}
+
+SVector SVector::MulSub(const SVector& a, const SVector& b, const SVector& c)
+{
+    return {Simd::MulSub(a.storage, b.storage, c.storage)};
+}
+
+SVector SVector::MulSub(const SVector& a, const float& b, const SVector& c)
+{
+    return {Simd::MulSub(a.storage, MakeStorage(b), c.storage)};
+}
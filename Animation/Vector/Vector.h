@@ -2,6 +2,8 @@
 
 #include <xmmintrin.h>
 #include <iostream>
+#include "VectorReduction.h"
+#include "../Simd/Precision.h"
 
 /*
 * UVector provides two ways to access the same data in memory.
@@ -51,7 +53,12 @@ struct SVector
     SVector();
     SVector(const float& value);
     SVector(const float& x, const float& y, const float& z);
-    SVector(const __m128& value);
+    // inline, so the vectors of inlined SIMD code, like 'VectorExpression', don't leave registers to be constructed
+    SVector(const __m128& value)
+        : storage{value}
+    {
+        ResetUnusedAxis();
+    }
 
     float GetX() const { return components[X_INDEX]; }
     float GetY() const { return components[Y_INDEX]; }
@@ -65,6 +72,9 @@ struct SVector
     
     void ResetUnusedAxis() { components[U_INDEX] = 0.f; }
 
+    // 128bit SIMD register of the vector, suitable for kernels that work with many vectors at once
+    const __m128& GetStorage() const { return storage; }
+
     const static SVector ZeroVector;
 
     // hexadecimal value of '15' and binary '00001111' that corresponds to a 'true' result from '_mm_movemask_ps'  
@@ -122,12 +132,31 @@ struct SVector
     SVector NormalSafe() const;
     SVector Unit() const { return Normal(); }
     SVector UnitSafe() const { return NormalSafe(); }
+
+    /*
+    * Precision policy versions: 'SPrecisionExact', 'SPrecisionFast' or 'SPrecisionApproximate'.
+    * Safe versions keep vectors with a squared magnitude up to 'TPrecision::MinSqrMagnitude' unchanged, without a branch.
+    * Methods without a policy are exact.
+    */
+    template <typename TPrecision> float Magnitude() const;
+    template <typename TPrecision> void Normalize();
+    template <typename TPrecision> void NormalizeSafe();
+    template <typename TPrecision> SVector Normal() const;
+    template <typename TPrecision> SVector NormalSafe() const;
     
     // Dot Product
     float operator|(const SVector& rhs) const;
     float DotProduct(const SVector& rhs) const { return *this | rhs; }
     static float DotProduct(const SVector& lhs, const SVector& rhs) { return lhs | rhs; }
     
+    /*
+    * Horizontal sums of '|' and the magnitudes go through kernels picked at runtime by CPU features.
+    * The default path is the fastest bit-compatible one, 'SetReductionPath' switches every thread to another one,
+    * it returns false and keeps the current path when the CPU doesn't support 'path'.
+    */
+    static EReductionPath GetReductionPath();
+    static bool SetReductionPath(EReductionPath path);
+
     // operator ^ (cross product)
     SVector& operator^=(const SVector& rhs);
     SVector operator^(const SVector& rhs) const;
@@ -166,6 +195,15 @@ struct SVector
 
     void RejectToNormal(const SVector& n);
     SVector RejectionToNormal(const SVector& n) const;
+
+    // linear interpolation, 'a' at alpha 0 and 'b' at alpha 1 exactly; FMA in builds that have it, see 'Simd::Lerp'
+    static SVector Lerp(const SVector& a, const SVector& b, const float& alpha);
+
+    // a * b + c and a * b - c, rounded once in builds with FMA
+    static SVector MulAdd(const SVector& a, const SVector& b, const SVector& c);
+    static SVector MulAdd(const SVector& a, const float& b, const SVector& c);
+    static SVector MulSub(const SVector& a, const SVector& b, const SVector& c);
+    static SVector MulSub(const SVector& a, const float& b, const SVector& c);
     
     // todo: List of methods to implement
     // outer product
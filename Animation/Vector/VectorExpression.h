@@ -0,0 +1,304 @@
+#pragma once
+
+#include <immintrin.h>
+#include <type_traits>
+
+#include "Vector.h"
+#include "../Simd/Simd.h"
+
+/*
+* An optional expression template layer of 'SVector' arithmetic. Operators on 'Lazy' vectors, 'Dot' products and floats compute
+* nothing: they build a tree of terms, and the conversion of the tree to an 'SVector' evaluates it in one inlined kernel.
+*  - a product followed by a sum or a difference is a single fused multiply-add in builds with FMA (x86-64-v3 and above), and a
+*    multiplication and an addition rounded as the 'SVector' operators round them otherwise;
+*  - scalar parts, like '(a | v) / (v | v)', are computed as floats and broadcast into a register once;
+*  - operands are copied into the tree, an expression can wait in an 'auto' variable and be evaluated later.
+* Without FMA results are bit-equal to the same expression written with 'SVector' operators and a bit-compatible reduction path;
+* with FMA every fused step rounds once instead of twice, so results can differ in the last bit. Methods of 'SVector' don't use it.
+*   const SVector rejection = Lazy(a) - Dot(a, v) / Dot(v, v) * Lazy(v);
+*/
+namespace VectorExpression
+{
+    constexpr bool IsFused{ Simd::HasFusedMultiplyAdd };
+
+    // what an expression evaluates to: a register of a vector or a float
+    struct SVectorKind {};
+    struct SScalarKind {};
+
+    template <typename T, typename = void>
+    struct SIsExpression : std::false_type {};
+
+    template <typename T>
+    struct SIsExpression<T, std::void_t<typename T::Kind>> : std::true_type {};
+
+    template <typename T>
+    constexpr bool IsVectorTerm = std::is_same_v<typename T::Kind, SVectorKind>;
+
+    template <typename T, typename = void>
+    struct SIsVectorExpression : std::false_type {};
+
+    template <typename T>
+    struct SIsVectorExpression<T, std::void_t<typename T::Kind>> : std::is_same<typename T::Kind, SVectorKind> {};
+
+    enum class EOperation
+    {
+        Add,
+        Sub,
+        Mul,
+        Div,
+    };
+
+    /*            Kernels            */
+    // the sum of 'EReductionPath::FusedMultiplyAdd' with FMA, otherwise (u + z) + (y + x) as every bit-compatible path
+    inline float DotProduct(const __m128& lhs, const __m128& rhs)
+    {
+#if defined(ANIMATION_SIMD_FMA)
+        const __m128 high = _mm_mul_ps(_mm_movehl_ps(lhs, lhs), _mm_movehl_ps(rhs, rhs));
+        const __m128 pairs = _mm_fmadd_ps(lhs, rhs, high);
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+#else
+        const __m128 value = _mm_mul_ps(lhs, rhs);
+        const __m128 pairs = _mm_add_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_movehl_ps(pairs, pairs)));
+#endif
+    }
+
+    /*            Terms            */
+    // every vector term keeps 0 in the unused lane, as 'SVector' does, so a dot product of terms doesn't see it
+    struct SVectorTerm
+    {
+        using Kind = SVectorKind;
+
+        __m128 storage;
+
+        __m128 Evaluate() const { return storage; }
+        operator SVector() const { return {storage}; }
+    };
+
+    struct SScalarTerm
+    {
+        using Kind = SScalarKind;
+
+        float value;
+
+        float Evaluate() const { return value; }
+    };
+
+    inline SVectorTerm MakeTerm(const SVector& vector) { return {vector.GetStorage()}; }
+    inline SScalarTerm MakeTerm(float value) { return {value}; }
+
+    template <typename TExpression, typename = std::enable_if_t<SIsExpression<TExpression>::value>>
+    const TExpression& MakeTerm(const TExpression& expression) { return expression; }
+
+    // term of an operand: expressions as they are, vectors and floats as leaves
+    template <typename T>
+    using TTerm = std::decay_t<decltype(MakeTerm(std::declval<const T&>()))>;
+
+    // a register of a term for an operation with a vector: a scalar in X, Y and Z, the unused lane 0
+    template <typename T>
+    __m128 AsStorage(const T& term)
+    {
+        if constexpr (IsVectorTerm<T>)
+        {
+            return term.Evaluate();
+        }
+        else
+        {
+            return SVector::MakeStorage(term.Evaluate());
+        }
+    }
+
+    // as 'AsStorage', with 1 in the unused lane of a scalar as 'SVector' divides by a float
+    template <typename T>
+    __m128 AsDivisor(const T& term)
+    {
+        if constexpr (IsVectorTerm<T>)
+        {
+            return term.Evaluate();
+        }
+        else
+        {
+            return SVector::MakeDivisor(term.Evaluate());
+        }
+    }
+
+    template <EOperation Operation, typename TLhs, typename TRhs>
+    struct SVectorOperation;
+
+    // products of two terms of which one is a vector, the products that fuse into a following sum or difference
+    template <typename T>
+    struct SIsProduct : std::false_type {};
+
+    template <typename TLhs, typename TRhs>
+    struct SIsProduct<SVectorOperation<EOperation::Mul, TLhs, TRhs>> : std::true_type {};
+
+    template <EOperation Operation, typename TLhs, typename TRhs>
+    struct SVectorOperation
+    {
+        using Kind = SVectorKind;
+
+        TLhs lhs;
+        TRhs rhs;
+
+        __m128 Evaluate() const
+        {
+            if constexpr (Operation == EOperation::Add)
+            {
+                if constexpr (SIsProduct<TLhs>::value)
+                {
+                    return Simd::MulAdd(AsStorage(lhs.lhs), AsStorage(lhs.rhs), AsStorage(rhs));
+                }
+                else if constexpr (SIsProduct<TRhs>::value)
+                {
+                    return Simd::MulAdd(AsStorage(rhs.lhs), AsStorage(rhs.rhs), AsStorage(lhs));
+                }
+                else
+                {
+                    return _mm_add_ps(AsStorage(lhs), AsStorage(rhs));
+                }
+            }
+            else if constexpr (Operation == EOperation::Sub)
+            {
+                if constexpr (SIsProduct<TRhs>::value)
+                {
+                    return Simd::NegativeMulAdd(AsStorage(rhs.lhs), AsStorage(rhs.rhs), AsStorage(lhs));
+                }
+                else if constexpr (SIsProduct<TLhs>::value)
+                {
+                    return Simd::MulSub(AsStorage(lhs.lhs), AsStorage(lhs.rhs), AsStorage(rhs));
+                }
+                else
+                {
+                    return _mm_sub_ps(AsStorage(lhs), AsStorage(rhs));
+                }
+            }
+            else if constexpr (Operation == EOperation::Mul)
+            {
+                return _mm_mul_ps(AsStorage(lhs), AsStorage(rhs));
+            }
+            else
+            {
+                const __m128 quotient = _mm_div_ps(AsStorage(lhs), AsDivisor(rhs));
+                if constexpr (IsVectorTerm<TRhs>)
+                {
+                    // 0 / 0 in the unused lane
+                    return _mm_move_ss(quotient, _mm_setzero_ps());
+                }
+                else
+                {
+                    return quotient;
+                }
+            }
+        }
+
+        operator SVector() const { return {Evaluate()}; }
+    };
+
+    template <EOperation Operation, typename TLhs, typename TRhs>
+    struct SScalarOperation
+    {
+        using Kind = SScalarKind;
+
+        TLhs lhs;
+        TRhs rhs;
+
+        float Evaluate() const
+        {
+            const float a = lhs.Evaluate();
+            const float b = rhs.Evaluate();
+            if constexpr (Operation == EOperation::Add)
+            {
+                return a + b;
+            }
+            else if constexpr (Operation == EOperation::Sub)
+            {
+                return a - b;
+            }
+            else if constexpr (Operation == EOperation::Mul)
+            {
+                return a * b;
+            }
+            else
+            {
+                return a / b;
+            }
+        }
+    };
+
+    template <typename T>
+    struct SVectorNegation
+    {
+        using Kind = SVectorKind;
+
+        T term;
+
+        // the sign of the unused lane stays, a dot product with -0 in it would round a -0 sum differently
+        __m128 Evaluate() const
+        {
+            const __m128 value = term.Evaluate();
+            return _mm_move_ss(_mm_xor_ps(value, _mm_set1_ps(-0.f)), value);
+        }
+
+        operator SVector() const { return {Evaluate()}; }
+    };
+
+    template <typename TLhs, typename TRhs>
+    struct SDot
+    {
+        using Kind = SScalarKind;
+
+        TLhs lhs;
+        TRhs rhs;
+
+        float Evaluate() const { return DotProduct(lhs.Evaluate(), rhs.Evaluate()); }
+    };
+
+    /*            Operators            */
+    template <typename T>
+    constexpr bool IsOperand = SIsExpression<T>::value || std::is_same_v<T, SVector> || std::is_arithmetic_v<T>;
+
+    // operators of this layer take an expression on at least one side, 'SVector' operators keep the rest
+    template <typename TLhs, typename TRhs>
+    constexpr bool IsExpressionOperation = (SIsExpression<TLhs>::value || SIsExpression<TRhs>::value) && IsOperand<TLhs> && IsOperand<TRhs>;
+
+    template <EOperation Operation, typename TLhs, typename TRhs>
+    auto MakeOperation(const TLhs& lhs, const TRhs& rhs)
+    {
+        using TLhsTerm = TTerm<TLhs>;
+        using TRhsTerm = TTerm<TRhs>;
+        if constexpr (IsVectorTerm<TLhsTerm> || IsVectorTerm<TRhsTerm>)
+        {
+            return SVectorOperation<Operation, TLhsTerm, TRhsTerm>{MakeTerm(lhs), MakeTerm(rhs)};
+        }
+        else
+        {
+            return SScalarOperation<Operation, TLhsTerm, TRhsTerm>{MakeTerm(lhs), MakeTerm(rhs)};
+        }
+    }
+
+    template <typename TLhs, typename TRhs, typename = std::enable_if_t<IsExpressionOperation<TLhs, TRhs>>>
+    auto operator+(const TLhs& lhs, const TRhs& rhs) { return MakeOperation<EOperation::Add>(lhs, rhs); }
+
+    template <typename TLhs, typename TRhs, typename = std::enable_if_t<IsExpressionOperation<TLhs, TRhs>>>
+    auto operator-(const TLhs& lhs, const TRhs& rhs) { return MakeOperation<EOperation::Sub>(lhs, rhs); }
+
+    template <typename TLhs, typename TRhs, typename = std::enable_if_t<IsExpressionOperation<TLhs, TRhs>>>
+    auto operator*(const TLhs& lhs, const TRhs& rhs) { return MakeOperation<EOperation::Mul>(lhs, rhs); }
+
+    template <typename TLhs, typename TRhs, typename = std::enable_if_t<IsExpressionOperation<TLhs, TRhs>>>
+    auto operator/(const TLhs& lhs, const TRhs& rhs) { return MakeOperation<EOperation::Div>(lhs, rhs); }
+
+    template <typename T, typename = std::enable_if_t<SIsVectorExpression<T>::value>>
+    SVectorNegation<T> operator-(const T& term) { return {term}; }
+
+    // a vector that takes part in expressions
+    inline SVectorTerm Lazy(const SVector& vector) { return {vector.GetStorage()}; }
+
+    // dot product of two vectors or vector expressions, a scalar expression
+    template <typename TLhs, typename TRhs>
+    SDot<TTerm<TLhs>, TTerm<TRhs>> Dot(const TLhs& lhs, const TRhs& rhs)
+    {
+        static_assert(IsVectorTerm<TTerm<TLhs>> && IsVectorTerm<TTerm<TRhs>>, "a dot product of two vectors");
+        return {MakeTerm(lhs), MakeTerm(rhs)};
+    }
+}
@@ -0,0 +1,112 @@
+#include "VectorInterpolation.h"
+
+#include "../Profile/ProfileScope.h"
+#include "../Simd/Simd.h"
+
+namespace
+{
+    using InterpolationPack = Simd::FloatPack;
+
+    // whole vectors in a register: 1 with SSE, 2 with AVX, 4 with AVX-512
+    constexpr size_t InterpolationPackWidth{ Simd::SPackTraits<InterpolationPack>::Width / 4 };
+
+    // the factor of every vector in its four lanes, overloads of narrower registers are unused in wider builds
+    [[maybe_unused]] __m128 BroadcastFactors(const float* factors, __m128)
+    {
+        return _mm_set1_ps(factors[0]);
+    }
+
+#if defined(__AVX__)
+    [[maybe_unused]] __m256 BroadcastFactors(const float* factors, __m256)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(factors[0])), _mm_set1_ps(factors[1]), 1);
+    }
+#endif
+
+#if defined(__AVX512F__)
+    __m512 BroadcastFactors(const float* factors, __m512)
+    {
+        const __m512i lanes = _mm512_set_epi32(3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0);
+        return _mm512_permutexvar_ps(lanes, _mm512_castps128_ps512(_mm_loadu_ps(factors)));
+    }
+#endif
+
+    /*
+    * Calls 'kernel(i, register)' for vector 'i' of every register of 'InterpolationPackWidth' vectors, then for each remaining vector
+    * with an '__m128': the kernel is a generic lambda, the type of the register picks the overloads of loads, stores and broadcasts.
+    */
+    template <typename TKernel>
+    void ForEachPack(size_t count, TKernel kernel)
+    {
+        size_t i = 0;
+        for (; i + InterpolationPackWidth <= count; i += InterpolationPackWidth)
+        {
+            kernel(i, InterpolationPack{});
+        }
+        for (; i < count; ++i)
+        {
+            kernel(i, __m128{});
+        }
+    }
+
+    // loads of 'ForEachPack' kernels, by the register type of the iteration
+    InterpolationPack LoadVectors(const SVector* vectors, InterpolationPack)
+    {
+        return Simd::LoadUnaligned<InterpolationPack>(reinterpret_cast<const float*>(vectors));
+    }
+
+    void StoreVectors(SVector* vectors, const InterpolationPack& value)
+    {
+        Simd::StoreUnaligned(reinterpret_cast<float*>(vectors), value);
+    }
+
+#if defined(__AVX__)
+    __m128 LoadVectors(const SVector* vectors, __m128) { return vectors->GetStorage(); }
+    void StoreVectors(SVector* vectors, const __m128& value) { _mm_store_ps(reinterpret_cast<float*>(vectors), value); }
+#endif
+}
+
+void SVectorInterpolation::Lerp(const SVector* from, const SVector* to, const float* alphas, SVector* out, size_t count)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorInterpolation::Lerp");
+    ForEachPack(count, [=](size_t i, auto pack)
+    {
+        StoreVectors(out + i, Simd::Lerp(LoadVectors(from + i, pack), LoadVectors(to + i, pack), BroadcastFactors(alphas + i, pack)));
+    });
+}
+
+void SVectorInterpolation::Lerp(const SVector* from, const SVector* to, float alpha, SVector* out, size_t count)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorInterpolation::Lerp");
+    ForEachPack(count, [=](size_t i, auto pack)
+    {
+        StoreVectors(out + i, Simd::Lerp(LoadVectors(from + i, pack), LoadVectors(to + i, pack), Simd::Set(alpha, pack)));
+    });
+}
+
+void SVectorInterpolation::MulAdd(const SVector* a, const SVector* b, const SVector* c, SVector* out, size_t count)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorInterpolation::MulAdd");
+    ForEachPack(count, [=](size_t i, auto pack)
+    {
+        StoreVectors(out + i, Simd::MulAdd(LoadVectors(a + i, pack), LoadVectors(b + i, pack), LoadVectors(c + i, pack)));
+    });
+}
+
+void SVectorInterpolation::MulAdd(const SVector* a, const float* scales, const SVector* c, SVector* out, size_t count)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorInterpolation::MulAdd");
+    ForEachPack(count, [=](size_t i, auto pack)
+    {
+        StoreVectors(out + i, Simd::MulAdd(LoadVectors(a + i, pack), BroadcastFactors(scales + i, pack), LoadVectors(c + i, pack)));
+    });
+}
+
+void SVectorInterpolation::MulAdd(const SVector* a, float scale, const SVector* c, SVector* out, size_t count)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorInterpolation::MulAdd");
+    ForEachPack(count, [=](size_t i, auto pack)
+    {
+        StoreVectors(out + i, Simd::MulAdd(LoadVectors(a + i, pack), Simd::Set(scale, pack), LoadVectors(c + i, pack)));
+    });
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "Vector.h"
+
+/*
+* SVectorInterpolation runs 'SVector::Lerp' and 'SVector::MulAdd' over arrays of vectors, with a factor per vector or one for all:
+*   Lerp:   out[i] = Lerp(from[i], to[i], alphas[i])
+*   MulAdd: out[i] = a[i] * scales[i] + c[i]
+* Kernels load 1 (SSE), 2 (AVX) or 4 (AVX-512) vectors per register and use fused multiply-adds in builds with FMA. Every lane
+* rounds as the single vector functions and as 'Simd::Lerp' / 'Simd::MulAdd' on floats, so results are bit-equal to them.
+* 'out' may be the same array as any input.
+*/
+struct SVectorInterpolation
+{
+    static void Lerp(const SVector* from, const SVector* to, const float* alphas, SVector* out, size_t count);
+    static void Lerp(const SVector* from, const SVector* to, float alpha, SVector* out, size_t count);
+
+    static void MulAdd(const SVector* a, const SVector* b, const SVector* c, SVector* out, size_t count);
+    static void MulAdd(const SVector* a, const float* scales, const SVector* c, SVector* out, size_t count);
+    static void MulAdd(const SVector* a, float scale, const SVector* c, SVector* out, size_t count);
+};
@@ -0,0 +1,162 @@
+#include "VectorReduction.h"
+#include "../Simd/CpuFeatures.h"
+
+#include <initializer_list>
+#include <immintrin.h>
+
+namespace
+{
+    /*            HorizontalAdd            */
+    ANIMATION_TARGET("sse3") float DotHorizontalAdd(const __m128& lhs, const __m128& rhs)
+    {
+        __m128 value = _mm_mul_ps(lhs, rhs);
+        value = _mm_hadd_ps(value, value);  // {u + z, y + x, u + z, y + x}
+        value = _mm_hadd_ps(value, value);  // {(u + z) + (y + x), ...}
+        return _mm_cvtss_f32(value);
+    }
+
+    ANIMATION_TARGET("sse3") float DotXYHorizontalAdd(const __m128& lhs, const __m128& rhs)
+    {
+        __m128 value = _mm_mul_ps(lhs, rhs);
+        value = _mm_hadd_ps(value, value);  // {u + z, y + x, u + z, y + x}
+        return _mm_cvtss_f32(_mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 2, 3)));
+    }
+
+    /*            ShuffleAdd            */
+    float DotShuffleAdd(const __m128& lhs, const __m128& rhs)
+    {
+        const __m128 value = _mm_mul_ps(lhs, rhs);
+        const __m128 pairs = _mm_add_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));  // {u + z, ..., y + x, ...}
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_movehl_ps(pairs, pairs)));
+    }
+
+    float DotXYShuffleAdd(const __m128& lhs, const __m128& rhs)
+    {
+        const __m128 value = _mm_mul_ps(lhs, rhs);
+        const __m128 high = _mm_movehl_ps(value, value);  // {y, x, y, x}
+        return _mm_cvtss_f32(_mm_add_ss(_mm_shuffle_ps(high, high, _MM_SHUFFLE(0, 0, 0, 1)), high));
+    }
+
+    /*            DotProduct            */
+    // '_mm_dp_ps' sums products as (lane 0 + lane 1) + (lane 2 + lane 3), the order of two '_mm_hadd_ps'
+    ANIMATION_TARGET("sse4.1") float DotDotProduct(const __m128& lhs, const __m128& rhs)
+    {
+        return _mm_cvtss_f32(_mm_dp_ps(lhs, rhs, 0xF1));
+    }
+
+    ANIMATION_TARGET("sse4.1") float DotXYDotProduct(const __m128& lhs, const __m128& rhs)
+    {
+        return _mm_cvtss_f32(_mm_dp_ps(lhs, rhs, 0xC1));
+    }
+
+    /*            FusedMultiplyAdd            */
+    ANIMATION_TARGET("fma") float DotFusedMultiplyAdd(const __m128& lhs, const __m128& rhs)
+    {
+        // {y * y', x * x'} + {u * u', z * z'} with one rounding per lane
+        const __m128 high = _mm_mul_ps(_mm_movehl_ps(lhs, lhs), _mm_movehl_ps(rhs, rhs));
+        const __m128 pairs = _mm_fmadd_ps(lhs, rhs, high);
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+
+    ANIMATION_TARGET("fma") float DotXYFusedMultiplyAdd(const __m128& lhs, const __m128& rhs)
+    {
+        const __m128 lhs_high = _mm_movehl_ps(lhs, lhs);
+        const __m128 rhs_high = _mm_movehl_ps(rhs, rhs);
+        const __m128 y = _mm_mul_ss(lhs_high, rhs_high);
+        const __m128 x = _mm_fmadd_ss(_mm_shuffle_ps(lhs_high, lhs_high, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(rhs_high, rhs_high, _MM_SHUFFLE(1, 1, 1, 1)), y);
+        return _mm_cvtss_f32(x);
+    }
+
+    // indexed by 'EReductionPath'
+    const SReductionKernels Kernels[]{
+        {DotHorizontalAdd, DotXYHorizontalAdd},
+        {DotShuffleAdd, DotXYShuffleAdd},
+        {DotDotProduct, DotXYDotProduct},
+        {DotFusedMultiplyAdd, DotXYFusedMultiplyAdd},
+    };
+}
+
+std::atomic<const SReductionKernels*> SReductionKernels::ActiveKernels{ nullptr };
+
+bool SReductionKernels::IsSupported(EReductionPath path)
+{
+    const SCpuFeatures& features = SCpuFeatures::Get();
+    switch (path)
+    {
+    case EReductionPath::HorizontalAdd:
+        return features.sse3;
+    case EReductionPath::ShuffleAdd:
+        return true;
+    case EReductionPath::DotProduct:
+        return features.sse41;
+    case EReductionPath::FusedMultiplyAdd:
+        return features.fma;
+    }
+    return false;
+}
+
+EReductionPath SReductionKernels::DefaultPath()
+{
+    /*
+    * Preference by 'AnimationBenchmark SReductionKernels' throughput, bit-compatible paths only:
+    * ShuffleAdd 1.7 ns, HorizontalAdd 1.8 ns, DotProduct 3.1 ns per call on a Xeon with AVX-512;
+    * '_mm_dp_ps' decodes to 4 uops and '_mm_hadd_ps' to 3, shuffles and adds are single uops on every core.
+    */
+    for (const EReductionPath path : { EReductionPath::ShuffleAdd, EReductionPath::HorizontalAdd, EReductionPath::DotProduct })
+    {
+        if (IsSupported(path))
+        {
+            return path;
+        }
+    }
+    return EReductionPath::ShuffleAdd;
+}
+
+const SReductionKernels& SReductionKernels::Get(EReductionPath path)
+{
+    return Kernels[static_cast<size_t>(path)];
+}
+
+const SReductionKernels& SReductionKernels::SelectDefault()
+{
+    // every thread racing here picks the same table, a path set explicitly in the meantime wins
+    const SReductionKernels* expected = nullptr;
+    const SReductionKernels* kernels = &Get(DefaultPath());
+    if (!ActiveKernels.compare_exchange_strong(expected, kernels, std::memory_order_acq_rel))
+    {
+        return *expected;
+    }
+    return *kernels;
+}
+
+EReductionPath SReductionKernels::GetActivePath()
+{
+    return static_cast<EReductionPath>(&Active() - Kernels);
+}
+
+bool SReductionKernels::SetActivePath(EReductionPath path)
+{
+    if (!IsSupported(path))
+    {
+        return false;
+    }
+
+    ActiveKernels.store(&Get(path), std::memory_order_release);
+    return true;
+}
+
+const char* SReductionKernels::GetName(EReductionPath path)
+{
+    switch (path)
+    {
+    case EReductionPath::HorizontalAdd:
+        return "HorizontalAdd";
+    case EReductionPath::ShuffleAdd:
+        return "ShuffleAdd";
+    case EReductionPath::DotProduct:
+        return "DotProduct";
+    case EReductionPath::FusedMultiplyAdd:
+        return "FusedMultiplyAdd";
+    }
+    return "Unknown";
+}
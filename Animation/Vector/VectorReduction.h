@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <xmmintrin.h>
+
+// implementation of the horizontal sums behind 'SVector::operator|' and the magnitudes
+enum class EReductionPath
+{
+    // two '_mm_hadd_ps', SSE3
+    HorizontalAdd,
+    // shuffles and adds, plain SSE
+    ShuffleAdd,
+    // a single '_mm_dp_ps', SSE4.1
+    DotProduct,
+    // fused multiply-add, FMA3; products aren't rounded separately, so results differ in the last bits
+    FusedMultiplyAdd,
+};
+
+/*
+* SReductionKernels is a table of horizontal sums of lane products for one 'EReductionPath'.
+* HorizontalAdd, ShuffleAdd and DotProduct sum products in the same order, (u * u' + z * z') + (y * y' + x * x'),
+* so their results are bit-equal and any of them can be picked by CPU features without changing behaviour.
+* FusedMultiplyAdd rounds two of the products together with the sums, it is used only when selected explicitly.
+*/
+struct SReductionKernels
+{
+    using ReductionFunction = float (*)(const __m128& lhs, const __m128& rhs);
+
+    // sum of products of all four lanes, the unused lane of a vector is zero
+    ReductionFunction dot;
+    // sum of products of X and Y lanes
+    ReductionFunction dot_xy;
+
+    // returns false when the running CPU lacks instructions of 'path'
+    static bool IsSupported(EReductionPath path);
+
+    // the fastest bit-compatible path of the running CPU
+    static EReductionPath DefaultPath();
+
+    static const SReductionKernels& Get(EReductionPath path);
+
+    // kernels of the active path, the default path is selected on the first call
+    static const SReductionKernels& Active()
+    {
+        const SReductionKernels* kernels = ActiveKernels.load(std::memory_order_acquire);
+        return kernels != nullptr ? *kernels : SelectDefault();
+    }
+
+    static EReductionPath GetActivePath();
+    // returns false and keeps the active path when 'path' isn't supported
+    static bool SetActivePath(EReductionPath path);
+
+    static const char* GetName(EReductionPath path);
+
+private:
+    // constant initialized, so 'SVector' methods called from static constructors of other files see either null or a valid table
+    static std::atomic<const SReductionKernels*> ActiveKernels;
+
+    static const SReductionKernels& SelectDefault();
+};
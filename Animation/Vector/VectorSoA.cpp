@@ -0,0 +1,508 @@
+#include "VectorSoA.h"
+
+#include "../Profile/ProfileScope.h"
+#include "../Simd/Precision.h"
+#include "../Simd/Simd.h"
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+    using VectorPack = Simd::FloatPack;
+    constexpr size_t VectorPackWidth{ Simd::SPackTraits<VectorPack>::Width };
+
+    // writes a register of scalar results, the last register of a stream is cut to the size of the destination
+    void StoreScalars(float* out, size_t index, size_t size, const VectorPack& value)
+    {
+        if (index + VectorPackWidth <= size)
+        {
+            Simd::StoreUnaligned(out + index, value);
+            return;
+        }
+
+        alignas(SVectorSoA::Alignment) float buffer[VectorPackWidth];
+        Simd::Store(buffer, value);
+        std::memcpy(out + index, buffer, (size - index) * sizeof(float));
+    }
+
+    // applies 'kernel' to every register of two streams: kernel(lx, ly, lz, rx, ry, rz, out_x, out_y, out_z)
+    template <typename TKernel>
+    void ForEachVector(const SVectorSoA& lhs, const SVectorSoA& rhs, SVectorSoA& out, TKernel kernel)
+    {
+        assert(lhs.Size() == rhs.Size());
+        out.Resize(lhs.Size());
+
+        const float* lx = lhs.GetX(); const float* ly = lhs.GetY(); const float* lz = lhs.GetZ();
+        const float* rx = rhs.GetX(); const float* ry = rhs.GetY(); const float* rz = rhs.GetZ();
+        float* ox = out.GetX(); float* oy = out.GetY(); float* oz = out.GetZ();
+
+        const size_t count = lhs.PaddedSize();
+        for (size_t i = 0; i < count; i += VectorPackWidth)
+        {
+            VectorPack x, y, z;
+            kernel(Simd::Load<VectorPack>(lx + i), Simd::Load<VectorPack>(ly + i), Simd::Load<VectorPack>(lz + i),
+                   Simd::Load<VectorPack>(rx + i), Simd::Load<VectorPack>(ry + i), Simd::Load<VectorPack>(rz + i),
+                   x, y, z);
+            Simd::Store(ox + i, x);
+            Simd::Store(oy + i, y);
+            Simd::Store(oz + i, z);
+        }
+    }
+
+    // applies 'kernel' to every register of a stream: kernel(x, y, z, out_x, out_y, out_z)
+    template <typename TKernel>
+    void ForEachVector(const SVectorSoA& vectors, SVectorSoA& out, TKernel kernel)
+    {
+        out.Resize(vectors.Size());
+
+        const float* vx = vectors.GetX(); const float* vy = vectors.GetY(); const float* vz = vectors.GetZ();
+        float* ox = out.GetX(); float* oy = out.GetY(); float* oz = out.GetZ();
+
+        const size_t count = vectors.PaddedSize();
+        for (size_t i = 0; i < count; i += VectorPackWidth)
+        {
+            VectorPack x, y, z;
+            kernel(Simd::Load<VectorPack>(vx + i), Simd::Load<VectorPack>(vy + i), Simd::Load<VectorPack>(vz + i), x, y, z);
+            Simd::Store(ox + i, x);
+            Simd::Store(oy + i, y);
+            Simd::Store(oz + i, z);
+        }
+    }
+
+    // 'SVector::operator|' sums {0.0f + z, y + x} with two horizontal additions, the same order is (x + y) + z
+    VectorPack Dot(const VectorPack& lx, const VectorPack& ly, const VectorPack& lz, const VectorPack& rx, const VectorPack& ry, const VectorPack& rz)
+    {
+        const VectorPack xy = Simd::Add(Simd::Mul(lx, rx), Simd::Mul(ly, ry));
+        return Simd::Add(xy, Simd::Mul(lz, rz));
+    }
+
+    // 'SVector::NormalSafe' without a branch: vectors with a squared magnitude up to 'TPrecision::MinSqrMagnitude' are kept as they are
+    template <typename TPrecision>
+    void NormalSafe(const VectorPack& x, const VectorPack& y, const VectorPack& z, VectorPack& out_x, VectorPack& out_y, VectorPack& out_z)
+    {
+        const VectorPack sqr_magnitude = Dot(x, y, z, x, y, z);
+        const VectorPack factor = TPrecision::NormalizationFactor(sqr_magnitude);
+        const auto is_positive = Simd::CmpGt(sqr_magnitude, Simd::Set<VectorPack>(TPrecision::MinSqrMagnitude));
+        out_x = Simd::Select(is_positive, TPrecision::Normalize(x, factor), x);
+        out_y = Simd::Select(is_positive, TPrecision::Normalize(y, factor), y);
+        out_z = Simd::Select(is_positive, TPrecision::Normalize(z, factor), z);
+    }
+}
+
+SVectorSoA::SVectorSoA()
+{
+}
+
+SVectorSoA::SVectorSoA(size_t size)
+{
+    Resize(size);
+}
+
+SVectorSoA::SVectorSoA(const SVector* vectors, size_t count)
+{
+    Assign(vectors, count);
+}
+
+SVectorSoA::SVectorSoA(const SVectorSoA& other)
+{
+    *this = other;
+}
+
+SVectorSoA::SVectorSoA(SVectorSoA&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+SVectorSoA::~SVectorSoA()
+{
+    _mm_free(x);
+}
+
+SVectorSoA& SVectorSoA::operator=(const SVectorSoA& other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    size = 0;
+    Reserve(other.size);
+    size = other.size;
+    std::memcpy(x, other.x, size * sizeof(float));
+    std::memcpy(y, other.y, size * sizeof(float));
+    std::memcpy(z, other.z, size * sizeof(float));
+    return *this;
+}
+
+SVectorSoA& SVectorSoA::operator=(SVectorSoA&& other) noexcept
+{
+    std::swap(x, other.x);
+    std::swap(y, other.y);
+    std::swap(z, other.z);
+    std::swap(size, other.size);
+    std::swap(capacity, other.capacity);
+    return *this;
+}
+
+/*            Size & Capacity            */
+void SVectorSoA::Reallocate(size_t count)
+{
+    const size_t new_capacity = RoundUp(count);
+    float* block = static_cast<float*>(_mm_malloc(3 * new_capacity * sizeof(float), Alignment));
+    float* new_y = block + new_capacity;
+    float* new_z = new_y + new_capacity;
+
+    if (size > 0)
+    {
+        std::memcpy(block, x, size * sizeof(float));
+        std::memcpy(new_y, y, size * sizeof(float));
+        std::memcpy(new_z, z, size * sizeof(float));
+    }
+
+    _mm_free(x);
+    x = block;
+    y = new_y;
+    z = new_z;
+    capacity = new_capacity;
+}
+
+void SVectorSoA::Reserve(size_t count)
+{
+    if (count > capacity)
+    {
+        Reallocate(count);
+    }
+}
+
+void SVectorSoA::Resize(size_t count)
+{
+    Reserve(count);
+    if (count > size)
+    {
+        const size_t added = count - size;
+        std::memset(x + size, 0, added * sizeof(float));
+        std::memset(y + size, 0, added * sizeof(float));
+        std::memset(z + size, 0, added * sizeof(float));
+    }
+    size = count;
+}
+
+void SVectorSoA::PushBack(const SVector& value)
+{
+    if (size == capacity)
+    {
+        Reallocate(capacity == 0 ? PaddingGranularity : capacity * 2);
+    }
+    ++size;
+    Set(size - 1, value);
+}
+
+void SVectorSoA::Set(size_t index, const SVector& value)
+{
+    x[index] = value.GetX();
+    y[index] = value.GetY();
+    z[index] = value.GetZ();
+}
+
+/*            Conversion            */
+void SVectorSoA::Assign(const SVector* vectors, size_t count)
+{
+    size = 0;
+    Reserve(count);
+    size = count;
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        // rows are {U, Z, Y, X}, after the transpose every register keeps one axis of four vectors
+        __m128 r0 = vectors[i + 0].GetStorage();
+        __m128 r1 = vectors[i + 1].GetStorage();
+        __m128 r2 = vectors[i + 2].GetStorage();
+        __m128 r3 = vectors[i + 3].GetStorage();
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        _mm_store_ps(x + i, r3);
+        _mm_store_ps(y + i, r2);
+        _mm_store_ps(z + i, r1);
+    }
+
+    for (; i < count; ++i)
+    {
+        Set(i, vectors[i]);
+    }
+}
+
+void SVectorSoA::CopyTo(SVector* vectors) const
+{
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128 r0 = _mm_setzero_ps();
+        __m128 r1 = _mm_load_ps(z + i);
+        __m128 r2 = _mm_load_ps(y + i);
+        __m128 r3 = _mm_load_ps(x + i);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        vectors[i + 0] = SVector(r0);
+        vectors[i + 1] = SVector(r1);
+        vectors[i + 2] = SVector(r2);
+        vectors[i + 3] = SVector(r3);
+    }
+
+    for (; i < size; ++i)
+    {
+        vectors[i] = Get(i);
+    }
+}
+
+/*            Addition            */
+void SVectorSoA::Add(const SVectorSoA& lhs, const SVectorSoA& rhs, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Add");
+    ForEachVector(lhs, rhs, out, [](const VectorPack& lx, const VectorPack& ly, const VectorPack& lz, const VectorPack& rx, const VectorPack& ry, const VectorPack& rz,
+                                    VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        x = Simd::Add(lx, rx);
+        y = Simd::Add(ly, ry);
+        z = Simd::Add(lz, rz);
+    });
+}
+
+void SVectorSoA::Add(const SVectorSoA& lhs, const float& value, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Add");
+    const VectorPack rhs = Simd::Set<VectorPack>(value);
+    ForEachVector(lhs, out, [&rhs](const VectorPack& vx, const VectorPack& vy, const VectorPack& vz, VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        x = Simd::Add(vx, rhs);
+        y = Simd::Add(vy, rhs);
+        z = Simd::Add(vz, rhs);
+    });
+}
+
+/*            Subtraction            */
+void SVectorSoA::Sub(const SVectorSoA& lhs, const SVectorSoA& rhs, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Sub");
+    ForEachVector(lhs, rhs, out, [](const VectorPack& lx, const VectorPack& ly, const VectorPack& lz, const VectorPack& rx, const VectorPack& ry, const VectorPack& rz,
+                                    VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        x = Simd::Sub(lx, rx);
+        y = Simd::Sub(ly, ry);
+        z = Simd::Sub(lz, rz);
+    });
+}
+
+void SVectorSoA::Sub(const SVectorSoA& lhs, const float& value, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Sub");
+    const VectorPack rhs = Simd::Set<VectorPack>(value);
+    ForEachVector(lhs, out, [&rhs](const VectorPack& vx, const VectorPack& vy, const VectorPack& vz, VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        x = Simd::Sub(vx, rhs);
+        y = Simd::Sub(vy, rhs);
+        z = Simd::Sub(vz, rhs);
+    });
+}
+
+/*            Multiplication            */
+void SVectorSoA::Mul(const SVectorSoA& lhs, const SVectorSoA& rhs, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Mul");
+    ForEachVector(lhs, rhs, out, [](const VectorPack& lx, const VectorPack& ly, const VectorPack& lz, const VectorPack& rx, const VectorPack& ry, const VectorPack& rz,
+                                    VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        x = Simd::Mul(lx, rx);
+        y = Simd::Mul(ly, ry);
+        z = Simd::Mul(lz, rz);
+    });
+}
+
+void SVectorSoA::Mul(const SVectorSoA& lhs, const float& value, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Mul");
+    const VectorPack rhs = Simd::Set<VectorPack>(value);
+    ForEachVector(lhs, out, [&rhs](const VectorPack& vx, const VectorPack& vy, const VectorPack& vz, VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        x = Simd::Mul(vx, rhs);
+        y = Simd::Mul(vy, rhs);
+        z = Simd::Mul(vz, rhs);
+    });
+}
+
+/*            Division            */
+void SVectorSoA::Div(const SVectorSoA& lhs, const SVectorSoA& rhs, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Div");
+    ForEachVector(lhs, rhs, out, [](const VectorPack& lx, const VectorPack& ly, const VectorPack& lz, const VectorPack& rx, const VectorPack& ry, const VectorPack& rz,
+                                    VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        x = Simd::Div(lx, rx);
+        y = Simd::Div(ly, ry);
+        z = Simd::Div(lz, rz);
+    });
+}
+
+void SVectorSoA::Div(const SVectorSoA& lhs, const float& value, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Div");
+    const VectorPack rhs = Simd::Set<VectorPack>(value);
+    ForEachVector(lhs, out, [&rhs](const VectorPack& vx, const VectorPack& vy, const VectorPack& vz, VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        x = Simd::Div(vx, rhs);
+        y = Simd::Div(vy, rhs);
+        z = Simd::Div(vz, rhs);
+    });
+}
+
+/*            Dot Product            */
+void SVectorSoA::Dot(const SVectorSoA& lhs, const SVectorSoA& rhs, float* out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Dot");
+    assert(lhs.Size() == rhs.Size());
+
+    const size_t count = lhs.Size();
+    for (size_t i = 0; i < count; i += VectorPackWidth)
+    {
+        const VectorPack dot = ::Dot(Simd::Load<VectorPack>(lhs.x + i), Simd::Load<VectorPack>(lhs.y + i), Simd::Load<VectorPack>(lhs.z + i),
+                               Simd::Load<VectorPack>(rhs.x + i), Simd::Load<VectorPack>(rhs.y + i), Simd::Load<VectorPack>(rhs.z + i));
+        StoreScalars(out, i, count, dot);
+    }
+}
+
+/*            Cross Product            */
+void SVectorSoA::Cross(const SVectorSoA& lhs, const SVectorSoA& rhs, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Cross");
+    ForEachVector(lhs, rhs, out, [](const VectorPack& lx, const VectorPack& ly, const VectorPack& lz, const VectorPack& rx, const VectorPack& ry, const VectorPack& rz,
+                                    VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        x = Simd::Sub(Simd::Mul(ly, rz), Simd::Mul(lz, ry));
+        y = Simd::Sub(Simd::Mul(lz, rx), Simd::Mul(lx, rz));
+        z = Simd::Sub(Simd::Mul(lx, ry), Simd::Mul(ly, rx));
+    });
+}
+
+/*            Magnitude            */
+void SVectorSoA::Magnitude(const SVectorSoA& vectors, float* out)
+{
+    Magnitude<SPrecisionExact>(vectors, out);
+}
+
+template <typename TPrecision>
+void SVectorSoA::Magnitude(const SVectorSoA& vectors, float* out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Magnitude");
+    const size_t count = vectors.Size();
+    for (size_t i = 0; i < count; i += VectorPackWidth)
+    {
+        const VectorPack x = Simd::Load<VectorPack>(vectors.x + i);
+        const VectorPack y = Simd::Load<VectorPack>(vectors.y + i);
+        const VectorPack z = Simd::Load<VectorPack>(vectors.z + i);
+        StoreScalars(out, i, count, TPrecision::Magnitude(::Dot(x, y, z, x, y, z)));
+    }
+}
+
+void SVectorSoA::SqrMagnitude(const SVectorSoA& vectors, float* out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::SqrMagnitude");
+    const size_t count = vectors.Size();
+    for (size_t i = 0; i < count; i += VectorPackWidth)
+    {
+        const VectorPack x = Simd::Load<VectorPack>(vectors.x + i);
+        const VectorPack y = Simd::Load<VectorPack>(vectors.y + i);
+        const VectorPack z = Simd::Load<VectorPack>(vectors.z + i);
+        StoreScalars(out, i, count, ::Dot(x, y, z, x, y, z));
+    }
+}
+
+/*            Normalization            */
+void SVectorSoA::Normalize(const SVectorSoA& vectors, SVectorSoA& out)
+{
+    Normalize<SPrecisionExact>(vectors, out);
+}
+
+void SVectorSoA::NormalizeSafe(const SVectorSoA& vectors, SVectorSoA& out)
+{
+    NormalizeSafe<SPrecisionExact>(vectors, out);
+}
+
+template <typename TPrecision>
+void SVectorSoA::Normalize(const SVectorSoA& vectors, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Normalize");
+    ForEachVector(vectors, out, [](const VectorPack& vx, const VectorPack& vy, const VectorPack& vz, VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        const VectorPack factor = TPrecision::NormalizationFactor(::Dot(vx, vy, vz, vx, vy, vz));
+        x = TPrecision::Normalize(vx, factor);
+        y = TPrecision::Normalize(vy, factor);
+        z = TPrecision::Normalize(vz, factor);
+    });
+}
+
+template <typename TPrecision>
+void SVectorSoA::NormalizeSafe(const SVectorSoA& vectors, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::NormalizeSafe");
+    ForEachVector(vectors, out, [](const VectorPack& vx, const VectorPack& vy, const VectorPack& vz, VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        NormalSafe<TPrecision>(vx, vy, vz, x, y, z);
+    });
+}
+
+#define INSTANTIATE_PRECISION(TPrecision) \
+    template void SVectorSoA::Magnitude<TPrecision>(const SVectorSoA& vectors, float* out); \
+    template void SVectorSoA::Normalize<TPrecision>(const SVectorSoA& vectors, SVectorSoA& out); \
+    template void SVectorSoA::NormalizeSafe<TPrecision>(const SVectorSoA& vectors, SVectorSoA& out);
+
+INSTANTIATE_PRECISION(SPrecisionExact)
+INSTANTIATE_PRECISION(SPrecisionFast)
+INSTANTIATE_PRECISION(SPrecisionApproximate)
+
+#undef INSTANTIATE_PRECISION
+
+/*            Projection            */
+void SVectorSoA::ProjectOnTo(const SVectorSoA& vectors, const SVectorSoA& targets, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::ProjectOnTo");
+    ForEachVector(vectors, targets, out, [](const VectorPack& vx, const VectorPack& vy, const VectorPack& vz, const VectorPack& tx, const VectorPack& ty, const VectorPack& tz,
+                                            VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        const VectorPack scale = Simd::Div(::Dot(vx, vy, vz, tx, ty, tz), ::Dot(tx, ty, tz, tx, ty, tz));
+        x = Simd::Mul(tx, scale);
+        y = Simd::Mul(ty, scale);
+        z = Simd::Mul(tz, scale);
+    });
+}
+
+void SVectorSoA::ProjectOnToNormal(const SVectorSoA& vectors, const SVectorSoA& normals, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::ProjectOnToNormal");
+    ForEachVector(vectors, normals, out, [](const VectorPack& vx, const VectorPack& vy, const VectorPack& vz, const VectorPack& nx, const VectorPack& ny, const VectorPack& nz,
+                                            VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        const VectorPack scale = ::Dot(vx, vy, vz, nx, ny, nz);
+        x = Simd::Mul(nx, scale);
+        y = Simd::Mul(ny, scale);
+        z = Simd::Mul(nz, scale);
+    });
+}
+
+/*            Reflection            */
+void SVectorSoA::Reflection(const SVectorSoA& vectors, const SVectorSoA& normals, SVectorSoA& out)
+{
+    ANIMATION_PROFILE_KERNEL_SCOPE("SVectorSoA::Reflection");
+    ForEachVector(vectors, normals, out, [](const VectorPack& vx, const VectorPack& vy, const VectorPack& vz, const VectorPack& nx, const VectorPack& ny, const VectorPack& nz,
+                                            VectorPack& x, VectorPack& y, VectorPack& z)
+    {
+        VectorPack unit_x, unit_y, unit_z;
+        NormalSafe<SPrecisionExact>(nx, ny, nz, unit_x, unit_y, unit_z);
+
+        // v - 2 * (v * n) n
+        const VectorPack scale = Simd::Mul(Simd::Set<VectorPack>(2.f), ::Dot(vx, vy, vz, unit_x, unit_y, unit_z));
+        x = Simd::Sub(vx, Simd::Mul(unit_x, scale));
+        y = Simd::Sub(vy, Simd::Mul(unit_y, scale));
+        z = Simd::Sub(vz, Simd::Mul(unit_z, scale));
+    });
+}
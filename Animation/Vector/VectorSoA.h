@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Vector.h"
+
+/*
+* SVectorSoA keeps a stream of 3-Dimensional vectors as a Structure of Arrays: every X component in one array, every Y in another and every Z in the third.
+* Each array is 64-byte aligned and padded to a multiple of 'PaddingGranularity' elements, so batch kernels process 8 (AVX) or 16 (AVX-512) vectors
+* per instruction and never waste the unused lane of 'SVector'.
+* Batch kernels repeat the arithmetic of the matching 'SVector' method in the same order, so results are equal to the per-vector methods
+* and existing code can switch to the container one call site at a time.
+*/
+struct SVectorSoA
+{
+    // alignment of each component array in bytes
+    constexpr static size_t Alignment{ 64 };
+
+    // each component array is padded to a multiple of this number of elements
+    constexpr static size_t PaddingGranularity{ 16 };
+
+    SVectorSoA();
+    explicit SVectorSoA(size_t size);
+    SVectorSoA(const SVector* vectors, size_t count);
+    SVectorSoA(const SVectorSoA& other);
+    SVectorSoA(SVectorSoA&& other) noexcept;
+    ~SVectorSoA();
+
+    SVectorSoA& operator=(const SVectorSoA& other);
+    SVectorSoA& operator=(SVectorSoA&& other) noexcept;
+
+    size_t Size() const { return size; }
+    size_t Capacity() const { return capacity; }
+    bool IsEmpty() const { return size == 0; }
+
+    // number of elements the kernels touch: size rounded up to 'PaddingGranularity'
+    size_t PaddedSize() const { return RoundUp(size); }
+
+    // keeps existing values, new vectors are zero vectors
+    void Resize(size_t count);
+    void Reserve(size_t count);
+    void Clear() { size = 0; }
+    void PushBack(const SVector& value);
+
+    SVector Get(size_t index) const { return {x[index], y[index], z[index]}; }
+    void Set(size_t index, const SVector& value);
+
+    // conversion from and to an array of 'SVector'
+    void Assign(const SVector* vectors, size_t count);
+    void CopyTo(SVector* vectors) const;
+
+    float* GetX() { return x; }
+    float* GetY() { return y; }
+    float* GetZ() { return z; }
+    const float* GetX() const { return x; }
+    const float* GetY() const { return y; }
+    const float* GetZ() const { return z; }
+
+    /*
+    * Batch kernels. 'out' is resized to the size of the first argument and may be the same container as any input.
+    * Scalar results are written to a plain array of at least 'Size()' floats.
+    */
+
+    // Addition, Subtraction, Multiplication and Division, component-wise as 'SVector' operators
+    static void Add(const SVectorSoA& lhs, const SVectorSoA& rhs, SVectorSoA& out);
+    static void Add(const SVectorSoA& lhs, const float& value, SVectorSoA& out);
+    static void Sub(const SVectorSoA& lhs, const SVectorSoA& rhs, SVectorSoA& out);
+    static void Sub(const SVectorSoA& lhs, const float& value, SVectorSoA& out);
+    static void Mul(const SVectorSoA& lhs, const SVectorSoA& rhs, SVectorSoA& out);
+    static void Mul(const SVectorSoA& lhs, const float& value, SVectorSoA& out);
+    static void Div(const SVectorSoA& lhs, const SVectorSoA& rhs, SVectorSoA& out);
+    static void Div(const SVectorSoA& lhs, const float& value, SVectorSoA& out);
+
+    // Dot Product, 'SVector::operator|'
+    static void Dot(const SVectorSoA& lhs, const SVectorSoA& rhs, float* out);
+
+    // Cross Product, 'SVector::operator^'
+    static void Cross(const SVectorSoA& lhs, const SVectorSoA& rhs, SVectorSoA& out);
+
+    // Magnitude & Length
+    static void Magnitude(const SVectorSoA& vectors, float* out);
+    static void SqrMagnitude(const SVectorSoA& vectors, float* out);
+
+    // Normalization, 'SVector::Normal' and 'SVector::NormalSafe'
+    static void Normalize(const SVectorSoA& vectors, SVectorSoA& out);
+    static void NormalizeSafe(const SVectorSoA& vectors, SVectorSoA& out);
+
+    // Precision policy versions of Magnitude and Normalization, 'SPrecisionExact', 'SPrecisionFast' or 'SPrecisionApproximate'
+    template <typename TPrecision> static void Magnitude(const SVectorSoA& vectors, float* out);
+    template <typename TPrecision> static void Normalize(const SVectorSoA& vectors, SVectorSoA& out);
+    template <typename TPrecision> static void NormalizeSafe(const SVectorSoA& vectors, SVectorSoA& out);
+
+    // Projection, 'SVector::ProjectionOnTo' and 'SVector::ProjectionOnToNormal'
+    static void ProjectOnTo(const SVectorSoA& vectors, const SVectorSoA& targets, SVectorSoA& out);
+    static void ProjectOnToNormal(const SVectorSoA& vectors, const SVectorSoA& normals, SVectorSoA& out);
+
+    // Reflection, 'SVector::Reflection'
+    static void Reflection(const SVectorSoA& vectors, const SVectorSoA& normals, SVectorSoA& out);
+
+private:
+    static size_t RoundUp(size_t count) { return (count + PaddingGranularity - 1) / PaddingGranularity * PaddingGranularity; }
+
+    // reallocates storage for at least 'count' vectors and keeps first 'size' values
+    void Reallocate(size_t count);
+
+    // a single allocation keeps all three arrays: X, then Y, then Z
+    float* x{ nullptr };
+    float* y{ nullptr };
+    float* z{ nullptr };
+
+    size_t size{ 0 };
+    size_t capacity{ 0 };
+};
@@ -0,0 +1,200 @@
+#include "VectorText.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace
+{
+    template <typename TChar>
+    bool IsBlank(TChar character)
+    {
+        return character == TChar(' ') || character == TChar('\t') || character == TChar('\r');
+    }
+
+    template <typename TChar>
+    const TChar* SkipBlanks(const TChar* cursor, const TChar* end)
+    {
+        while (cursor != end && IsBlank(*cursor))
+        {
+            ++cursor;
+        }
+        return cursor;
+    }
+
+    // 'std::from_chars' takes neither leading blanks nor '+', stream extraction takes both
+    template <typename TChar>
+    const TChar* SkipNumberPrefix(const TChar* cursor, const TChar* end)
+    {
+        cursor = SkipBlanks(cursor, end);
+        if (cursor != end && *cursor == TChar('+') && cursor + 1 != end && *(cursor + 1) != TChar('-') && *(cursor + 1) != TChar('+'))
+        {
+            ++cursor;
+        }
+        return cursor;
+    }
+
+    // returns the end of the number or nullptr
+    const char* ParseFloat(const char* cursor, const char* end, float& value)
+    {
+        cursor = SkipNumberPrefix(cursor, end);
+        const auto [number_end, error] = std::from_chars(cursor, end, value);
+        return error == std::errc() ? number_end : nullptr;
+    }
+
+    // 'std::from_chars' reads narrow text only, a number is short enough to narrow on the stack
+    const wchar_t* ParseFloat(const wchar_t* cursor, const wchar_t* end, float& value)
+    {
+        cursor = SkipNumberPrefix(cursor, end);
+
+        char number[64];
+        size_t length{ 0 };
+        while (cursor + length != end && length < sizeof(number))
+        {
+            const wchar_t character = cursor[length];
+            if (character <= L' ' || character > L'~' || character == L',' || character == L')')
+            {
+                break;
+            }
+            number[length++] = static_cast<char>(character);
+        }
+
+        const auto [number_end, error] = std::from_chars(number, number + length, value);
+        return error == std::errc() ? cursor + (number_end - number) : nullptr;
+    }
+
+    template <typename TChar>
+    const TChar* Expect(const TChar* cursor, const TChar* end, TChar expected)
+    {
+        cursor = SkipBlanks(cursor, end);
+        return cursor != end && *cursor == expected ? cursor + 1 : nullptr;
+    }
+
+    // '(x, y, z)' starting at 'cursor', returns false for anything else
+    template <typename TChar>
+    bool ParseVector(const TChar* cursor, const TChar* end, SVector& vector)
+    {
+        float x{ 0.f }, y{ 0.f }, z{ 0.f };
+        if (!(cursor = Expect(cursor, end, TChar('('))) ||
+            !(cursor = ParseFloat(cursor, end, x)) || !(cursor = Expect(cursor, end, TChar(','))) ||
+            !(cursor = ParseFloat(cursor, end, y)) || !(cursor = Expect(cursor, end, TChar(','))) ||
+            !(cursor = ParseFloat(cursor, end, z)) || !(cursor = Expect(cursor, end, TChar(')'))))
+        {
+            return false;
+        }
+
+        vector = SVector(x, y, z);
+        return true;
+    }
+
+    template <typename TChar>
+    SVectorTextResult ParseText(const TChar* begin, const TChar* end, SVector* out, size_t capacity)
+    {
+        SVectorTextResult result;
+        const TChar* line = begin;
+        while (line != end && result.count < capacity)
+        {
+            const TChar* line_end = std::find(line, end, TChar('\n'));
+            const TChar* cursor = SkipBlanks(line, line_end);
+            if (cursor != line_end)
+            {
+                if (!ParseVector(cursor, line_end, out[result.count]))
+                {
+                    result.error = true;
+                    break;
+                }
+                ++result.count;
+            }
+            line = line_end == end ? end : line_end + 1;
+        }
+
+        result.consumed = static_cast<size_t>(line - begin);
+        return result;
+    }
+
+    template <typename TChar>
+    SVectorTextResult ParseText(std::basic_string_view<TChar> text, std::vector<SVector>& out)
+    {
+        // one allocation for the upper bound of a vector per line, trimmed afterwards
+        const size_t offset = out.size();
+        out.resize(offset + static_cast<size_t>(std::count(text.begin(), text.end(), TChar('\n'))) + 1);
+
+        const SVectorTextResult result = ParseText(text.data(), text.data() + text.size(), out.data() + offset, out.size() - offset);
+        out.resize(offset + result.count);
+        return result;
+    }
+
+    // sign, 39 digits of FLT_MAX, point and 9 decimals; the shortest notation is never longer
+    constexpr size_t MaxFloatLength{ 50 };
+    // '(', two ", ", ')' and '\n'
+    constexpr size_t MaxVectorLength{ 3 * MaxFloatLength + 7 };
+
+    char* WriteFloat(char* first, char* last, float value, int precision)
+    {
+        const auto [end, error] = precision < 0 ? std::to_chars(first, last, value) : std::to_chars(first, last, value, std::chars_format::fixed, precision);
+        return error == std::errc() ? end : first;
+    }
+
+    // formats narrow text, wide output widens the ASCII result
+    template <typename TChar>
+    void WriteText(const SVector* vectors, size_t count, std::basic_string<TChar>& out, int precision)
+    {
+        precision = std::min(precision, 9);
+
+        const size_t offset = out.size();
+        out.resize(offset + count * MaxVectorLength);
+        TChar* output = out.data() + offset;
+
+        char buffer[MaxVectorLength];
+        char* const last = buffer + MaxVectorLength;
+        for (size_t i = 0; i < count; ++i)
+        {
+            char* cursor = buffer;
+            *cursor++ = '(';
+            cursor = WriteFloat(cursor, last, vectors[i].GetX(), precision);
+            *cursor++ = ',';
+            *cursor++ = ' ';
+            cursor = WriteFloat(cursor, last, vectors[i].GetY(), precision);
+            *cursor++ = ',';
+            *cursor++ = ' ';
+            cursor = WriteFloat(cursor, last, vectors[i].GetZ(), precision);
+            *cursor++ = ')';
+            *cursor++ = '\n';
+
+            output = std::copy(buffer, cursor, output);
+        }
+
+        out.resize(static_cast<size_t>(output - out.data()));
+    }
+}
+
+/*            Parse            */
+SVectorTextResult SVectorText::Parse(const char* begin, const char* end, SVector* out, size_t capacity)
+{
+    return ParseText(begin, end, out, capacity);
+}
+
+SVectorTextResult SVectorText::Parse(const wchar_t* begin, const wchar_t* end, SVector* out, size_t capacity)
+{
+    return ParseText(begin, end, out, capacity);
+}
+
+SVectorTextResult SVectorText::Parse(std::string_view text, std::vector<SVector>& out)
+{
+    return ParseText(text, out);
+}
+
+SVectorTextResult SVectorText::Parse(std::wstring_view text, std::vector<SVector>& out)
+{
+    return ParseText(text, out);
+}
+
+/*            Write            */
+void SVectorText::Write(const SVector* vectors, size_t count, std::string& out, int precision)
+{
+    WriteText(vectors, count, out, precision);
+}
+
+void SVectorText::Write(const SVector* vectors, size_t count, std::wstring& out, int precision)
+{
+    WriteText(vectors, count, out, precision);
+}
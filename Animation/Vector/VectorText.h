@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Vector.h"
+
+// outcome of a bulk parse
+struct SVectorTextResult
+{
+    // number of vectors written to the output
+    size_t count{ 0 };
+    // characters consumed; with 'error' set, the offset of the first malformed line
+    size_t consumed{ 0 };
+    // a line isn't blank and isn't a '(x, y, z)' vector
+    bool error{ false };
+};
+
+/*
+* SVectorText converts arrays of vectors to and from text in bulk, one '(x, y, z)' vector per line, the format of 'SVector' stream operators.
+* Parsing runs over a contiguous buffer with 'std::from_chars', there is no allocation and no locale per vector;
+* writing formats with 'std::to_chars' straight into the output string. Narrow and wide text share the same grammar.
+*
+* Grammar of a line: spaces or tabs, '(', x, ',', y, ',', z, ')' and anything up to the end of the line; numbers may have leading spaces and '+'.
+* Blank lines are skipped, parsing stops at the first malformed line and reports it.
+*/
+struct SVectorText
+{
+    // 'precision' value of 'Write' for the shortest text that reads back to the same float
+    constexpr static int ShortestPrecision{ -1 };
+
+    // digits after the point used by 'SVector::operator<<'
+    constexpr static int StreamPrecision{ 2 };
+
+    // parses up to 'capacity' vectors from [begin, end)
+    static SVectorTextResult Parse(const char* begin, const char* end, SVector* out, size_t capacity);
+    static SVectorTextResult Parse(const wchar_t* begin, const wchar_t* end, SVector* out, size_t capacity);
+
+    // parses every vector of 'text' and appends them to 'out'
+    static SVectorTextResult Parse(std::string_view text, std::vector<SVector>& out);
+    static SVectorTextResult Parse(std::wstring_view text, std::vector<SVector>& out);
+
+    // appends vectors to 'out', each followed by '\n'; 'precision' is a number of digits after the point, up to 9, or 'ShortestPrecision'
+    static void Write(const SVector* vectors, size_t count, std::string& out, int precision = ShortestPrecision);
+    static void Write(const SVector* vectors, size_t count, std::wstring& out, int precision = ShortestPrecision);
+};
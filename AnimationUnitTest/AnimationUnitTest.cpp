@@ -1,10 +1,79 @@
 #include "pch.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <random>
 #include <sstream>
 #include <string>
+#include <vector>
 #include <xmmintrin.h>
 #include "CppUnitTest.h"
+#include "../Animation/Simd/CpuFeatures.cpp"
+#include "../Animation/Simd/CpuFeatures.h"
+#include "../Animation/Simd/Trigonometry.cpp"
+#include "../Animation/Simd/Trigonometry.h"
 #include "../Animation/Vector/Vector.cpp"
 #include "../Animation/Vector/Vector.h"
+#include "../Animation/Vector/VectorReduction.cpp"
+#include "../Animation/Vector/VectorReduction.h"
+#include "../Animation/Vector/VectorSoA.cpp"
+#include "../Animation/Vector/VectorSoA.h"
+#include "../Animation/Vector/VectorText.cpp"
+#include "../Animation/Vector/VectorText.h"
+#include "../Animation/Vector/VectorExpression.h"
+#include "../Animation/Vector/VectorInterpolation.cpp"
+#include "../Animation/Vector/VectorInterpolation.h"
+#include "../Animation/Memory/FrameArena.cpp"
+#include "../Animation/Memory/FrameArena.h"
+#include "../Animation/Profile/Profiler.cpp"
+#include "../Animation/Profile/Profiler.h"
+#include "../Animation/Quaternion/Quaternion.cpp"
+#include "../Animation/Quaternion/Quaternion.h"
+#include "../Animation/Quaternion/QuaternionInterpolation.cpp"
+#include "../Animation/Quaternion/QuaternionInterpolation.h"
+#include "../Animation/Quaternion/DualQuaternion.cpp"
+#include "../Animation/Quaternion/DualQuaternion.h"
+#include "../Animation/Matrix/Matrix.cpp"
+#include "../Animation/Matrix/Matrix.h"
+#include "../Animation/Clip/Clip.cpp"
+#include "../Animation/Clip/Clip.h"
+#include "../Animation/Clip/ClipFile.cpp"
+#include "../Animation/Clip/ClipFile.h"
+#include "../Animation/Clip/ClipSampler.cpp"
+#include "../Animation/Clip/ClipSampler.h"
+#include "../Animation/Clip/CompressedClip.cpp"
+#include "../Animation/Clip/CompressedClip.h"
+#include "../Animation/Clip/KeyReduction.cpp"
+#include "../Animation/Clip/KeyReduction.h"
+#include "../Animation/Skeleton/Pose.cpp"
+#include "../Animation/Skeleton/Pose.h"
+#include "../Animation/Skeleton/Skeleton.cpp"
+#include "../Animation/Skeleton/Skeleton.h"
+#include "../Animation/Blend/PoseBlend.cpp"
+#include "../Animation/Blend/PoseBlend.h"
+#include "../Animation/Blend/BlendTree.cpp"
+#include "../Animation/Blend/BlendTree.h"
+#include "../Animation/Jobs/JobSystem.cpp"
+#include "../Animation/Jobs/JobSystem.h"
+#include "../Animation/Jobs/AnimationLod.cpp"
+#include "../Animation/Jobs/AnimationLod.h"
+#include "../Animation/Jobs/AnimationUpdate.cpp"
+#include "../Animation/Jobs/AnimationUpdate.h"
+#include "../Animation/Skinning/Skinning.cpp"
+#include "../Animation/Skinning/Skinning.h"
+#include "../Animation/IK/InverseKinematics.cpp"
+#include "../Animation/IK/InverseKinematics.h"
+#include "../Animation/Retarget/Retarget.cpp"
+#include "../Animation/Retarget/Retarget.h"
+#include "../Animation/Track/TrackFile.cpp"
+#include "../Animation/Track/TrackFile.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -15,14 +84,102 @@ namespace Microsoft
 		namespace CppUnitTestFramework
 		{
 
-			template<> static std::wstring ToString<SVector>(const SVector& v)
+			template<> std::wstring ToString<SVector>(const SVector& v)
 			{
 				std::wostringstream line;
 				line.precision(8);
 				line << "x: " << v.GetX() << "y: " << v.GetY() << "z: " << v.GetZ() << "Unused: " << v.GetUnusedAxis();
 				return std::wstring(line.str());
 			}
+
+			template<> std::wstring ToString<SQuaternion>(const SQuaternion& q)
+			{
+				std::wostringstream line;
+				line.precision(8);
+				line << "x: " << q.GetX() << "y: " << q.GetY() << "z: " << q.GetZ() << "w: " << q.GetW();
+				return std::wstring(line.str());
+			}
+		}
+	}
+}
+
+/*
+* Heap allocations of every thread through 'operator new', so tests can check that code in a steady state doesn't allocate.
+* The replacement counts and forwards to 'malloc'; over-aligned allocations keep the operators of the standard library.
+*/
+static std::atomic<size_t> HeapAllocationCount{ 0 };
+
+void* operator new(size_t bytes)
+{
+	HeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(bytes > 0 ? bytes : 1))
+	{
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+// the standard library takes temporary buffers of 'std::stable_sort' with it, they come back through the 'operator delete' below
+void* operator new(size_t bytes, const std::nothrow_t&) noexcept
+{
+	HeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(bytes > 0 ? bytes : 1);
+}
+
+// GCC takes 'operator new' for the one of the library where it inlines a delete and warns about 'free'
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace
+{
+	// deterministic vectors with mixed signs and magnitudes, counts that are not a multiple of any register width leave tails
+	std::vector<SVector> MakeVectors(size_t count, float seed)
+	{
+		std::vector<SVector> vectors;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float t = seed + static_cast<float>(i);
+			vectors.emplace_back(sinf(t) * 10.f, cosf(t * 1.3f) * 5.f, sinf(t * 0.7f + 1.f) * 3.f);
 		}
+		return vectors;
+	}
+
+	// the three axes, the unused one isn't compared
+	void AssertVectorsNear(const SVector& expected, const SVector& actual, float tolerance)
+	{
+		Assert::AreEqual(expected.GetX(), actual.GetX(), tolerance);
+		Assert::AreEqual(expected.GetY(), actual.GetY(), tolerance);
+		Assert::AreEqual(expected.GetZ(), actual.GetZ(), tolerance);
+	}
+
+	// components uniform in [min, max]
+	SVector RandomVector(std::mt19937& random, float min, float max)
+	{
+		std::uniform_real_distribution<float> value(min, max);
+		const float x = value(random), y = value(random), z = value(random);
+		return SVector(x, y, z);
+	}
+
+	// roll, pitch and yaw uniform over about a turn
+	SQuaternion RandomRotation(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+		const float roll = angle(random), pitch = angle(random), yaw = angle(random);
+		return SQuaternion(roll, pitch, yaw);
 	}
 }
 
@@ -292,6 +449,47 @@ namespace AnimationUnitTest
 				Assert::AreNotEqual(len_b, 1.f);
 			}
 		}
+		TEST_METHOD(PrecisionPolicyTests)
+		{
+			const SVector vectors[] = { SVector(4.f, 3.f, 0.f), SVector(-1e-3f, 2e-2f, 7e-3f), SVector(1e5f, -3e4f, 2e5f), SVector(0.3f, 0.3f, -0.9f) };
+			for (const SVector& v : vectors)
+			{
+				// the exact policy is the behaviour of methods without a policy
+				Assert::AreEqual(v.Normal(), v.Normal<SPrecisionExact>());
+				Assert::AreEqual(v.NormalSafe(), v.NormalSafe<SPrecisionExact>());
+				Assert::AreEqual(v.Magnitude(), v.Magnitude<SPrecisionExact>());
+
+				const SVector exact = v.Normal();
+				const SVector fast = v.Normal<SPrecisionFast>();
+				const SVector approximate = v.Normal<SPrecisionApproximate>();
+				Assert::AreEqual(exact.GetX(), fast.GetX(), 3.5e-7f);
+				Assert::AreEqual(exact.GetY(), fast.GetY(), 3.5e-7f);
+				Assert::AreEqual(exact.GetZ(), fast.GetZ(), 3.5e-7f);
+				Assert::AreEqual(0.f, fast.GetUnusedAxis());
+				Assert::AreEqual(exact.GetX(), approximate.GetX(), 3.5e-4f);
+				Assert::AreEqual(exact.GetY(), approximate.GetY(), 3.5e-4f);
+				Assert::AreEqual(exact.GetZ(), approximate.GetZ(), 3.5e-4f);
+
+				Assert::AreEqual(v.Magnitude(), v.Magnitude<SPrecisionFast>(), v.Magnitude() * 3.5e-7f);
+				Assert::AreEqual(v.Magnitude(), v.Magnitude<SPrecisionApproximate>(), v.Magnitude() * 3.5e-4f);
+
+				SVector normalized(v);
+				normalized.NormalizeSafe<SPrecisionFast>();
+				Assert::AreEqual(fast, normalized);
+			}
+
+			{
+				// zero and vectors with a squared magnitude below FLT_MIN stay as they are
+				for (const SVector& tiny : { SVector::ZeroVector, SVector(1e-20f, 0.f, -1e-20f) })
+				{
+					Assert::AreEqual(tiny, tiny.NormalSafe<SPrecisionFast>());
+					Assert::AreEqual(tiny, tiny.NormalSafe<SPrecisionApproximate>());
+					Assert::AreEqual(0.f, SVector::ZeroVector.Magnitude<SPrecisionFast>());
+					Assert::AreEqual(0.f, SVector::ZeroVector.Magnitude<SPrecisionApproximate>());
+				}
+				Assert::AreEqual(SVector::ZeroVector, SVector::ZeroVector.NormalSafe<SPrecisionExact>());
+			}
+		}
 		TEST_METHOD(DotProductTests)
 		{
 			{
@@ -400,6 +598,100 @@ namespace AnimationUnitTest
 				Assert::AreEqual(x, a);
 			}
 		}
+		TEST_METHOD(TextConversionTests)
+		{
+			const std::vector<SVector> vectors{ {1.5f, 1.3f, 1.f}, {-2.25f, 0.f, 1e6f}, {0.1f, -7.125f, 3.14159265f}, {FLT_MAX, -FLT_MIN, 1e-7f} };
+
+			{
+				// same text as the stream operators, line by line
+				std::ostringstream expected;
+				for (const SVector& vector : vectors)
+				{
+					expected << vector << '\n';
+				}
+
+				std::string text;
+				SVectorText::Write(vectors.data(), vectors.size(), text, SVectorText::StreamPrecision);
+				Assert::AreEqual(expected.str(), text);
+
+				std::wstring wide_text;
+				SVectorText::Write(vectors.data(), vectors.size(), wide_text, SVectorText::StreamPrecision);
+				Assert::AreEqual(std::wstring(text.begin(), text.end()), wide_text);
+
+				// reads back what 'operator>>' reads
+				std::vector<SVector> parsed;
+				const SVectorTextResult result = SVectorText::Parse(text, parsed);
+				Assert::IsFalse(result.error);
+				Assert::AreEqual(vectors.size(), result.count);
+				Assert::AreEqual(text.size(), result.consumed);
+
+				std::istringstream input(text);
+				for (const SVector& vector : parsed)
+				{
+					SVector streamed;
+					input >> streamed;
+					Assert::AreEqual(streamed, vector);
+				}
+			}
+
+			{
+				// the shortest notation round-trips every float
+				std::string text;
+				SVectorText::Write(vectors.data(), vectors.size(), text);
+				std::wstring wide_text;
+				SVectorText::Write(vectors.data(), vectors.size(), wide_text);
+
+				std::vector<SVector> parsed;
+				SVectorText::Parse(text, parsed);
+				SVectorText::Parse(std::wstring_view(wide_text), parsed);
+				Assert::AreEqual(2 * vectors.size(), parsed.size());
+				for (size_t i = 0; i < parsed.size(); ++i)
+				{
+					Assert::AreEqual(vectors[i % vectors.size()], parsed[i]);
+				}
+			}
+
+			{
+				// blanks, '+', blank lines, Windows line ends and text after the vector
+				const std::wstring text(L"\t( +1.5 ,-2,3e1 )\r\n\n   \r\n(4, 5, 6) // comment");
+				SVector parsed[3];
+				const SVectorTextResult result = SVectorText::Parse(text.data(), text.data() + text.size(), parsed, 3);
+				Assert::IsFalse(result.error);
+				Assert::AreEqual(static_cast<size_t>(2), result.count);
+				Assert::AreEqual(text.size(), result.consumed);
+				Assert::AreEqual(SVector(1.5f, -2.f, 30.f), parsed[0]);
+				Assert::AreEqual(SVector(4.f, 5.f, 6.f), parsed[1]);
+			}
+
+			{
+				// stops at the first malformed line
+				const std::string text("(1, 2, 3)\n(1, 2)\n(4, 5, 6)\n");
+				std::vector<SVector> parsed;
+				const SVectorTextResult result = SVectorText::Parse(text, parsed);
+				Assert::IsTrue(result.error);
+				Assert::AreEqual(static_cast<size_t>(1), result.count);
+				Assert::AreEqual(text.find('\n') + 1, result.consumed);
+				Assert::AreEqual(static_cast<size_t>(1), parsed.size());
+
+				for (const char* malformed : { "1, 2, 3", "(1, 2, 3", "(1, 2, x)", "(1,, 2, 3)", "(1 2, 3, 4)" })
+				{
+					const std::string line(malformed);
+					SVector vector;
+					Assert::IsTrue(SVectorText::Parse(line.data(), line.data() + line.size(), &vector, 1).error);
+				}
+			}
+
+			{
+				// stops at the capacity
+				const std::string text("(1, 2, 3)\n(4, 5, 6)\n");
+				SVector parsed;
+				const SVectorTextResult result = SVectorText::Parse(text.data(), text.data() + text.size(), &parsed, 1);
+				Assert::IsFalse(result.error);
+				Assert::AreEqual(static_cast<size_t>(1), result.count);
+				Assert::AreEqual(text.find('\n') + 1, result.consumed);
+				Assert::AreEqual(SVector(1.f, 2.f, 3.f), parsed);
+			}
+		}
 		TEST_METHOD(ReflectionMethodsTest)
 		{
 			{
@@ -541,5 +833,3695 @@ namespace AnimationUnitTest
 				Assert::AreEqual(expected, a.RejectionToNormal(n));
 			}
 		}
+
+		TEST_METHOD(LerpTests)
+		{
+			const SVector a(1.f, -2.f, 3.5f);
+			const SVector b(-4.f, 0.25f, 7.f);
+
+			// exact at both ends
+			Assert::AreEqual(a, SVector::Lerp(a, b, 0.f));
+			Assert::AreEqual(b, SVector::Lerp(a, b, 1.f));
+			Assert::AreEqual(SVector(1.f, 2.f, -1.f), SVector::Lerp(SVector::ZeroVector, SVector(2.f, 4.f, -2.f), 0.5f));
+
+			for (int step = 0; step <= 64; ++step)
+			{
+				const float alpha = static_cast<float>(step) / 64.f;
+				const SVector lerp = SVector::Lerp(a, b, alpha);
+
+				// every lane rounds as the scalar function
+				Assert::AreEqual(Simd::Lerp(a.GetX(), b.GetX(), alpha), lerp.GetX());
+				Assert::AreEqual(Simd::Lerp(a.GetY(), b.GetY(), alpha), lerp.GetY());
+				Assert::AreEqual(Simd::Lerp(a.GetZ(), b.GetZ(), alpha), lerp.GetZ());
+				Assert::AreEqual(0.f, lerp.GetUnusedAxis());
+
+				const double t = alpha;
+				Assert::AreEqual((1.0 - t) * a.GetX() + t * b.GetX(), static_cast<double>(lerp.GetX()), 1e-6);
+				Assert::AreEqual((1.0 - t) * a.GetY() + t * b.GetY(), static_cast<double>(lerp.GetY()), 1e-6);
+				Assert::AreEqual((1.0 - t) * a.GetZ() + t * b.GetZ(), static_cast<double>(lerp.GetZ()), 1e-6);
+			}
+		}
+
+		TEST_METHOD(MulAddTests)
+		{
+			const SVector a(1.5f, -2.25f, 3.1f);
+			const SVector b(0.3f, 4.f, -1.7f);
+			const SVector c(-0.6f, 2.f, 0.9f);
+
+			const SVector mul_add = SVector::MulAdd(a, b, c);
+			const SVector mul_sub = SVector::MulSub(a, b, c);
+			const SVector scaled_add = SVector::MulAdd(a, 0.7f, c);
+			const SVector scaled_sub = SVector::MulSub(a, 0.7f, c);
+
+			// every lane rounds as the scalar functions, a fused operation rounds once
+			Assert::AreEqual(Simd::MulAdd(a.GetX(), b.GetX(), c.GetX()), mul_add.GetX());
+			Assert::AreEqual(Simd::MulAdd(a.GetY(), b.GetY(), c.GetY()), mul_add.GetY());
+			Assert::AreEqual(Simd::MulAdd(a.GetZ(), b.GetZ(), c.GetZ()), mul_add.GetZ());
+			Assert::AreEqual(Simd::MulSub(a.GetX(), b.GetX(), c.GetX()), mul_sub.GetX());
+			Assert::AreEqual(Simd::MulSub(a.GetY(), b.GetY(), c.GetY()), mul_sub.GetY());
+			Assert::AreEqual(Simd::MulSub(a.GetZ(), b.GetZ(), c.GetZ()), mul_sub.GetZ());
+			Assert::AreEqual(Simd::MulAdd(a.GetX(), 0.7f, c.GetX()), scaled_add.GetX());
+			Assert::AreEqual(Simd::MulSub(a.GetZ(), 0.7f, c.GetZ()), scaled_sub.GetZ());
+			Assert::AreEqual(0.f, mul_sub.GetUnusedAxis());
+
+			if (!Simd::HasFusedMultiplyAdd)
+			{
+				Assert::AreEqual(a * b + c, mul_add);
+				Assert::AreEqual(a * b - c, mul_sub);
+				Assert::AreEqual(a * 0.7f + c, scaled_add);
+				Assert::AreEqual(a * 0.7f - c, scaled_sub);
+			}
+			else
+			{
+				Assert::AreEqual(std::fma(a.GetY(), b.GetY(), c.GetY()), mul_add.GetY());
+				Assert::AreEqual((a * b + c).GetX(), mul_add.GetX(), 1e-6f);
+			}
+		}
+	};
+	TEST_CLASS(SReductionKernelsTests)
+	{
+	public:
+
+		static std::vector<SVector> MakeVectors(size_t count)
+		{
+			std::vector<SVector> vectors;
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float t = static_cast<float>(i);
+				SVector v(sinf(t * 1.3f) * 10.f, cosf(t * 0.7f) * 0.01f, sinf(t * 2.9f + 1.f) * 1000.f);
+				// the unused lane takes part in the sums, every path has to treat it the same way
+				v.SetUnusedAxis(i % 3 == 0 ? 0.f : cosf(t));
+				vectors.push_back(v);
+			}
+			return vectors;
+		}
+
+		TEST_METHOD(CpuFeaturesTests)
+		{
+			const SCpuFeatures& features = SCpuFeatures::Get();
+			Assert::IsTrue(&features == &SCpuFeatures::Get());
+			// the tests are built with SSE3 at least, a CPU running them has it
+			Assert::IsTrue(features.sse3);
+			Assert::IsTrue(!features.sse42 || features.sse41);
+			Assert::IsTrue(!features.avx2 || features.avx);
+			Assert::IsTrue(!features.avx512f || features.avx2);
+		}
+		TEST_METHOD(BitCompatiblePathsTests)
+		{
+			const std::vector<SVector> vectors = MakeVectors(101);
+			const SReductionKernels& reference = SReductionKernels::Get(EReductionPath::HorizontalAdd);
+
+			for (const EReductionPath path : { EReductionPath::ShuffleAdd, EReductionPath::DotProduct })
+			{
+				if (!SReductionKernels::IsSupported(path))
+				{
+					continue;
+				}
+
+				const SReductionKernels& kernels = SReductionKernels::Get(path);
+				for (size_t i = 0; i + 1 < vectors.size(); ++i)
+				{
+					const __m128& a = vectors[i].GetStorage();
+					const __m128& b = vectors[i + 1].GetStorage();
+					Assert::AreEqual(reference.dot(a, b), kernels.dot(a, b));
+					Assert::AreEqual(reference.dot(a, a), kernels.dot(a, a));
+					Assert::AreEqual(reference.dot_xy(a, b), kernels.dot_xy(a, b));
+				}
+			}
+		}
+		TEST_METHOD(FusedMultiplyAddPathTests)
+		{
+			if (!SReductionKernels::IsSupported(EReductionPath::FusedMultiplyAdd))
+			{
+				return;
+			}
+
+			const std::vector<SVector> vectors = MakeVectors(101);
+			const SReductionKernels& kernels = SReductionKernels::Get(EReductionPath::FusedMultiplyAdd);
+			for (size_t i = 0; i + 1 < vectors.size(); ++i)
+			{
+				const SVector& a = vectors[i];
+				const SVector& b = vectors[i + 1];
+				const double products[] = {
+					static_cast<double>(a.GetX()) * b.GetX(), static_cast<double>(a.GetY()) * b.GetY(),
+					static_cast<double>(a.GetZ()) * b.GetZ(), static_cast<double>(a.GetUnusedAxis()) * b.GetUnusedAxis() };
+
+				// two roundings of the sum, relative to the sum of absolute products, since products may cancel out
+				const double scale = fabs(products[0]) + fabs(products[1]) + fabs(products[2]) + fabs(products[3]);
+				const double expected = products[0] + products[1] + products[2] + products[3];
+				Assert::AreEqual(expected, static_cast<double>(kernels.dot(a.GetStorage(), b.GetStorage())), 2.0 * FLT_EPSILON * scale);
+				Assert::AreEqual(products[0] + products[1], static_cast<double>(kernels.dot_xy(a.GetStorage(), b.GetStorage())),
+					FLT_EPSILON * (fabs(products[0]) + fabs(products[1])));
+			}
+		}
+		TEST_METHOD(ActivePathTests)
+		{
+			const EReductionPath initial = SVector::GetReductionPath();
+			Assert::IsTrue(initial == SReductionKernels::DefaultPath());
+			Assert::IsTrue(initial != EReductionPath::FusedMultiplyAdd);
+
+			const SVector a(1.5f, -2.25f, 3.f);
+			const SVector b(0.5f, 4.f, -1.f);
+			for (const EReductionPath path : { EReductionPath::HorizontalAdd, EReductionPath::ShuffleAdd, EReductionPath::DotProduct, EReductionPath::FusedMultiplyAdd })
+			{
+				Assert::AreEqual(SReductionKernels::IsSupported(path), SVector::SetReductionPath(path));
+				if (SReductionKernels::IsSupported(path))
+				{
+					Assert::IsTrue(path == SVector::GetReductionPath());
+					// every product and sum is exact, so all paths agree
+					Assert::AreEqual(-11.25f, a | b);
+					Assert::AreEqual(5.f, SVector(4.f, 3.f, 9.f).MagnitudeXY());
+					Assert::AreEqual(25.f, SVector(4.f, 3.f, 0.f).SqrMagnitude());
+				}
+			}
+
+			Assert::IsTrue(SVector::SetReductionPath(initial));
+			Assert::IsTrue(initial == SVector::GetReductionPath());
+		}
+	};
+
+	TEST_CLASS(SVectorExpressionTests)
+	{
+	public:
+		static void AssertNear(const SVector& expected, const SVector& actual)
+		{
+			const float tolerance = 1e-5f * std::max(1.f, expected.Magnitude());
+			Assert::AreEqual(expected.GetX(), actual.GetX(), tolerance);
+			Assert::AreEqual(expected.GetY(), actual.GetY(), tolerance);
+			Assert::AreEqual(expected.GetZ(), actual.GetZ(), tolerance);
+			Assert::AreEqual(0.f, actual.GetUnusedAxis());
+		}
+
+		// exact where nothing fuses, within rounding of the fused steps otherwise
+		static void AssertMatches(const SVector& expected, const SVector& actual)
+		{
+			if constexpr (VectorExpression::IsFused)
+			{
+				AssertNear(expected, actual);
+			}
+			else
+			{
+				Assert::IsTrue(expected == actual);
+				Assert::AreEqual(0.f, actual.GetUnusedAxis());
+			}
+		}
+
+		TEST_METHOD(Operators)
+		{
+			using namespace VectorExpression;
+
+			// single operations don't fuse and round as the 'SVector' operators
+			const std::vector<SVector> vectors = MakeVectors(64, 0.1f);
+			for (size_t i = 0; i + 1 < vectors.size(); ++i)
+			{
+				const SVector& a = vectors[i];
+				const SVector& b = vectors[i + 1];
+				const float s = b.GetY();
+
+				Assert::IsTrue(a + b == SVector(Lazy(a) + b));
+				Assert::IsTrue(a - b == SVector(a - Lazy(b)));
+				Assert::IsTrue(a * b == SVector(Lazy(a) * Lazy(b)));
+				Assert::IsTrue(a / b == SVector(Lazy(a) / b));
+				Assert::IsTrue(a * s == SVector(Lazy(a) * s));
+				Assert::IsTrue(s * a == SVector(s * Lazy(a)));
+				Assert::IsTrue(a / s == SVector(Lazy(a) / s));
+				Assert::IsTrue(s / a == SVector(s / Lazy(a)));
+				Assert::IsTrue(-a == SVector(-Lazy(a)));
+				Assert::AreEqual(0.f, SVector(Lazy(a) / b).GetUnusedAxis());
+
+				Assert::AreEqual(0.f, SVector(-(Lazy(a) / b)).GetUnusedAxis());
+
+				// scalar parts are floats, dot products sum as the bit-compatible reduction paths without FMA
+				const float quotient = (Dot(a, b) / Dot(Lazy(b), b)).Evaluate();
+				Assert::AreEqual((a | b) / (b | b), quotient, VectorExpression::IsFused ? 1e-5f * std::abs(quotient) : 0.f);
+			}
+		}
+
+		TEST_METHOD(Fusion)
+		{
+			using namespace VectorExpression;
+
+			const std::vector<SVector> vectors = MakeVectors(64, 0.1f);
+			for (size_t i = 0; i + 1 < vectors.size(); ++i)
+			{
+				const SVector& a = vectors[i];
+				const SVector& v = vectors[i + 1];
+				const SVector n = v.NormalSafe();
+
+				AssertMatches(a.ProjectionOnTo(v), Dot(a, v) / Dot(v, v) * Lazy(v));
+				AssertMatches(a.ProjectionOnToNormal(n), Dot(a, n) * Lazy(n));
+				AssertMatches(a.RejectionTo(v), Lazy(a) - Dot(a, v) / Dot(v, v) * Lazy(v));
+				AssertMatches(a.RejectionToNormal(n), Lazy(a) - Dot(a, n) * Lazy(n));
+				AssertMatches(a.Reflection(v), Lazy(a) - 2.f * Dot(a, n) * Lazy(n));
+				AssertNear(a.Reflection(v), Lazy(a) - 2.f * Dot(a, v) / Dot(v, v) * Lazy(v));
+				AssertMatches(a * v + n, Lazy(a) * v + n);
+				AssertMatches(n + a * 3.f, n + Lazy(a) * 3.f);
+				AssertMatches(a * v - n, Lazy(a) * v - n);
+				AssertMatches((a + v) * (a - v) + n, (Lazy(a) + v) * (Lazy(a) - v) + n);
+			}
+		}
+
+		TEST_METHOD(DeferredEvaluation)
+		{
+			using namespace VectorExpression;
+
+			SVector a(1.f, 2.f, 3.f);
+			SVector b(-4.f, 0.5f, 2.f);
+			const SVector expected = a * 2.f + b;
+
+			// operands are copied, an expression waits for its evaluation
+			const auto expression = Lazy(a) * 2.f + b;
+			a = SVector(0.f);
+			b = SVector(0.f);
+			AssertMatches(expected, expression);
+			AssertMatches(expected, expression);
+
+			const auto dot = Dot(Lazy(expected) - b, Lazy(expected));
+			Assert::AreEqual(expected | expected, dot.Evaluate(), 1e-4f);
+		}
+	};
+
+	TEST_CLASS(SVectorInterpolationTests)
+	{
+	public:
+		static std::vector<float> MakeFactors(size_t count, float seed)
+		{
+			std::vector<float> factors;
+			for (size_t i = 0; i < count; ++i)
+			{
+				factors.push_back(0.5f + 0.5f * sinf(seed + static_cast<float>(i) * 0.9f));
+			}
+			return factors;
+		}
+
+		// counts up to 11 cover full registers of 1, 2 and 4 vectors and every tail after them
+		TEST_METHOD(Lerp)
+		{
+			for (size_t count = 0; count < 12; ++count)
+			{
+				const std::vector<SVector> from = MakeVectors(count, 0.3f);
+				const std::vector<SVector> to = MakeVectors(count, 5.1f);
+				const std::vector<float> alphas = MakeFactors(count, 1.2f);
+
+				std::vector<SVector> out(count);
+				SVectorInterpolation::Lerp(from.data(), to.data(), alphas.data(), out.data(), count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					Assert::AreEqual(SVector::Lerp(from[i], to[i], alphas[i]), out[i]);
+				}
+
+				SVectorInterpolation::Lerp(from.data(), to.data(), 0.35f, out.data(), count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					Assert::AreEqual(SVector::Lerp(from[i], to[i], 0.35f), out[i]);
+				}
+
+				// in place and exact at both ends
+				std::vector<SVector> in_place = from;
+				SVectorInterpolation::Lerp(in_place.data(), to.data(), 1.f, in_place.data(), count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					Assert::AreEqual(to[i], in_place[i]);
+				}
+				SVectorInterpolation::Lerp(from.data(), to.data(), 0.f, in_place.data(), count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					Assert::AreEqual(from[i], in_place[i]);
+				}
+			}
+		}
+
+		TEST_METHOD(MulAdd)
+		{
+			for (size_t count = 0; count < 12; ++count)
+			{
+				const std::vector<SVector> a = MakeVectors(count, 0.7f);
+				const std::vector<SVector> b = MakeVectors(count, 2.9f);
+				const std::vector<SVector> c = MakeVectors(count, 8.4f);
+				const std::vector<float> scales = MakeFactors(count, 3.3f);
+
+				std::vector<SVector> out(count);
+				SVectorInterpolation::MulAdd(a.data(), b.data(), c.data(), out.data(), count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					Assert::AreEqual(SVector::MulAdd(a[i], b[i], c[i]), out[i]);
+				}
+
+				SVectorInterpolation::MulAdd(a.data(), scales.data(), c.data(), out.data(), count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					Assert::AreEqual(SVector::MulAdd(a[i], scales[i], c[i]), out[i]);
+				}
+
+				std::vector<SVector> sum = c;
+				SVectorInterpolation::MulAdd(a.data(), -1.5f, sum.data(), sum.data(), count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					Assert::AreEqual(SVector::MulAdd(a[i], -1.5f, c[i]), sum[i]);
+					Assert::AreEqual(0.f, sum[i].GetUnusedAxis());
+				}
+			}
+		}
+	};
+
+	TEST_CLASS(SVectorSoATests)
+	{
+	public:
+		TEST_METHOD(ContainerTests)
+		{
+			{
+				const SVectorSoA empty;
+				Assert::IsTrue(empty.IsEmpty());
+				Assert::AreEqual(empty.Size(), size_t{ 0 });
+			}
+
+			{
+				const std::vector<SVector> vectors = MakeVectors(37, 0.f);
+				const SVectorSoA soa(vectors.data(), vectors.size());
+				Assert::AreEqual(soa.Size(), vectors.size());
+				Assert::AreEqual(soa.PaddedSize(), size_t{ 48 });
+				Assert::IsTrue(reinterpret_cast<uintptr_t>(soa.GetX()) % SVectorSoA::Alignment == 0);
+				Assert::IsTrue(reinterpret_cast<uintptr_t>(soa.GetY()) % SVectorSoA::Alignment == 0);
+				Assert::IsTrue(reinterpret_cast<uintptr_t>(soa.GetZ()) % SVectorSoA::Alignment == 0);
+
+				std::vector<SVector> copy(vectors.size());
+				soa.CopyTo(copy.data());
+				for (size_t i = 0; i < vectors.size(); ++i)
+				{
+					Assert::AreEqual(vectors[i], soa.Get(i));
+					Assert::AreEqual(vectors[i], copy[i]);
+				}
+			}
+
+			{
+				SVectorSoA soa;
+				for (int i = 0; i < 20; ++i)
+				{
+					soa.PushBack(SVector(static_cast<float>(i), 1.f, 2.f));
+				}
+				soa.Resize(22);
+				SVectorSoA copy(soa);
+
+				Assert::AreEqual(copy.Size(), size_t{ 22 });
+				Assert::AreEqual(copy.Get(19), SVector(19.f, 1.f, 2.f));
+				Assert::AreEqual(copy.Get(21), SVector::ZeroVector);
+			}
+		}
+		TEST_METHOD(ArithmeticTests)
+		{
+			const std::vector<SVector> a = MakeVectors(37, 0.f);
+			const std::vector<SVector> b = MakeVectors(37, 100.f);
+			const SVectorSoA soa_a(a.data(), a.size());
+			const SVectorSoA soa_b(b.data(), b.size());
+			SVectorSoA add, sub, mul, div, add_s, sub_s, mul_s, div_s, cross;
+			SVectorSoA::Add(soa_a, soa_b, add);
+			SVectorSoA::Sub(soa_a, soa_b, sub);
+			SVectorSoA::Mul(soa_a, soa_b, mul);
+			SVectorSoA::Div(soa_a, soa_b, div);
+			SVectorSoA::Add(soa_a, 3.f, add_s);
+			SVectorSoA::Sub(soa_a, 3.f, sub_s);
+			SVectorSoA::Mul(soa_a, 3.f, mul_s);
+			SVectorSoA::Div(soa_a, 3.f, div_s);
+			SVectorSoA::Cross(soa_a, soa_b, cross);
+
+			for (size_t i = 0; i < a.size(); ++i)
+			{
+				Assert::AreEqual(a[i] + b[i], add.Get(i));
+				Assert::AreEqual(a[i] - b[i], sub.Get(i));
+				Assert::AreEqual(a[i] * b[i], mul.Get(i));
+				Assert::AreEqual(a[i] / b[i], div.Get(i));
+				Assert::AreEqual(a[i] + 3.f, add_s.Get(i));
+				Assert::AreEqual(a[i] - 3.f, sub_s.Get(i));
+				Assert::AreEqual(a[i] * 3.f, mul_s.Get(i));
+				Assert::AreEqual(a[i] / 3.f, div_s.Get(i));
+				Assert::AreEqual(a[i] ^ b[i], cross.Get(i));
+			}
+
+			// output may be the same container as an input
+			SVectorSoA in_place(soa_a);
+			SVectorSoA::Add(in_place, soa_b, in_place);
+			for (size_t i = 0; i < a.size(); ++i)
+			{
+				Assert::AreEqual(a[i] + b[i], in_place.Get(i));
+			}
+		}
+		TEST_METHOD(ReductionTests)
+		{
+			const std::vector<SVector> a = MakeVectors(37, 0.f);
+			const std::vector<SVector> b = MakeVectors(37, 100.f);
+			const SVectorSoA soa_a(a.data(), a.size());
+			const SVectorSoA soa_b(b.data(), b.size());
+			std::vector<float> dot(a.size()), magnitude(a.size()), sqr_magnitude(a.size());
+			SVectorSoA::Dot(soa_a, soa_b, dot.data());
+			SVectorSoA::Magnitude(soa_a, magnitude.data());
+			SVectorSoA::SqrMagnitude(soa_a, sqr_magnitude.data());
+
+			for (size_t i = 0; i < a.size(); ++i)
+			{
+				Assert::AreEqual(a[i] | b[i], dot[i]);
+				Assert::AreEqual(a[i].Magnitude(), magnitude[i]);
+				Assert::AreEqual(a[i].SqrMagnitude(), sqr_magnitude[i]);
+			}
+		}
+		TEST_METHOD(NormalizationTests)
+		{
+			std::vector<SVector> a = MakeVectors(37, 0.f);
+			a[5] = SVector::ZeroVector;
+			const SVectorSoA soa_a(a.data(), a.size());
+			SVectorSoA normal, normal_safe;
+			SVectorSoA::Normalize(soa_a, normal);
+			SVectorSoA::NormalizeSafe(soa_a, normal_safe);
+
+			for (size_t i = 0; i < a.size(); ++i)
+			{
+				if (i != 5)
+				{
+					Assert::AreEqual(a[i].Normal(), normal.Get(i));
+				}
+				Assert::AreEqual(a[i].NormalSafe(), normal_safe.Get(i));
+			}
+		}
+		TEST_METHOD(PrecisionPolicyTests)
+		{
+			std::vector<SVector> a = MakeVectors(37, 0.f);
+			a[5] = SVector::ZeroVector;
+			const SVectorSoA soa_a(a.data(), a.size());
+
+			SVectorSoA exact, fast, approximate;
+			SVectorSoA::Normalize<SPrecisionExact>(soa_a, exact);
+			SVectorSoA::NormalizeSafe<SPrecisionFast>(soa_a, fast);
+			SVectorSoA::NormalizeSafe<SPrecisionApproximate>(soa_a, approximate);
+
+			std::vector<float> magnitudes(a.size());
+			SVectorSoA::Magnitude<SPrecisionFast>(soa_a, magnitudes.data());
+
+			for (size_t i = 0; i < a.size(); ++i)
+			{
+				if (i != 5)
+				{
+					Assert::AreEqual(a[i].Normal(), exact.Get(i));
+				}
+
+				// AVX-512 estimates 'rsqrt' with more bits than SSE, so results are compared with the exact normal, not with 'SVector'
+				const SVector exact_safe = a[i].NormalSafe();
+				Assert::AreEqual(exact_safe.GetX(), fast.Get(i).GetX(), 3.5e-7f);
+				Assert::AreEqual(exact_safe.GetY(), fast.Get(i).GetY(), 3.5e-7f);
+				Assert::AreEqual(exact_safe.GetZ(), fast.Get(i).GetZ(), 3.5e-7f);
+
+				Assert::AreEqual(exact_safe.GetX(), approximate.Get(i).GetX(), 3.5e-4f);
+				Assert::AreEqual(exact_safe.GetY(), approximate.Get(i).GetY(), 3.5e-4f);
+				Assert::AreEqual(exact_safe.GetZ(), approximate.Get(i).GetZ(), 3.5e-4f);
+
+				Assert::AreEqual(a[i].Magnitude(), magnitudes[i], a[i].Magnitude() * 3.5e-7f);
+			}
+			Assert::AreEqual(SVector::ZeroVector, fast.Get(5));
+			Assert::AreEqual(0.f, magnitudes[5]);
+		}
+		TEST_METHOD(ProjectionReflectionTests)
+		{
+			const std::vector<SVector> a = MakeVectors(37, 0.f);
+			std::vector<SVector> b = MakeVectors(37, 100.f);
+			std::vector<SVector> n(b.size());
+			for (size_t i = 0; i < b.size(); ++i)
+			{
+				n[i] = b[i].Normal();
+			}
+			b[3] = SVector::ZeroVector;
+
+			const SVectorSoA soa_a(a.data(), a.size());
+			const SVectorSoA soa_b(b.data(), b.size());
+			const SVectorSoA soa_n(n.data(), n.size());
+			SVectorSoA projection, projection_normal, reflection;
+			SVectorSoA::ProjectOnTo(soa_a, soa_n, projection);
+			SVectorSoA::ProjectOnToNormal(soa_a, soa_n, projection_normal);
+			SVectorSoA::Reflection(soa_a, soa_b, reflection);
+
+			for (size_t i = 0; i < a.size(); ++i)
+			{
+				Assert::AreEqual(a[i].ProjectionOnTo(n[i]), projection.Get(i));
+				Assert::AreEqual(a[i].ProjectionOnToNormal(n[i]), projection_normal.Get(i));
+				Assert::AreEqual(a[i].Reflection(b[i]), reflection.Get(i));
+			}
+		}
+	};
+	TEST_CLASS(SQuaternionTests)
+	{
+	public:
+		// scalar reference of the quaternion algebra
+		struct SScalarQuaternion
+		{
+			float x, y, z, w;
+
+			static SScalarQuaternion From(const SQuaternion& q) { return {q.GetX(), q.GetY(), q.GetZ(), q.GetW()}; }
+
+			SScalarQuaternion operator*(const SScalarQuaternion& r) const
+			{
+				return {
+					w * r.x + x * r.w + y * r.z - z * r.y,
+					w * r.y - x * r.z + y * r.w + z * r.x,
+					w * r.z + x * r.y - y * r.x + z * r.w,
+					w * r.w - x * r.x - y * r.y - z * r.z};
+			}
+
+			float Dot(const SScalarQuaternion& r) const { return x * r.x + y * r.y + z * r.z + w * r.w; }
+			SScalarQuaternion Conjugate() const { return {-x, -y, -z, w}; }
+			SScalarQuaternion Scale(float s) const { return {x * s, y * s, z * s, w * s}; }
+		};
+
+		static void AreNear(const SScalarQuaternion& expected, const SQuaternion& actual, float tolerance = 1e-5f)
+		{
+			Assert::AreEqual(expected.x, actual.GetX(), tolerance);
+			Assert::AreEqual(expected.y, actual.GetY(), tolerance);
+			Assert::AreEqual(expected.z, actual.GetZ(), tolerance);
+			Assert::AreEqual(expected.w, actual.GetW(), tolerance);
+		}
+
+		static void AreNear(const SVector& expected, const SVector& actual, float tolerance = 1e-5f)
+		{
+			Assert::AreEqual(expected.GetX(), actual.GetX(), tolerance);
+			Assert::AreEqual(expected.GetY(), actual.GetY(), tolerance);
+			Assert::AreEqual(expected.GetZ(), actual.GetZ(), tolerance);
+			Assert::AreEqual(expected.GetUnusedAxis(), actual.GetUnusedAxis());
+		}
+
+		TEST_METHOD(ConstructorTests)
+		{
+			{
+				const SQuaternion q(1.f, 2.f, 3.f, 4.f);
+				Assert::AreEqual(q.GetX(), 1.f);
+				Assert::AreEqual(q.GetY(), 2.f);
+				Assert::AreEqual(q.GetZ(), 3.f);
+				Assert::AreEqual(q.GetW(), 4.f);
+			}
+
+			{
+				Assert::AreEqual(SQuaternion::Identity, SQuaternion(0.f, 0.f, 0.f, 1.f));
+				Assert::IsTrue(SQuaternion(1.f, 2.f, 3.f, 4.f) != SQuaternion(1.f, 2.f, 3.f, 5.f));
+			}
+		}
+		TEST_METHOD(EulerConstructorTests)
+		{
+			// reference: the component formulas evaluated in double precision
+			for (const float roll : { 0.f, 0.3f, -1.2f, 2.9f, 6.f })
+			{
+				for (const float pitch : { 0.f, -0.7f, 1.5f, -3.1f })
+				{
+					for (const float yaw : { 0.f, 0.45f, -2.2f, 4.f })
+					{
+						const double sr = sin(roll * 0.5), cr = cos(roll * 0.5);
+						const double sp = sin(pitch * 0.5), cp = cos(pitch * 0.5);
+						const double sy = sin(yaw * 0.5), cy = cos(yaw * 0.5);
+						const SScalarQuaternion expected{
+							static_cast<float>(sr * cp * cy - cr * sp * sy),
+							static_cast<float>(cr * sp * cy + sr * cp * sy),
+							static_cast<float>(cr * cp * sy - sr * sp * cy),
+							static_cast<float>(cr * cp * cy + sr * sp * sy) };
+
+						AreNear(expected, SQuaternion(roll, pitch, yaw), 1e-6f);
+					}
+				}
+			}
+
+			Assert::AreEqual(SQuaternion::Identity, SQuaternion(0.f, 0.f, 0.f));
+		}
+		TEST_METHOD(HamiltonProductTests)
+		{
+			{
+				// i * j = k, j * i = -k
+				const SQuaternion i(1.f, 0.f, 0.f, 0.f);
+				const SQuaternion j(0.f, 1.f, 0.f, 0.f);
+
+				Assert::AreEqual(SQuaternion(0.f, 0.f, 1.f, 0.f), i * j);
+				Assert::AreEqual(SQuaternion(0.f, 0.f, -1.f, 0.f), j * i);
+			}
+
+			{
+				const SQuaternion a(0.5f, -1.5f, 2.f, 0.25f);
+				const SQuaternion b(-0.75f, 0.3f, 1.1f, -2.f);
+				const SScalarQuaternion expected = SScalarQuaternion::From(a) * SScalarQuaternion::From(b);
+
+				AreNear(expected, a * b);
+
+				SQuaternion c(a);
+				c *= b;
+				AreNear(expected, c);
+			}
+		}
+		TEST_METHOD(DotProductMagnitudeTests)
+		{
+			const SQuaternion a(0.5f, -1.5f, 2.f, 0.25f);
+			const SQuaternion b(-0.75f, 0.3f, 1.1f, -2.f);
+			const SScalarQuaternion sa = SScalarQuaternion::From(a);
+
+			Assert::AreEqual(sa.Dot(SScalarQuaternion::From(b)), a | b, 1e-6f);
+			Assert::AreEqual(sa.Dot(SScalarQuaternion::From(b)), SQuaternion::DotProduct(a, b), 1e-6f);
+			Assert::AreEqual(sa.Dot(sa), a.SqrMagnitude(), 1e-6f);
+			Assert::AreEqual(sqrtf(sa.Dot(sa)), a.Magnitude(), 1e-6f);
+		}
+		TEST_METHOD(NormalizationTests)
+		{
+			const SQuaternion a(0.5f, -1.5f, 2.f, 0.25f);
+			const SScalarQuaternion sa = SScalarQuaternion::From(a);
+			const SScalarQuaternion expected = sa.Scale(1.f / sqrtf(sa.Dot(sa)));
+
+			AreNear(expected, a.Normal());
+			Assert::AreEqual(1.f, a.Normal().Magnitude(), 1e-6f);
+
+			SQuaternion b(a);
+			b.Normalize();
+			AreNear(expected, b);
+		}
+		TEST_METHOD(ConjugateInverseTests)
+		{
+			const SQuaternion a(0.5f, -1.5f, 2.f, 0.25f);
+			const SScalarQuaternion sa = SScalarQuaternion::From(a);
+
+			Assert::AreEqual(SQuaternion(-0.5f, 1.5f, -2.f, 0.25f), a.Conjugation());
+
+			SQuaternion b(a);
+			b.Conjugate();
+			Assert::AreEqual(a.Conjugation(), b);
+
+			const SScalarQuaternion expected = sa.Conjugate().Scale(1.f / sa.Dot(sa));
+			AreNear(expected, a.Inverse());
+
+			SQuaternion c(a);
+			c.Invert();
+			AreNear(expected, c);
+
+			// q * q^-1 = identity
+			AreNear(SScalarQuaternion::From(SQuaternion::Identity), a * a.Inverse());
+		}
+		TEST_METHOD(RotationTests)
+		{
+			{
+				// 90 degrees around Z turns X into Y
+				const float half = 0.5f * 1.5707963f;
+				const SQuaternion q(0.f, 0.f, sinf(half), cosf(half));
+
+				AreNear(SVector(0.f, 1.f, 0.f), q.Rotate(SVector(1.f, 0.f, 0.f)));
+				AreNear(SVector(-1.f, 0.f, 0.f), q.Rotate(SVector(0.f, 1.f, 0.f)));
+				AreNear(SVector(0.f, 0.f, 1.f), q.Rotate(SVector(0.f, 0.f, 1.f)));
+			}
+
+			{
+				// q * v * q^-1 with a pure quaternion v
+				const SQuaternion q = SQuaternion(0.3f, -0.6f, 0.2f, 0.7f).Normal();
+				const SVector v(1.5f, -2.f, 0.5f);
+				const SScalarQuaternion sq = SScalarQuaternion::From(q);
+				const SScalarQuaternion sv{v.GetX(), v.GetY(), v.GetZ(), 0.f};
+				const SScalarQuaternion expected = sq * sv * sq.Conjugate();
+
+				AreNear(SVector(expected.x, expected.y, expected.z), q.Rotate(v));
+			}
+
+			{
+				const SQuaternion a = SQuaternion(0.3f, -0.6f, 0.2f, 0.7f).Normal();
+				const SQuaternion b = SQuaternion(-0.1f, 0.4f, 0.9f, 0.2f).Normal();
+				const SVector v(1.5f, -2.f, 0.5f);
+
+				// composition: (a * b) rotates by 'b' first
+				AreNear(a.Rotate(b.Rotate(v)), (a * b).Rotate(v));
+			}
+		}
+	};
+	TEST_CLASS(SDualQuaternionTests)
+	{
+	public:
+		TEST_METHOD(TransformTests)
+		{
+			std::mt19937 random(50u);
+			Assert::IsTrue(SDualQuaternion() == SDualQuaternion::Identity);
+			for (int i = 0; i < 100; ++i)
+			{
+				const SQuaternion rotation = RandomRotation(random);
+				const SVector translation = RandomVector(random, -2.f, 2.f), v = RandomVector(random, -2.f, 2.f);
+				const SDualQuaternion transform = SDualQuaternion::FromTransform(rotation, translation);
+
+				Assert::IsTrue(transform.GetRotation() == rotation);
+				AssertVectorsNear(translation, transform.GetTranslation(), 1e-5f);
+				AssertVectorsNear(rotation.Rotate(v) + translation, transform.TransformPoint(v), 1e-5f);
+				AssertVectorsNear(rotation.Rotate(v), transform.TransformDirection(v), 1e-5f);
+				AssertVectorsNear(v, SDualQuaternion::Identity.TransformPoint(v), 0.f);
+			}
+		}
+		TEST_METHOD(BatchTests)
+		{
+			std::mt19937 random(51u);
+			for (size_t count = 0; count < 10; ++count)
+			{
+				std::vector<SQuaternion> rotations;
+				std::vector<SVector> translations;
+				for (size_t i = 0; i < count; ++i)
+				{
+					rotations.push_back(RandomRotation(random));
+					translations.push_back(RandomVector(random, -2.f, 2.f));
+				}
+				std::vector<SDualQuaternion> dual_quaternions(count + 1);
+				SDualQuaternion::FromTransforms(rotations.data(), translations.data(), dual_quaternions.data(), count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					Assert::IsTrue(SDualQuaternion::FromTransform(rotations[i], translations[i]) == dual_quaternions[i]);
+				}
+				Assert::IsTrue(dual_quaternions[count] == SDualQuaternion::Identity);
+			}
+		}
+		TEST_METHOD(ProductTests)
+		{
+			std::mt19937 random(52u);
+			for (int i = 0; i < 100; ++i)
+			{
+				const SDualQuaternion a = SDualQuaternion::FromTransform(RandomRotation(random), RandomVector(random, -2.f, 2.f));
+				const SDualQuaternion b = SDualQuaternion::FromTransform(RandomRotation(random), RandomVector(random, -2.f, 2.f));
+				const SVector v = RandomVector(random, -2.f, 2.f);
+				// 'a * b' applies 'b' first
+				AssertVectorsNear(a.TransformPoint(b.TransformPoint(v)), (a * b).TransformPoint(v), 1e-4f);
+
+				SDualQuaternion c = a;
+				c *= b;
+				Assert::IsTrue(c == a * b);
+			}
+		}
+		TEST_METHOD(BlendTests)
+		{
+			std::mt19937 random(53u);
+			for (int i = 0; i < 100; ++i)
+			{
+				const SQuaternion rotation = RandomRotation(random);
+				const SVector translation = RandomVector(random, -2.f, 2.f);
+				const SDualQuaternion transform = SDualQuaternion::FromTransform(rotation, translation);
+
+				// the negated dual quaternion is the same transform, the blend flips it back
+				const SDualQuaternion negated(SQuaternion(_mm_xor_ps(transform.real.GetStorage(), _mm_set1_ps(-0.f))),
+				                              SQuaternion(_mm_xor_ps(transform.dual.GetStorage(), _mm_set1_ps(-0.f))));
+				const SDualQuaternion pair[] = { transform, negated };
+				const float weights[] = { .25f, .75f };
+				const SDualQuaternion blend = SDualQuaternion::Blend(pair, weights, 2).Normal();
+				Assert::AreEqual(1.f, blend.real.Magnitude(), 1e-6f);
+				AssertVectorsNear(translation, blend.GetTranslation(), 1e-5f);
+				Assert::IsTrue((blend.real | rotation) > 1.f - 1e-6f);
+
+				// pure translations blend linearly
+				const SVector other = RandomVector(random, -2.f, 2.f);
+				const SDualQuaternion translations[] = { SDualQuaternion::FromTransform(SQuaternion::Identity, translation),
+				                                         SDualQuaternion::FromTransform(SQuaternion::Identity, other) };
+				AssertVectorsNear(translation * .25f + other * .75f, SDualQuaternion::Blend(translations, weights, 2).Normal().GetTranslation(), 1e-5f);
+			}
+		}
+	};
+
+	TEST_CLASS(SQuaternionInterpolationTests)
+	{
+	public:
+		// unit quaternions rotating around varying axes by angles up to 180 degrees, the count is not a multiple of a register width
+		static void MakePairs(size_t count, std::vector<SQuaternion>& from, std::vector<SQuaternion>& to, std::vector<float>& alphas)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float f = static_cast<float>(i);
+				from.push_back(SQuaternion(sinf(f), cosf(f * 1.7f), sinf(f * 0.3f + 2.f), cosf(f * 0.9f)).Normal());
+				const float half = 0.5f * 3.1415926f * static_cast<float>(i) / static_cast<float>(count);
+				const SVector axis = SVector(cosf(f * 2.1f), sinf(f), 0.5f).Normal();
+				const SQuaternion rotation(axis.GetX() * sinf(half), axis.GetY() * sinf(half), axis.GetZ() * sinf(half), cosf(half));
+				// every other pair has a negative dot product to exercise the shortest path
+				const SQuaternion target = rotation * from.back();
+				to.push_back(i % 2 == 0 ? target : SQuaternion(_mm_xor_ps(target.GetStorage(), _mm_set1_ps(-0.f))));
+				alphas.push_back(static_cast<float>(i % 5) / 4.f);
+			}
+		}
+
+		// double precision slerp along the shortest path
+		static void ReferenceSlerp(const SQuaternion& from, const SQuaternion& to, float t, double result[4])
+		{
+			const double a[4] = { from.GetX(), from.GetY(), from.GetZ(), from.GetW() };
+			double b[4] = { to.GetX(), to.GetY(), to.GetZ(), to.GetW() };
+			double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+			if (dot < 0.0)
+			{
+				for (double& component : b)
+				{
+					component = -component;
+				}
+				dot = -dot;
+			}
+
+			const double angle = acos(dot > 1.0 ? 1.0 : dot);
+			for (int i = 0; i < 4; ++i)
+			{
+				result[i] = angle < 1e-9 ? a[i] : (sin((1.0 - t) * angle) * a[i] + sin(t * angle) * b[i]) / sin(angle);
+			}
+		}
+
+		// rotation angle between two unit quaternions, well conditioned for small angles
+		static double Angle(const SQuaternion& q, const double r[4])
+		{
+			const double a[4] = { q.GetX(), q.GetY(), q.GetZ(), q.GetW() };
+			const double sign = a[0] * r[0] + a[1] * r[1] + a[2] * r[2] + a[3] * r[3] < 0.0 ? -1.0 : 1.0;
+			double chord = 0.0;
+			for (int i = 0; i < 4; ++i)
+			{
+				chord += (a[i] - sign * r[i]) * (a[i] - sign * r[i]);
+			}
+			return 4.0 * asin(sqrt(chord) / 2.0);
+		}
+
+		TEST_METHOD(SlerpTests)
+		{
+			std::vector<SQuaternion> from, to;
+			std::vector<float> alphas;
+			MakePairs(67, from, to, alphas);
+
+			std::vector<SQuaternion> out(from);
+			SQuaternionInterpolation::Slerp(from.data(), to.data(), alphas.data(), out.data(), out.size());
+
+			for (size_t i = 0; i < out.size(); ++i)
+			{
+				double expected[4];
+				ReferenceSlerp(from[i], to[i], alphas[i], expected);
+				Assert::IsTrue(Angle(out[i], expected) < 1e-5);
+				Assert::AreEqual(1.f, out[i].Magnitude(), 1e-5f);
+			}
+		}
+		TEST_METHOD(NlerpTests)
+		{
+			std::vector<SQuaternion> from, to;
+			std::vector<float> alphas;
+			MakePairs(67, from, to, alphas);
+
+			std::vector<SQuaternion> out(from);
+			SQuaternionInterpolation::Nlerp(from.data(), to.data(), alphas.data(), out.data(), out.size());
+
+			for (size_t i = 0; i < out.size(); ++i)
+			{
+				const float sign = (from[i] | to[i]) < 0.f ? -1.f : 1.f;
+				const float t = alphas[i];
+				const SQuaternion expected = SQuaternion(
+					from[i].GetX() * (1.f - t) + sign * to[i].GetX() * t,
+					from[i].GetY() * (1.f - t) + sign * to[i].GetY() * t,
+					from[i].GetZ() * (1.f - t) + sign * to[i].GetZ() * t,
+					from[i].GetW() * (1.f - t) + sign * to[i].GetW() * t).Normal();
+
+				Assert::AreEqual(expected.GetX(), out[i].GetX(), 1e-6f);
+				Assert::AreEqual(expected.GetY(), out[i].GetY(), 1e-6f);
+				Assert::AreEqual(expected.GetZ(), out[i].GetZ(), 1e-6f);
+				Assert::AreEqual(expected.GetW(), out[i].GetW(), 1e-6f);
+			}
+		}
+		TEST_METHOD(FastSlerpTests)
+		{
+			std::vector<SQuaternion> from, to;
+			std::vector<float> alphas;
+			MakePairs(997, from, to, alphas);
+
+			std::vector<SQuaternion> out(from);
+			SQuaternionInterpolation::FastSlerp(from.data(), to.data(), alphas.data(), out.data(), out.size());
+
+			for (size_t i = 0; i < out.size(); ++i)
+			{
+				double expected[4];
+				ReferenceSlerp(from[i], to[i], alphas[i], expected);
+				Assert::IsTrue(Angle(out[i], expected) <= SQuaternionInterpolation::FastSlerpMaxError);
+			}
+		}
+		TEST_METHOD(ShortestPathTests)
+		{
+			// 'to' is the same rotation as 'from' with an opposite sign, the result must not spin around
+			const SQuaternion from = SQuaternion::Identity;
+			const SQuaternion to(0.f, 0.f, 0.f, -1.f);
+			const float alpha = 0.5f;
+
+			for (const EQuaternionInterpolation method : { EQuaternionInterpolation::Slerp, EQuaternionInterpolation::Nlerp, EQuaternionInterpolation::FastSlerp })
+			{
+				SQuaternion out(0.f);
+				SQuaternionInterpolation::Interpolate(method, &from, &to, &alpha, &out, 1);
+				Assert::AreEqual(SQuaternion::Identity, out);
+			}
+		}
+		TEST_METHOD(EndpointsTests)
+		{
+			std::vector<SQuaternion> from, to;
+			std::vector<float> alphas;
+			MakePairs(9, from, to, alphas);
+
+			for (const EQuaternionInterpolation method : { EQuaternionInterpolation::Slerp, EQuaternionInterpolation::Nlerp, EQuaternionInterpolation::FastSlerp })
+			{
+				std::vector<SQuaternion> out(from);
+				const std::vector<float> zeros(from.size(), 0.f);
+				SQuaternionInterpolation::Interpolate(method, from.data(), to.data(), zeros.data(), out.data(), out.size());
+				for (size_t i = 0; i < out.size(); ++i)
+				{
+					Assert::AreEqual(1.f, fabsf(out[i] | from[i]), 1e-6f);
+				}
+
+				const std::vector<float> ones(from.size(), 1.f);
+				SQuaternionInterpolation::Interpolate(method, from.data(), to.data(), ones.data(), out.data(), out.size());
+				for (size_t i = 0; i < out.size(); ++i)
+				{
+					Assert::AreEqual(1.f, fabsf(out[i] | to[i]), 1e-6f);
+				}
+			}
+		}
+	};
+
+	TEST_CLASS(STrigonometryTests)
+	{
+	public:
+
+		// angles spread over [-range, range], 'count' is not a multiple of any register width so the tail is covered too
+		static std::vector<float> MakeAngles(float range, size_t count)
+		{
+			std::vector<float> angles(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				angles[i] = range * ((2.f * static_cast<float>(i) + 1.f) / static_cast<float>(count) - 1.f);
+			}
+			return angles;
+		}
+
+		TEST_METHOD(SinCosTests)
+		{
+			for (const size_t count : { 1, 3, 4, 7, 17, 1001 })
+			{
+				const std::vector<float> angles = MakeAngles(3.14159265f, count);
+				std::vector<float> sines(count), cosines(count);
+				Simd::SinCos(angles.data(), sines.data(), cosines.data(), count);
+
+				for (size_t i = 0; i < count; ++i)
+				{
+					const double angle = angles[i];
+					// 1.5 ULP of a value in [0.5, 1] is below 1.8e-7, smaller values have finer ULPs
+					Assert::AreEqual(sin(angle), static_cast<double>(sines[i]), 1.5 * std::max(fabs(sin(angle)), 1e-7) * FLT_EPSILON + 1e-12);
+					Assert::AreEqual(cos(angle), static_cast<double>(cosines[i]), 1.5 * std::max(fabs(cos(angle)), 1e-7) * FLT_EPSILON + 1e-12);
+				}
+			}
+		}
+		TEST_METHOD(LargeAnglesTests)
+		{
+			const size_t count = 100003;
+			const std::vector<float> angles = MakeAngles(Simd::SinCosMaxAngle, count);
+			std::vector<float> sines(count), cosines(count);
+			Simd::Sin(angles.data(), sines.data(), count);
+			Simd::Cos(angles.data(), cosines.data(), count);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				Assert::AreEqual(sin(static_cast<double>(angles[i])), static_cast<double>(sines[i]), 8e-8);
+				Assert::AreEqual(cos(static_cast<double>(angles[i])), static_cast<double>(cosines[i]), 8e-8);
+			}
+		}
+		TEST_METHOD(SpecialValuesTests)
+		{
+			const float angles[] = { 0.f, -0.f, 1.57079632f, -1.57079632f, 3.14159265f };
+			float sines[5], cosines[5];
+			Simd::SinCos(angles, sines, cosines, 5);
+
+			Assert::AreEqual(0.f, sines[0]);
+			Assert::AreEqual(1.f, cosines[0]);
+			Assert::AreEqual(1.f, sines[2]);
+			Assert::AreEqual(-1.f, sines[3]);
+			Assert::AreEqual(-1.f, cosines[4]);
+		}
+	};
+}
+namespace
+{
+	std::string MakeTrackFilePath(const char* name)
+	{
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+
+	// a file image in 16-byte aligned memory, as 'STrackFile::Validate' takes it
+	std::vector<__m128> ReadTrackFileImage(const std::string& path, size_t& size)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		size = static_cast<size_t>(file.tellg());
+		std::vector<__m128> image((size + sizeof(__m128) - 1) / sizeof(__m128));
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(image.data()), static_cast<std::streamsize>(size));
+		return image;
+	}
+
+	// recomputes checksums of the index and the header of an edited image
+	void ResealTrackFileImage(std::vector<__m128>& image)
+	{
+		unsigned char* bytes = reinterpret_cast<unsigned char*>(image.data());
+		STrackFileHeader& header = *reinterpret_cast<STrackFileHeader*>(bytes);
+		const STrackFileEntry* entries = reinterpret_cast<const STrackFileEntry*>(bytes + header.index_offset);
+		header.index_checksum = STrackFile::Checksum(entries, header.track_count * sizeof(STrackFileEntry));
+		header.header_checksum = 0;
+		header.header_checksum = STrackFile::Checksum(&header, sizeof(header));
+	}
+}
+
+namespace AnimationUnitTest
+{
+	TEST_CLASS(STrackFileTests)
+	{
+	public:
+		TEST_METHOD(ChecksumTests)
+		{
+			const char text[] = "123456789";
+			const uint32_t crc = STrackFile::Checksum(text, 9);
+			Assert::AreEqual(0xE3069283u, crc);
+			Assert::AreEqual(crc, STrackFile::Checksum(text + 4, 5, STrackFile::Checksum(text, 4)));
+			Assert::AreEqual(0u, STrackFile::Checksum(text, 0));
+		}
+		TEST_METHOD(RoundTripTests)
+		{
+			// unused lanes aren't zero in the input, the writer clears them
+			std::vector<__m128> raw_vectors;
+			for (int i = 0; i < 1000; ++i)
+			{
+				raw_vectors.push_back(_mm_set_ps(static_cast<float>(i), -0.5f * i, 1e-3f * i, 7.f));
+			}
+			const SVector* vectors = reinterpret_cast<const SVector*>(raw_vectors.data());
+
+			std::vector<SQuaternion> rotations;
+			for (int i = 0; i < 37; ++i)
+			{
+				rotations.emplace_back(0.1f * i, -0.05f * i, 0.02f * i);
+			}
+
+			STrackFileWriter writer;
+			Assert::IsTrue(writer.AddVectors("root/translation", vectors, raw_vectors.size()));
+			Assert::IsTrue(writer.AddQuaternions("root/rotation", rotations.data(), rotations.size()));
+			Assert::IsTrue(writer.AddVectors("empty", nullptr, 0));
+			Assert::IsFalse(writer.AddVectors("root/translation", vectors, 1));
+			Assert::IsFalse(writer.AddVectors("", vectors, 1));
+			Assert::IsFalse(writer.AddVectors("a_name_longer_than_the_31_characters", vectors, 1));
+
+			const std::string path = MakeTrackFilePath("AnimationUnitTest_RoundTrip.track");
+			Assert::IsTrue(writer.Write(path.c_str()) == ETrackFileStatus::Ok);
+
+			STrackFile file;
+			Assert::IsTrue(file.Open(path.c_str()) == ETrackFileStatus::Ok);
+			Assert::AreEqual(static_cast<size_t>(3), file.GetTrackCount());
+			Assert::AreEqual(static_cast<size_t>(0), file.FindTrack("root/translation"));
+			Assert::AreEqual(static_cast<size_t>(1), file.FindTrack("root/rotation"));
+			Assert::AreEqual(static_cast<size_t>(3), file.FindTrack("missing"));
+
+			const SVector* loaded_vectors = file.GetVectors(0);
+			const SQuaternion* loaded_rotations = file.GetQuaternions(1);
+			Assert::IsTrue(file.GetQuaternions(0) == nullptr);
+			Assert::IsTrue(file.GetVectors(1) == nullptr);
+			Assert::IsTrue(reinterpret_cast<uintptr_t>(loaded_vectors) % STrackFile::SectionAlignment == 0);
+			Assert::IsTrue(reinterpret_cast<uintptr_t>(loaded_rotations) % STrackFile::SectionAlignment == 0);
+			Assert::AreEqual(static_cast<uint64_t>(raw_vectors.size()), file.GetTrack(0).count);
+			Assert::AreEqual(static_cast<uint64_t>(rotations.size()), file.GetTrack(1).count);
+			Assert::AreEqual(static_cast<uint64_t>(0), file.GetTrack(2).count);
+
+			for (size_t i = 0; i < raw_vectors.size(); ++i)
+			{
+				Assert::AreEqual(SVector(vectors[i].GetX(), vectors[i].GetY(), vectors[i].GetZ()), loaded_vectors[i]);
+				Assert::AreEqual(0.f, loaded_vectors[i].GetUnusedAxis());
+			}
+			for (size_t i = 0; i < rotations.size(); ++i)
+			{
+				Assert::AreEqual(rotations[i], loaded_rotations[i]);
+			}
+
+			STrackFile moved(std::move(file));
+			Assert::IsFalse(file.IsOpen());
+			Assert::IsTrue(moved.IsOpen());
+			moved.Close();
+			std::remove(path.c_str());
+		}
+		TEST_METHOD(ValidationTests)
+		{
+			const std::vector<SVector> vectors{ {1.f, 2.f, 3.f}, {4.f, 5.f, 6.f} };
+			STrackFileWriter writer;
+			writer.AddVectors("vectors", vectors.data(), vectors.size());
+			const std::string path = MakeTrackFilePath("AnimationUnitTest_Validation.track");
+			writer.Write(path.c_str());
+
+			size_t size{ 0 };
+			const std::vector<__m128> image = ReadTrackFileImage(path, size);
+			const size_t data_offset = 2 * sizeof(STrackFileHeader);
+			Assert::IsTrue(STrackFile::Validate(image.data(), size, ETrackFileValidation::Full) == ETrackFileStatus::Ok);
+
+			auto validate_edited = [&](size_t byte, unsigned char value, ETrackFileValidation validation, bool reseal = false)
+			{
+				std::vector<__m128> edited(image);
+				reinterpret_cast<unsigned char*>(edited.data())[byte] = value;
+				if (reseal)
+				{
+					ResealTrackFileImage(edited);
+				}
+				return STrackFile::Validate(edited.data(), size, validation);
+			};
+
+			Assert::IsTrue(validate_edited(0, 'X', ETrackFileValidation::Header) == ETrackFileStatus::BadMagic);
+			Assert::IsTrue(validate_edited(8, 2, ETrackFileValidation::Header) == ETrackFileStatus::UnsupportedVersion);
+			Assert::IsTrue(validate_edited(20, 9, ETrackFileValidation::Header) == ETrackFileStatus::HeaderChecksumMismatch);
+			Assert::IsTrue(validate_edited(sizeof(STrackFileHeader), 'V', ETrackFileValidation::Header) == ETrackFileStatus::IndexChecksumMismatch);
+			Assert::IsTrue(validate_edited(data_offset + 4, 0xFF, ETrackFileValidation::Header) == ETrackFileStatus::Ok);
+			Assert::IsTrue(validate_edited(data_offset + 4, 0xFF, ETrackFileValidation::Full) == ETrackFileStatus::DataChecksumMismatch);
+			// a section past the end of the file, the count is the 49th byte of an entry
+			Assert::IsTrue(validate_edited(sizeof(STrackFileHeader) + 48, 0x7F, ETrackFileValidation::Header, true) == ETrackFileStatus::BadSection);
+
+			{
+				// a nonzero unused lane with a matching checksum
+				std::vector<__m128> edited(image);
+				unsigned char* bytes = reinterpret_cast<unsigned char*>(edited.data());
+				bytes[data_offset + 16 + 3] = 0x3F;
+				STrackFileEntry& entry = *reinterpret_cast<STrackFileEntry*>(bytes + sizeof(STrackFileHeader));
+				entry.checksum = STrackFile::Checksum(bytes + data_offset, vectors.size() * sizeof(SVector));
+				ResealTrackFileImage(edited);
+				Assert::IsTrue(STrackFile::Validate(edited.data(), size, ETrackFileValidation::Header) == ETrackFileStatus::Ok);
+				Assert::IsTrue(STrackFile::Validate(edited.data(), size, ETrackFileValidation::Full) == ETrackFileStatus::UnusedLaneNotZero);
+			}
+
+			Assert::IsTrue(STrackFile::Validate(image.data(), size - 1, ETrackFileValidation::Header) == ETrackFileStatus::TooSmall);
+			Assert::IsTrue(STrackFile::Validate(reinterpret_cast<const char*>(image.data()) + 4, size - 4, ETrackFileValidation::Header) == ETrackFileStatus::Misaligned);
+
+			STrackFile file;
+			Assert::IsTrue(file.Open(MakeTrackFilePath("AnimationUnitTest_Missing.track").c_str()) == ETrackFileStatus::OpenFailed);
+			Assert::IsFalse(file.IsOpen());
+			std::remove(path.c_str());
+		}
+		TEST_METHOD(FloatTests)
+		{
+			// floats pack four bytes apart, the next section still starts aligned
+			std::vector<float> times;
+			for (int i = 0; i < 4099; ++i)
+			{
+				times.push_back(0.25f * i);
+			}
+			const SVector vectors[] = { {1.f, 2.f, 3.f} };
+
+			STrackFileWriter writer;
+			Assert::IsTrue(writer.AddFloats("times", times.data(), times.size()));
+			Assert::IsTrue(writer.AddVectors("values", vectors, 1));
+			Assert::IsFalse(writer.AddFloats("values", times.data(), 1));
+
+			const std::string path = MakeTrackFilePath("AnimationUnitTest_Floats.track");
+			Assert::IsTrue(writer.Write(path.c_str()) == ETrackFileStatus::Ok);
+
+			STrackFile file;
+			Assert::IsTrue(file.Open(path.c_str()) == ETrackFileStatus::Ok);
+			Assert::IsTrue(file.GetTrack(0).type == ETrackType::Float);
+			Assert::AreEqual(static_cast<uint32_t>(sizeof(float)), file.GetTrack(0).element_size);
+			Assert::IsTrue(file.GetVectors(0) == nullptr);
+			Assert::IsTrue(file.GetFloats(1) == nullptr);
+			Assert::IsTrue(reinterpret_cast<uintptr_t>(file.GetVectors(1)) % STrackFile::SectionAlignment == 0);
+			Assert::AreEqual(vectors[0], file.GetVectors(1)[0]);
+
+			const float* loaded = file.GetFloats(0);
+			for (size_t i = 0; i < times.size(); ++i)
+			{
+				Assert::AreEqual(times[i], loaded[i]);
+			}
+			file.Close();
+			std::remove(path.c_str());
+		}
+	};
+}
+
+namespace
+{
+	// a chain-heavy hierarchy like a character rig: most joints hang off the previous few
+	std::vector<int16_t> MakeSkeletonParents(size_t joint_count, std::mt19937& random)
+	{
+		std::vector<int16_t> parents(joint_count, SSkeleton::NoParent);
+		for (size_t joint = 1; joint < joint_count; ++joint)
+		{
+			const size_t back = std::uniform_int_distribution<size_t>(1, std::min<size_t>(joint, 4))(random);
+			parents[joint] = static_cast<int16_t>(joint - back);
+		}
+		return parents;
+	}
+
+	SPose MakeLocalPose(size_t joint_count, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+		SPose pose(joint_count);
+		for (size_t joint = 0; joint < joint_count; ++joint)
+		{
+			pose.GetTranslations()[joint] = SVector(distribution(random), distribution(random), distribution(random));
+			pose.GetRotations()[joint] = SQuaternion(distribution(random) * 3.f, distribution(random) * 3.f, distribution(random) * 3.f);
+			pose.GetScales()[joint] = SVector(1.f + 0.25f * distribution(random));
+		}
+		return pose;
+	}
+}
+
+namespace AnimationUnitTest
+{
+	TEST_CLASS(SSkeletonTests)
+	{
+	public:
+		TEST_METHOD(HierarchyTests)
+		{
+			const SSkeleton skeleton({ SSkeleton::NoParent, 0, 1, 1, SSkeleton::NoParent }, { "root", "spine", "head", "arm", "prop" });
+			Assert::IsTrue(skeleton.IsValid());
+			Assert::AreEqual(static_cast<size_t>(5), skeleton.GetJointCount());
+			Assert::AreEqual(static_cast<int16_t>(1), skeleton.GetParent(3));
+			Assert::AreEqual(static_cast<size_t>(3), skeleton.FindJoint("arm"));
+			Assert::AreEqual(static_cast<size_t>(5), skeleton.FindJoint("leg"));
+			Assert::AreEqual(std::string("head"), skeleton.GetName(2));
+
+			Assert::IsTrue(SSkeleton({ SSkeleton::NoParent, 0, 0 }).IsValid());
+			Assert::IsTrue(SSkeleton().IsValid());
+			Assert::AreEqual(std::string(), SSkeleton({ SSkeleton::NoParent }).GetName(0));
+
+			// a child before its parent, a joint parenting itself, a parent out of range and a name missing
+			Assert::IsFalse(SSkeleton({ 1, SSkeleton::NoParent }).IsValid());
+			Assert::IsFalse(SSkeleton({ SSkeleton::NoParent, 1 }).IsValid());
+			Assert::IsFalse(SSkeleton({ SSkeleton::NoParent, -2 }).IsValid());
+			Assert::IsFalse(SSkeleton({ SSkeleton::NoParent, 0 }, { "root" }).IsValid());
+		}
+		TEST_METHOD(LocalToModelTests)
+		{
+			{
+				// a root moved along X, a child turned 90 degrees around Z one unit along X, a grandchild one unit along X of the child
+				const SSkeleton skeleton({ SSkeleton::NoParent, 0, 1 });
+				SPose local(3);
+				local.GetTranslations()[0] = SVector(1.f, 0.f, 0.f);
+				local.GetScales()[0] = SVector(2.f);
+				local.GetTranslations()[1] = SVector(1.f, 0.f, 0.f);
+				local.GetRotations()[1] = SQuaternion(0.f, 0.f, 1.57079632f);
+				local.GetTranslations()[2] = SVector(1.f, 0.f, 0.f);
+
+				SPose model;
+				skeleton.LocalToModel(local, model);
+				Assert::AreEqual(static_cast<size_t>(3), model.Size());
+
+				const SVector expected[] = { {1.f, 0.f, 0.f}, {3.f, 0.f, 0.f}, {3.f, 2.f, 0.f} };
+				for (size_t joint = 0; joint < 3; ++joint)
+				{
+					Assert::AreEqual(expected[joint].GetX(), model.GetTranslations()[joint].GetX(), 1e-6f);
+					Assert::AreEqual(expected[joint].GetY(), model.GetTranslations()[joint].GetY(), 1e-6f);
+					Assert::AreEqual(expected[joint].GetZ(), model.GetTranslations()[joint].GetZ(), 1e-6f);
+					Assert::AreEqual(SVector(2.f), model.GetScales()[joint]);
+				}
+				Assert::AreEqual(local.GetRotations()[1], model.GetRotations()[2]);
+			}
+
+			{
+				// bit-equal to a per-joint loop over 'SQuaternion' and 'SVector' operators
+				std::mt19937 random(7u);
+				const SSkeleton skeleton(MakeSkeletonParents(150, random));
+				std::vector<SPose> locals{ MakeLocalPose(150, random), MakeLocalPose(150, random) };
+				std::vector<SPose> models(2);
+				skeleton.LocalToModel(locals.data(), models.data(), locals.size());
+
+				for (size_t pose = 0; pose < locals.size(); ++pose)
+				{
+					const SPose& local = locals[pose];
+					SPose expected(150);
+					for (size_t joint = 0; joint < 150; ++joint)
+					{
+						const int16_t parent = skeleton.GetParent(joint);
+						if (parent == SSkeleton::NoParent)
+						{
+							expected.GetTranslations()[joint] = local.GetTranslations()[joint];
+							expected.GetRotations()[joint] = local.GetRotations()[joint];
+							expected.GetScales()[joint] = local.GetScales()[joint];
+							continue;
+						}
+
+						const SQuaternion& parent_rotation = expected.GetRotations()[parent];
+						const SVector& parent_scale = expected.GetScales()[parent];
+						expected.GetTranslations()[joint] = parent_rotation.Rotate(parent_scale * local.GetTranslations()[joint]) + expected.GetTranslations()[parent];
+						expected.GetRotations()[joint] = parent_rotation * local.GetRotations()[joint];
+						expected.GetScales()[joint] = parent_scale * local.GetScales()[joint];
+					}
+
+					for (size_t joint = 0; joint < 150; ++joint)
+					{
+						Assert::AreEqual(expected.GetTranslations()[joint], models[pose].GetTranslations()[joint]);
+						Assert::AreEqual(expected.GetRotations()[joint], models[pose].GetRotations()[joint]);
+						Assert::AreEqual(expected.GetScales()[joint], models[pose].GetScales()[joint]);
+						Assert::AreEqual(0.f, models[pose].GetTranslations()[joint].GetUnusedAxis());
+					}
+				}
+			}
+		}
+	};
+}
+
+namespace
+{
+	// joints with 0 to 40 keys per channel over 'duration' seconds, keys at random intervals
+	SClip MakeRandomClip(size_t joint_count, float duration, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+		SClip clip(joint_count, duration);
+		for (size_t joint = 0; joint < joint_count; ++joint)
+		{
+			for (int channel = 0; channel < 3; ++channel)
+			{
+				const size_t count = std::uniform_int_distribution<size_t>(0, 40)(random);
+				std::vector<float> times;
+				for (size_t key = 0; key < count; ++key)
+				{
+					times.push_back(duration * (static_cast<float>(key) + 0.5f * (distribution(random) + 1.f) * 0.9f) / static_cast<float>(count));
+				}
+
+				std::vector<SVector> vectors;
+				std::vector<SQuaternion> rotations;
+				for (size_t key = 0; key < count; ++key)
+				{
+					vectors.emplace_back(distribution(random), distribution(random), distribution(random));
+					rotations.emplace_back(distribution(random) * 3.f, distribution(random) * 3.f, distribution(random) * 3.f);
+				}
+
+				if (count > 0)
+				{
+					const bool is_added = channel == 0 ? clip.SetTranslations(joint, times.data(), vectors.data(), count) :
+					                      channel == 1 ? clip.SetRotations(joint, times.data(), rotations.data(), count) :
+					                                     clip.SetScales(joint, times.data(), vectors.data(), count);
+					Assert::IsTrue(is_added);
+				}
+			}
+		}
+		return clip;
+	}
+
+	void AssertPosesEqual(const SPose& expected, const SPose& actual)
+	{
+		Assert::AreEqual(expected.Size(), actual.Size());
+		for (size_t joint = 0; joint < expected.Size(); ++joint)
+		{
+			Assert::AreEqual(expected.GetTranslations()[joint], actual.GetTranslations()[joint]);
+			Assert::AreEqual(expected.GetRotations()[joint], actual.GetRotations()[joint]);
+			Assert::AreEqual(expected.GetScales()[joint], actual.GetScales()[joint]);
+		}
+	}
+}
+
+namespace AnimationUnitTest
+{
+	TEST_CLASS(SClipSamplerTests)
+	{
+	public:
+		TEST_METHOD(FindKeyTests)
+		{
+			const float times[] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f };
+			for (uint32_t cached : { 0u, 3u, 7u, 10u, 100u })
+			{
+				Assert::AreEqual(0u, SClipSampler::FindKey(times, 12, -1.f, cached));
+				Assert::AreEqual(0u, SClipSampler::FindKey(times, 12, 0.f, cached));
+				Assert::AreEqual(2u, SClipSampler::FindKey(times, 12, 2.5f, cached));
+				Assert::AreEqual(5u, SClipSampler::FindKey(times, 12, 5.f, cached));
+				Assert::AreEqual(9u, SClipSampler::FindKey(times, 12, 9.99f, cached));
+				Assert::AreEqual(10u, SClipSampler::FindKey(times, 12, 11.f, cached));
+				Assert::AreEqual(10u, SClipSampler::FindKey(times, 12, 50.f, cached));
+			}
+			Assert::AreEqual(0u, SClipSampler::FindKey(times, 1, 5.f, 0));
+		}
+		TEST_METHOD(SampleTests)
+		{
+			SClip clip(3, 2.f);
+			const float times[] = { 0.f, 1.f, 2.f };
+			const SVector translations[] = { {0.f, 0.f, 0.f}, {2.f, 4.f, -2.f}, {2.f, 0.f, 0.f} };
+			const float rotation_times[] = { 0.5f, 1.5f };
+			const SQuaternion rotations[] = { SQuaternion::Identity, SQuaternion(0.f, 0.f, 1.5f) };
+			Assert::IsTrue(clip.SetTranslations(0, times, translations, 3));
+			Assert::IsTrue(clip.SetRotations(1, rotation_times, rotations, 2));
+			Assert::IsFalse(clip.SetRotations(1, rotation_times, rotations, 2));
+			Assert::IsFalse(clip.SetScales(2, times, translations, 0));
+			Assert::IsFalse(clip.SetScales(3, times, translations, 1));
+			const float repeated_times[] = { 0.f, 0.f };
+			Assert::IsFalse(clip.SetScales(2, repeated_times, translations, 2));
+			Assert::AreEqual(static_cast<size_t>(5), clip.GetKeyCount());
+
+			SClipSampler sampler;
+			SClipCursor cursor;
+			SPose pose;
+
+			sampler.Sample(clip, 0.25f, cursor, pose);
+			Assert::AreEqual(static_cast<size_t>(3), pose.Size());
+			Assert::AreEqual(SVector(0.5f, 1.f, -0.5f), pose.GetTranslations()[0]);
+			Assert::AreEqual(SVector::ZeroVector, pose.GetTranslations()[1]);
+			Assert::AreEqual(SVector(1.f), pose.GetScales()[2]);
+			Assert::AreEqual(SQuaternion::Identity, pose.GetRotations()[0]);
+			Assert::AreEqual(SQuaternion::Identity, pose.GetRotations()[1]);
+
+			sampler.Sample(clip, 1.25f, cursor, pose);
+			Assert::AreEqual(SVector(2.f, 3.f, -1.5f), pose.GetTranslations()[0]);
+			{
+				const float alpha = 0.75f;
+				SQuaternion expected(SQuaternion::Identity);
+				SQuaternionInterpolation::Nlerp(&rotations[0], &rotations[1], &alpha, &expected, 1);
+				Assert::AreEqual(expected, pose.GetRotations()[1]);
+			}
+
+			// held outside of the keys
+			sampler.Sample(clip, 5.f, cursor, pose);
+			Assert::AreEqual(translations[2], pose.GetTranslations()[0]);
+			Assert::AreEqual(rotations[1].GetZ(), pose.GetRotations()[1].GetZ(), 1e-7f);
+			sampler.Sample(clip, -5.f, cursor, pose);
+			Assert::AreEqual(translations[0], pose.GetTranslations()[0]);
+		}
+		TEST_METHOD(CursorTests)
+		{
+			// cached cursors give the pose a fresh cursor gives, forward, looping and seeking
+			std::mt19937 random(11u);
+			const SClip clip = MakeRandomClip(24, 3.f, random);
+			std::vector<float> sample_times;
+			for (int frame = 0; frame < 400; ++frame)
+			{
+				sample_times.push_back(std::fmod(frame / 60.f, clip.GetDuration()));
+			}
+			for (int seek = 0; seek < 50; ++seek)
+			{
+				sample_times.push_back(std::uniform_real_distribution<float>(-0.5f, 3.5f)(random));
+			}
+
+			SClipSampler sampler;
+			std::vector<SClipCursor> cursors(2);
+			std::vector<SPose> poses(2);
+			for (const float time : sample_times)
+			{
+				SClipCursor fresh_cursor;
+				SPose expected;
+				sampler.Sample(clip, time, fresh_cursor, expected);
+
+				const float times[] = { time, time };
+				sampler.Sample(clip, times, cursors.data(), poses.data(), 2);
+				AssertPosesEqual(expected, poses[0]);
+				AssertPosesEqual(expected, poses[1]);
+			}
+		}
+	};
+}
+
+namespace
+{
+	// angle between rotations of two quaternions, in double: the acos of a float near 1 is off by 1e-4
+	float RotationDistance(const SQuaternion& a, const SQuaternion& b)
+	{
+		const auto dot = [](const SQuaternion& lhs, const SQuaternion& rhs)
+		{
+			return static_cast<double>(lhs.GetX()) * rhs.GetX() + static_cast<double>(lhs.GetY()) * rhs.GetY() +
+			       static_cast<double>(lhs.GetZ()) * rhs.GetZ() + static_cast<double>(lhs.GetW()) * rhs.GetW();
+		};
+		const double cosine = std::fabs(dot(a, b)) / std::sqrt(dot(a, a) * dot(b, b));
+		return static_cast<float>(2.0 * std::acos(std::min(cosine, 1.0)));
+	}
+
+}
+
+namespace AnimationUnitTest
+{
+	TEST_CLASS(SCompressedClipTests)
+	{
+	public:
+		TEST_METHOD(BudgetTests)
+		{
+			std::mt19937 random(12u);
+			const SClip clip = MakeRandomClip(32, 3.f, random);
+
+			SCompressionSettings settings;
+			settings.budget = { 1e-4f, 1e-3f, 1e-4f };
+			SCompressionReport report;
+			const SCompressedClip compressed = SCompressedClip::Compress(clip, settings, &report);
+
+			Assert::AreEqual(clip.GetJointCount(), compressed.GetJointCount());
+			Assert::AreEqual(clip.GetDuration(), compressed.GetDuration());
+			Assert::AreEqual(static_cast<size_t>(0), report.tracks_over_budget);
+			Assert::IsTrue(report.max_translation_error <= settings.budget.translation);
+			Assert::IsTrue(report.max_rotation_error <= settings.budget.rotation);
+			Assert::IsTrue(report.max_scale_error <= settings.budget.scale);
+			Assert::AreEqual(compressed.GetMemorySize(), report.compressed_bytes);
+			Assert::IsTrue(report.Ratio() > 1.5f);
+
+			// a blend of keys within budget stays within budget, rotations within the error of a blend
+			SClipSampler sampler;
+			SClipCursor raw_cursor, compressed_cursor;
+			SPose raw_pose, compressed_pose;
+			for (int frame = 0; frame < 200; ++frame)
+			{
+				const float time = std::fmod(frame / 60.f, clip.GetDuration());
+				sampler.Sample(clip, time, raw_cursor, raw_pose);
+				sampler.Sample(compressed, time, compressed_cursor, compressed_pose);
+				Assert::AreEqual(raw_pose.Size(), compressed_pose.Size());
+				for (size_t joint = 0; joint < raw_pose.Size(); ++joint)
+				{
+					Assert::IsTrue((raw_pose.GetTranslations()[joint] - compressed_pose.GetTranslations()[joint]).Length() <= settings.budget.translation);
+					Assert::IsTrue((raw_pose.GetScales()[joint] - compressed_pose.GetScales()[joint]).Length() <= settings.budget.scale);
+					Assert::IsTrue(RotationDistance(raw_pose.GetRotations()[joint], compressed_pose.GetRotations()[joint]) <= 2.f * settings.budget.rotation);
+					Assert::AreEqual(0.f, compressed_pose.GetTranslations()[joint].GetUnusedAxis());
+					Assert::AreEqual(0.f, compressed_pose.GetScales()[joint].GetUnusedAxis());
+				}
+			}
+
+			std::ostringstream stream;
+			stream << report;
+			Assert::IsFalse(stream.str().empty());
+		}
+		TEST_METHOD(BitRateTests)
+		{
+			// joints 0, 4 and 8 in groups of their own
+			SClip clip(9, 1.f);
+			const float times[] = { 0.f, 0.5f, 1.f };
+			const SVector constant[] = { {1.f, 2.f, 3.f}, {1.f, 2.f, 3.f}, {1.f, 2.f, 3.f} };
+			const SVector moving[] = { {0.f, 0.f, 0.f}, {0.25f, -1.f, 0.5f}, {1.f, 0.f, 0.f} };
+			Assert::IsTrue(clip.SetTranslations(0, times, constant, 3));
+			Assert::IsTrue(clip.SetTranslations(4, times, moving, 3));
+			Assert::IsTrue(clip.SetTranslations(8, times, moving, 3));
+			Assert::IsTrue(clip.SetScales(0, times, constant, 1));
+
+			// joint 8 asks for a tighter budget than joint 4
+			SCompressionSettings settings;
+			settings.joint_budgets.assign(9, SCompressionBudget{ 1e-2f, 1e-3f, 1e-5f });
+			settings.joint_budgets[8].translation = 1e-5f;
+			SCompressionReport report;
+			const SCompressedClip compressed = SCompressedClip::Compress(clip, settings, &report);
+
+			const std::vector<SCompressedVectorGroup>& groups = compressed.GetTranslations().groups;
+			Assert::AreEqual(static_cast<size_t>(3), groups.size());
+			Assert::AreEqual(0u, groups[0].bits);
+			Assert::AreEqual(0u, compressed.GetScales().groups[0].bits);
+			Assert::IsTrue(groups[1].bits > 0);
+			Assert::IsTrue(groups[2].bits > groups[1].bits);
+			Assert::AreEqual(static_cast<size_t>(0), report.tracks_over_budget);
+
+			SClipSampler sampler;
+			SClipCursor cursor;
+			SPose pose;
+			sampler.Sample(compressed, 0.75f, cursor, pose);
+			Assert::AreEqual(constant[0], pose.GetTranslations()[0]);
+			Assert::AreEqual(constant[0], pose.GetScales()[0]);
+			Assert::AreEqual(SVector(1.f), pose.GetScales()[1]);
+			Assert::AreEqual(SVector::ZeroVector, pose.GetTranslations()[1]);
+			Assert::AreEqual(SQuaternion::Identity, pose.GetRotations()[8]);
+			Assert::IsTrue((pose.GetTranslations()[8] - SVector(0.625f, -0.5f, 0.25f)).Length() <= 1e-5f);
+
+			// a track sets the bit rate of its group: joint 5 takes the rate of joint 8
+			settings.joint_budgets[5] = settings.joint_budgets[8];
+			Assert::IsTrue(clip.SetTranslations(5, times, moving, 3));
+			const SCompressedClip shared = SCompressedClip::Compress(clip, settings, &report);
+			Assert::AreEqual(groups[2].bits, shared.GetTranslations().groups[1].bits);
+
+			// a budget no bit rate meets is reported
+			settings.joint_budgets[8].translation = 1e-9f;
+			const SCompressedClip over_budget = SCompressedClip::Compress(clip, settings, &report);
+			Assert::AreEqual(static_cast<size_t>(1), report.tracks_over_budget);
+			Assert::AreEqual(SCompressedClip::MaxVectorBits, over_budget.GetTranslations().groups[2].bits);
+		}
+		TEST_METHOD(CursorTests)
+		{
+			std::mt19937 random(30u);
+			const SClip clip = MakeRandomClip(13, 2.f, random);
+			const SCompressedClip compressed = SCompressedClip::Compress(clip);
+
+			// playing on, seeking back and jumping ahead with one cursor samples what a new cursor samples
+			SClipSampler sampler;
+			SClipCursor cursor;
+			SPose pose, expected;
+			const float times[] = { 0.f, 0.01f, 0.02f, 0.2f, 0.21f, 1.9f, 0.5f, 0.51f, 2.f, 0.f, 1.3f, 1.31f, 1.32f };
+			for (const float time : times)
+			{
+				SClipCursor fresh;
+				sampler.Sample(compressed, time, cursor, pose);
+				sampler.Sample(compressed, time, fresh, expected);
+				AssertPosesEqual(expected, pose);
+			}
+
+			// a reset cursor keeps its memory and decodes again
+			cursor.Reset();
+			sampler.Sample(compressed, 0.7f, cursor, pose);
+			SClipCursor fresh;
+			sampler.Sample(compressed, 0.7f, fresh, expected);
+			AssertPosesEqual(expected, pose);
+
+			// a cursor moved to another clip of the same size, or to the raw clip and back, decodes that clip's keys
+			const SCompressedClip other = SCompressedClip::Compress(MakeRandomClip(13, 2.f, random));
+			for (const float time : { 0.7f, 0.71f })
+			{
+				SClipCursor other_fresh;
+				sampler.Sample(other, time, cursor, pose);
+				sampler.Sample(other, time, other_fresh, expected);
+				AssertPosesEqual(expected, pose);
+			}
+			for (const float time : { 0.72f, 0.73f })
+			{
+				SClipCursor compressed_fresh;
+				sampler.Sample(clip, time, cursor, pose);
+				sampler.Sample(compressed, time, cursor, pose);
+				sampler.Sample(compressed, time, compressed_fresh, expected);
+				AssertPosesEqual(expected, pose);
+			}
+		}
+		TEST_METHOD(RotationTests)
+		{
+			// the largest component in every lane, of either sign
+			const std::vector<SQuaternion> rotations = {
+				SQuaternion::Identity, SQuaternion(0.f, 0.f, 0.f, -1.f),
+				SQuaternion(0.8f, 0.1f, -0.3f, 0.2f), SQuaternion(-0.8f, 0.1f, -0.3f, 0.2f),
+				SQuaternion(0.1f, -0.9f, 0.3f, 0.2f), SQuaternion(0.1f, 0.2f, -0.9f, -0.3f),
+				SQuaternion(0.5f, 0.5f, 0.5f, 0.5f), SQuaternion(0.7071068f, 0.f, 0.f, -0.7071068f) };
+			std::vector<float> times;
+			for (size_t key = 0; key < rotations.size(); ++key)
+			{
+				times.push_back(static_cast<float>(key));
+			}
+
+			// joints 0 and 4 in groups of their own
+			SClip clip(5, static_cast<float>(rotations.size()));
+			Assert::IsTrue(clip.SetRotations(0, times.data(), rotations.data(), rotations.size()));
+			Assert::IsTrue(clip.SetRotations(4, times.data(), rotations.data(), rotations.size()));
+
+			SCompressionSettings settings;
+			settings.joint_budgets.assign(5, SCompressionBudget{ 1e-4f, 1e-2f, 1e-5f });
+			settings.joint_budgets[4].rotation = 2e-4f;
+			const SCompressedClip compressed = SCompressedClip::Compress(clip, settings);
+			Assert::AreEqual(SCompressedClip::SmallRotationBits, compressed.GetRotations().groups[0].bits);
+			Assert::AreEqual(SCompressedClip::LargeRotationBits, compressed.GetRotations().groups[1].bits);
+
+			SClipSampler sampler;
+			SClipCursor cursor;
+			SPose pose;
+			for (size_t key = 0; key < rotations.size(); ++key)
+			{
+				sampler.Sample(compressed, times[key], cursor, pose);
+				Assert::IsTrue(RotationDistance(rotations[key], pose.GetRotations()[0]) <= 1e-2f);
+				Assert::IsTrue(RotationDistance(rotations[key], pose.GetRotations()[4]) <= 2e-4f);
+				Assert::AreEqual(SQuaternion::Identity, pose.GetRotations()[2]);
+			}
+		}
+	};
+}
+
+namespace
+{
+	/*
+	* A clip like raw motion capture: a key on every frame of every track. Bones keep their offsets, joints turn along sums of sines,
+	* the root also walks in a straight line, and scales stay at one.
+	*/
+	SClip MakeCaptureClip(size_t joint_count, size_t frame_count, float frame_rate, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+		const float duration = static_cast<float>(frame_count - 1) / frame_rate;
+		SClip clip(joint_count, duration);
+
+		std::vector<float> times(frame_count);
+		for (size_t frame = 0; frame < frame_count; ++frame)
+		{
+			times[frame] = static_cast<float>(frame) / frame_rate;
+		}
+
+		std::vector<SVector> translations(frame_count), scales(frame_count, SVector(1.f));
+		std::vector<SQuaternion> rotations(frame_count, SQuaternion::Identity);
+		for (size_t joint = 0; joint < joint_count; ++joint)
+		{
+			const SVector bone(0.1f * distribution(random), 0.2f + 0.1f * distribution(random), 0.1f * distribution(random));
+			const float amplitudes[3]{ 0.6f * distribution(random), 0.6f * distribution(random), 0.6f * distribution(random) };
+			const float frequencies[3]{ 1.f + distribution(random), 1.f + distribution(random), 2.f + distribution(random) };
+			for (size_t frame = 0; frame < frame_count; ++frame)
+			{
+				const float time = times[frame];
+				translations[frame] = joint == 0 ? SVector(0.8f * time, 1.f, 0.f) : bone;
+				rotations[frame] = SQuaternion(amplitudes[0] * std::sin(frequencies[0] * time), amplitudes[1] * std::sin(frequencies[1] * time),
+				                               amplitudes[2] * std::sin(frequencies[2] * time));
+			}
+			Assert::IsTrue(clip.SetTranslations(joint, times.data(), translations.data(), frame_count));
+			Assert::IsTrue(clip.SetRotations(joint, times.data(), rotations.data(), frame_count));
+			Assert::IsTrue(clip.SetScales(joint, times.data(), scales.data(), frame_count));
+		}
+		return clip;
+	}
+
+	// largest distance between joints and angle between joint rotations of two clips in model space, at 'times'
+	void MeasureModelError(const SClip& expected, const SClip& actual, const SSkeleton& skeleton, const std::vector<float>& times,
+	                       float& position_error, float& rotation_error)
+	{
+		SClipSampler sampler;
+		SClipCursor expected_cursor, actual_cursor;
+		SPose expected_local, actual_local, expected_model, actual_model;
+		position_error = 0.f;
+		rotation_error = 0.f;
+		for (const float time : times)
+		{
+			sampler.Sample(expected, time, expected_cursor, expected_local);
+			sampler.Sample(actual, time, actual_cursor, actual_local);
+			skeleton.LocalToModel(expected_local, expected_model);
+			skeleton.LocalToModel(actual_local, actual_model);
+			for (size_t joint = 0; joint < skeleton.GetJointCount(); ++joint)
+			{
+				position_error = std::max(position_error, (expected_model.GetTranslations()[joint] - actual_model.GetTranslations()[joint]).Length());
+				rotation_error = std::max(rotation_error, RotationDistance(expected_model.GetRotations()[joint], actual_model.GetRotations()[joint]));
+			}
+		}
+	}
+}
+
+namespace AnimationUnitTest
+{
+	TEST_CLASS(SKeyReducerTests)
+	{
+	public:
+		TEST_METHOD(ToleranceTests)
+		{
+			std::mt19937 random(23u);
+			const SSkeleton skeleton(MakeSkeletonParents(40, random));
+			const SClip clip = MakeCaptureClip(40, 61, 30.f, random);
+
+			SKeyReductionSettings settings;
+			settings.position_tolerance = 1e-3f;
+			settings.rotation_tolerance = 5e-3f;
+			SKeyReductionReport report;
+			const SClip reduced = SKeyReducer::Reduce(clip, skeleton, settings, &report);
+
+			Assert::AreEqual(clip.GetJointCount(), reduced.GetJointCount());
+			Assert::AreEqual(clip.GetDuration(), reduced.GetDuration());
+			Assert::AreEqual(clip.GetKeyCount(), report.source_keys);
+			Assert::AreEqual(reduced.GetKeyCount(), report.reduced_keys);
+			Assert::IsTrue(report.Ratio() > 4.f);
+			Assert::IsTrue(report.max_position_error <= settings.position_tolerance);
+			Assert::IsTrue(report.max_rotation_error <= settings.rotation_tolerance);
+
+			// bones and scales hold one key, the walk of the root its two ends
+			for (size_t joint = 0; joint < clip.GetJointCount(); ++joint)
+			{
+				Assert::AreEqual(joint == 0 ? 2u : 1u, reduced.GetTranslations().tracks[joint].count);
+				Assert::AreEqual(1u, reduced.GetScales().tracks[joint].count);
+				Assert::IsTrue(reduced.GetRotations().tracks[joint].count >= 2);
+			}
+			Assert::AreEqual(clip.GetDuration(), reduced.GetTranslations().times[1]);
+
+			// a sampler of the reduced clip stays within tolerance at every frame, and close to it between frames
+			float position_error{ 0.f }, rotation_error{ 0.f };
+			MeasureModelError(clip, reduced, skeleton, clip.GetTranslations().times, position_error, rotation_error);
+			Assert::IsTrue(position_error <= settings.position_tolerance * 1.001f);
+			Assert::IsTrue(rotation_error <= settings.rotation_tolerance * 1.001f);
+
+			std::vector<float> between_times;
+			for (int frame = 0; frame < 120; ++frame)
+			{
+				between_times.push_back((static_cast<float>(frame) + 0.5f) / 60.f);
+			}
+			MeasureModelError(clip, reduced, skeleton, between_times, position_error, rotation_error);
+			Assert::IsTrue(position_error <= 2.f * settings.position_tolerance);
+
+			// a tighter tolerance keeps more keys
+			settings.position_tolerance = 1e-4f;
+			SKeyReductionReport tight_report;
+			SKeyReducer::Reduce(clip, skeleton, settings, &tight_report);
+			Assert::IsTrue(tight_report.reduced_keys > report.reduced_keys);
+			Assert::IsTrue(tight_report.max_position_error <= settings.position_tolerance);
+
+			std::ostringstream stream;
+			stream << report;
+			Assert::IsFalse(stream.str().empty());
+		}
+		TEST_METHOD(TrackTests)
+		{
+			// keys at different times per track, tracks without keys and with one key
+			const SSkeleton skeleton({ SSkeleton::NoParent, 0, 1 });
+			SClip clip(3, 2.f);
+			const float times[] = { 0.f, 0.5f, 1.f, 1.5f, 2.f };
+			const float late_times[] = { 0.25f, 0.75f, 1.25f };
+			const SVector line[] = { {0.f, 0.f, 0.f}, {0.5f, 1.f, 0.f}, {1.f, 2.f, 0.f}, {1.5f, 3.f, 0.f}, {2.f, 4.f, 0.f} };
+			const SVector corner[] = { {0.f, 0.f, 0.f}, {0.5f, 0.f, 0.f}, {1.f, 0.f, 0.f}, {1.f, 0.5f, 0.f}, {1.f, 1.f, 0.f} };
+			const SVector held[] = { {0.f, 1.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 1.f, 0.f} };
+			const SQuaternion turn[] = { SQuaternion::Identity, SQuaternion(0.f, 0.f, 0.3f), SQuaternion(0.f, 0.f, 0.6f) };
+			Assert::IsTrue(clip.SetTranslations(0, times, line, 5));
+			Assert::IsTrue(clip.SetTranslations(1, times, corner, 5));
+			Assert::IsTrue(clip.SetTranslations(2, late_times, held, 3));
+			Assert::IsTrue(clip.SetRotations(1, late_times, turn, 1));
+			Assert::IsTrue(clip.SetScales(2, late_times, held, 3));
+
+			SKeyReductionReport report;
+			const SClip reduced = SKeyReducer::Reduce(clip, skeleton, {}, &report);
+			const SClipChannel<SVector>& translations = reduced.GetTranslations();
+			Assert::AreEqual(2u, translations.tracks[0].count);
+			Assert::AreEqual(3u, translations.tracks[1].count);
+			Assert::AreEqual(1.f, translations.times[translations.tracks[1].first + 1]);
+			Assert::AreEqual(1u, translations.tracks[2].count);
+			Assert::AreEqual(0.25f, translations.times[translations.tracks[2].first]);
+			Assert::AreEqual(0u, reduced.GetRotations().tracks[0].count);
+			Assert::AreEqual(1u, reduced.GetRotations().tracks[1].count);
+			Assert::AreEqual(0u, reduced.GetScales().tracks[0].count);
+			Assert::AreEqual(1u, reduced.GetScales().tracks[2].count);
+			Assert::AreEqual(static_cast<size_t>(17), report.source_keys);
+			Assert::AreEqual(static_cast<size_t>(8), report.reduced_keys);
+			Assert::AreEqual(0.f, report.max_position_error);
+			Assert::AreEqual(0.f, report.max_rotation_error);
+		}
+		TEST_METHOD(ParallelTests)
+		{
+			std::mt19937 random(24u);
+			const SSkeleton skeleton(MakeSkeletonParents(30, random));
+			std::vector<SClip> clips;
+			for (int i = 0; i < 3; ++i)
+			{
+				clips.push_back(MakeCaptureClip(30, 46, 30.f, random));
+			}
+
+			// the reduction of every clip alone, on the calling thread
+			std::vector<SClip> expected;
+			SKeyReductionReport expected_report;
+			for (const SClip& clip : clips)
+			{
+				SKeyReductionReport clip_report;
+				expected.push_back(SKeyReducer::Reduce(clip, skeleton, {}, &clip_report));
+				expected_report.source_keys += clip_report.source_keys;
+				expected_report.reduced_keys += clip_report.reduced_keys;
+				expected_report.max_position_error = std::max(expected_report.max_position_error, clip_report.max_position_error);
+			}
+
+			// any number of threads gives the same keys
+			for (const size_t thread_count : { 1, 4 })
+			{
+				SJobSystem jobs(thread_count);
+				std::vector<SClip> reduced(clips.size());
+				SKeyReductionReport report;
+				SKeyReducer::Reduce(clips.data(), reduced.data(), clips.size(), skeleton, {}, &report, &jobs);
+				Assert::AreEqual(expected_report.source_keys, report.source_keys);
+				Assert::AreEqual(expected_report.reduced_keys, report.reduced_keys);
+				Assert::AreEqual(expected_report.max_position_error, report.max_position_error);
+				for (size_t i = 0; i < clips.size(); ++i)
+				{
+					Assert::IsTrue(expected[i].GetRotations().times == reduced[i].GetRotations().times);
+					Assert::IsTrue(expected[i].GetTranslations().times == reduced[i].GetTranslations().times);
+					Assert::IsTrue(expected[i].GetScales().times == reduced[i].GetScales().times);
+				}
+			}
+		}
+	};
+}
+
+namespace
+{
+	void AssertPosesNear(const SPose& expected, const SPose& actual, float tolerance)
+	{
+		Assert::AreEqual(expected.Size(), actual.Size());
+		for (size_t joint = 0; joint < expected.Size(); ++joint)
+		{
+			Assert::IsTrue((expected.GetTranslations()[joint] - actual.GetTranslations()[joint]).Length() <= tolerance);
+			Assert::IsTrue((expected.GetScales()[joint] - actual.GetScales()[joint]).Length() <= tolerance);
+			Assert::IsTrue(RotationDistance(expected.GetRotations()[joint], actual.GetRotations()[joint]) <= tolerance);
+			Assert::AreEqual(0.f, actual.GetTranslations()[joint].GetUnusedAxis());
+			Assert::AreEqual(0.f, actual.GetScales()[joint].GetUnusedAxis());
+		}
+	}
+}
+
+namespace AnimationUnitTest
+{
+	TEST_CLASS(SPoseBlenderTests)
+	{
+	public:
+		TEST_METHOD(TwoPoseTests)
+		{
+			// 13 joints leave a tail in every kernel
+			std::mt19937 random(13u);
+			const size_t joint_count = 13;
+			const SPose a = MakeLocalPose(joint_count, random);
+			SPose b = MakeLocalPose(joint_count, random);
+			const float t = 0.3f;
+
+			SPoseBlender blender;
+			SPose blended;
+			blender.Begin(joint_count);
+			blender.Add(a, 1.f - t);
+			blender.Add(b, t);
+			blender.End(blended);
+			Assert::AreEqual(joint_count, blended.Size());
+			Assert::AreEqual(1.f, blender.GetTotalWeight());
+
+			std::vector<SQuaternion> expected(joint_count, SQuaternion::Identity);
+			const std::vector<float> alphas(joint_count, t);
+			SQuaternionInterpolation::Nlerp(a.GetRotations(), b.GetRotations(), alphas.data(), expected.data(), joint_count);
+			for (size_t joint = 0; joint < joint_count; ++joint)
+			{
+				Assert::AreEqual(expected[joint], blended.GetRotations()[joint]);
+				const SVector translation = a.GetTranslations()[joint] * (1.f - t) + b.GetTranslations()[joint] * t;
+				Assert::IsTrue((translation - blended.GetTranslations()[joint]).Length() <= 1e-6f);
+				Assert::AreEqual(0.f, blended.GetTranslations()[joint].GetUnusedAxis());
+			}
+
+			// q and -q are the same rotation, the blend takes the shortest path either way
+			for (size_t joint = 0; joint < joint_count; ++joint)
+			{
+				const SQuaternion& rotation = b.GetRotations()[joint];
+				b.GetRotations()[joint] = SQuaternion(-rotation.GetX(), -rotation.GetY(), -rotation.GetZ(), -rotation.GetW());
+			}
+			SPose flipped;
+			const SPose* poses[] = { &a, &b };
+			const float weights[] = { 1.f - t, t };
+			blender.Blend(poses, weights, 2, flipped);
+			for (size_t joint = 0; joint < joint_count; ++joint)
+			{
+				Assert::AreEqual(expected[joint], flipped.GetRotations()[joint]);
+			}
+		}
+		TEST_METHOD(WeightTests)
+		{
+			std::mt19937 random(14u);
+			const size_t joint_count = 21;
+			std::vector<SPose> poses;
+			for (int i = 0; i < 3; ++i)
+			{
+				poses.push_back(MakeLocalPose(joint_count, random));
+			}
+
+			// weights are relative and zero weights are skipped
+			SPoseBlender blender;
+			SPose expected, actual;
+			const SPose* pair[] = { &poses[0], &poses[2] };
+			const float pair_weights[] = { 0.25f, 0.75f };
+			blender.Blend(pair, pair_weights, 2, expected);
+			const SPose* all[] = { &poses[0], &poses[1], &poses[2] };
+			const float all_weights[] = { 2.f, 0.f, 6.f };
+			blender.Blend(all, all_weights, 3, actual);
+			Assert::AreEqual(8.f, blender.GetTotalWeight());
+			AssertPosesNear(expected, actual, 1e-6f);
+
+			// a pose blended with itself stays, also when 'out' is the input
+			blender.Begin(joint_count);
+			blender.Add(poses[1], 0.4f);
+			blender.Add(poses[1], 1.3f);
+			blender.Add(poses[1], 0.3f);
+			blender.End(poses[1]);
+			const SPose copy = poses[1];
+			AssertPosesNear(copy, poses[1], 1e-6f);
+
+			// nothing added gives the identity pose
+			blender.Begin(joint_count);
+			blender.Add(poses[0], 0.f);
+			blender.Add(poses[0], -1.f);
+			blender.End(actual);
+			AssertPosesEqual(SPose(joint_count), actual);
+		}
+	};
+
+	TEST_CLASS(SBlendTreeTests)
+	{
+	public:
+		TEST_METHOD(EvaluateTests)
+		{
+			std::mt19937 random(15u);
+			const size_t joint_count = 30;
+			std::vector<SPose> inputs;
+			for (int i = 0; i < 4; ++i)
+			{
+				inputs.push_back(MakeLocalPose(joint_count, random));
+			}
+
+			// root = blend(blend(0, 1), blend(2, 3))
+			SBlendTree tree;
+			SPose out;
+			Assert::IsFalse(tree.Evaluate(inputs.data(), inputs.size(), out));
+			uint32_t leaves[4];
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				leaves[i] = tree.AddPose(i);
+			}
+			const uint32_t unknown[] = { 0, 99 };
+			Assert::AreEqual(SBlendTree::InvalidNode, tree.AddBlend(unknown, 2));
+			const uint32_t left = tree.AddBlend(leaves, 2);
+			const uint32_t right = tree.AddBlend(leaves + 2, 2);
+			const uint32_t branches[] = { left, right };
+			const uint32_t root = tree.AddBlend(branches, 2);
+			Assert::AreEqual(root, tree.GetRoot());
+			Assert::AreEqual(static_cast<size_t>(7), tree.GetNodeCount());
+
+			const float weights[] = { 0.2f, 0.8f, 1.f, 3.f };
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				tree.SetWeight(leaves[i], weights[i]);
+			}
+			tree.SetWeight(left, 0.6f);
+			tree.SetWeight(right, 0.4f);
+			Assert::IsTrue(tree.Evaluate(inputs.data(), inputs.size(), out));
+
+			// the same blends by hand
+			SPoseBlender blender;
+			SPose left_pose, right_pose, expected;
+			const SPose* left_inputs[] = { &inputs[0], &inputs[1] };
+			const SPose* right_inputs[] = { &inputs[2], &inputs[3] };
+			blender.Blend(left_inputs, weights, 2, left_pose);
+			blender.Blend(right_inputs, weights + 2, 2, right_pose);
+			const SPose* branch_poses[] = { &left_pose, &right_pose };
+			const float branch_weights[] = { 0.6f, 0.4f };
+			blender.Blend(branch_poses, branch_weights, 2, expected);
+			AssertPosesEqual(expected, out);
+
+			// a branch without weight is never visited and a single branch passes its pose through
+			tree.SetWeight(right, 0.f);
+			Assert::IsTrue(tree.Evaluate(inputs.data(), 2, out));
+			AssertPosesEqual(left_pose, out);
+			tree.SetWeight(leaves[1], 0.f);
+			Assert::IsTrue(tree.Evaluate(inputs.data(), 1, out));
+			AssertPosesEqual(inputs[0], out);
+			tree.SetWeight(right, 1.f);
+			Assert::IsFalse(tree.Evaluate(inputs.data(), 1, out));
+
+			// no weight anywhere gives the identity pose
+			tree.SetWeight(left, 0.f);
+			tree.SetWeight(right, 0.f);
+			Assert::IsTrue(tree.Evaluate(inputs.data(), inputs.size(), out));
+			AssertPosesEqual(SPose(joint_count), out);
+
+			tree.Clear();
+			Assert::AreEqual(SBlendTree::InvalidNode, tree.GetRoot());
+		}
+	};
+}
+
+namespace
+{
+	std::vector<std::string> MakeJointNames(size_t joint_count)
+	{
+		std::vector<std::string> names;
+		for (size_t joint = 0; joint < joint_count; ++joint)
+		{
+			names.push_back("joint" + std::to_string(joint));
+		}
+		return names;
+	}
+
+	/*
+	* The rest pose of a rig with the hierarchy of 'skeleton', 'scale' times the size of 'rest', and every joint frame turned by
+	* 'frames[joint]' in model space: a model rotation of the rig is the model rotation of 'rest' times the frame of its joint.
+	*/
+	SPose MakeRetargetRest(const SSkeleton& skeleton, const SPose& rest, float scale, const std::vector<SQuaternion>& frames)
+	{
+		SPose target(rest.Size());
+		for (size_t joint = 0; joint < rest.Size(); ++joint)
+		{
+			const int16_t parent = skeleton.GetParent(joint);
+			const SQuaternion parent_frame = parent == SSkeleton::NoParent ? SQuaternion::Identity : frames[parent].Conjugation();
+			target.GetTranslations()[joint] = SVector(scale) * parent_frame.Rotate(rest.GetTranslations()[joint]);
+			target.GetRotations()[joint] = parent_frame * rest.GetRotations()[joint] * frames[joint];
+		}
+		return target;
+	}
+
+	// a local pose of unit scales; joints below the root keep the translations of 'rest', as bones of a rig do
+	SPose MakeAnimatedPose(const SPose& rest, std::mt19937& random)
+	{
+		SPose pose = MakeLocalPose(rest.Size(), random);
+		for (size_t joint = 0; joint < pose.Size(); ++joint)
+		{
+			if (joint > 0)
+			{
+				pose.GetTranslations()[joint] = rest.GetTranslations()[joint];
+			}
+			pose.GetScales()[joint] = SVector(1.f);
+		}
+		return pose;
+	}
+}
+
+namespace AnimationUnitTest
+{
+	TEST_CLASS(SRetargetMapTests)
+	{
+	public:
+		TEST_METHOD(ProportionTests)
+		{
+			std::mt19937 random(25u);
+			constexpr size_t joint_count = 24;
+			const std::vector<int16_t> parents = MakeSkeletonParents(joint_count, random);
+			const SSkeleton source(parents, MakeJointNames(joint_count));
+			const SSkeleton target(parents, MakeJointNames(joint_count));
+
+			const SPose source_rest = MakeAnimatedPose(MakeLocalPose(joint_count, random), random);
+			std::vector<SQuaternion> frames;
+			for (size_t joint = 0; joint < joint_count; ++joint)
+			{
+				frames.push_back(MakeLocalPose(1, random).GetRotations()[0]);
+			}
+			const SPose target_rest = MakeRetargetRest(source, source_rest, 2.f, frames);
+
+			const SRetargetMap map(source, source_rest, target, target_rest);
+			Assert::IsTrue(map.IsValid());
+			Assert::AreEqual(joint_count, map.GetBoneCount());
+			Assert::AreEqual(joint_count, map.GetSourceJointCount());
+			Assert::AreEqual(joint_count, map.GetTargetJointCount());
+			for (size_t joint = 0; joint < joint_count; ++joint)
+			{
+				Assert::AreEqual(static_cast<int16_t>(joint), map.GetSource(joint));
+			}
+
+			// the rest pose of the source is the rest pose of the target
+			SPose retargeted;
+			map.Retarget(source_rest, retargeted);
+			AssertPosesNear(target_rest, retargeted, 1e-4f);
+
+			// the target moves as the source twice its size, every joint frame turned by its own rotation
+			SPose source_model, target_model;
+			for (int i = 0; i < 8; ++i)
+			{
+				const SPose animated = MakeAnimatedPose(source_rest, random);
+				map.Retarget(animated, retargeted);
+				source.LocalToModel(animated, source_model);
+				target.LocalToModel(retargeted, target_model);
+				for (size_t joint = 0; joint < joint_count; ++joint)
+				{
+					const SVector expected = SVector(2.f) * source_model.GetTranslations()[joint];
+					Assert::IsTrue((expected - target_model.GetTranslations()[joint]).Length() <= 1e-4f * (1.f + expected.Length()));
+					Assert::IsTrue(RotationDistance(source_model.GetRotations()[joint] * frames[joint], target_model.GetRotations()[joint]) <= 1e-3f);
+				}
+			}
+		}
+		TEST_METHOD(BoneTests)
+		{
+			const SSkeleton source({ SSkeleton::NoParent, 0, 1 }, { "hips", "spine", "head" });
+			const SSkeleton target({ SSkeleton::NoParent, 0, 1, 2 }, { "hips", "spine", "neck", "head" });
+			SPose source_rest(3), target_rest(4);
+			source_rest.GetTranslations()[0] = SVector(0.f, 1.f, 0.f);
+			source_rest.GetTranslations()[1] = SVector(0.f, 0.5f, 0.f);
+			source_rest.GetTranslations()[2] = SVector(0.f, 0.5f, 0.f);
+			target_rest.GetTranslations()[0] = SVector(0.f, 1.5f, 0.f);
+			target_rest.GetTranslations()[1] = SVector(0.f, 0.75f, 0.f);
+			target_rest.GetTranslations()[2] = SVector(0.f, 0.25f, 0.f);
+			target_rest.GetTranslations()[3] = SVector(0.f, 0.5f, 0.f);
+			target_rest.GetScales()[2] = SVector(0.5f);
+
+			SPose animated(3);
+			animated.GetTranslations()[0] = SVector(2.f, 1.f, 0.f);
+			animated.GetTranslations()[1] = SVector(0.f, 2.f, 0.f);
+			animated.GetTranslations()[2] = SVector(0.f, 1.f, 4.f);
+			animated.GetRotations()[1] = SQuaternion(0.3f, 0.f, 0.f);
+			animated.GetScales()[2] = SVector(2.f);
+
+			// by name: the root walks scaled to the height of the target, bones keep their lengths, the neck its rest transform
+			const SRetargetMap map(source, source_rest, target, target_rest);
+			Assert::IsTrue(map.IsValid());
+			Assert::AreEqual(static_cast<size_t>(3), map.GetBoneCount());
+			Assert::AreEqual(SRetargetMap::NoSource, map.GetSource(2));
+			Assert::AreEqual(static_cast<int16_t>(2), map.GetSource(3));
+
+			SPose retargeted;
+			map.Retarget(animated, retargeted);
+			Assert::AreEqual(static_cast<size_t>(4), retargeted.Size());
+			Assert::AreEqual(SVector(3.f, 1.5f, 0.f), retargeted.GetTranslations()[0]);
+			Assert::AreEqual(target_rest.GetTranslations()[1], retargeted.GetTranslations()[1]);
+			Assert::AreEqual(animated.GetRotations()[1], retargeted.GetRotations()[1]);
+			Assert::AreEqual(target_rest.GetTranslations()[2], retargeted.GetTranslations()[2]);
+			Assert::AreEqual(target_rest.GetScales()[2], retargeted.GetScales()[2]);
+			Assert::AreEqual(SVector(2.f), retargeted.GetScales()[3]);
+
+			// explicit bones with a scaled translation, the neck drives the head
+			const SRetargetMap scaled(source, source_rest, target, target_rest,
+			                          { { 3, 2, ERetargetTranslation::Scaled, 0.5f }, { 0, 0, ERetargetTranslation::Offset, 1.f } });
+			Assert::IsTrue(scaled.IsValid());
+			Assert::AreEqual(static_cast<size_t>(2), scaled.GetBoneCount());
+			scaled.Retarget(animated, retargeted);
+			Assert::AreEqual(SVector(2.f, 1.5f, 0.f), retargeted.GetTranslations()[0]);
+			Assert::AreEqual(target_rest.GetTranslations()[1], retargeted.GetTranslations()[1]);
+			Assert::AreEqual(SVector(0.f, 0.5f, 2.f), retargeted.GetTranslations()[3]);
+
+			// many characters at once
+			std::vector<SPose> sources(3, animated), targets(3);
+			sources[1].GetTranslations()[0] = SVector(-1.f, 0.5f, 0.f);
+			map.Retarget(sources.data(), targets.data(), sources.size());
+			for (size_t i = 0; i < sources.size(); ++i)
+			{
+				map.Retarget(sources[i], retargeted);
+				AssertPosesEqual(retargeted, targets[i]);
+			}
+
+			// a target joint with two bones, joints out of range, rest poses of other skeletons
+			Assert::IsFalse(SRetargetMap(source, source_rest, target, target_rest, { { 1, 1 }, { 1, 2 } }).IsValid());
+			Assert::IsFalse(SRetargetMap(source, source_rest, target, target_rest, { { 4, 1 } }).IsValid());
+			Assert::IsFalse(SRetargetMap(source, source_rest, target, target_rest, { { 1, 3 } }).IsValid());
+			Assert::IsFalse(SRetargetMap(source, target_rest, target, target_rest).IsValid());
+			Assert::IsFalse(SRetargetMap().IsValid());
+		}
+		TEST_METHOD(ClipTests)
+		{
+			std::mt19937 random(26u);
+			constexpr size_t joint_count = 13;
+			const std::vector<int16_t> parents = MakeSkeletonParents(joint_count, random);
+			const SSkeleton source(parents, MakeJointNames(joint_count));
+			const SSkeleton target(parents, MakeJointNames(joint_count));
+			const SPose source_rest = MakeAnimatedPose(MakeLocalPose(joint_count, random), random);
+			std::vector<SQuaternion> frames;
+			for (size_t joint = 0; joint < joint_count; ++joint)
+			{
+				frames.push_back(MakeLocalPose(1, random).GetRotations()[0]);
+			}
+			const SRetargetMap map(source, source_rest, target, MakeRetargetRest(source, source_rest, 1.5f, frames));
+
+			// a retargeted clip plays as the retargeted poses of the source clip
+			const SClip clip = MakeRandomClip(joint_count, 2.f, random);
+			const SClip retargeted = map.Retarget(clip);
+			Assert::AreEqual(joint_count, retargeted.GetJointCount());
+			Assert::AreEqual(clip.GetDuration(), retargeted.GetDuration());
+			for (size_t joint = 0; joint < joint_count; ++joint)
+			{
+				Assert::AreEqual(std::max(clip.GetRotations().tracks[joint].count, 1u), retargeted.GetRotations().tracks[joint].count);
+				Assert::AreEqual(std::max(clip.GetScales().tracks[joint].count, 1u), retargeted.GetScales().tracks[joint].count);
+				Assert::AreEqual(joint == 0 ? std::max(clip.GetTranslations().tracks[joint].count, 1u) : 1u, retargeted.GetTranslations().tracks[joint].count);
+			}
+
+			SClipSampler sampler;
+			SClipCursor cursor, retargeted_cursor;
+			SPose sampled, expected, actual;
+			for (int frame = 0; frame <= 40; ++frame)
+			{
+				const float time = 0.05f * static_cast<float>(frame);
+				sampler.Sample(clip, time, cursor, sampled);
+				map.Retarget(sampled, expected);
+				sampler.Sample(retargeted, time, retargeted_cursor, actual);
+				AssertPosesNear(expected, actual, 1e-4f);
+			}
+
+			// poses go through the four bone kernel, keys through the operators of 'SQuaternion' and 'SVector', with the same arithmetic
+			SClip keys(joint_count, 0.f);
+			const float zero_time = 0.f;
+			for (size_t joint = 0; joint < joint_count; ++joint)
+			{
+				keys.SetTranslations(joint, &zero_time, &sampled.GetTranslations()[joint], 1);
+				keys.SetRotations(joint, &zero_time, &sampled.GetRotations()[joint], 1);
+				keys.SetScales(joint, &zero_time, &sampled.GetScales()[joint], 1);
+			}
+			const SClip retargeted_keys = map.Retarget(keys);
+			map.Retarget(sampled, expected);
+			for (size_t joint = 0; joint < joint_count; ++joint)
+			{
+				Assert::IsTrue(expected.GetTranslations()[joint] == retargeted_keys.GetTranslations().values[retargeted_keys.GetTranslations().tracks[joint].first]);
+				Assert::IsTrue(expected.GetRotations()[joint] == retargeted_keys.GetRotations().values[retargeted_keys.GetRotations().tracks[joint].first]);
+				Assert::IsTrue(expected.GetScales()[joint] == retargeted_keys.GetScales().values[retargeted_keys.GetScales().tracks[joint].first]);
+			}
+
+			// the baked file reads back as the retargeted clip
+			const std::string path = MakeTrackFilePath("AnimationUnitTest_Retarget.track");
+			Assert::IsTrue(map.Bake(clip, path.c_str()) == ETrackFileStatus::Ok);
+			SClip loaded;
+			Assert::IsTrue(SClipFile::Read(path.c_str(), loaded) == ETrackFileStatus::Ok);
+			Assert::AreEqual(retargeted.GetDuration(), loaded.GetDuration());
+			Assert::AreEqual(retargeted.GetJointCount(), loaded.GetJointCount());
+			Assert::IsTrue(retargeted.GetTranslations().times == loaded.GetTranslations().times);
+			Assert::IsTrue(retargeted.GetTranslations().values == loaded.GetTranslations().values);
+			Assert::IsTrue(retargeted.GetRotations().times == loaded.GetRotations().times);
+			Assert::IsTrue(retargeted.GetRotations().values == loaded.GetRotations().values);
+			Assert::IsTrue(retargeted.GetScales().times == loaded.GetScales().times);
+			Assert::IsTrue(retargeted.GetScales().values == loaded.GetScales().values);
+			for (size_t joint = 0; joint < joint_count; ++joint)
+			{
+				Assert::AreEqual(retargeted.GetRotations().tracks[joint].first, loaded.GetRotations().tracks[joint].first);
+				Assert::AreEqual(retargeted.GetRotations().tracks[joint].count, loaded.GetRotations().tracks[joint].count);
+			}
+
+			// a clip with empty tracks goes both ways, a file of other tracks is no clip
+			Assert::IsTrue(SClipFile::Write(clip, path.c_str()) == ETrackFileStatus::Ok);
+			Assert::IsTrue(SClipFile::Read(path.c_str(), loaded) == ETrackFileStatus::Ok);
+			Assert::AreEqual(clip.GetKeyCount(), loaded.GetKeyCount());
+			Assert::IsTrue(clip.GetScales().values == loaded.GetScales().values);
+
+			const SVector vectors[] = { {1.f, 2.f, 3.f} };
+			STrackFileWriter writer;
+			writer.AddVectors("values", vectors, 1);
+			Assert::IsTrue(writer.Write(path.c_str()) == ETrackFileStatus::Ok);
+			Assert::IsTrue(SClipFile::Read(path.c_str(), loaded) == ETrackFileStatus::UnexpectedTracks);
+			Assert::AreEqual(clip.GetKeyCount(), loaded.GetKeyCount());
+			std::remove(path.c_str());
+			Assert::IsTrue(SClipFile::Read(path.c_str(), loaded) == ETrackFileStatus::OpenFailed);
+		}
+	};
+}
+
+namespace AnimationUnitTest
+{
+	TEST_CLASS(SFrameArenaTests)
+	{
+	public:
+		TEST_METHOD(AllocateTests)
+		{
+			SFrameArena arena(1024);
+			Assert::AreEqual(size_t(1024), arena.GetCapacity());
+			Assert::AreEqual(size_t(1), arena.GetHeapAllocationCount());
+
+			// every allocation on its own cache lines
+			uint8_t* first = static_cast<uint8_t*>(arena.Allocate(1));
+			uint8_t* second = static_cast<uint8_t*>(arena.Allocate(100));
+			float* third = arena.Allocate<float>(3);
+			Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(first) % SFrameArena::Alignment);
+			Assert::IsTrue(second == first + 64);
+			Assert::IsTrue(reinterpret_cast<uint8_t*>(third) == second + 128);
+			Assert::AreEqual(size_t(256), arena.GetUsed());
+
+			// a rewind hands out the same memory again
+			const size_t marker = arena.GetMarker();
+			void* scratch = arena.Allocate(500);
+			arena.Rewind(marker);
+			Assert::IsTrue(scratch == arena.Allocate(500));
+			Assert::AreEqual(size_t(768), arena.GetPeak());
+
+			arena.Reset();
+			Assert::AreEqual(size_t(0), arena.GetUsed());
+			Assert::IsTrue(first == arena.Allocate(64));
+			Assert::AreEqual(size_t(1), arena.GetHeapAllocationCount());
+		}
+		TEST_METHOD(GrowthTests)
+		{
+			// a frame that outgrows the block takes blocks from the heap, the next frames get a block that fits
+			SFrameArena arena(0);
+			Assert::AreEqual(size_t(0), arena.GetHeapAllocationCount());
+			for (int frame = 0; frame < 4; ++frame)
+			{
+				for (size_t size = 1; size < 20000; size *= 3)
+				{
+					const size_t marker = arena.GetMarker();
+					uint8_t* memory = arena.Allocate<uint8_t>(size);
+					Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(memory) % SFrameArena::Alignment);
+					std::fill(memory, memory + size, static_cast<uint8_t>(frame));
+					arena.Allocate(size);
+					arena.Rewind(marker);
+				}
+				arena.Reset();
+			}
+			// 20 allocations in the first frame and the block after it
+			Assert::AreEqual(size_t(21), arena.GetHeapAllocationCount());
+			Assert::IsTrue(arena.GetCapacity() >= arena.GetPeak());
+
+			SFrameArena moved(std::move(arena));
+			Assert::AreEqual(size_t(21), moved.GetHeapAllocationCount());
+			Assert::AreEqual(size_t(0), arena.GetCapacity());
+		}
+		TEST_METHOD(PoseTests)
+		{
+			SFrameArena arena;
+			SPose pose(arena, 5);
+			Assert::IsTrue(pose.IsArenaPose());
+			Assert::AreEqual(size_t(5), pose.Size());
+			Assert::IsTrue(static_cast<void*>(pose.GetTranslations()) == static_cast<void*>(pose.GetRotations() - 5));
+			for (size_t joint = 0; joint < 5; ++joint)
+			{
+				Assert::IsTrue(pose.GetTranslations()[joint] == SVector::ZeroVector);
+				Assert::IsTrue(pose.GetRotations()[joint] == SQuaternion::Identity);
+				Assert::IsTrue(pose.GetScales()[joint] == SVector(1.f));
+			}
+
+			// growing keeps transforms and stays in the arena
+			pose.GetTranslations()[4] = SVector(1.f, 2.f, 3.f);
+			pose.Resize(40);
+			Assert::IsTrue(pose.GetTranslations()[4] == SVector(1.f, 2.f, 3.f));
+			Assert::IsTrue(pose.GetRotations()[39] == SQuaternion::Identity);
+			// 5 joints rounded up to whole cache lines, and 40 joints
+			Assert::AreEqual(size_t(4 * 64 + 40 * 48), arena.GetUsed());
+
+			// copies are heap poses, an assignment keeps the storage of the target
+			SPose copy(pose);
+			Assert::IsFalse(copy.IsArenaPose());
+			Assert::IsTrue(copy.GetTranslations()[4] == SVector(1.f, 2.f, 3.f));
+			SPose heap(3);
+			heap = std::move(pose);
+			Assert::IsFalse(heap.IsArenaPose());
+			Assert::AreEqual(size_t(40), heap.Size());
+			SPose other(arena, 0);
+			other = std::move(pose);
+			Assert::IsTrue(other.IsArenaPose());
+			Assert::AreEqual(size_t(40), other.Size());
+			Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(heap.GetTranslations()) % SFrameArena::Alignment);
+		}
+		TEST_METHOD(BlendTests)
+		{
+			// the blender and the sampler give the same poses with an arena
+			std::mt19937 random(70u);
+			const SClip clip = MakeRandomClip(30, 2.f, random);
+			SFrameArena arena(0);
+			SClipSampler sampler, arena_sampler;
+			SPoseBlender blender, arena_blender;
+			arena_sampler.arena = &arena;
+			arena_blender.arena = &arena;
+			for (int frame = 0; frame < 3; ++frame)
+			{
+				SClipCursor cursor, arena_cursor;
+				SPose sampled, blended;
+				SPose arena_sampled(arena, 0), arena_blended(arena, 0);
+				blender.Begin(30);
+				arena_blender.Begin(30);
+				for (const float time : { .3f, 1.1f, 1.9f })
+				{
+					sampler.Sample(clip, time + frame, cursor, sampled);
+					arena_sampler.Sample(clip, time + frame, arena_cursor, arena_sampled);
+					AssertPosesEqual(sampled, arena_sampled);
+					blender.Add(sampled, time);
+					arena_blender.Add(arena_sampled, time);
+				}
+				blender.End(blended);
+				arena_blender.End(arena_blended);
+				AssertPosesEqual(blended, arena_blended);
+				arena.Reset();
+			}
+		}
+	};
+
+	TEST_CLASS(SJobSystemTests)
+	{
+	public:
+		TEST_METHOD(ParallelForTests)
+		{
+			for (const size_t thread_count : { 1, 2, 4 })
+			{
+				SJobSystem jobs(thread_count);
+				Assert::AreEqual(thread_count, jobs.GetThreadCount());
+				Assert::AreEqual(static_cast<size_t>(0), jobs.GetThreadIndex());
+
+				// every index exactly once, batches don't cross their bounds
+				std::vector<std::atomic<int>> visits(1000);
+				std::vector<size_t> order;
+				std::mutex order_mutex;
+				jobs.ParallelFor(visits.size(), 7, [&](size_t begin, size_t end)
+				{
+					Assert::IsTrue(end - begin <= 7 && jobs.GetThreadIndex() < thread_count);
+					for (size_t i = begin; i < end; ++i)
+					{
+						visits[i].fetch_add(1);
+					}
+					std::lock_guard<std::mutex> lock(order_mutex);
+					order.push_back(begin);
+				});
+				for (const std::atomic<int>& visit : visits)
+				{
+					Assert::AreEqual(1, visit.load());
+				}
+
+				// single-threaded mode runs batches in order
+				if (jobs.IsSingleThreaded())
+				{
+					Assert::IsTrue(std::is_sorted(order.begin(), order.end()));
+				}
+				jobs.ParallelFor(0, 7, [&](size_t, size_t) { Assert::Fail(L"no batch for no indices"); });
+			}
+		}
+		TEST_METHOD(NestedTests)
+		{
+			SJobSystem jobs(4);
+
+			// jobs that wait for jobs of their own
+			std::atomic<size_t> sum{ 0 };
+			jobs.ParallelFor(16, 1, [&](size_t outer, size_t)
+			{
+				jobs.ParallelFor(100, 10, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; ++i)
+					{
+						sum.fetch_add(outer * 100 + i);
+					}
+				});
+			});
+			Assert::AreEqual(static_cast<size_t>(1600 * 1599 / 2), sum.load());
+
+			// single jobs with a counter
+			SJobCounter counter;
+			std::vector<size_t> values(64, 0);
+			for (size_t i = 0; i < values.size(); ++i)
+			{
+				const JobFunction square = [](void* context, size_t begin, size_t) { static_cast<size_t*>(context)[begin] = begin * begin; };
+				jobs.Submit({ square, values.data(), i, i + 1, &counter });
+			}
+			jobs.Wait(counter);
+			Assert::AreEqual(static_cast<size_t>(0), counter.pending.load());
+			for (size_t i = 0; i < values.size(); ++i)
+			{
+				Assert::AreEqual(i * i, values[i]);
+			}
+		}
+	};
+
+	TEST_CLASS(SAnimationUpdateTests)
+	{
+	public:
+		TEST_METHOD(PaletteTests)
+		{
+			std::mt19937 random(16u);
+			const SSkeleton skeleton(MakeSkeletonParents(20, random));
+			SPose bind;
+			skeleton.LocalToModel(MakeLocalPose(20, random), bind);
+			SPose inverse_bind, palette;
+			SSkeleton::Invert(bind, inverse_bind);
+
+			// the bind pose skins to the identity and composition is in place safe
+			SSkeleton::Compose(bind, inverse_bind, palette);
+			AssertPosesNear(SPose(20), palette, 1e-5f);
+			SSkeleton::Compose(bind, inverse_bind, inverse_bind);
+			AssertPosesEqual(palette, inverse_bind);
+		}
+		TEST_METHOD(DeterminismTests)
+		{
+			// characters of one skeleton with 0 to 3 layers
+			std::mt19937 random(17u);
+			const size_t joint_count = 24;
+			const SSkeleton skeleton(MakeSkeletonParents(joint_count, random));
+			std::vector<SClip> clips;
+			for (int i = 0; i < 4; ++i)
+			{
+				clips.push_back(MakeRandomClip(joint_count, 1.f + i, random));
+			}
+			SPose inverse_bind;
+			skeleton.LocalToModel(MakeLocalPose(joint_count, random), inverse_bind);
+			SSkeleton::Invert(inverse_bind, inverse_bind);
+
+			std::vector<SAnimatedCharacter> characters(37);
+			for (size_t i = 0; i < characters.size(); ++i)
+			{
+				characters[i].skeleton = &skeleton;
+				characters[i].inverse_bind = i % 5 == 0 ? nullptr : &inverse_bind;
+				for (size_t layer = 0; layer < i % 4; ++layer)
+				{
+					SAnimationLayer animation_layer;
+					animation_layer.clip = &clips[(i + layer) % clips.size()];
+					animation_layer.time = std::uniform_real_distribution<float>(0.f, 4.f)(random);
+					animation_layer.speed = layer == 2 ? -1.f : 1.f;
+					animation_layer.weight = i % 7 == 0 ? 0.f : 0.5f + static_cast<float>(layer);
+					characters[i].layers.push_back(animation_layer);
+				}
+			}
+			std::vector<SAnimatedCharacter> parallel_characters = characters;
+
+			SJobSystem single_thread(1);
+			SJobSystem threads(4);
+			SAnimationUpdate update, parallel_update;
+			parallel_update.batch_size = 3;
+			for (int frame = 0; frame < 5; ++frame)
+			{
+				update.Update(single_thread, characters.data(), characters.size(), 1.f / 30.f);
+				parallel_update.Update(threads, parallel_characters.data(), parallel_characters.size(), 1.f / 30.f);
+				for (size_t i = 0; i < characters.size(); ++i)
+				{
+					AssertPosesEqual(characters[i].local, parallel_characters[i].local);
+					AssertPosesEqual(characters[i].model, parallel_characters[i].model);
+					AssertPosesEqual(characters[i].palette, parallel_characters[i].palette);
+					Assert::IsTrue(characters[i].palette_matrices == parallel_characters[i].palette_matrices);
+				}
+			}
+
+			// the stages by hand for a character of two layers
+			const SAnimatedCharacter& character = characters[2];
+			SClipSampler sampler;
+			SPoseBlender blender;
+			SPose sampled, local, model, palette;
+			blender.Begin(joint_count);
+			for (const SAnimationLayer& layer : character.layers)
+			{
+				SClipCursor cursor;
+				sampler.Sample(*layer.clip, layer.time, cursor, sampled);
+				blender.Add(sampled, layer.weight);
+			}
+			blender.End(local);
+			skeleton.LocalToModel(local, model);
+			SSkeleton::Compose(model, inverse_bind, palette);
+			AssertPosesEqual(local, character.local);
+			AssertPosesEqual(palette, character.palette);
+			for (size_t joint = 0; joint < joint_count; ++joint)
+			{
+				const SMatrix matrix = SMatrix::FromTransform(palette.GetRotations()[joint], palette.GetTranslations()[joint], palette.GetScales()[joint]);
+				Assert::IsTrue(matrix == character.palette_matrices[joint]);
+			}
+			AssertPosesEqual(characters[5].model, characters[5].palette);
+			AssertPosesEqual(SPose(joint_count), characters[0].local);
+		}
+		TEST_METHOD(AllocationTests)
+		{
+			// after the first frames, updates take nothing from the heap on any thread
+			std::mt19937 random(18u);
+			const size_t joint_count = 40;
+			const SSkeleton skeleton(MakeSkeletonParents(joint_count, random));
+			const std::vector<SClip> clips = { MakeRandomClip(joint_count, 1.f, random), MakeRandomClip(joint_count, 2.f, random) };
+			std::vector<SAnimatedCharacter> characters(50);
+			for (size_t i = 0; i < characters.size(); ++i)
+			{
+				characters[i].skeleton = &skeleton;
+				for (size_t layer = 0; layer < i % 3 + 1; ++layer)
+				{
+					SAnimationLayer animation_layer;
+					animation_layer.clip = &clips[(i + layer) % clips.size()];
+					animation_layer.weight = 1.f + static_cast<float>(layer);
+					characters[i].layers.push_back(animation_layer);
+				}
+			}
+
+			for (const size_t thread_count : { size_t(1), size_t(4) })
+			{
+				SJobSystem jobs(thread_count);
+				SAnimationUpdate update;
+				update.batch_size = 4;
+				for (int frame = 0; frame < 3; ++frame)
+				{
+					update.Update(jobs, characters.data(), characters.size(), 1.f / 60.f);
+				}
+
+				const size_t arena_allocations = update.GetArenaHeapAllocationCount();
+				const size_t heap_allocations = HeapAllocationCount.load();
+				for (int frame = 0; frame < 20; ++frame)
+				{
+					update.Update(jobs, characters.data(), characters.size(), 1.f / 60.f);
+				}
+				Assert::AreEqual(heap_allocations, HeapAllocationCount.load());
+				Assert::AreEqual(arena_allocations, update.GetArenaHeapAllocationCount());
+			}
+		}
+	};
+
+	TEST_CLASS(SAnimationLodSchedulerTests)
+	{
+	public:
+		TEST_METHOD(LevelTests)
+		{
+			SAnimationLodScheduler scheduler;
+			Assert::AreEqual(static_cast<size_t>(1), SAnimationLodScheduler::GetInterval(EAnimationLod::Full));
+			Assert::AreEqual(static_cast<size_t>(8), SAnimationLodScheduler::GetInterval(EAnimationLod::Eighth));
+			Assert::IsTrue(scheduler.GetLevel(1.f, EAnimationLod::Full, false) == EAnimationLod::Full);
+			Assert::IsTrue(scheduler.GetLevel(0.3f, EAnimationLod::Full, false) == EAnimationLod::Half);
+			Assert::IsTrue(scheduler.GetLevel(0.15f, EAnimationLod::Full, false) == EAnimationLod::Quarter);
+			Assert::IsTrue(scheduler.GetLevel(0.f, EAnimationLod::Full, false) == EAnimationLod::Eighth);
+
+			// lower levels need the importance below the threshold by the hysteresis, higher ones don't
+			Assert::IsTrue(scheduler.GetLevel(0.47f, EAnimationLod::Full, true) == EAnimationLod::Full);
+			Assert::IsTrue(scheduler.GetLevel(0.44f, EAnimationLod::Full, true) == EAnimationLod::Half);
+			Assert::IsTrue(scheduler.GetLevel(0.05f, EAnimationLod::Half, true) == EAnimationLod::Eighth);
+			Assert::IsTrue(scheduler.GetLevel(0.095f, EAnimationLod::Quarter, true) == EAnimationLod::Quarter);
+			Assert::IsTrue(scheduler.GetLevel(0.5f, EAnimationLod::Eighth, true) == EAnimationLod::Full);
+		}
+		TEST_METHOD(RateTests)
+		{
+			std::mt19937 random(27u);
+			const size_t joint_count = 10;
+			const SSkeleton skeleton(MakeSkeletonParents(joint_count, random));
+			const SClip clip = MakeRandomClip(joint_count, 2.f, random);
+
+			// eight characters of every level
+			const float importances[] = { 1.f, 0.3f, 0.15f, 0.01f };
+			std::vector<SAnimatedCharacter> characters(32);
+			for (size_t i = 0; i < characters.size(); ++i)
+			{
+				characters[i].skeleton = &skeleton;
+				characters[i].importance = importances[i % 4];
+				SAnimationLayer layer;
+				layer.clip = &clip;
+				characters[i].layers.push_back(layer);
+			}
+
+			SJobSystem jobs(1);
+			SAnimationLodScheduler scheduler;
+			SAnimationUpdate update;
+			update.scheduler = &scheduler;
+			update.Update(jobs, characters.data(), characters.size(), 1.f / 60.f);
+			Assert::AreEqual(characters.size(), scheduler.GetStats().evaluated);
+			for (const size_t level_count : scheduler.GetStats().characters)
+			{
+				Assert::AreEqual(static_cast<size_t>(8), level_count);
+			}
+
+			// every level at its rate, the same work on every frame
+			std::vector<size_t> evaluations(characters.size(), 0);
+			for (int frame = 0; frame < 16; ++frame)
+			{
+				update.Update(jobs, characters.data(), characters.size(), 1.f / 60.f);
+				Assert::AreEqual(static_cast<size_t>(8 + 4 + 2 + 1), scheduler.GetStats().evaluated);
+				Assert::AreEqual(15 * joint_count, scheduler.GetStats().joint_samples);
+				for (size_t i = 0; i < characters.size(); ++i)
+				{
+					evaluations[i] += characters[i].lod.is_evaluated ? 1 : 0;
+				}
+			}
+			for (size_t i = 0; i < characters.size(); ++i)
+			{
+				Assert::AreEqual(16 / SAnimationLodScheduler::GetInterval(characters[i].lod.level), evaluations[i]);
+			}
+			Assert::AreEqual(static_cast<uint64_t>(17), scheduler.GetFrame());
+		}
+		TEST_METHOD(BudgetTests)
+		{
+			std::mt19937 random(28u);
+			const size_t joint_count = 12;
+			const SSkeleton skeleton(MakeSkeletonParents(joint_count, random));
+			const SClip clip = MakeRandomClip(joint_count, 2.f, random);
+			std::vector<SAnimatedCharacter> characters(24);
+			for (size_t i = 0; i < characters.size(); ++i)
+			{
+				characters[i].skeleton = &skeleton;
+				characters[i].importance = 1.f - 0.01f * static_cast<float>(i);
+				SAnimationLayer layer;
+				layer.clip = &clip;
+				characters[i].layers.push_back(layer);
+			}
+
+			SJobSystem jobs(1);
+			SAnimationLodScheduler scheduler;
+			scheduler.settings.evaluation_budget = 6 * joint_count;
+			SAnimationUpdate update;
+			update.scheduler = &scheduler;
+
+			// characters without a pose are evaluated over the budget
+			update.Update(jobs, characters.data(), characters.size(), 1.f / 60.f);
+			Assert::AreEqual(characters.size(), scheduler.GetStats().evaluated);
+
+			// full rate characters share the budget in turns, none waits more than its share
+			for (int frame = 0; frame < 12; ++frame)
+			{
+				update.Update(jobs, characters.data(), characters.size(), 1.f / 60.f);
+				Assert::AreEqual(static_cast<size_t>(6), scheduler.GetStats().evaluated);
+				Assert::AreEqual(static_cast<size_t>(18), scheduler.GetStats().deferred);
+				Assert::IsTrue(scheduler.GetStats().joint_samples <= scheduler.settings.evaluation_budget);
+				for (const SAnimatedCharacter& character : characters)
+				{
+					Assert::IsTrue(character.lod.frames_since_evaluation < 4);
+				}
+			}
+		}
+		TEST_METHOD(InterpolationTests)
+		{
+			// a root walking in a straight line
+			const SSkeleton skeleton({ SSkeleton::NoParent, 0 });
+			SClip clip(2, 10.f);
+			const float times[] = { 0.f, 10.f };
+			const SVector walk[] = { {0.f, 0.f, 0.f}, {10.f, 0.f, 0.f} };
+			Assert::IsTrue(clip.SetTranslations(0, times, walk, 2));
+
+			std::vector<SAnimatedCharacter> characters(2);
+			for (SAnimatedCharacter& character : characters)
+			{
+				character.skeleton = &skeleton;
+				SAnimationLayer layer;
+				layer.clip = &clip;
+				character.layers.push_back(layer);
+			}
+			characters[1].importance = 0.f;
+			std::vector<SAnimatedCharacter> unscheduled = characters;
+
+			SJobSystem jobs(1);
+			SAnimationLodScheduler scheduler;
+			SAnimationUpdate update, unscheduled_update;
+			update.scheduler = &scheduler;
+			const float delta_time = 1.f / 32.f;
+			for (int frame = 0; frame < 40; ++frame)
+			{
+				update.Update(jobs, characters.data(), characters.size(), delta_time);
+				unscheduled_update.Update(jobs, unscheduled.data(), unscheduled.size(), delta_time);
+
+				// full rate is the update without a scheduler
+				AssertPosesEqual(unscheduled[0].local, characters[0].local);
+				AssertPosesEqual(unscheduled[0].model, characters[0].model);
+				Assert::IsTrue(unscheduled[0].palette_matrices == characters[0].palette_matrices);
+
+				// an eighth rate character skins every frame, seven frames late
+				Assert::IsTrue(characters[1].lod.level == EAnimationLod::Eighth);
+				Assert::AreEqual(characters[0].layers[0].time, characters[1].layers[0].time);
+				if (frame >= 8)
+				{
+					const float expected = characters[1].layers[0].time - 7.f * delta_time;
+					Assert::IsTrue(std::fabs(characters[1].palette.GetTranslations()[0].GetX() - expected) < 1e-4f);
+					Assert::IsTrue(std::fabs(characters[1].palette_matrices[0].Get(3, 0) - expected) < 1e-4f);
+				}
+
+				// its model pose is the one of its last evaluation
+				const float evaluated = characters[1].layers[0].time - static_cast<float>(characters[1].lod.frames_since_evaluation) * delta_time;
+				Assert::IsTrue(std::fabs(characters[1].model.GetTranslations()[0].GetX() - evaluated) < 1e-4f);
+			}
+		}
+		TEST_METHOD(DeterminismTests)
+		{
+			std::mt19937 random(29u);
+			const size_t joint_count = 16;
+			const SSkeleton skeleton(MakeSkeletonParents(joint_count, random));
+			const std::vector<SClip> clips = { MakeRandomClip(joint_count, 1.f, random), MakeRandomClip(joint_count, 2.f, random) };
+			std::vector<SAnimatedCharacter> characters(41);
+			for (size_t i = 0; i < characters.size(); ++i)
+			{
+				characters[i].skeleton = &skeleton;
+				characters[i].importance = std::uniform_real_distribution<float>(0.f, 1.f)(random);
+				for (size_t layer = 0; layer < i % 3; ++layer)
+				{
+					SAnimationLayer animation_layer;
+					animation_layer.clip = &clips[(i + layer) % clips.size()];
+					animation_layer.weight = 1.f + static_cast<float>(layer);
+					characters[i].layers.push_back(animation_layer);
+				}
+			}
+			std::vector<SAnimatedCharacter> parallel_characters = characters;
+
+			// any thread count gives the same poses, importance changes on the way
+			SJobSystem single_thread(1);
+			SJobSystem threads(4);
+			SAnimationLodScheduler scheduler, parallel_scheduler;
+			scheduler.settings.evaluation_budget = parallel_scheduler.settings.evaluation_budget = 20 * joint_count;
+			SAnimationUpdate update, parallel_update;
+			update.scheduler = &scheduler;
+			parallel_update.scheduler = &parallel_scheduler;
+			parallel_update.batch_size = 3;
+			for (int frame = 0; frame < 20; ++frame)
+			{
+				if (frame == 10)
+				{
+					for (size_t i = 0; i < characters.size(); i += 3)
+					{
+						characters[i].importance = parallel_characters[i].importance = 1.f - characters[i].importance;
+					}
+				}
+				update.Update(single_thread, characters.data(), characters.size(), 1.f / 30.f);
+				parallel_update.Update(threads, parallel_characters.data(), parallel_characters.size(), 1.f / 30.f);
+				Assert::AreEqual(scheduler.GetStats().evaluated, parallel_scheduler.GetStats().evaluated);
+				for (size_t i = 0; i < characters.size(); ++i)
+				{
+					AssertPosesEqual(characters[i].local, parallel_characters[i].local);
+					Assert::IsTrue(characters[i].palette_matrices == parallel_characters[i].palette_matrices);
+				}
+			}
+		}
+	};
+
+	TEST_CLASS(SProfilerTests)
+	{
+	public:
+		TEST_METHOD(RecordTests)
+		{
+			SProfiler& profiler = SProfiler::Get();
+			// a stopped profiler records nothing
+			profiler.Stop();
+			{
+				const SProfileScope scope("Stopped");
+			}
+
+			profiler.Start(4);
+			{
+				const SProfileScope outer("Outer");
+				const SProfileScope inner("Inner");
+			}
+			profiler.EndFrame();
+			profiler.Stop();
+			Assert::AreEqual(size_t(2), profiler.GetEventCount());
+			Assert::AreEqual(size_t(0), profiler.GetDroppedEventCount());
+			Assert::AreEqual(size_t(1), profiler.GetFrameCount());
+
+			// nested scopes count in full, the outer one is at least as long as the inner one
+			const std::vector<SProfileStageSummary> summaries = profiler.Summarize();
+			Assert::AreEqual(size_t(3), summaries.size());
+			Assert::AreEqual(std::string("Frame"), summaries[0].name);
+			const SProfileStageSummary* outer = FindStage(summaries, "Outer");
+			const SProfileStageSummary* inner = FindStage(summaries, "Inner");
+			Assert::IsTrue(outer != nullptr && inner != nullptr && FindStage(summaries, "Stopped") == nullptr);
+			Assert::AreEqual(1.0, outer->calls_per_frame);
+			Assert::IsTrue(outer->max >= inner->max && summaries[0].max >= outer->max);
+
+			// a full buffer drops scopes, a new capture starts empty
+			profiler.Start(4);
+			for (int i = 0; i < 10; ++i)
+			{
+				const SProfileScope scope("Full");
+			}
+			profiler.Stop();
+			Assert::AreEqual(size_t(4), profiler.GetEventCount());
+			Assert::AreEqual(size_t(6), profiler.GetDroppedEventCount());
+			Assert::AreEqual(size_t(0), profiler.GetFrameCount());
+		}
+		TEST_METHOD(SummaryTests)
+		{
+			// frame 'f' has one scope of 'f + 1' thousand ticks, every other frame a second stage of a thousand ticks
+			SProfiler& profiler = SProfiler::Get();
+			profiler.Start(256);
+			for (uint64_t frame = 0; frame < 100; ++frame)
+			{
+				const uint64_t begin = SProfiler::Now();
+				profiler.Record("Stage", begin, begin + (frame + 1) * 1000);
+				if (frame % 2 == 1)
+				{
+					profiler.Record("Other", begin, begin + 1000);
+				}
+				profiler.EndFrame();
+			}
+			// after the last frame, in no frame
+			profiler.Record("Late", SProfiler::Now(), SProfiler::Now());
+			profiler.Stop();
+
+			const double ticks = 1000.0 / profiler.GetTicksPerMicrosecond();
+			const std::vector<SProfileStageSummary> summaries = profiler.Summarize();
+			Assert::AreEqual(size_t(3), summaries.size());
+			const SProfileStageSummary& stage = summaries[1];
+			Assert::AreEqual(std::string("Stage"), stage.name);
+			Assert::AreEqual(1.0, stage.calls_per_frame);
+			Assert::AreEqual(50.0 * ticks, stage.p50, 1e-9 * stage.p50);
+			Assert::AreEqual(90.0 * ticks, stage.p90, 1e-9 * stage.p90);
+			Assert::AreEqual(99.0 * ticks, stage.p99, 1e-9 * stage.p99);
+			Assert::AreEqual(100.0 * ticks, stage.max, 1e-9 * stage.max);
+
+			// frames without a scope of a stage count as no time
+			const SProfileStageSummary& other = summaries[2];
+			Assert::AreEqual(std::string("Other"), other.name);
+			Assert::AreEqual(.5, other.calls_per_frame);
+			Assert::AreEqual(0.0, other.p50);
+			Assert::AreEqual(ticks, other.p90, 1e-9 * ticks);
+
+			std::ostringstream summary;
+			profiler.WriteSummary(summary);
+			Assert::IsTrue(summary.str().find("100 frames, 151 scopes, 0 dropped") != std::string::npos);
+		}
+		TEST_METHOD(ThreadTests)
+		{
+			// every thread records into its own buffer and gets a track of its own
+			SProfiler& profiler = SProfiler::Get();
+			SJobSystem jobs(4);
+			profiler.Start(1024);
+			for (int frame = 0; frame < 3; ++frame)
+			{
+				jobs.ParallelFor(200, 1, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; ++i)
+					{
+						const SProfileScope scope("Job \"quoted\"");
+					}
+				});
+				profiler.EndFrame();
+			}
+			profiler.Stop();
+			Assert::AreEqual(size_t(600), profiler.GetEventCount());
+			Assert::AreEqual(200.0, FindStage(profiler.Summarize(), "Job \"quoted\"")->calls_per_frame);
+
+			std::ostringstream stream;
+			profiler.WriteChromeTrace(stream);
+			const std::string trace = stream.str();
+			Assert::AreEqual(size_t(0), trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+			Assert::AreEqual(trace.size() - 4, trace.rfind("\n]}\n"));
+			Assert::AreEqual(size_t(600), CountOf(trace, "\"name\":\"Job \\\"quoted\\\"\""));
+			Assert::AreEqual(size_t(3), CountOf(trace, "\"name\":\"Frame\""));
+			Assert::AreEqual(size_t(1), CountOf(trace, "\"name\":\"Frames\""));
+			Assert::AreEqual(CountOf(trace, "{"), CountOf(trace, "}"));
+		}
+		TEST_METHOD(StageTests)
+		{
+			// the library stages record only in a build with ANIMATION_PROFILE, the kernels with ANIMATION_PROFILE_KERNELS as well
+			std::mt19937 random(19u);
+			const size_t joint_count = 30;
+			const SSkeleton skeleton(MakeSkeletonParents(joint_count, random));
+			const std::vector<SClip> clips = { MakeRandomClip(joint_count, 1.f, random), MakeRandomClip(joint_count, 2.f, random) };
+			std::vector<SAnimatedCharacter> characters(10);
+			for (size_t i = 0; i < characters.size(); ++i)
+			{
+				characters[i].skeleton = &skeleton;
+				for (const SClip& clip : clips)
+				{
+					SAnimationLayer layer;
+					layer.clip = &clip;
+					characters[i].layers.push_back(layer);
+				}
+			}
+
+			SProfiler& profiler = SProfiler::Get();
+			SJobSystem jobs(2);
+			SAnimationUpdate update;
+			profiler.Start();
+			for (int frame = 0; frame < 4; ++frame)
+			{
+				update.Update(jobs, characters.data(), characters.size(), 1.f / 60.f);
+				profiler.EndFrame();
+			}
+			profiler.Stop();
+
+			const std::vector<SProfileStageSummary> summaries = profiler.Summarize();
+#if defined(ANIMATION_PROFILE)
+			Assert::AreEqual(1.0, FindStage(summaries, "SAnimationUpdate::Update")->calls_per_frame);
+			Assert::AreEqual(1.0, FindStage(summaries, "SAnimationUpdate::UpdateBatch")->calls_per_frame);
+#if defined(ANIMATION_PROFILE_KERNELS)
+			Assert::AreEqual(10.0, FindStage(summaries, "SAnimationUpdate::UpdateCharacter")->calls_per_frame);
+			Assert::AreEqual(20.0, FindStage(summaries, "SClipSampler::Sample")->calls_per_frame);
+			Assert::AreEqual(20.0, FindStage(summaries, "SPoseBlender::Add")->calls_per_frame);
+			Assert::AreEqual(10.0, FindStage(summaries, "SMatrix::FromTransforms")->calls_per_frame);
+#else
+			Assert::IsTrue(FindStage(summaries, "SAnimationUpdate::UpdateCharacter") == nullptr);
+			Assert::IsTrue(FindStage(summaries, "SClipSampler::Sample") == nullptr);
+#endif
+#else
+			Assert::AreEqual(size_t(1), summaries.size());
+			Assert::AreEqual(size_t(0), profiler.GetEventCount());
+#endif
+		}
+
+	private:
+		static const SProfileStageSummary* FindStage(const std::vector<SProfileStageSummary>& summaries, const char* name)
+		{
+			for (const SProfileStageSummary& summary : summaries)
+			{
+				if (summary.name == name)
+				{
+					return &summary;
+				}
+			}
+			return nullptr;
+		}
+
+		static size_t CountOf(const std::string& text, const std::string& pattern)
+		{
+			size_t count = 0;
+			for (size_t position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + pattern.size()))
+			{
+				++count;
+			}
+			return count;
+		}
+	};
+
+	TEST_CLASS(SMatrixTests)
+	{
+	public:
+		static void AssertMatricesNear(const SMatrix& expected, const SMatrix& actual, float tolerance)
+		{
+			for (size_t row = 0; row < 4; ++row)
+			{
+				for (size_t column = 0; column < 4; ++column)
+				{
+					Assert::AreEqual(expected.Get(row, column), actual.Get(row, column), tolerance);
+				}
+			}
+		}
+
+		static SMatrix RandomMatrix(std::mt19937& random)
+		{
+			const SQuaternion rotation = RandomRotation(random);
+			const SVector translation = RandomVector(random, -2.f, 2.f);
+			const SVector scale = RandomVector(random, .5f, 2.f);
+			return SMatrix::FromTransform(rotation, translation, scale);
+		}
+
+		TEST_METHOD(LayoutTests)
+		{
+			const SMatrix m(_mm_set_ps(1.f, 2.f, 3.f, 4.f), _mm_set_ps(5.f, 6.f, 7.f, 8.f), _mm_set_ps(9.f, 10.f, 11.f, 12.f), _mm_set_ps(13.f, 14.f, 15.f, 16.f));
+			for (size_t row = 0; row < 4; ++row)
+			{
+				for (size_t column = 0; column < 4; ++column)
+				{
+					Assert::AreEqual(static_cast<float>(row * 4 + column + 1), m.Get(row, column));
+				}
+			}
+			for (size_t row = 0; row < 4; ++row)
+			{
+				for (size_t column = 0; column < 4; ++column)
+				{
+					Assert::AreEqual(row == column ? 1.f : 0.f, SMatrix::Identity.Get(row, column));
+				}
+			}
+			Assert::IsTrue(SMatrix() == SMatrix::Identity);
+			Assert::IsTrue(m != SMatrix::Identity);
+		}
+		TEST_METHOD(FromTransformTests)
+		{
+			std::mt19937 random(30u);
+			for (int i = 0; i < 100; ++i)
+			{
+				const SQuaternion rotation = RandomRotation(random);
+				const SVector translation = RandomVector(random, -2.f, 2.f);
+				const SVector scale = RandomVector(random, .5f, 2.f);
+				const SVector v = RandomVector(random, -3.f, 3.f);
+				const SMatrix m = SMatrix::FromTransform(rotation, translation, scale);
+
+				AssertVectorsNear(rotation.Rotate(scale * v) + translation, m.TransformPoint(v), 1e-5f);
+				AssertVectorsNear(rotation.Rotate(scale * v), m.TransformDirection(v), 1e-5f);
+				// the unused lane stays zero for points too
+				Assert::AreEqual(0, _mm_movemask_ps(_mm_cmpneq_ps(m.TransformPoint(v).GetStorage(), _mm_set_ps(0.f, 0.f, 0.f, 0.f))) & 1);
+				for (size_t row = 0; row < 4; ++row)
+				{
+					Assert::AreEqual(row == SMatrix::TRANSLATION ? 1.f : 0.f, m.Get(row, 3));
+				}
+			}
+		}
+		TEST_METHOD(BatchTests)
+		{
+			// every count around the four-wide kernel, tails included, is equal to the single conversion
+			std::mt19937 random(31u);
+			for (size_t count = 0; count < 10; ++count)
+			{
+				std::vector<SQuaternion> rotations;
+				std::vector<SVector> translations, scales;
+				for (size_t i = 0; i < count; ++i)
+				{
+					rotations.push_back(RandomRotation(random));
+					translations.push_back(RandomVector(random, -2.f, 2.f));
+					scales.push_back(RandomVector(random, .5f, 2.f));
+				}
+				std::vector<SMatrix> matrices(count + 1, SMatrix::Identity);
+				SMatrix::FromTransforms(rotations.data(), translations.data(), scales.data(), matrices.data(), count);
+				for (size_t i = 0; i < count; ++i)
+				{
+					Assert::IsTrue(SMatrix::FromTransform(rotations[i], translations[i], scales[i]) == matrices[i]);
+				}
+				Assert::IsTrue(matrices[count] == SMatrix::Identity);
+			}
+		}
+		TEST_METHOD(ProductTests)
+		{
+			std::mt19937 random(32u);
+			for (int i = 0; i < 100; ++i)
+			{
+				const SMatrix a = RandomMatrix(random), b = RandomMatrix(random);
+				const SVector v = RandomVector(random, -3.f, 3.f);
+				// 'a * b' applies 'a' first
+				AssertVectorsNear(b.TransformPoint(a.TransformPoint(v)), (a * b).TransformPoint(v), 1e-4f);
+				AssertVectorsNear(b.TransformDirection(a.TransformDirection(v)), (a * b).TransformDirection(v), 1e-4f);
+				Assert::IsTrue(a * SMatrix::Identity == a);
+				Assert::IsTrue(SMatrix::Identity * a == a);
+
+				SMatrix c = a;
+				c *= b;
+				Assert::IsTrue(c == a * b);
+				c = a;
+				c *= c;
+				Assert::IsTrue(c == a * a);
+			}
+		}
+		TEST_METHOD(TransposeTests)
+		{
+			std::mt19937 random(33u);
+			const SMatrix m = RandomMatrix(random);
+			const SMatrix t = m.Transposition();
+			for (size_t row = 0; row < 4; ++row)
+			{
+				for (size_t column = 0; column < 4; ++column)
+				{
+					Assert::AreEqual(m.Get(row, column), t.Get(column, row));
+				}
+			}
+			SMatrix twice = t;
+			twice.Transpose();
+			Assert::IsTrue(twice == m);
+		}
+		TEST_METHOD(InverseTests)
+		{
+			std::mt19937 random(34u);
+			for (int i = 0; i < 100; ++i)
+			{
+				const SMatrix m = RandomMatrix(random);
+				const SMatrix inverse = m.AffineInverse();
+				const SVector v = RandomVector(random, -3.f, 3.f);
+
+				AssertMatricesNear(SMatrix::Identity, m * inverse, 1e-5f);
+				AssertMatricesNear(SMatrix::Identity, inverse * m, 1e-5f);
+				AssertVectorsNear(v, inverse.TransformPoint(m.TransformPoint(v)), 1e-4f);
+				for (size_t row = 0; row < 4; ++row)
+				{
+					Assert::AreEqual(row == SMatrix::TRANSLATION ? 1.f : 0.f, inverse.Get(row, 3));
+				}
+
+				SMatrix in_place = m;
+				in_place.InvertAffine();
+				Assert::IsTrue(in_place == inverse);
+			}
+		}
+	};
+
+	TEST_CLASS(SSkinningTests)
+	{
+	public:
+		// 'vertex_count' vertices with 1 to 4 influences and weights adding up to 1, bones below 'bone_count'
+		static SSkinnedMesh MakeSkinnedMesh(size_t vertex_count, size_t bone_count, bool has_normals, std::mt19937& random)
+		{
+			SSkinnedMesh mesh(vertex_count, has_normals);
+			std::uniform_real_distribution<float> value(-2.f, 2.f);
+			std::uniform_int_distribution<int> bone(0, static_cast<int>(bone_count) - 1);
+			for (size_t vertex = 0; vertex < vertex_count; ++vertex)
+			{
+				const float x = value(random), y = value(random), z = value(random);
+				mesh.GetPositions().Set(vertex, SVector(x, y, z));
+				if (has_normals)
+				{
+					const float nx = value(random), ny = value(random);
+					mesh.GetNormals().Set(vertex, SVector(nx, ny, 1.f).Normal());
+				}
+
+				const size_t count = 1 + vertex % SSkinnedMesh::MaxInfluences;
+				uint16_t bones[SSkinnedMesh::MaxInfluences];
+				float weights[SSkinnedMesh::MaxInfluences];
+				float total = 0.f;
+				for (size_t i = 0; i < count; ++i)
+				{
+					bones[i] = static_cast<uint16_t>(bone(random));
+					weights[i] = std::uniform_real_distribution<float>(.1f, 1.f)(random);
+					total += weights[i];
+				}
+				for (size_t i = 0; i < count; ++i)
+				{
+					weights[i] /= total;
+				}
+				mesh.SetInfluences(vertex, bones, weights, count);
+			}
+			return mesh;
+		}
+
+		static std::vector<SMatrix> MakeSkinningPalette(size_t bone_count, std::mt19937& random)
+		{
+			std::vector<SMatrix> palette;
+			for (size_t i = 0; i < bone_count; ++i)
+			{
+				const SQuaternion rotation = RandomRotation(random);
+				const SVector translation = RandomVector(random, -1.f, 1.f);
+				const SVector scale = RandomVector(random, .5f, 1.5f);
+				palette.push_back(SMatrix::FromTransform(rotation, translation, scale));
+			}
+			return palette;
+		}
+
+		static std::vector<ESkinningPath> SupportedPaths()
+		{
+			std::vector<ESkinningPath> paths;
+			for (const ESkinningPath path : { ESkinningPath::Sse, ESkinningPath::Fma })
+			{
+				if (SSkinning::IsSupported(path))
+				{
+					paths.push_back(path);
+				}
+			}
+			return paths;
+		}
+
+		static void AssertStreamsEqual(const SVectorSoA& expected, const SVectorSoA& actual)
+		{
+			Assert::AreEqual(expected.Size(), actual.Size());
+			for (size_t i = 0; i < expected.Size(); ++i)
+			{
+				Assert::IsTrue(expected.Get(i) == actual.Get(i));
+			}
+		}
+
+		TEST_METHOD(MeshTests)
+		{
+			SSkinnedMesh mesh(5);
+			Assert::AreEqual(size_t(5), mesh.GetVertexCount());
+			Assert::IsTrue(mesh.HasNormals());
+			Assert::IsTrue(mesh.IsValid(1));
+			Assert::IsFalse(mesh.IsValid(0));
+
+			const uint16_t bones[] = { 3, 1, 2 };
+			const float weights[] = { .5f, .3f, .2f };
+			mesh.SetInfluences(2, bones, weights, 3);
+			Assert::IsTrue(mesh.IsValid(4));
+			Assert::IsFalse(mesh.IsValid(3));
+			mesh.SetInfluences(2, bones + 1, weights, 1);
+			Assert::IsTrue(mesh.IsValid(2));
+			Assert::AreEqual(uint16_t(1), mesh.GetBones(0)[2]);
+			Assert::AreEqual(0.f, mesh.GetWeights(1)[2]);
+
+			// influence arrays cover the padding of the streams
+			mesh.Resize(20, false);
+			Assert::IsFalse(mesh.HasNormals());
+			Assert::AreEqual(size_t(0), mesh.GetNormals().Size());
+			Assert::AreEqual(.5f, mesh.GetWeights(0)[2]);
+			for (size_t vertex = 20; vertex < mesh.GetPositions().PaddedSize(); ++vertex)
+			{
+				Assert::AreEqual(0.f, mesh.GetWeights(0)[vertex]);
+			}
+			Assert::IsTrue(mesh.IsValid(2));
+		}
+		TEST_METHOD(IdentityTests)
+		{
+			// one influence of weight 1 on identity matrices leaves every vertex as it is
+			std::mt19937 random(40u);
+			SSkinnedMesh mesh = MakeSkinnedMesh(21, 3, true, random);
+			for (size_t vertex = 0; vertex < mesh.GetVertexCount(); ++vertex)
+			{
+				const uint16_t bone = static_cast<uint16_t>(vertex % 3);
+				const float weight = 1.f;
+				mesh.SetInfluences(vertex, &bone, &weight, 1);
+			}
+			const std::vector<SMatrix> palette(3, SMatrix::Identity);
+			for (const ESkinningPath path : SupportedPaths())
+			{
+				SSkinning skinning;
+				skinning.path = path;
+				SVectorSoA positions, normals;
+				skinning.SkinLinear(mesh, palette.data(), positions, normals);
+				AssertStreamsEqual(mesh.GetPositions(), positions);
+				AssertStreamsEqual(mesh.GetNormals(), normals);
+			}
+		}
+		TEST_METHOD(LinearTests)
+		{
+			// every path against the weighted sum of the vertex transformed by each bone, for tails of every length
+			std::mt19937 random(41u);
+			const std::vector<SMatrix> palette = MakeSkinningPalette(7, random);
+			for (size_t vertex_count = 0; vertex_count < 38; vertex_count += 3)
+			{
+				const bool has_normals = vertex_count % 2 == 0;
+				const SSkinnedMesh mesh = MakeSkinnedMesh(vertex_count, palette.size(), has_normals, random);
+				for (const ESkinningPath path : SupportedPaths())
+				{
+					SSkinning skinning;
+					skinning.path = path;
+					SVectorSoA positions, normals;
+					skinning.SkinLinear(mesh, palette.data(), positions, normals);
+					Assert::AreEqual(vertex_count, positions.Size());
+					Assert::AreEqual(has_normals ? vertex_count : size_t(0), normals.Size());
+
+					for (size_t vertex = 0; vertex < vertex_count; ++vertex)
+					{
+						SVector position, normal;
+						for (size_t slot = 0; slot < SSkinnedMesh::MaxInfluences; ++slot)
+						{
+							const SMatrix& matrix = palette[mesh.GetBones(slot)[vertex]];
+							const float weight = mesh.GetWeights(slot)[vertex];
+							position += matrix.TransformPoint(mesh.GetPositions().Get(vertex)) * weight;
+							if (has_normals)
+							{
+								normal += matrix.TransformDirection(mesh.GetNormals().Get(vertex)) * weight;
+							}
+						}
+						Assert::IsTrue((position - positions.Get(vertex)).Magnitude() < 1e-5f);
+						if (has_normals)
+						{
+							Assert::IsTrue((normal - normals.Get(vertex)).Magnitude() < 1e-5f);
+						}
+					}
+				}
+			}
+		}
+		TEST_METHOD(DualQuaternionTests)
+		{
+			// every path against 'SDualQuaternion' blending per vertex, rigid transforms agree with linear blend skinning
+			std::mt19937 random(43u);
+			std::vector<SQuaternion> rotations;
+			std::vector<SVector> translations;
+			for (size_t bone = 0; bone < 7; ++bone)
+			{
+				const SMatrix matrix = MakeSkinningPalette(1, random)[0];
+				const float roll = std::uniform_real_distribution<float>(-3.14f, 3.14f)(random);
+				rotations.push_back(SQuaternion(roll, roll * .5f, 1.f - roll));
+				translations.push_back(SVector(matrix.GetRow(SMatrix::TRANSLATION)) - SVector(0.f));
+			}
+			std::vector<SDualQuaternion> palette(rotations.size());
+			std::vector<SMatrix> matrices(rotations.size());
+			SDualQuaternion::FromTransforms(rotations.data(), translations.data(), palette.data(), palette.size());
+			for (size_t bone = 0; bone < rotations.size(); ++bone)
+			{
+				matrices[bone] = SMatrix::FromTransform(rotations[bone], translations[bone], SVector(1.f));
+			}
+
+			for (size_t vertex_count = 0; vertex_count < 38; vertex_count += 3)
+			{
+				const bool has_normals = vertex_count % 2 == 0;
+				SSkinnedMesh mesh = MakeSkinnedMesh(vertex_count, palette.size(), has_normals, random);
+				if (vertex_count > 0)
+				{
+					// a vertex without influences stays where it is
+					mesh.SetInfluences(0, nullptr, nullptr, 0);
+				}
+				for (const ESkinningPath path : SupportedPaths())
+				{
+					SSkinning skinning;
+					skinning.path = path;
+					SVectorSoA positions, normals, linear_positions, linear_normals;
+					skinning.SkinDualQuaternion(mesh, palette.data(), positions, normals);
+					skinning.SkinLinear(mesh, matrices.data(), linear_positions, linear_normals);
+					Assert::AreEqual(vertex_count, positions.Size());
+					Assert::AreEqual(has_normals ? vertex_count : size_t(0), normals.Size());
+
+					for (size_t vertex = 0; vertex < vertex_count; ++vertex)
+					{
+						SDualQuaternion influences[SSkinnedMesh::MaxInfluences];
+						float weights[SSkinnedMesh::MaxInfluences];
+						for (size_t slot = 0; slot < SSkinnedMesh::MaxInfluences; ++slot)
+						{
+							influences[slot] = palette[mesh.GetBones(slot)[vertex]];
+							weights[slot] = mesh.GetWeights(slot)[vertex];
+						}
+						if (vertex == 0)
+						{
+							Assert::IsTrue(mesh.GetPositions().Get(vertex) == positions.Get(vertex));
+							continue;
+						}
+
+						const SDualQuaternion blend = SDualQuaternion::Blend(influences, weights, SSkinnedMesh::MaxInfluences).Normal();
+						Assert::IsTrue((blend.TransformPoint(mesh.GetPositions().Get(vertex)) - positions.Get(vertex)).Magnitude() < 1e-5f);
+						if (has_normals)
+						{
+							Assert::IsTrue((blend.TransformDirection(mesh.GetNormals().Get(vertex)) - normals.Get(vertex)).Magnitude() < 1e-5f);
+						}
+						if (weights[1] == 0.f)
+						{
+							Assert::IsTrue((linear_positions.Get(vertex) - positions.Get(vertex)).Magnitude() < 1e-5f);
+						}
+					}
+				}
+			}
+		}
+		TEST_METHOD(CandyWrapperTests)
+		{
+			// a ring around a bone twisted by 170 degrees, every vertex half on each bone
+			const float half_twist = .5f * 170.f * 3.1415926f / 180.f;
+			const SQuaternion twist(sinf(half_twist), 0.f, 0.f, cosf(half_twist));
+			const std::vector<SMatrix> matrices = { SMatrix::Identity, SMatrix::FromTransform(twist, SVector(0.f), SVector(1.f)) };
+			const std::vector<SDualQuaternion> palette = { SDualQuaternion::Identity, SDualQuaternion::FromTransform(twist, SVector(0.f)) };
+
+			SSkinnedMesh mesh(16, false);
+			const uint16_t bones[] = { 0, 1 };
+			const float weights[] = { .5f, .5f };
+			for (size_t vertex = 0; vertex < mesh.GetVertexCount(); ++vertex)
+			{
+				const float angle = static_cast<float>(vertex) * 2.f * 3.1415926f / 16.f;
+				mesh.GetPositions().Set(vertex, SVector(0.f, cosf(angle), sinf(angle)));
+				mesh.SetInfluences(vertex, bones, weights, 2);
+			}
+
+			SSkinning skinning;
+			SVectorSoA linear, dual_quaternion, normals;
+			skinning.SkinLinear(mesh, matrices.data(), linear, normals);
+			skinning.SkinDualQuaternion(mesh, palette.data(), dual_quaternion, normals);
+			for (size_t vertex = 0; vertex < mesh.GetVertexCount(); ++vertex)
+			{
+				// matrices collapse the ring to cos(85 degrees) of its radius, dual quaternions keep it
+				Assert::AreEqual(cosf(half_twist), linear.Get(vertex).Magnitude(), 1e-5f);
+				Assert::AreEqual(1.f, dual_quaternion.Get(vertex).Magnitude(), 1e-5f);
+			}
+		}
+		TEST_METHOD(ParallelTests)
+		{
+			// job chunks and streaming stores give the results of the single-threaded cached call
+			std::mt19937 random(42u);
+			const std::vector<SMatrix> palette = MakeSkinningPalette(12, random);
+			std::vector<SDualQuaternion> dual_palette;
+			for (const SMatrix& matrix : palette)
+			{
+				dual_palette.push_back(SDualQuaternion::FromTransform(SQuaternion(matrix.Get(0, 0), matrix.Get(1, 1), matrix.Get(2, 2)), SVector(1.f, 2.f, 3.f)));
+			}
+			const SSkinnedMesh mesh = MakeSkinnedMesh(1000, palette.size(), true, random);
+			SJobSystem jobs(4);
+			for (const ESkinningPath path : SupportedPaths())
+			{
+				SSkinning skinning;
+				skinning.path = path;
+				SVectorSoA positions, normals, dual_positions, dual_normals;
+				skinning.SkinLinear(mesh, palette.data(), positions, normals);
+				skinning.SkinDualQuaternion(mesh, dual_palette.data(), dual_positions, dual_normals);
+
+				for (const size_t chunk_size : { size_t(1), size_t(40), size_t(256), SSkinning::DefaultChunkSize })
+				{
+					for (const ESkinningStore store : { ESkinningStore::Cached, ESkinningStore::Streaming })
+					{
+						SSkinning parallel = skinning;
+						parallel.chunk_size = chunk_size;
+						parallel.store = store;
+						SVectorSoA parallel_positions, parallel_normals;
+						parallel.SkinLinear(jobs, mesh, palette.data(), parallel_positions, parallel_normals);
+						AssertStreamsEqual(positions, parallel_positions);
+						AssertStreamsEqual(normals, parallel_normals);
+						parallel.SkinDualQuaternion(jobs, mesh, dual_palette.data(), parallel_positions, parallel_normals);
+						AssertStreamsEqual(dual_positions, parallel_positions);
+						AssertStreamsEqual(dual_normals, parallel_normals);
+					}
+				}
+			}
+		}
+	};
+
+	TEST_CLASS(SIKSolverTests)
+	{
+	public:
+		static SVector RandomDirection(std::mt19937& random)
+		{
+			std::uniform_real_distribution<float> value(-1.f, 1.f);
+			for (;;)
+			{
+				const float x = value(random), y = value(random), z = value(random);
+				const SVector direction(x, y, z);
+				if (direction.SqrMagnitude() > .01f)
+				{
+					return direction.Normal();
+				}
+			}
+		}
+
+		// a chain with bones of 'lengths' in random directions from 'root'
+		static std::vector<SVector> MakeIKChain(const SVector& root, const std::vector<float>& lengths, std::mt19937& random)
+		{
+			std::vector<SVector> positions = { root };
+			for (const float length : lengths)
+			{
+				positions.push_back(positions.back() + RandomDirection(random) * length);
+			}
+			return positions;
+		}
+
+		/*
+		* 'chain_count' chains of 'joint_count' joints with random bone lengths, the target of every chain is the end effector of
+		* another chain with the same root and lengths, so every target is in reach
+		*/
+		static SIKChains MakeIKChains(size_t chain_count, size_t joint_count, std::mt19937& random)
+		{
+			SIKChains chains(chain_count, joint_count);
+			std::uniform_real_distribution<float> length(.3f, 1.f);
+			for (size_t chain = 0; chain < chain_count; ++chain)
+			{
+				std::vector<float> lengths(joint_count - 1);
+				for (float& bone_length : lengths)
+				{
+					bone_length = length(random);
+				}
+				const SVector root = RandomDirection(random) * 2.f;
+				const std::vector<SVector> positions = MakeIKChain(root, lengths, random);
+				const SVector target = MakeIKChain(root, lengths, random).back();
+				chains.SetChain(chain, positions.data(), target, root + RandomDirection(random));
+			}
+			return chains;
+		}
+
+		// root in place, bones at their lengths, reported errors match the positions
+		static void AssertIKChainsValid(const SIKChains& before, const SIKChains& after, float tolerance = 1e-4f)
+		{
+			for (size_t chain = 0; chain < after.GetChainCount(); ++chain)
+			{
+				Assert::IsTrue(before.GetJoints(0).Get(chain) == after.GetJoints(0).Get(chain));
+				for (size_t bone = 0; bone + 1 < after.GetJointCount(); ++bone)
+				{
+					const float length = (before.GetJoints(bone + 1).Get(chain) - before.GetJoints(bone).Get(chain)).Magnitude();
+					Assert::AreEqual(length, (after.GetJoints(bone + 1).Get(chain) - after.GetJoints(bone).Get(chain)).Magnitude(), tolerance);
+				}
+				const SVector end = after.GetJoints(after.GetJointCount() - 1).Get(chain);
+				Assert::AreEqual((end - after.GetTargets().Get(chain)).Magnitude(), after.GetErrors()[chain], 1e-6f);
+			}
+		}
+
+		TEST_METHOD(TwoBoneTests)
+		{
+			std::mt19937 random(60u);
+			const SIKChains before = MakeIKChains(101, 3, random);
+			SIKChains chains = before;
+			SIKSolver().SolveTwoBone(chains);
+			AssertIKChainsValid(before, chains);
+			for (size_t chain = 0; chain < chains.GetChainCount(); ++chain)
+			{
+				Assert::IsTrue(chains.GetErrors()[chain] < 1e-4f);
+				Assert::AreEqual(1u, chains.GetIterations()[chain]);
+
+				// the middle joint is on the side of the pole
+				const SVector root = chains.GetJoints(0).Get(chain);
+				const SVector direction = (chains.GetTargets().Get(chain) - root).Normal();
+				const SVector pole = (chains.GetPoles().Get(chain) - root).RejectionToNormal(direction);
+				Assert::IsTrue(((chains.GetJoints(1).Get(chain) - root) | pole) >= 0.f);
+			}
+
+			// out of reach: a straight chain pointing at the target
+			const SVector positions[] = { SVector(0.f), SVector(1.f, 0.f, 0.f), SVector(1.f, 2.f, 0.f) };
+			SIKChains far(1, 3);
+			far.SetChain(0, positions, SVector(0.f, 0.f, 10.f));
+			SIKSolver().SolveTwoBone(far);
+			Assert::IsTrue((far.GetJoints(1).Get(0) - SVector(0.f, 0.f, 1.f)).Magnitude() < 1e-6f);
+			Assert::IsTrue((far.GetJoints(2).Get(0) - SVector(0.f, 0.f, 3.f)).Magnitude() < 1e-6f);
+			Assert::AreEqual(7.f, far.GetErrors()[0], 1e-6f);
+
+			// a target closer than the bones can fold: the end effector as close as it gets
+			far.SetChain(0, positions, SVector(0.f, .5f, 0.f));
+			SIKSolver().SolveTwoBone(far);
+			Assert::AreEqual(1.f, (far.GetJoints(2).Get(0) - SVector(0.f)).Magnitude(), 1e-5f);
+			Assert::IsTrue((far.GetJoints(2).Get(0) - SVector(0.f, 1.f, 0.f)).Magnitude() < 1e-5f);
+		}
+		TEST_METHOD(IterativeTests)
+		{
+			std::mt19937 random(61u);
+			for (const size_t joint_count : { size_t(2), size_t(3), size_t(5), size_t(8) })
+			{
+				const SIKChains before = MakeIKChains(64, joint_count, random);
+				SIKSolver solver;
+				solver.max_iterations = 64;
+				for (const bool fabrik : { false, true })
+				{
+					SIKChains chains = before;
+					fabrik ? solver.SolveFabrik(chains) : solver.SolveCCD(chains);
+					AssertIKChainsValid(before, chains);
+
+					size_t converged = 0;
+					for (size_t chain = 0; chain < chains.GetChainCount(); ++chain)
+					{
+						const bool done = chains.GetErrors()[chain] <= solver.tolerance;
+						converged += done ? 1 : 0;
+						Assert::IsTrue(done || chains.GetIterations()[chain] == solver.max_iterations);
+						Assert::IsTrue(chains.GetIterations()[chain] <= solver.max_iterations);
+					}
+					// every target is in reach, a few chains may need more iterations
+					Assert::IsTrue(converged >= chains.GetChainCount() * 9 / 10);
+				}
+			}
+
+			// converged chains don't move
+			SIKChains chains(1, 3);
+			const SVector positions[] = { SVector(0.f), SVector(1.f, 0.f, 0.f), SVector(1.f, 1.f, 0.f) };
+			chains.SetChain(0, positions, positions[2]);
+			SIKSolver().SolveCCD(chains);
+			Assert::AreEqual(0u, chains.GetIterations()[0]);
+			SIKSolver().SolveFabrik(chains);
+			Assert::AreEqual(0u, chains.GetIterations()[0]);
+			Assert::IsTrue(chains.GetJoints(2).Get(0) == positions[2]);
+
+			// FABRIK out of reach: a straight chain pointing at the target in one pass
+			chains.SetChain(0, positions, SVector(0.f, -5.f, 0.f));
+			SIKSolver().SolveFabrik(chains);
+			Assert::AreEqual(1u, chains.GetIterations()[0]);
+			Assert::IsTrue((chains.GetJoints(1).Get(0) - SVector(0.f, -1.f, 0.f)).Magnitude() < 1e-6f);
+			Assert::IsTrue((chains.GetJoints(2).Get(0) - SVector(0.f, -2.f, 0.f)).Magnitude() < 1e-6f);
+		}
+		TEST_METHOD(BatchTests)
+		{
+			// every chain of a batch gets the result it gets alone
+			std::mt19937 random(62u);
+			const SIKChains before = MakeIKChains(37, 3, random);
+			SIKSolver solver;
+			solver.max_iterations = 8;
+			for (int method = 0; method < 3; ++method)
+			{
+				const auto solve = [&](SIKChains& chains)
+				{
+					method == 0 ? solver.SolveTwoBone(chains) : method == 1 ? solver.SolveCCD(chains) : solver.SolveFabrik(chains);
+				};
+				SIKChains batch = before;
+				solve(batch);
+				for (size_t chain = 0; chain < before.GetChainCount(); ++chain)
+				{
+					SVector positions[3];
+					before.GetChain(chain, positions);
+					SIKChains single(1, 3);
+					single.SetChain(0, positions, before.GetTargets().Get(chain), before.GetPoles().Get(chain));
+					solve(single);
+					for (size_t joint = 0; joint < 3; ++joint)
+					{
+						Assert::IsTrue(single.GetJoints(joint).Get(0) == batch.GetJoints(joint).Get(chain));
+					}
+					Assert::AreEqual(single.GetErrors()[0], batch.GetErrors()[chain]);
+					Assert::AreEqual(single.GetIterations()[0], batch.GetIterations()[chain]);
+				}
+			}
+		}
+		TEST_METHOD(SwingRotationTests)
+		{
+			std::mt19937 random(63u);
+			const SIKChains before = MakeIKChains(21, 4, random);
+			SIKChains after = before;
+			SIKSolver().SolveFabrik(after);
+			// the last chain turns its first bone around
+			SVector positions[4];
+			before.GetChain(20, positions);
+			positions[1] = positions[0] * 2.f - positions[1];
+			after.SetChain(20, positions, before.GetTargets().Get(20));
+
+			std::vector<SQuaternion> rotations(before.GetChainCount(), SQuaternion::Identity);
+			for (size_t bone = 0; bone < 3; ++bone)
+			{
+				SIKSolver::SwingRotations(before, after, bone, rotations.data());
+				for (size_t chain = 0; chain < before.GetChainCount(); ++chain)
+				{
+					const SVector from = (before.GetJoints(bone + 1).Get(chain) - before.GetJoints(bone).Get(chain)).Normal();
+					const SVector to = (after.GetJoints(bone + 1).Get(chain) - after.GetJoints(bone).Get(chain)).Normal();
+					Assert::AreEqual(1.f, rotations[chain].Magnitude(), 1e-5f);
+					Assert::IsTrue((rotations[chain].Rotate(from) - to).Magnitude() < 1e-5f);
+				}
+			}
+
+			SIKSolver::SwingRotations(before, before, 0, rotations.data());
+			Assert::IsTrue(rotations[0] == SQuaternion::Identity);
+		}
 	};
 }
@@ -0,0 +1,169 @@
+#pragma once
+
+/*
+* Portable subset of the Microsoft CppUnitTestFramework, so 'AnimationUnitTest.cpp' builds and runs unchanged outside of Visual Studio.
+* Only the parts used by the tests are provided: TEST_CLASS, TEST_METHOD, 'Assert' and 'ToString'.
+* Test methods register themselves before 'main', 'TestRunner.cpp' runs all of them and reports failures.
+*/
+
+#include <cmath>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Microsoft
+{
+    namespace VisualStudio
+    {
+        namespace CppUnitTestFramework
+        {
+            // converts a value to a text for a failure message, tests specialize it for their own types
+            template <typename Q>
+            std::wstring ToString(const Q& value)
+            {
+                if constexpr (std::is_arithmetic_v<Q>)
+                {
+                    std::wostringstream line;
+                    line.precision(9);
+                    line << value;
+                    return line.str();
+                }
+                else
+                {
+                    return L"<object>";
+                }
+            }
+
+            template <>
+            inline std::wstring ToString<std::wstring>(const std::wstring& value) { return value; }
+
+            template <>
+            inline std::wstring ToString<std::string>(const std::string& value) { return {value.begin(), value.end()}; }
+
+            struct SAssertFailure : std::exception
+            {
+                explicit SAssertFailure(std::wstring text)
+                    : message{std::move(text)}
+                {}
+
+                const char* what() const noexcept override { return "assertion failed"; }
+
+                std::wstring message;
+            };
+
+            struct SLineInfo
+            {
+            };
+
+            class Assert
+            {
+            public:
+                template <typename T>
+                static void AreEqual(const T& expected, const T& actual, const wchar_t* message = nullptr, const SLineInfo* = nullptr)
+                {
+                    if (!(expected == actual))
+                    {
+                        Throw(L"Expected: <" + ToString(expected) + L"> Actual: <" + ToString(actual) + L">", message);
+                    }
+                }
+
+                static void AreEqual(float expected, float actual, float tolerance, const wchar_t* message = nullptr, const SLineInfo* = nullptr)
+                {
+                    if (!(std::fabs(expected - actual) <= tolerance))
+                    {
+                        Throw(L"Expected: <" + ToString(expected) + L"> Actual: <" + ToString(actual) + L"> Tolerance: <" + ToString(tolerance) + L">", message);
+                    }
+                }
+
+                static void AreEqual(double expected, double actual, double tolerance, const wchar_t* message = nullptr, const SLineInfo* = nullptr)
+                {
+                    if (!(std::fabs(expected - actual) <= tolerance))
+                    {
+                        Throw(L"Expected: <" + ToString(expected) + L"> Actual: <" + ToString(actual) + L"> Tolerance: <" + ToString(tolerance) + L">", message);
+                    }
+                }
+
+                template <typename T>
+                static void AreNotEqual(const T& not_expected, const T& actual, const wchar_t* message = nullptr, const SLineInfo* = nullptr)
+                {
+                    if (not_expected == actual)
+                    {
+                        Throw(L"Not expected: <" + ToString(not_expected) + L"> Actual: <" + ToString(actual) + L">", message);
+                    }
+                }
+
+                static void IsTrue(bool condition, const wchar_t* message = nullptr, const SLineInfo* = nullptr)
+                {
+                    if (!condition)
+                    {
+                        Throw(L"IsTrue failed", message);
+                    }
+                }
+
+                static void IsFalse(bool condition, const wchar_t* message = nullptr, const SLineInfo* = nullptr)
+                {
+                    if (condition)
+                    {
+                        Throw(L"IsFalse failed", message);
+                    }
+                }
+
+                static void Fail(const wchar_t* message = nullptr, const SLineInfo* = nullptr)
+                {
+                    Throw(L"Fail", message);
+                }
+
+            private:
+                static void Throw(const std::wstring& reason, const wchar_t* message)
+                {
+                    throw SAssertFailure(message == nullptr ? reason : reason + L" " + message);
+                }
+            };
+
+            // registry of every test method in the executable
+            struct STestRegistry
+            {
+                struct STest
+                {
+                    const char* class_name;
+                    const char* method_name;
+                    void (*run)();
+                };
+
+                static std::vector<STest>& Tests()
+                {
+                    static std::vector<STest> tests;
+                    return tests;
+                }
+
+                static bool Add(const char* class_name, const char* method_name, void (*run)())
+                {
+                    Tests().push_back({class_name, method_name, run});
+                    return true;
+                }
+            };
+
+            template <typename T, typename TName>
+            class TestClass
+            {
+            public:
+                using ThisClass = T;
+
+                static const char* GetClassName() { return TName::Get(); }
+            };
+        }
+    }
+}
+
+#define TEST_CLASS(className) \
+    struct className##_Name { static const char* Get() { return #className; } }; \
+    class className : public ::Microsoft::VisualStudio::CppUnitTestFramework::TestClass<className, className##_Name>
+
+#define TEST_METHOD(methodName) \
+    static void methodName##_Run() { ThisClass instance; instance.methodName(); } \
+    inline static const bool methodName##_Registered = \
+        ::Microsoft::VisualStudio::CppUnitTestFramework::STestRegistry::Add(GetClassName(), #methodName, &methodName##_Run); \
+    void methodName()
@@ -0,0 +1,52 @@
+#include "CppUnitTest.h"
+#include <cstring>
+#include <iostream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+/*
+* Runs every registered test method and returns the number of failures.
+* An optional argument runs only tests whose 'Class::Method' name contains it.
+*/
+int main(int argc, char* argv[])
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    int passed{ 0 };
+    int failed{ 0 };
+    for (const STestRegistry::STest& test : STestRegistry::Tests())
+    {
+        const std::string name = std::string(test.class_name) + "::" + test.method_name;
+        if (filter != nullptr && name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        try
+        {
+            test.run();
+            ++passed;
+            std::cout << "[ PASSED ] " << name << '\n';
+        }
+        catch (const SAssertFailure& failure)
+        {
+            ++failed;
+            std::cout << "[ FAILED ] " << name << '\n';
+            // messages are wide, the console stays narrow, so characters are narrowed one by one
+            std::string message;
+            for (const wchar_t symbol : failure.message)
+            {
+                message.push_back(static_cast<char>(symbol));
+            }
+            std::cout << "           " << message << '\n';
+        }
+        catch (const std::exception& exception)
+        {
+            ++failed;
+            std::cout << "[ FAILED ] " << name << ": " << exception.what() << '\n';
+        }
+    }
+
+    std::cout << passed << " passed, " << failed << " failed" << std::endl;
+    return failed;
+}
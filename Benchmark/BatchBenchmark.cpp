@@ -0,0 +1,159 @@
+#include "Benchmark.h"
+
+#include "../Animation/Quaternion/QuaternionInterpolation.h"
+#include "../Animation/Simd/Trigonometry.h"
+#include "../Animation/Vector/VectorInterpolation.h"
+#include "../Animation/Vector/VectorSoA.h"
+
+namespace
+{
+    SVector MakeVector(std::mt19937& random)
+    {
+        return {Benchmark::RandomFloat(random, -10.f, 10.f), Benchmark::RandomFloat(random, -10.f, 10.f), Benchmark::RandomFloat(random, -10.f, 10.f)};
+    }
+
+    SQuaternion MakeRotation(std::mt19937& random)
+    {
+        return {Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f)};
+    }
+
+    float MakeAlpha(std::mt19937& random)
+    {
+        return Benchmark::RandomFloat(random, 0.f, 1.f);
+    }
+
+    // registers 'kernel(lhs, rhs, vectors, scalars)' over two SoA inputs, every kernel writes either 'vectors' or 'scalars'
+    template <typename TKernel>
+    void RegisterSoA(const char* name, size_t bytes_per_operation, TKernel kernel)
+    {
+        Benchmark::Register("SVectorSoA", name, bytes_per_operation, [kernel](size_t count)
+        {
+            const std::vector<SVector> lhs_vectors = Benchmark::Generate<SVector>(count, MakeVector);
+            const std::vector<SVector> rhs_vectors = Benchmark::Generate<SVector>(count, MakeVector, 2u);
+            const SVectorSoA lhs(lhs_vectors.data(), count);
+            const SVectorSoA rhs(rhs_vectors.data(), count);
+            SVectorSoA vectors(count);
+            std::vector<float> scalars(count);
+
+            return Benchmark::Measure(count, [&]()
+            {
+                kernel(lhs, rhs, vectors, scalars.data());
+                Benchmark::DoNotOptimize(vectors.GetX());
+                Benchmark::DoNotOptimize(scalars.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+
+    // registers 'kernel(from, to, alphas, out, count)' over arrays of vectors and blend factors
+    template <typename TKernel>
+    void RegisterVectorInterpolation(const char* name, TKernel kernel)
+    {
+        Benchmark::Register("SVectorInterpolation", name, 3 * sizeof(SVector) + sizeof(float), [kernel](size_t count)
+        {
+            const std::vector<SVector> from = Benchmark::Generate<SVector>(count, MakeVector);
+            const std::vector<SVector> to = Benchmark::Generate<SVector>(count, MakeVector, 2u);
+            const std::vector<float> alphas = Benchmark::Generate<float>(count, MakeAlpha, 3u);
+            std::vector<SVector> out(count);
+
+            return Benchmark::Measure(count, [&]()
+            {
+                kernel(from.data(), to.data(), alphas.data(), out.data(), count);
+                Benchmark::DoNotOptimize(out.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+
+    void RegisterInterpolation(const char* name, EQuaternionInterpolation method)
+    {
+        Benchmark::Register("SQuaternionInterpolation", name, 3 * sizeof(SQuaternion) + sizeof(float), [method](size_t count)
+        {
+            const std::vector<SQuaternion> from = Benchmark::Generate<SQuaternion>(count, MakeRotation);
+            const std::vector<SQuaternion> to = Benchmark::Generate<SQuaternion>(count, MakeRotation, 2u);
+            const std::vector<float> alphas = Benchmark::Generate<float>(count, MakeAlpha, 3u);
+            std::vector<SQuaternion> out(count, SQuaternion::Identity);
+
+            return Benchmark::Measure(count, [&]()
+            {
+                SQuaternionInterpolation::Interpolate(method, from.data(), to.data(), alphas.data(), out.data(), count);
+                Benchmark::DoNotOptimize(out.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+}
+
+void Benchmark::RegisterBatchBenchmarks()
+{
+    constexpr size_t vector_bytes{ 3 * sizeof(float) };
+
+    /*            SVectorSoA            */
+    RegisterSoA("Add", 3 * vector_bytes, [](const SVectorSoA& a, const SVectorSoA& b, SVectorSoA& out, float*) { SVectorSoA::Add(a, b, out); });
+    RegisterSoA("Mul(float)", 2 * vector_bytes, [](const SVectorSoA& a, const SVectorSoA&, SVectorSoA& out, float*) { SVectorSoA::Mul(a, 2.f, out); });
+    RegisterSoA("Div", 3 * vector_bytes, [](const SVectorSoA& a, const SVectorSoA& b, SVectorSoA& out, float*) { SVectorSoA::Div(a, b, out); });
+    RegisterSoA("Dot", 2 * vector_bytes + sizeof(float), [](const SVectorSoA& a, const SVectorSoA& b, SVectorSoA&, float* out) { SVectorSoA::Dot(a, b, out); });
+    RegisterSoA("Cross", 3 * vector_bytes, [](const SVectorSoA& a, const SVectorSoA& b, SVectorSoA& out, float*) { SVectorSoA::Cross(a, b, out); });
+    RegisterSoA("Magnitude", vector_bytes + sizeof(float), [](const SVectorSoA& a, const SVectorSoA&, SVectorSoA&, float* out) { SVectorSoA::Magnitude(a, out); });
+    RegisterSoA("Normalize", 2 * vector_bytes, [](const SVectorSoA& a, const SVectorSoA&, SVectorSoA& out, float*) { SVectorSoA::Normalize(a, out); });
+    RegisterSoA("NormalizeSafe", 2 * vector_bytes, [](const SVectorSoA& a, const SVectorSoA&, SVectorSoA& out, float*) { SVectorSoA::NormalizeSafe(a, out); });
+    RegisterSoA("Magnitude<Fast>", vector_bytes + sizeof(float),
+                [](const SVectorSoA& a, const SVectorSoA&, SVectorSoA&, float* out) { SVectorSoA::Magnitude<SPrecisionFast>(a, out); });
+    RegisterSoA("Normalize<Fast>", 2 * vector_bytes,
+                [](const SVectorSoA& a, const SVectorSoA&, SVectorSoA& out, float*) { SVectorSoA::Normalize<SPrecisionFast>(a, out); });
+    RegisterSoA("NormalizeSafe<Fast>", 2 * vector_bytes,
+                [](const SVectorSoA& a, const SVectorSoA&, SVectorSoA& out, float*) { SVectorSoA::NormalizeSafe<SPrecisionFast>(a, out); });
+    RegisterSoA("NormalizeSafe<Approximate>", 2 * vector_bytes,
+                [](const SVectorSoA& a, const SVectorSoA&, SVectorSoA& out, float*) { SVectorSoA::NormalizeSafe<SPrecisionApproximate>(a, out); });
+    RegisterSoA("ProjectOnTo", 3 * vector_bytes, [](const SVectorSoA& a, const SVectorSoA& b, SVectorSoA& out, float*) { SVectorSoA::ProjectOnTo(a, b, out); });
+    RegisterSoA("Reflection", 3 * vector_bytes, [](const SVectorSoA& a, const SVectorSoA& b, SVectorSoA& out, float*) { SVectorSoA::Reflection(a, b, out); });
+
+    /*            SQuaternionInterpolation            */
+    RegisterInterpolation("Slerp", EQuaternionInterpolation::Slerp);
+    RegisterInterpolation("Nlerp", EQuaternionInterpolation::Nlerp);
+    RegisterInterpolation("FastSlerp", EQuaternionInterpolation::FastSlerp);
+
+    /*            SVectorInterpolation            */
+    // the loops over 'SVector' first: operators, as the clip sampler interpolated keys before 'Lerp', and single 'Lerp' calls
+    RegisterVectorInterpolation("Lerp(operators)", [](const SVector* from, const SVector* to, const float* alphas, SVector* out, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = from[i] * (1.f - alphas[i]) + to[i] * alphas[i];
+        }
+    });
+    RegisterVectorInterpolation("Lerp(SVector)", [](const SVector* from, const SVector* to, const float* alphas, SVector* out, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = SVector::Lerp(from[i], to[i], alphas[i]);
+        }
+    });
+    RegisterVectorInterpolation("Lerp", [](const SVector* from, const SVector* to, const float* alphas, SVector* out, size_t count)
+    {
+        SVectorInterpolation::Lerp(from, to, alphas, out, count);
+    });
+    RegisterVectorInterpolation("Lerp(float)", [](const SVector* from, const SVector* to, const float*, SVector* out, size_t count)
+    {
+        SVectorInterpolation::Lerp(from, to, 0.35f, out, count);
+    });
+    RegisterVectorInterpolation("MulAdd(float*)", [](const SVector* a, const SVector* c, const float* scales, SVector* out, size_t count)
+    {
+        SVectorInterpolation::MulAdd(a, scales, c, out, count);
+    });
+
+    /*            Trigonometry            */
+    Register("Simd", "SinCos", 3 * sizeof(float), [](size_t count)
+    {
+        const std::vector<float> angles = Generate<float>(count, [](std::mt19937& random) { return RandomFloat(random, -100.f, 100.f); });
+        std::vector<float> sines(count), cosines(count);
+
+        return Measure(count, [&]()
+        {
+            Simd::SinCos(angles.data(), sines.data(), cosines.data(), count);
+            DoNotOptimize(sines.data());
+            DoNotOptimize(cosines.data());
+            ClobberMemory();
+        });
+    });
+}
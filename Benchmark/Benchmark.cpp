@@ -0,0 +1,113 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace
+{
+    struct SBenchmark
+    {
+        std::string group;
+        std::string name;
+        size_t bytes_per_operation;
+        Benchmark::RunFunction run;
+    };
+
+    std::vector<SBenchmark>& Benchmarks()
+    {
+        static std::vector<SBenchmark> benchmarks;
+        return benchmarks;
+    }
+}
+
+const std::vector<Benchmark::SDataSize>& Benchmark::DataSizes()
+{
+    static const std::vector<SDataSize> sizes{
+        {"L1", 16 * 1024},
+        {"L2", 256 * 1024},
+        {"RAM", 64 * 1024 * 1024},
+    };
+    return sizes;
+}
+
+Benchmark::SOptions& Benchmark::Options()
+{
+    static SOptions options;
+    return options;
+}
+
+void Benchmark::Register(const char* group, const char* name, size_t bytes_per_operation, RunFunction run)
+{
+    Benchmarks().push_back({group, name, bytes_per_operation, std::move(run)});
+}
+
+/*
+* Runs every registered benchmark at every data size and prints one line per run.
+* Arguments:
+*   --quick         one short sample at the L1 size only, to check that every benchmark runs;
+*   --trace <path>  profiles a crowd update into a Chrome trace instead, meaningful in a build with ANIMATION_PROFILE;
+*   <filter>        runs only benchmarks whose 'Group::Name' contains the text.
+*/
+int main(int argc, char* argv[])
+{
+    const char* filter = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--quick") == 0)
+        {
+            Benchmark::SOptions& options = Benchmark::Options();
+            options.quick = true;
+            options.samples = 1;
+            options.min_sample_time = std::chrono::microseconds(100);
+        }
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            return Benchmark::WriteTrace(argv[++i]) ? 0 : 1;
+        }
+        else
+        {
+            filter = argv[i];
+        }
+    }
+
+    Benchmark::RegisterVectorBenchmarks();
+    Benchmark::RegisterQuaternionBenchmarks();
+    Benchmark::RegisterBatchBenchmarks();
+    Benchmark::RegisterSkeletonBenchmarks();
+    Benchmark::RegisterClipBenchmarks();
+    Benchmark::RegisterTextBenchmarks();
+    Benchmark::RegisterTrackFileBenchmarks();
+    Benchmark::RegisterBlendBenchmarks();
+    Benchmark::RegisterJobBenchmarks();
+    Benchmark::RegisterMatrixBenchmarks();
+    Benchmark::RegisterSkinningBenchmarks();
+    Benchmark::RegisterIKBenchmarks();
+    Benchmark::RegisterRetargetBenchmarks();
+
+    std::printf("%-48s %-4s %10s %12s %16s\n", "benchmark", "size", "count", "ns/op", "ops/sec");
+    for (const SBenchmark& benchmark : Benchmarks())
+    {
+        const std::string name = benchmark.group + "::" + benchmark.name;
+        if (filter != nullptr && name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        for (const Benchmark::SDataSize& size : Benchmark::DataSizes())
+        {
+            const size_t count = std::max<size_t>(size.bytes / benchmark.bytes_per_operation, 1);
+            const Benchmark::SResult result = benchmark.run(count);
+            std::printf("%-48s %-4s %10zu %12.3f %16.4g\n", name.c_str(), size.name, count,
+                        result.nanoseconds_per_operation, result.operations_per_second);
+            std::fflush(stdout);
+
+            if (Benchmark::Options().quick)
+            {
+                break;
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+* Minimal micro-benchmark harness.
+* A benchmark is registered with the number of bytes one operation touches, the harness runs it with working sets sized for
+* L1 (16 KiB), L2 (256 KiB) and RAM (64 MiB), and reports nanoseconds per operation and operations per second.
+* Every measurement repeats a pass over the data until a sample is long enough for the clock and keeps the fastest sample.
+*/
+namespace Benchmark
+{
+    // working set of a run, named after the memory level it is sized for
+    struct SDataSize
+    {
+        const char* name;
+        size_t bytes;
+    };
+
+    const std::vector<SDataSize>& DataSizes();
+
+    struct SOptions
+    {
+        // a sample is repeated until it takes at least this long
+        std::chrono::nanoseconds min_sample_time{ std::chrono::milliseconds(20) };
+        // number of samples, the fastest one is reported
+        size_t samples{ 5 };
+        // runs only the first data size
+        bool quick{ false };
+    };
+
+    SOptions& Options();
+
+    struct SResult
+    {
+        double nanoseconds_per_operation;
+        double operations_per_second;
+    };
+
+    // runs a benchmark for 'count' operations and returns its result
+    using RunFunction = std::function<SResult(size_t count)>;
+
+    // 'group' and 'name' are copied
+    void Register(const char* group, const char* name, size_t bytes_per_operation, RunFunction run);
+
+    // keeps 'value' observable, so the optimizer can't drop the computation of it
+    template <typename T>
+    void DoNotOptimize(const T& value)
+    {
+#if defined(_MSC_VER)
+        static volatile const void* sink;
+        sink = &value;
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    // forces pending stores to memory, so a pass over the data can't be merged with the next one
+    inline void ClobberMemory()
+    {
+#if defined(_MSC_VER)
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : : "memory");
+#endif
+    }
+
+    // measures 'pass', which performs 'operations' operations per call
+    template <typename TPass>
+    SResult Measure(size_t operations, TPass&& pass)
+    {
+        using Clock = std::chrono::steady_clock;
+        const SOptions& options = Options();
+
+        // warms up caches and pages in the data
+        pass();
+
+        size_t passes = 1;
+        double best = 0.0;
+        for (size_t sample = 0; sample < options.samples; ++sample)
+        {
+            for (;;)
+            {
+                const Clock::time_point start = Clock::now();
+                for (size_t i = 0; i < passes; ++i)
+                {
+                    pass();
+                }
+                const Clock::duration elapsed = Clock::now() - start;
+
+                if (elapsed < options.min_sample_time)
+                {
+                    passes *= 2;
+                    continue;
+                }
+
+                const double nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(passes);
+                best = sample == 0 ? nanoseconds : std::min(best, nanoseconds);
+                break;
+            }
+        }
+
+        const double per_operation = best / static_cast<double>(operations);
+        return {per_operation, 1e9 / per_operation};
+    }
+
+    // the same pseudo random data on every run, 'seed' tells apart several inputs of one benchmark
+    template <typename T, typename TMake>
+    std::vector<T> Generate(size_t count, TMake make, unsigned seed = 1u)
+    {
+        std::mt19937 random(seed);
+        std::vector<T> values;
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values.push_back(make(random));
+        }
+        return values;
+    }
+
+    inline float RandomFloat(std::mt19937& random, float min, float max)
+    {
+        return std::uniform_real_distribution<float>(min, max)(random);
+    }
+
+    // 'bool' results are stored as bytes, 'std::vector<bool>' would measure bit packing
+    template <typename T>
+    using TStored = std::conditional_t<std::is_same_v<T, bool>, unsigned char, T>;
+
+    // registers out[i] = operation(inputs[i]), 'count' is at least 1
+    template <typename TInput, typename TMake, typename TOperation>
+    void RegisterUnary(const char* group, const char* name, TMake make, TOperation operation)
+    {
+        using TOutput = TStored<std::decay_t<decltype(operation(std::declval<const TInput&>()))>>;
+
+        Register(group, name, sizeof(TInput) + sizeof(TOutput), [make, operation](size_t count)
+        {
+            const std::vector<TInput> inputs = Generate<TInput>(count, make);
+            // filled with a computed value, not every output type is default constructible
+            std::vector<TOutput> outputs(count, operation(inputs[0]));
+            return Measure(count, [&]()
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    outputs[i] = operation(inputs[i]);
+                }
+                DoNotOptimize(outputs.data());
+                ClobberMemory();
+            });
+        });
+    }
+
+    // registers out[i] = operation(lhs[i], rhs[i])
+    template <typename TInput, typename TMake, typename TOperation>
+    void RegisterBinary(const char* group, const char* name, TMake make, TOperation operation)
+    {
+        using TOutput = TStored<std::decay_t<decltype(operation(std::declval<const TInput&>(), std::declval<const TInput&>()))>>;
+
+        Register(group, name, 2 * sizeof(TInput) + sizeof(TOutput), [make, operation](size_t count)
+        {
+            const std::vector<TInput> lhs = Generate<TInput>(count, make);
+            const std::vector<TInput> rhs = Generate<TInput>(count, make, 2u);
+            std::vector<TOutput> outputs(count, operation(lhs[0], rhs[0]));
+            return Measure(count, [&]()
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    outputs[i] = operation(lhs[i], rhs[i]);
+                }
+                DoNotOptimize(outputs.data());
+                ClobberMemory();
+            });
+        });
+    }
+
+    // suites, every one registers its benchmarks
+    void RegisterVectorBenchmarks();
+    void RegisterQuaternionBenchmarks();
+    void RegisterBatchBenchmarks();
+    void RegisterSkeletonBenchmarks();
+    void RegisterClipBenchmarks();
+    void RegisterTextBenchmarks();
+    void RegisterTrackFileBenchmarks();
+    void RegisterBlendBenchmarks();
+    void RegisterJobBenchmarks();
+    void RegisterMatrixBenchmarks();
+    void RegisterSkinningBenchmarks();
+    void RegisterIKBenchmarks();
+    void RegisterRetargetBenchmarks();
+
+    // profiles frames of a crowd update into a Chrome trace at 'path' and prints the summary, false when the file can't be written
+    bool WriteTrace(const char* path);
+}
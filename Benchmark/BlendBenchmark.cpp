@@ -0,0 +1,150 @@
+#include "Benchmark.h"
+
+#include <string>
+
+#include "../Animation/Blend/BlendTree.h"
+
+namespace
+{
+    constexpr const char* Group{ "SPoseBlender" };
+    constexpr size_t JointCount{ 150 };
+
+    SPose MakePose(std::mt19937& random)
+    {
+        SPose pose(JointCount);
+        for (size_t joint = 0; joint < JointCount; ++joint)
+        {
+            pose.GetTranslations()[joint] = {Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f)};
+            pose.GetRotations()[joint] = {Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f)};
+            pose.GetScales()[joint] = SVector(Benchmark::RandomFloat(random, 0.5f, 1.5f));
+        }
+        return pose;
+    }
+
+    // the blend a character would do joint by joint with 'SVector' and 'SQuaternion' operators, for comparison
+    void BlendPerJoint(const SPose* poses, const float* weights, size_t pose_count, SPose& out)
+    {
+        float total_weight{ 0.f };
+        for (size_t i = 0; i < pose_count; ++i)
+        {
+            total_weight += weights[i];
+        }
+
+        for (size_t joint = 0; joint < JointCount; ++joint)
+        {
+            SVector translation = SVector::ZeroVector;
+            SVector scale = SVector::ZeroVector;
+            SQuaternion rotation(0.f, 0.f, 0.f, 0.f);
+            for (size_t i = 0; i < pose_count; ++i)
+            {
+                translation += poses[i].GetTranslations()[joint] * weights[i];
+                scale += poses[i].GetScales()[joint] * weights[i];
+                const SQuaternion& q = poses[i].GetRotations()[joint];
+                const float weight = (rotation | q) < 0.f ? -weights[i] : weights[i];
+                rotation = SQuaternion(rotation.GetX() + q.GetX() * weight, rotation.GetY() + q.GetY() * weight,
+                                       rotation.GetZ() + q.GetZ() * weight, rotation.GetW() + q.GetW() * weight);
+            }
+            out.GetTranslations()[joint] = translation / total_weight;
+            out.GetScales()[joint] = scale / total_weight;
+            out.GetRotations()[joint] = rotation.Normal();
+        }
+    }
+
+    /*
+    * One operation blends 'pose_count' poses of one character into its output pose, data sizes set how many characters a frame updates.
+    * 'is_per_joint' runs the per-joint reference instead of 'SPoseBlender'.
+    */
+    void RegisterBlend(size_t pose_count, bool is_per_joint)
+    {
+        const size_t pose_bytes = JointCount * (2 * sizeof(SVector) + sizeof(SQuaternion));
+        const std::string name = std::string(is_per_joint ? "Blend(per joint)/" : "Blend/") + std::to_string(pose_count) + "x" + std::to_string(JointCount);
+
+        Benchmark::Register(Group, name.c_str(), (pose_count + 1) * pose_bytes, [pose_count, is_per_joint](size_t count)
+        {
+            std::mt19937 random(1u);
+            std::vector<SPose> inputs;
+            for (size_t i = 0; i < count * pose_count; ++i)
+            {
+                inputs.push_back(MakePose(random));
+            }
+            const std::vector<float> weights = Benchmark::Generate<float>(pose_count, [](std::mt19937& r) { return Benchmark::RandomFloat(r, 0.1f, 1.f); });
+            std::vector<SPose> outputs(count, SPose(JointCount));
+            SPoseBlender blender;
+
+            return Benchmark::Measure(count, [&]()
+            {
+                for (size_t character = 0; character < count; ++character)
+                {
+                    const SPose* poses = inputs.data() + character * pose_count;
+                    if (is_per_joint)
+                    {
+                        BlendPerJoint(poses, weights.data(), pose_count, outputs[character]);
+                        continue;
+                    }
+
+                    blender.Begin(JointCount);
+                    for (size_t i = 0; i < pose_count; ++i)
+                    {
+                        blender.Add(poses[i], weights[i]);
+                    }
+                    blender.End(outputs[character]);
+                }
+                Benchmark::DoNotOptimize(outputs.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+
+    // a blend space of 16 poses: 4 blends of 4 poses under the root, one blend without weight
+    void RegisterBlendTree()
+    {
+        constexpr size_t pose_count{ 16 };
+        const size_t pose_bytes = JointCount * (2 * sizeof(SVector) + sizeof(SQuaternion));
+
+        Benchmark::Register("SBlendTree", "Evaluate/16x150", (pose_count + 1) * pose_bytes, [](size_t count)
+        {
+            std::mt19937 random(1u);
+            std::vector<SPose> inputs;
+            for (size_t i = 0; i < count * pose_count; ++i)
+            {
+                inputs.push_back(MakePose(random));
+            }
+
+            SBlendTree tree;
+            uint32_t branches[4];
+            for (uint32_t branch = 0; branch < 4; ++branch)
+            {
+                uint32_t leaves[4];
+                for (uint32_t leaf = 0; leaf < 4; ++leaf)
+                {
+                    leaves[leaf] = tree.AddPose(4 * branch + leaf);
+                    tree.SetWeight(leaves[leaf], Benchmark::RandomFloat(random, 0.1f, 1.f));
+                }
+                branches[branch] = tree.AddBlend(leaves, 4);
+                tree.SetWeight(branches[branch], branch == 3 ? 0.f : Benchmark::RandomFloat(random, 0.1f, 1.f));
+            }
+            tree.AddBlend(branches, 4);
+            std::vector<SPose> outputs(count, SPose(JointCount));
+
+            return Benchmark::Measure(count, [&]()
+            {
+                for (size_t character = 0; character < count; ++character)
+                {
+                    tree.Evaluate(inputs.data() + character * pose_count, pose_count, outputs[character]);
+                }
+                Benchmark::DoNotOptimize(outputs.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+}
+
+void Benchmark::RegisterBlendBenchmarks()
+{
+    for (const size_t pose_count : { 4, 16 })
+    {
+        RegisterBlend(pose_count, false);
+        RegisterBlend(pose_count, true);
+    }
+    RegisterBlendTree();
+}
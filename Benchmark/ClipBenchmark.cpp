@@ -0,0 +1,166 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../Animation/Clip/ClipSampler.h"
+#include "../Animation/Clip/KeyReduction.h"
+#include "../Animation/Jobs/JobSystem.h"
+#include "../Animation/Skeleton/Skeleton.h"
+
+namespace
+{
+    constexpr const char* Group{ "SClipSampler" };
+
+    constexpr size_t JointCount{ 150 };
+    constexpr float Duration{ 10.f };
+    // keys per second of every track
+    constexpr float KeyRate{ 30.f };
+    constexpr float FrameTime{ 1.f / 60.f };
+
+    SClip MakeClip()
+    {
+        std::mt19937 random(1u);
+        const size_t key_count = static_cast<size_t>(Duration * KeyRate) + 1;
+        std::vector<float> times(key_count);
+        std::vector<SVector> vectors(key_count);
+        std::vector<SQuaternion> rotations(key_count, SQuaternion::Identity);
+
+        SClip clip(JointCount, Duration);
+        for (size_t joint = 0; joint < JointCount; ++joint)
+        {
+            for (size_t key = 0; key < key_count; ++key)
+            {
+                times[key] = static_cast<float>(key) / KeyRate;
+                vectors[key] = {Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f)};
+                rotations[key] = {Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f)};
+            }
+            clip.SetTranslations(joint, times.data(), vectors.data(), key_count);
+            clip.SetRotations(joint, times.data(), rotations.data(), key_count);
+            clip.SetScales(joint, times.data(), vectors.data(), key_count);
+        }
+        return clip;
+    }
+
+    /*
+    * One operation samples a full pose for one playback instance, instances start at random times.
+    * 'is_sequential' advances every instance by a frame per pass and keeps cursors, otherwise every sample is a seek with a reset cursor.
+    * 'is_compressed' samples the clip compressed with the default budget.
+    */
+    void RegisterSample(const char* name, bool is_sequential, bool is_compressed)
+    {
+        const size_t pose_bytes = JointCount * (2 * sizeof(SVector) + sizeof(SQuaternion));
+        Benchmark::Register(Group, name, pose_bytes, [is_sequential, is_compressed](size_t count)
+        {
+            const SClip clip = MakeClip();
+            const SCompressedClip compressed = is_compressed ? SCompressedClip::Compress(clip) : SCompressedClip();
+            std::vector<float> times = Benchmark::Generate<float>(count, [](std::mt19937& random) { return Benchmark::RandomFloat(random, 0.f, Duration); });
+            std::vector<SClipCursor> cursors(count);
+            std::vector<SPose> poses(count, SPose(JointCount));
+            SClipSampler sampler;
+
+            return Benchmark::Measure(count, [&]()
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (is_sequential)
+                    {
+                        times[i] = std::fmod(times[i] + FrameTime, Duration);
+                    }
+                    else
+                    {
+                        cursors[i].Reset();
+                    }
+                }
+                if (is_compressed)
+                {
+                    sampler.Sample(compressed, times.data(), cursors.data(), poses.data(), count);
+                }
+                else
+                {
+                    sampler.Sample(clip, times.data(), cursors.data(), poses.data(), count);
+                }
+                Benchmark::DoNotOptimize(poses.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+
+    constexpr size_t CaptureJointCount{ 60 };
+    constexpr float CaptureRate{ 60.f };
+
+    // a key on every frame of every track, as motion capture comes: fixed bones, joints turning along sums of sines, scales at one
+    SClip MakeCaptureClip(size_t frame_count)
+    {
+        std::mt19937 random(2u);
+        const float duration = static_cast<float>(frame_count - 1) / CaptureRate;
+        std::vector<float> times(frame_count);
+        for (size_t frame = 0; frame < frame_count; ++frame)
+        {
+            times[frame] = static_cast<float>(frame) / CaptureRate;
+        }
+
+        SClip clip(CaptureJointCount, duration);
+        std::vector<SVector> translations(frame_count), scales(frame_count, SVector(1.f));
+        std::vector<SQuaternion> rotations(frame_count, SQuaternion::Identity);
+        for (size_t joint = 0; joint < CaptureJointCount; ++joint)
+        {
+            const SVector bone(Benchmark::RandomFloat(random, -0.05f, 0.05f), Benchmark::RandomFloat(random, 0.05f, 0.2f), 0.f);
+            const float amplitude = Benchmark::RandomFloat(random, 0.1f, 0.8f);
+            const float frequency = Benchmark::RandomFloat(random, 0.5f, 3.f);
+            for (size_t frame = 0; frame < frame_count; ++frame)
+            {
+                const float phase = frequency * times[frame];
+                translations[frame] = bone;
+                rotations[frame] = {amplitude * std::sin(phase), 0.5f * amplitude * std::sin(1.7f * phase), 0.25f * amplitude * std::cos(phase)};
+            }
+            clip.SetTranslations(joint, times.data(), translations.data(), frame_count);
+            clip.SetRotations(joint, times.data(), rotations.data(), frame_count);
+            clip.SetScales(joint, times.data(), scales.data(), frame_count);
+        }
+        return clip;
+    }
+
+    // a joint hanging off one of the previous three, like the chains of a rig
+    SSkeleton MakeCaptureSkeleton()
+    {
+        std::vector<int16_t> parents(CaptureJointCount, SSkeleton::NoParent);
+        for (size_t joint = 1; joint < CaptureJointCount; ++joint)
+        {
+            parents[joint] = static_cast<int16_t>(joint - 1 - joint % std::min<size_t>(joint, 3));
+        }
+        return SSkeleton(std::move(parents));
+    }
+
+    /*
+    * One operation reduces one frame of a captured clip of 60 joints, a pass reduces a clip of 'count' frames.
+    * 'is_parallel' reduces on a job system of every hardware thread, otherwise the reducer runs on the calling thread.
+    */
+    void RegisterReduce(const char* name, bool is_parallel)
+    {
+        const size_t frame_bytes = CaptureJointCount * (2 * sizeof(SVector) + sizeof(SQuaternion) + 3 * sizeof(float));
+        Benchmark::Register(Group, name, frame_bytes, [is_parallel](size_t count)
+        {
+            const SClip clip = MakeCaptureClip(std::max<size_t>(count, 2));
+            const SSkeleton skeleton = MakeCaptureSkeleton();
+            SJobSystem jobs(0);
+
+            return Benchmark::Measure(count, [&]()
+            {
+                const SClip reduced = SKeyReducer::Reduce(clip, skeleton, {}, nullptr, is_parallel ? &jobs : nullptr);
+                Benchmark::DoNotOptimize(reduced.GetRotations().values.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+}
+
+void Benchmark::RegisterClipBenchmarks()
+{
+    RegisterSample("Sample(sequential)/150", true, false);
+    RegisterSample("Sample(seek)/150", false, false);
+    RegisterSample("Sample(compressed, sequential)/150", true, true);
+    RegisterSample("Sample(compressed, seek)/150", false, true);
+    RegisterReduce("Reduce/60", false);
+    RegisterReduce("Reduce(jobs)/60", true);
+}
@@ -0,0 +1,138 @@
+#include "Benchmark.h"
+
+#include <string>
+
+#include "../Animation/IK/InverseKinematics.h"
+
+namespace
+{
+    constexpr const char* Group{ "SIKSolver" };
+
+    enum class EIKMethod
+    {
+        TwoBone,
+        CCD,
+        Fabrik,
+        // FABRIK on an array of 'SVector' one chain at a time, the reference for the batch
+        FabrikScalar,
+    };
+
+    SVector RandomDirection(std::mt19937& random)
+    {
+        return SVector(Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f), 1.f).Normal();
+    }
+
+    // chains of random bones, every target is the end effector of another chain with the same root and bone lengths
+    SIKChains MakeChains(size_t chain_count, size_t joint_count, std::mt19937& random)
+    {
+        SIKChains chains(chain_count, joint_count);
+        std::vector<SVector> positions(joint_count);
+        for (size_t chain = 0; chain < chain_count; ++chain)
+        {
+            SVector target(0.f);
+            positions[0] = SVector(0.f);
+            for (size_t joint = 1; joint < joint_count; ++joint)
+            {
+                const float length = Benchmark::RandomFloat(random, .3f, 1.f);
+                positions[joint] = positions[joint - 1] + RandomDirection(random) * length;
+                target += RandomDirection(random) * length;
+            }
+            chains.SetChain(chain, positions.data(), target);
+        }
+        return chains;
+    }
+
+    // the algorithm of 'SIKSolver::SolveFabrik' for one chain
+    void SolveFabrikScalar(SVector* positions, size_t joint_count, const SVector& target, const SIKSolver& solver)
+    {
+        float lengths[16];
+        for (size_t bone = 0; bone + 1 < joint_count; ++bone)
+        {
+            lengths[bone] = (positions[bone + 1] - positions[bone]).Magnitude();
+        }
+
+        const SVector root = positions[0];
+        const size_t end = joint_count - 1;
+        for (size_t iteration = 0; iteration < solver.max_iterations && (positions[end] - target).Magnitude() > solver.tolerance; ++iteration)
+        {
+            positions[end] = target;
+            for (size_t joint = end; joint-- > 0;)
+            {
+                positions[joint] = positions[joint + 1] + (positions[joint] - positions[joint + 1]).NormalSafe() * lengths[joint];
+            }
+            positions[0] = root;
+            for (size_t joint = 0; joint < end; ++joint)
+            {
+                positions[joint + 1] = positions[joint] + (positions[joint + 1] - positions[joint]).NormalSafe() * lengths[joint];
+            }
+        }
+    }
+
+    /*
+    * One operation is one chain of 'joint_count' joints, every pass solves the chains from the same start: the copy of the
+    * start positions is part of the time. The tolerance shows the cost of convergence: every extra digit takes more iterations.
+    */
+    void RegisterSolve(const std::string& name, EIKMethod method, size_t joint_count, float tolerance)
+    {
+        const size_t chain_bytes = (joint_count + 2) * 3 * sizeof(float) + sizeof(float) + sizeof(uint32_t);
+
+        Benchmark::Register(Group, name.c_str(), chain_bytes, [method, joint_count, tolerance](size_t count)
+        {
+            std::mt19937 random(1u);
+            const SIKChains start = MakeChains(count, joint_count, random);
+            SIKChains chains = start;
+            SIKSolver solver;
+            solver.max_iterations = 64;
+            solver.tolerance = tolerance;
+
+            std::vector<SVector> start_positions(count * joint_count), positions;
+            for (size_t chain = 0; chain < count; ++chain)
+            {
+                start.GetChain(chain, start_positions.data() + chain * joint_count);
+            }
+
+            return Benchmark::Measure(count, [&]()
+            {
+                switch (method)
+                {
+                case EIKMethod::TwoBone:
+                    chains = start;
+                    solver.SolveTwoBone(chains);
+                    break;
+                case EIKMethod::CCD:
+                    chains = start;
+                    solver.SolveCCD(chains);
+                    break;
+                case EIKMethod::Fabrik:
+                    chains = start;
+                    solver.SolveFabrik(chains);
+                    break;
+                case EIKMethod::FabrikScalar:
+                    positions = start_positions;
+                    for (size_t chain = 0; chain < count; ++chain)
+                    {
+                        SolveFabrikScalar(positions.data() + chain * joint_count, joint_count, start.GetTargets().Get(chain), solver);
+                    }
+                    break;
+                }
+                Benchmark::DoNotOptimize(chains.GetErrors());
+                Benchmark::DoNotOptimize(positions.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+}
+
+void Benchmark::RegisterIKBenchmarks()
+{
+    RegisterSolve("SolveTwoBone", EIKMethod::TwoBone, 3, SIKSolver::DefaultTolerance);
+    for (const float tolerance : { 1e-2f, 1e-3f, 1e-4f })
+    {
+        const std::string suffix = "(4 joints, tolerance " + std::to_string(tolerance).substr(0, 6) + ")";
+        RegisterSolve("SolveCCD" + suffix, EIKMethod::CCD, 4, tolerance);
+        RegisterSolve("SolveFabrik" + suffix, EIKMethod::Fabrik, 4, tolerance);
+        RegisterSolve("SolveFabrik(scalar)" + suffix, EIKMethod::FabrikScalar, 4, tolerance);
+    }
+    RegisterSolve("SolveCCD(8 joints)", EIKMethod::CCD, 8, SIKSolver::DefaultTolerance);
+    RegisterSolve("SolveFabrik(8 joints)", EIKMethod::Fabrik, 8, SIKSolver::DefaultTolerance);
+}
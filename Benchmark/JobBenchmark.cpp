@@ -0,0 +1,177 @@
+#include "Benchmark.h"
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "../Animation/Jobs/AnimationUpdate.h"
+#include "../Animation/Profile/Profiler.h"
+
+namespace
+{
+    constexpr size_t JointCount{ 150 };
+    constexpr float Duration{ 2.f };
+    constexpr float KeyRate{ 30.f };
+
+    SClip MakeClip(std::mt19937& random)
+    {
+        const size_t key_count = static_cast<size_t>(Duration * KeyRate) + 1;
+        std::vector<float> times(key_count);
+        std::vector<SVector> translations(key_count);
+        std::vector<SQuaternion> rotations(key_count, SQuaternion::Identity);
+
+        SClip clip(JointCount, Duration);
+        for (size_t joint = 0; joint < JointCount; ++joint)
+        {
+            for (size_t key = 0; key < key_count; ++key)
+            {
+                times[key] = static_cast<float>(key) / KeyRate;
+                translations[key] = {Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f)};
+                rotations[key] = {Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f)};
+            }
+            clip.SetTranslations(joint, times.data(), translations.data(), key_count);
+            clip.SetRotations(joint, times.data(), rotations.data(), key_count);
+        }
+        return clip;
+    }
+
+    // characters of 'JointCount' joints with two blended layers of random clips at random times
+    struct SCrowd
+    {
+        SSkeleton skeleton;
+        std::vector<SClip> clips;
+        SPose inverse_bind{ JointCount };
+        std::vector<SAnimatedCharacter> characters;
+    };
+
+    std::unique_ptr<SCrowd> MakeCrowd(size_t count)
+    {
+        std::mt19937 random(1u);
+        std::vector<int16_t> parents(JointCount, SSkeleton::NoParent);
+        for (size_t joint = 1; joint < JointCount; ++joint)
+        {
+            parents[joint] = static_cast<int16_t>(joint - std::uniform_int_distribution<size_t>(1, std::min<size_t>(joint, 4))(random));
+        }
+
+        auto crowd = std::make_unique<SCrowd>();
+        crowd->skeleton = SSkeleton(std::move(parents));
+        crowd->clips = { MakeClip(random), MakeClip(random), MakeClip(random), MakeClip(random) };
+        crowd->characters.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            SAnimatedCharacter& character = crowd->characters[i];
+            character.skeleton = &crowd->skeleton;
+            character.inverse_bind = &crowd->inverse_bind;
+            for (size_t layer = 0; layer < 2; ++layer)
+            {
+                SAnimationLayer animation_layer;
+                animation_layer.clip = &crowd->clips[(i + layer) % crowd->clips.size()];
+                animation_layer.time = Benchmark::RandomFloat(random, 0.f, Duration);
+                animation_layer.weight = Benchmark::RandomFloat(random, 0.1f, 1.f);
+                character.layers.push_back(animation_layer);
+            }
+        }
+        return crowd;
+    }
+
+    /*
+    * One operation is the full update of one character with two blended layers: sample, blend, local-to-model and palette.
+    * 'thread_count' threads share the characters, 0 for every hardware thread. With 'profile' every pass is a capture of
+    * 'SProfiler', the difference to the same update without it is the cost of the scopes; in a build without ANIMATION_PROFILE
+    * there are no scopes to record. With 'lod' an 'SAnimationLodScheduler' throttles the crowd, a quarter of the characters in
+    * every level, so an operation is the average cost of a character over the frames of a cycle.
+    */
+    void RegisterUpdate(const char* name, size_t thread_count, bool profile = false, bool lod = false)
+    {
+        const size_t pose_bytes = JointCount * (2 * sizeof(SVector) + sizeof(SQuaternion));
+
+        Benchmark::Register("SAnimationUpdate", name, 4 * pose_bytes, [thread_count, profile, lod](size_t count)
+        {
+            const std::unique_ptr<SCrowd> crowd = MakeCrowd(count);
+            SJobSystem jobs(thread_count);
+            SAnimationLodScheduler scheduler;
+            SAnimationUpdate update;
+            if (lod)
+            {
+                const float importances[] = { 1.f, 0.3f, 0.15f, 0.01f };
+                for (size_t i = 0; i < count; ++i)
+                {
+                    crowd->characters[i].importance = importances[i % 4];
+                }
+                update.scheduler = &scheduler;
+            }
+            // every scope of a character fits, none is dropped
+            const size_t event_capacity = 32 * count;
+            return Benchmark::Measure(count, [&]()
+            {
+                if (profile)
+                {
+                    SProfiler::Get().Start(event_capacity);
+                }
+                update.Update(jobs, crowd->characters.data(), count, 1.f / 60.f);
+                if (profile)
+                {
+                    SProfiler::Get().Stop();
+                }
+                Benchmark::DoNotOptimize(crowd->characters.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+
+    // one operation is one scope, recorded or skipped by a stopped profiler
+    void RegisterScope(const char* name, bool recording)
+    {
+        Benchmark::Register("SProfiler", name, sizeof(SProfileEvent), [recording](size_t count)
+        {
+            return Benchmark::Measure(count, [&]()
+            {
+                if (recording)
+                {
+                    SProfiler::Get().Start(count);
+                }
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const SProfileScope scope("Benchmark");
+                }
+                SProfiler::Get().Stop();
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+}
+
+bool Benchmark::WriteTrace(const char* path)
+{
+    constexpr size_t CharacterCount{ 256 };
+    constexpr size_t FrameCount{ 120 };
+
+    const std::unique_ptr<SCrowd> crowd = MakeCrowd(CharacterCount);
+    SJobSystem jobs;
+    SAnimationUpdate update;
+    SProfiler& profiler = SProfiler::Get();
+    profiler.Start(32 * CharacterCount * FrameCount);
+    for (size_t frame = 0; frame < FrameCount; ++frame)
+    {
+        update.Update(jobs, crowd->characters.data(), CharacterCount, 1.f / 60.f);
+        profiler.EndFrame();
+    }
+    profiler.Stop();
+
+    std::ofstream file(path);
+    profiler.WriteChromeTrace(file);
+    profiler.WriteSummary(std::cout);
+    return static_cast<bool>(file);
+}
+
+void Benchmark::RegisterJobBenchmarks()
+{
+    RegisterUpdate("Update(1 thread)/150", 1);
+    RegisterUpdate("Update(all threads)/150", 0);
+    RegisterUpdate("Update(1 thread, profiler recording)/150", 1, true);
+    RegisterUpdate("Update(1 thread, lod)/150", 1, false, true);
+    RegisterUpdate("Update(all threads, lod)/150", 0, false, true);
+    RegisterScope("Scope(recording)", true);
+    RegisterScope("Scope(stopped)", false);
+}
@@ -0,0 +1,113 @@
+#include "Benchmark.h"
+
+#include <string>
+
+#include "../Animation/Matrix/Matrix.h"
+
+namespace
+{
+    constexpr const char* Group{ "SMatrix" };
+
+    // scalar reference, row vectors like 'SMatrix'
+    struct SScalarMatrix
+    {
+        float m[4][4];
+
+        friend SScalarMatrix operator*(const SScalarMatrix& lhs, const SScalarMatrix& rhs)
+        {
+            SScalarMatrix result;
+            for (int row = 0; row < 4; ++row)
+            {
+                for (int column = 0; column < 4; ++column)
+                {
+                    result.m[row][column] = lhs.m[row][0] * rhs.m[0][column] + lhs.m[row][1] * rhs.m[1][column] +
+                                            lhs.m[row][2] * rhs.m[2][column] + lhs.m[row][3] * rhs.m[3][column];
+                }
+            }
+            return result;
+        }
+
+        static SScalarMatrix FromTransform(const SQuaternion& q, const SVector& t, const SVector& s)
+        {
+            const float x = q.GetX(), y = q.GetY(), z = q.GetZ(), w = q.GetW();
+            return {{
+                {(1.f - 2.f * (y * y + z * z)) * s.GetX(), 2.f * (x * y + w * z) * s.GetX(), 2.f * (x * z - w * y) * s.GetX(), 0.f},
+                {2.f * (x * y - w * z) * s.GetY(), (1.f - 2.f * (x * x + z * z)) * s.GetY(), 2.f * (y * z + w * x) * s.GetY(), 0.f},
+                {2.f * (x * z + w * y) * s.GetZ(), 2.f * (y * z - w * x) * s.GetZ(), (1.f - 2.f * (x * x + y * y)) * s.GetZ(), 0.f},
+                {t.GetX(), t.GetY(), t.GetZ(), 1.f}}};
+        }
+    };
+
+    SQuaternion MakeRotation(std::mt19937& random)
+    {
+        return {Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f)};
+    }
+
+    SVector MakeVector(std::mt19937& random, float min, float max)
+    {
+        return {Benchmark::RandomFloat(random, min, max), Benchmark::RandomFloat(random, min, max), Benchmark::RandomFloat(random, min, max)};
+    }
+
+    SMatrix MakeMatrix(std::mt19937& random)
+    {
+        return SMatrix::FromTransform(MakeRotation(random), MakeVector(random, -1.f, 1.f), MakeVector(random, .5f, 2.f));
+    }
+
+    SScalarMatrix MakeScalarMatrix(std::mt19937& random)
+    {
+        return SScalarMatrix::FromTransform(MakeRotation(random), MakeVector(random, -1.f, 1.f), MakeVector(random, .5f, 2.f));
+    }
+
+    // one operation is the palette of one character, 'scalar' selects the reference
+    void RegisterPalette(size_t joint_count, bool scalar)
+    {
+        const std::string name = std::string(scalar ? "FromTransforms(scalar)/" : "FromTransforms/") + std::to_string(joint_count);
+        const size_t bytes = joint_count * (2 * sizeof(SVector) + sizeof(SQuaternion) + sizeof(SMatrix));
+
+        Benchmark::Register(Group, name.c_str(), bytes, [joint_count, scalar](size_t count)
+        {
+            const size_t total = count * joint_count;
+            const std::vector<SQuaternion> rotations = Benchmark::Generate<SQuaternion>(total, MakeRotation);
+            const std::vector<SVector> translations = Benchmark::Generate<SVector>(total, [](std::mt19937& random) { return MakeVector(random, -1.f, 1.f); });
+            const std::vector<SVector> scales = Benchmark::Generate<SVector>(total, [](std::mt19937& random) { return MakeVector(random, .5f, 2.f); });
+            std::vector<SMatrix> matrices(total);
+            std::vector<SScalarMatrix> scalar_matrices(total);
+
+            return Benchmark::Measure(count, [&]()
+            {
+                if (scalar)
+                {
+                    for (size_t i = 0; i < total; ++i)
+                    {
+                        scalar_matrices[i] = SScalarMatrix::FromTransform(rotations[i], translations[i], scales[i]);
+                    }
+                    Benchmark::DoNotOptimize(scalar_matrices.data());
+                }
+                else
+                {
+                    for (size_t i = 0; i < total; i += joint_count)
+                    {
+                        SMatrix::FromTransforms(&rotations[i], &translations[i], &scales[i], &matrices[i], joint_count);
+                    }
+                    Benchmark::DoNotOptimize(matrices.data());
+                }
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+}
+
+void Benchmark::RegisterMatrixBenchmarks()
+{
+    RegisterBinary<SMatrix>(Group, "operator*", MakeMatrix, [](const SMatrix& a, const SMatrix& b) { return a * b; });
+    RegisterBinary<SScalarMatrix>(Group, "operator*(scalar)", MakeScalarMatrix, [](const SScalarMatrix& a, const SScalarMatrix& b) { return a * b; });
+    RegisterUnary<SMatrix>(Group, "Transposition", MakeMatrix, [](const SMatrix& m) { return m.Transposition(); });
+    RegisterUnary<SMatrix>(Group, "AffineInverse", MakeMatrix, [](const SMatrix& m) { return m.AffineInverse(); });
+    RegisterUnary<SMatrix>(Group, "TransformPoint", MakeMatrix, [](const SMatrix& m) { return m.TransformPoint(SVector(1.f, 2.f, 3.f)); });
+
+    for (const size_t joint_count : { 50, 150 })
+    {
+        RegisterPalette(joint_count, false);
+        RegisterPalette(joint_count, true);
+    }
+}
@@ -0,0 +1,64 @@
+#include "Benchmark.h"
+
+#include <array>
+
+#include "../Animation/Quaternion/Quaternion.h"
+
+namespace
+{
+    constexpr const char* Group{ "SQuaternion" };
+
+    using SComponents = std::array<float, 4>;
+
+    SComponents MakeComponents(std::mt19937& random)
+    {
+        return {Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f),
+                Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f)};
+    }
+
+    // roll, pitch and yaw in X, Y and Z
+    SVector MakeAngles(std::mt19937& random)
+    {
+        return {Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f)};
+    }
+
+    SQuaternion MakeRotation(std::mt19937& random)
+    {
+        const SVector angles = MakeAngles(random);
+        return {angles.GetX(), angles.GetY(), angles.GetZ()};
+    }
+
+    SVector MakeVector(std::mt19937& random)
+    {
+        return {Benchmark::RandomFloat(random, -10.f, 10.f), Benchmark::RandomFloat(random, -10.f, 10.f), Benchmark::RandomFloat(random, -10.f, 10.f)};
+    }
+
+    struct SRotationInput
+    {
+        SQuaternion rotation;
+        SVector vector;
+    };
+}
+
+void Benchmark::RegisterQuaternionBenchmarks()
+{
+    /*            Constructors            */
+    RegisterUnary<float>(Group, "SQuaternion(value)", [](std::mt19937& random) { return RandomFloat(random, -1.f, 1.f); },
+                         [](const float& value) { return SQuaternion(value); });
+    RegisterUnary<SComponents>(Group, "SQuaternion(x, y, z, w)", MakeComponents,
+                               [](const SComponents& c) { return SQuaternion(c[0], c[1], c[2], c[3]); });
+    RegisterUnary<SVector>(Group, "SQuaternion(__m128)", MakeVector, [](const SVector& v) { return SQuaternion(v.GetStorage()); });
+    RegisterUnary<SVector>(Group, "SQuaternion(roll, pitch, yaw)", MakeAngles,
+                           [](const SVector& angles) { return SQuaternion(angles.GetX(), angles.GetY(), angles.GetZ()); });
+
+    /*            Algebra            */
+    RegisterBinary<SQuaternion>(Group, "operator==", MakeRotation, [](const SQuaternion& a, const SQuaternion& b) { return a == b; });
+    RegisterBinary<SQuaternion>(Group, "operator*", MakeRotation, [](const SQuaternion& a, const SQuaternion& b) { return a * b; });
+    RegisterBinary<SQuaternion>(Group, "operator|", MakeRotation, [](const SQuaternion& a, const SQuaternion& b) { return a | b; });
+    RegisterUnary<SQuaternion>(Group, "Magnitude", MakeRotation, [](const SQuaternion& q) { return q.Magnitude(); });
+    RegisterUnary<SQuaternion>(Group, "Normal", MakeRotation, [](const SQuaternion& q) { return q.Normal(); });
+    RegisterUnary<SQuaternion>(Group, "Conjugation", MakeRotation, [](const SQuaternion& q) { return q.Conjugation(); });
+    RegisterUnary<SQuaternion>(Group, "Inverse", MakeRotation, [](const SQuaternion& q) { return q.Inverse(); });
+    RegisterUnary<SRotationInput>(Group, "Rotate", [](std::mt19937& random) { return SRotationInput{MakeRotation(random), MakeVector(random)}; },
+                                  [](const SRotationInput& input) { return input.rotation.Rotate(input.vector); });
+}
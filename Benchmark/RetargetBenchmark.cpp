@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+
+#include <string>
+
+#include "../Animation/Retarget/Retarget.h"
+#include "../Animation/Skeleton/Skeleton.h"
+
+namespace
+{
+    constexpr const char* Group{ "SRetargetMap" };
+
+    // a rig hierarchy with named joints; the target rig has the same names, other bone lengths and other joint frames
+    SSkeleton MakeRetargetSkeleton(size_t joint_count)
+    {
+        std::mt19937 random(1u);
+        std::vector<int16_t> parents(joint_count, SSkeleton::NoParent);
+        std::vector<std::string> names(joint_count);
+        for (size_t joint = 0; joint < joint_count; ++joint)
+        {
+            if (joint > 0)
+            {
+                const size_t back = std::uniform_int_distribution<size_t>(1, std::min<size_t>(joint, 4))(random);
+                parents[joint] = static_cast<int16_t>(joint - back);
+            }
+            names[joint] = "joint" + std::to_string(joint);
+        }
+        return SSkeleton(std::move(parents), std::move(names));
+    }
+
+    SPose MakeRetargetPose(size_t joint_count, float length, std::mt19937& random)
+    {
+        SPose pose(joint_count);
+        for (size_t joint = 0; joint < joint_count; ++joint)
+        {
+            pose.GetTranslations()[joint] = {Benchmark::RandomFloat(random, -length, length), Benchmark::RandomFloat(random, -length, length), Benchmark::RandomFloat(random, -length, length)};
+            pose.GetRotations()[joint] = {Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f)};
+        }
+        return pose;
+    }
+
+    // one operation is the stage over one character: its source pose, its target pose and the map
+    void RegisterRetarget(size_t joint_count)
+    {
+        const size_t pose_bytes = joint_count * (2 * sizeof(SVector) + sizeof(SQuaternion));
+        const size_t map_bytes = joint_count * (2 * sizeof(int16_t) + 2 * sizeof(SQuaternion) + 3 * sizeof(SVector));
+        const std::string name = "Retarget/" + std::to_string(joint_count);
+
+        Benchmark::Register(Group, name.c_str(), 2 * pose_bytes + map_bytes, [joint_count](size_t count)
+        {
+            const SSkeleton skeleton = MakeRetargetSkeleton(joint_count);
+            std::mt19937 random(1u);
+            const SRetargetMap map(skeleton, MakeRetargetPose(joint_count, 1.f, random), skeleton, MakeRetargetPose(joint_count, 1.5f, random));
+            std::vector<SPose> sources;
+            for (size_t i = 0; i < count; ++i)
+            {
+                sources.push_back(MakeRetargetPose(joint_count, 1.f, random));
+            }
+            std::vector<SPose> targets(count, SPose(joint_count));
+
+            return Benchmark::Measure(count, [&]()
+            {
+                map.Retarget(sources.data(), targets.data(), count);
+                Benchmark::DoNotOptimize(targets.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+}
+
+void Benchmark::RegisterRetargetBenchmarks()
+{
+    for (const size_t joint_count : { 50, 150 })
+    {
+        RegisterRetarget(joint_count);
+    }
+}
@@ -0,0 +1,68 @@
+#include "Benchmark.h"
+
+#include <string>
+
+#include "../Animation/Skeleton/Skeleton.h"
+
+namespace
+{
+    constexpr const char* Group{ "SSkeleton" };
+
+    // a chain-heavy hierarchy like a character rig: most joints hang off the previous few
+    SSkeleton MakeSkeleton(size_t joint_count)
+    {
+        std::mt19937 random(1u);
+        std::vector<int16_t> parents(joint_count, SSkeleton::NoParent);
+        for (size_t joint = 1; joint < joint_count; ++joint)
+        {
+            const size_t back = std::uniform_int_distribution<size_t>(1, std::min<size_t>(joint, 4))(random);
+            parents[joint] = static_cast<int16_t>(joint - back);
+        }
+        return SSkeleton(std::move(parents));
+    }
+
+    SPose MakePose(size_t joint_count, std::mt19937& random)
+    {
+        SPose pose(joint_count);
+        for (size_t joint = 0; joint < joint_count; ++joint)
+        {
+            pose.GetTranslations()[joint] = {Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f)};
+            pose.GetRotations()[joint] = {Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f)};
+        }
+        return pose;
+    }
+
+    // one operation is the pass over one character, data sizes set how many characters a frame updates
+    void RegisterLocalToModel(size_t joint_count)
+    {
+        const size_t pose_bytes = joint_count * (2 * sizeof(SVector) + sizeof(SQuaternion));
+        const std::string name = "LocalToModel/" + std::to_string(joint_count);
+
+        Benchmark::Register(Group, name.c_str(), 2 * pose_bytes + joint_count * sizeof(int16_t), [joint_count](size_t count)
+        {
+            const SSkeleton skeleton = MakeSkeleton(joint_count);
+            std::mt19937 random(1u);
+            std::vector<SPose> locals;
+            for (size_t i = 0; i < count; ++i)
+            {
+                locals.push_back(MakePose(joint_count, random));
+            }
+            std::vector<SPose> models(count, SPose(joint_count));
+
+            return Benchmark::Measure(count, [&]()
+            {
+                skeleton.LocalToModel(locals.data(), models.data(), count);
+                Benchmark::DoNotOptimize(models.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+}
+
+void Benchmark::RegisterSkeletonBenchmarks()
+{
+    for (const size_t joint_count : { 50, 150, 500 })
+    {
+        RegisterLocalToModel(joint_count);
+    }
+}
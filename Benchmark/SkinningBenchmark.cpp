@@ -0,0 +1,160 @@
+#include "Benchmark.h"
+
+#include <string>
+
+#include "../Animation/Skinning/Skinning.h"
+
+namespace
+{
+    constexpr const char* Group{ "SSkinning" };
+    constexpr size_t BoneCount{ 150 };
+
+    // position, normal, 4 bones and 4 weights in, position and normal out
+    constexpr size_t VertexBytes{ 2 * 3 * sizeof(float) + SSkinnedMesh::MaxInfluences * (sizeof(uint16_t) + sizeof(float)) + 2 * 3 * sizeof(float) };
+
+    // 'vertex_count' vertices with 1 to 4 influences on random bones of the palette
+    SSkinnedMesh MakeMesh(size_t vertex_count, std::mt19937& random)
+    {
+        SSkinnedMesh mesh(vertex_count);
+        std::uniform_int_distribution<uint16_t> bone(0, BoneCount - 1);
+        for (size_t vertex = 0; vertex < vertex_count; ++vertex)
+        {
+            mesh.GetPositions().Set(vertex, {Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f)});
+            mesh.GetNormals().Set(vertex, SVector(Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f), 1.f).Normal());
+
+            const size_t count = std::uniform_int_distribution<size_t>(1, SSkinnedMesh::MaxInfluences)(random);
+            uint16_t bones[SSkinnedMesh::MaxInfluences];
+            float weights[SSkinnedMesh::MaxInfluences];
+            float total = 0.f;
+            for (size_t i = 0; i < count; ++i)
+            {
+                bones[i] = bone(random);
+                weights[i] = Benchmark::RandomFloat(random, .1f, 1.f);
+                total += weights[i];
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                weights[i] /= total;
+            }
+            mesh.SetInfluences(vertex, bones, weights, count);
+        }
+        return mesh;
+    }
+
+    // the same rigid bone transforms as matrices and as dual quaternions
+    void MakePalettes(std::mt19937& random, std::vector<SMatrix>& matrices, std::vector<SDualQuaternion>& dual_quaternions)
+    {
+        std::vector<SQuaternion> rotations;
+        std::vector<SVector> translations;
+        for (size_t bone = 0; bone < BoneCount; ++bone)
+        {
+            rotations.emplace_back(Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f), Benchmark::RandomFloat(random, -3.14f, 3.14f));
+            translations.emplace_back(Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f), Benchmark::RandomFloat(random, -1.f, 1.f));
+            matrices.push_back(SMatrix::FromTransform(rotations.back(), translations.back(), SVector(1.f)));
+        }
+        dual_quaternions.resize(BoneCount);
+        SDualQuaternion::FromTransforms(rotations.data(), translations.data(), dual_quaternions.data(), BoneCount);
+    }
+
+    // scalar reference: the blended 3x4 matrix of every vertex in floats, entries read from the rows in place
+    void SkinLinearScalar(const SSkinnedMesh& mesh, const SMatrix* palette, SVectorSoA& positions, SVectorSoA& normals)
+    {
+        const size_t count = mesh.GetVertexCount();
+        positions.Resize(count);
+        normals.Resize(count);
+        const float* entries = reinterpret_cast<const float*>(palette);
+        for (size_t vertex = 0; vertex < count; ++vertex)
+        {
+            float m[4][3] = {};
+            for (size_t slot = 0; slot < SSkinnedMesh::MaxInfluences; ++slot)
+            {
+                const float* matrix = entries + 16 * mesh.GetBones(slot)[vertex];
+                const float weight = mesh.GetWeights(slot)[vertex];
+                for (size_t row = 0; row < 4; ++row)
+                {
+                    for (size_t column = 0; column < 3; ++column)
+                    {
+                        m[row][column] += weight * matrix[row * 4 + SVector::X_INDEX - column];
+                    }
+                }
+            }
+
+            const float x = mesh.GetPositions().GetX()[vertex], y = mesh.GetPositions().GetY()[vertex], z = mesh.GetPositions().GetZ()[vertex];
+            positions.GetX()[vertex] = x * m[0][0] + y * m[1][0] + z * m[2][0] + m[3][0];
+            positions.GetY()[vertex] = x * m[0][1] + y * m[1][1] + z * m[2][1] + m[3][1];
+            positions.GetZ()[vertex] = x * m[0][2] + y * m[1][2] + z * m[2][2] + m[3][2];
+
+            const float nx = mesh.GetNormals().GetX()[vertex], ny = mesh.GetNormals().GetY()[vertex], nz = mesh.GetNormals().GetZ()[vertex];
+            normals.GetX()[vertex] = nx * m[0][0] + ny * m[1][0] + nz * m[2][0];
+            normals.GetY()[vertex] = nx * m[0][1] + ny * m[1][1] + nz * m[2][1];
+            normals.GetZ()[vertex] = nx * m[0][2] + ny * m[1][2] + nz * m[2][2];
+        }
+    }
+
+    /*
+    * One operation is one vertex, the mesh has as many vertices as the data size holds. 'thread_count' 0 runs on the calling thread
+    * alone, any other count on a job system of that many threads; 'scalar' selects the reference and 'dual' dual quaternion skinning.
+    */
+    void RegisterSkinning(const char* name, ESkinningPath path, ESkinningStore store, size_t thread_count, bool scalar = false, bool dual = false)
+    {
+        if (!SSkinning::IsSupported(path))
+        {
+            return;
+        }
+
+        Benchmark::Register(Group, name, VertexBytes, [path, store, thread_count, scalar, dual](size_t count)
+        {
+            std::mt19937 random(1u);
+            const SSkinnedMesh mesh = MakeMesh(count, random);
+            std::vector<SMatrix> palette;
+            std::vector<SDualQuaternion> dual_palette;
+            MakePalettes(random, palette, dual_palette);
+            SVectorSoA positions(count), normals(count);
+
+            SSkinning skinning;
+            skinning.path = path;
+            skinning.store = store;
+            SJobSystem jobs(std::max<size_t>(thread_count, 1));
+            return Benchmark::Measure(count, [&]()
+            {
+                if (scalar)
+                {
+                    SkinLinearScalar(mesh, palette.data(), positions, normals);
+                }
+                else if (dual && thread_count == 0)
+                {
+                    skinning.SkinDualQuaternion(mesh, dual_palette.data(), positions, normals);
+                }
+                else if (dual)
+                {
+                    skinning.SkinDualQuaternion(jobs, mesh, dual_palette.data(), positions, normals);
+                }
+                else if (thread_count == 0)
+                {
+                    skinning.SkinLinear(mesh, palette.data(), positions, normals);
+                }
+                else
+                {
+                    skinning.SkinLinear(jobs, mesh, palette.data(), positions, normals);
+                }
+                Benchmark::DoNotOptimize(positions.GetX());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+}
+
+void Benchmark::RegisterSkinningBenchmarks()
+{
+    const size_t all_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    RegisterSkinning("SkinLinear(scalar)", ESkinningPath::Sse, ESkinningStore::Cached, 0, true);
+    RegisterSkinning("SkinLinear(Sse)", ESkinningPath::Sse, ESkinningStore::Cached, 0);
+    RegisterSkinning("SkinLinear(Fma)", ESkinningPath::Fma, ESkinningStore::Cached, 0);
+    RegisterSkinning("SkinLinear(Fma, streaming)", ESkinningPath::Fma, ESkinningStore::Streaming, 0);
+    RegisterSkinning("SkinLinear(default, all threads)", SSkinning::DefaultPath(), ESkinningStore::Cached, all_threads);
+    RegisterSkinning("SkinLinear(default, all threads, streaming)", SSkinning::DefaultPath(), ESkinningStore::Streaming, all_threads);
+    RegisterSkinning("SkinDualQuaternion(Sse)", ESkinningPath::Sse, ESkinningStore::Cached, 0, false, true);
+    RegisterSkinning("SkinDualQuaternion(Fma)", ESkinningPath::Fma, ESkinningStore::Cached, 0, false, true);
+    RegisterSkinning("SkinDualQuaternion(Fma, streaming)", ESkinningPath::Fma, ESkinningStore::Streaming, 0, false, true);
+    RegisterSkinning("SkinDualQuaternion(default, all threads)", SSkinning::DefaultPath(), ESkinningStore::Cached, all_threads, false, true);
+}
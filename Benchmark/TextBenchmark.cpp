@@ -0,0 +1,98 @@
+#include "Benchmark.h"
+
+#include <sstream>
+#include <string>
+
+#include "../Animation/Vector/VectorText.h"
+
+namespace
+{
+    constexpr const char* Group{ "SVectorText" };
+
+    // "(-1.25, 3.50, -7.75)\n", the length of a line of 'MakeVector' components at the stream precision
+    constexpr size_t LineBytes{ 21 };
+
+    SVector MakeVector(std::mt19937& random)
+    {
+        return {Benchmark::RandomFloat(random, -10.f, 10.f), Benchmark::RandomFloat(random, -10.f, 10.f), Benchmark::RandomFloat(random, -10.f, 10.f)};
+    }
+
+    // 'SVectorText' against the stream operators over the same lines, written at the stream precision
+    template <typename TChar>
+    void RegisterText(const char* suffix)
+    {
+        using TString = std::basic_string<TChar>;
+        const std::string suffix_name(suffix);
+
+        Benchmark::Register(Group, ("Parse" + suffix_name).c_str(), LineBytes + sizeof(SVector), [](size_t count)
+        {
+            const std::vector<SVector> vectors = Benchmark::Generate<SVector>(count, MakeVector);
+            TString text;
+            SVectorText::Write(vectors.data(), count, text, SVectorText::StreamPrecision);
+            std::vector<SVector> parsed(count);
+
+            return Benchmark::Measure(count, [&]()
+            {
+                SVectorText::Parse(text.data(), text.data() + text.size(), parsed.data(), count);
+                Benchmark::DoNotOptimize(parsed.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+
+        Benchmark::Register(Group, ("operator>>" + suffix_name).c_str(), LineBytes + sizeof(SVector), [](size_t count)
+        {
+            const std::vector<SVector> vectors = Benchmark::Generate<SVector>(count, MakeVector);
+            TString text;
+            SVectorText::Write(vectors.data(), count, text, SVectorText::StreamPrecision);
+            std::vector<SVector> parsed(count);
+
+            return Benchmark::Measure(count, [&]()
+            {
+                std::basic_istringstream<TChar> input(text);
+                for (SVector& vector : parsed)
+                {
+                    input >> vector;
+                }
+                Benchmark::DoNotOptimize(parsed.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+
+        Benchmark::Register(Group, ("Write" + suffix_name).c_str(), sizeof(SVector) + LineBytes, [](size_t count)
+        {
+            const std::vector<SVector> vectors = Benchmark::Generate<SVector>(count, MakeVector);
+            TString text;
+
+            return Benchmark::Measure(count, [&]()
+            {
+                text.clear();
+                SVectorText::Write(vectors.data(), count, text, SVectorText::StreamPrecision);
+                Benchmark::DoNotOptimize(text.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+
+        Benchmark::Register(Group, ("operator<<" + suffix_name).c_str(), sizeof(SVector) + LineBytes, [](size_t count)
+        {
+            const std::vector<SVector> vectors = Benchmark::Generate<SVector>(count, MakeVector);
+
+            return Benchmark::Measure(count, [&]()
+            {
+                std::basic_ostringstream<TChar> output;
+                for (const SVector& vector : vectors)
+                {
+                    output << vector << TChar('\n');
+                }
+                const TString text = output.str();
+                Benchmark::DoNotOptimize(text.data());
+                Benchmark::ClobberMemory();
+            });
+        });
+    }
+}
+
+void Benchmark::RegisterTextBenchmarks()
+{
+    RegisterText<char>("");
+    RegisterText<wchar_t>("(wchar_t)");
+}
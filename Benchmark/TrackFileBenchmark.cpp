@@ -0,0 +1,95 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "../Animation/Track/TrackFile.h"
+#include "../Animation/Vector/VectorText.h"
+
+namespace
+{
+    constexpr const char* Group{ "STrackFile" };
+
+    // a vector in both files: 16 bytes of binary and about 21 characters of text
+    constexpr size_t VectorBytes{ sizeof(SVector) + 21 };
+
+    SVector MakeVector(std::mt19937& random)
+    {
+        return {Benchmark::RandomFloat(random, -10.f, 10.f), Benchmark::RandomFloat(random, -10.f, 10.f), Benchmark::RandomFloat(random, -10.f, 10.f)};
+    }
+
+    /*
+    * Startup cost of getting 'count' vectors from a file into usable memory, one operation is one vector.
+    * The file is written once per run and stays in the page cache, so runs compare parsing and mapping rather than the disk.
+    */
+    template <typename TLoad>
+    void RegisterLoad(const char* name, bool is_binary, TLoad load)
+    {
+        Benchmark::Register(Group, name, VectorBytes, [is_binary, load](size_t count)
+        {
+            const std::vector<SVector> vectors = Benchmark::Generate<SVector>(count, MakeVector);
+            const std::string path = (std::filesystem::temp_directory_path() / (is_binary ? "AnimationBenchmark.track" : "AnimationBenchmark.txt")).string();
+            if (is_binary)
+            {
+                STrackFileWriter writer;
+                writer.AddVectors("vectors", vectors.data(), count);
+                writer.Write(path.c_str());
+            }
+            else
+            {
+                std::string text;
+                SVectorText::Write(vectors.data(), count, text, SVectorText::StreamPrecision);
+                std::ofstream(path, std::ios::binary).write(text.data(), static_cast<std::streamsize>(text.size()));
+            }
+
+            const Benchmark::SResult result = Benchmark::Measure(count, [&]()
+            {
+                load(path, count);
+                Benchmark::ClobberMemory();
+            });
+
+            std::remove(path.c_str());
+            return result;
+        });
+    }
+}
+
+void Benchmark::RegisterTrackFileBenchmarks()
+{
+    RegisterLoad("Open(Header)", true, [](const std::string& path, size_t)
+    {
+        STrackFile file;
+        file.Open(path.c_str(), ETrackFileValidation::Header);
+        DoNotOptimize(file.GetVectors(0));
+    });
+
+    RegisterLoad("Open(Full)", true, [](const std::string& path, size_t)
+    {
+        STrackFile file;
+        file.Open(path.c_str(), ETrackFileValidation::Full);
+        DoNotOptimize(file.GetVectors(0));
+    });
+
+    RegisterLoad("SVectorText::Parse", false, [](const std::string& path, size_t)
+    {
+        std::ifstream input(path, std::ios::binary);
+        const std::string text{ std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+        std::vector<SVector> vectors;
+        SVectorText::Parse(text, vectors);
+        DoNotOptimize(vectors.data());
+    });
+
+    RegisterLoad("operator>>", false, [](const std::string& path, size_t count)
+    {
+        std::ifstream input(path);
+        std::vector<SVector> vectors(count);
+        for (SVector& vector : vectors)
+        {
+            input >> vector;
+        }
+        DoNotOptimize(vectors.data());
+    });
+}
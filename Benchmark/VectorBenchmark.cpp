@@ -0,0 +1,103 @@
+#include "Benchmark.h"
+
+#include <string>
+
+#include "../Animation/Vector/Vector.h"
+#include "../Animation/Vector/VectorExpression.h"
+
+namespace
+{
+    constexpr const char* Group{ "SVector" };
+
+    SVector MakeVector(std::mt19937& random)
+    {
+        return {Benchmark::RandomFloat(random, -10.f, 10.f), Benchmark::RandomFloat(random, -10.f, 10.f), Benchmark::RandomFloat(random, -10.f, 10.f)};
+    }
+
+    SVector MakeNormal(std::mt19937& random)
+    {
+        return MakeVector(random).Normal();
+    }
+}
+
+void Benchmark::RegisterVectorBenchmarks()
+{
+    /*            Equality            */
+    RegisterBinary<SVector>(Group, "operator==", MakeVector, [](const SVector& a, const SVector& b) { return a == b; });
+    RegisterBinary<SVector>(Group, "operator!=", MakeVector, [](const SVector& a, const SVector& b) { return a != b; });
+
+    /*            Arithmetic            */
+    RegisterBinary<SVector>(Group, "operator+", MakeVector, [](const SVector& a, const SVector& b) { return a + b; });
+    RegisterBinary<SVector>(Group, "operator+=", MakeVector, [](SVector a, const SVector& b) { return a += b; });
+    RegisterUnary<SVector>(Group, "operator+(float)", MakeVector, [](const SVector& a) { return a + 2.f; });
+    RegisterBinary<SVector>(Group, "operator-", MakeVector, [](const SVector& a, const SVector& b) { return a - b; });
+    RegisterBinary<SVector>(Group, "operator-=", MakeVector, [](SVector a, const SVector& b) { return a -= b; });
+    RegisterUnary<SVector>(Group, "operator-(float)", MakeVector, [](const SVector& a) { return a - 2.f; });
+    RegisterBinary<SVector>(Group, "operator*", MakeVector, [](const SVector& a, const SVector& b) { return a * b; });
+    RegisterBinary<SVector>(Group, "operator*=", MakeVector, [](SVector a, const SVector& b) { return a *= b; });
+    RegisterUnary<SVector>(Group, "operator*(float)", MakeVector, [](const SVector& a) { return a * 2.f; });
+    RegisterBinary<SVector>(Group, "operator/", MakeVector, [](const SVector& a, const SVector& b) { return a / b; });
+    RegisterBinary<SVector>(Group, "operator/=", MakeVector, [](SVector a, const SVector& b) { return a /= b; });
+    RegisterUnary<SVector>(Group, "operator/(float)", MakeVector, [](const SVector& a) { return a / 2.f; });
+    RegisterUnary<SVector>(Group, "operator-()", MakeVector, [](const SVector& a) { return -a; });
+
+    /*            Magnitude            */
+    RegisterUnary<SVector>(Group, "Magnitude", MakeVector, [](const SVector& a) { return a.Magnitude(); });
+    RegisterUnary<SVector>(Group, "MagnitudeXY", MakeVector, [](const SVector& a) { return a.MagnitudeXY(); });
+    RegisterUnary<SVector>(Group, "SqrMagnitude", MakeVector, [](const SVector& a) { return a.SqrMagnitude(); });
+
+    /*            Normalization            */
+    RegisterUnary<SVector>(Group, "IsZero", MakeVector, [](const SVector& a) { return a.IsZero(); });
+    RegisterUnary<SVector>(Group, "Normalize", MakeVector, [](SVector a) { a.Normalize(); return a; });
+    RegisterUnary<SVector>(Group, "NormalizeSafe", MakeVector, [](SVector a) { a.NormalizeSafe(); return a; });
+
+    /*            Precision Policies            */
+    RegisterUnary<SVector>(Group, "Magnitude<Fast>", MakeVector, [](const SVector& a) { return a.Magnitude<SPrecisionFast>(); });
+    RegisterUnary<SVector>(Group, "Magnitude<Approximate>", MakeVector, [](const SVector& a) { return a.Magnitude<SPrecisionApproximate>(); });
+    RegisterUnary<SVector>(Group, "Normal<Fast>", MakeVector, [](const SVector& a) { return a.Normal<SPrecisionFast>(); });
+    RegisterUnary<SVector>(Group, "Normal<Approximate>", MakeVector, [](const SVector& a) { return a.Normal<SPrecisionApproximate>(); });
+    RegisterUnary<SVector>(Group, "NormalSafe<Fast>", MakeVector, [](const SVector& a) { return a.NormalSafe<SPrecisionFast>(); });
+    RegisterUnary<SVector>(Group, "NormalSafe<Approximate>", MakeVector, [](const SVector& a) { return a.NormalSafe<SPrecisionApproximate>(); });
+
+    /*            Dot and Cross Products            */
+    RegisterBinary<SVector>(Group, "operator|", MakeVector, [](const SVector& a, const SVector& b) { return a | b; });
+    RegisterBinary<SVector>(Group, "operator^", MakeVector, [](const SVector& a, const SVector& b) { return a ^ b; });
+    RegisterBinary<SVector>(Group, "operator^=", MakeVector, [](SVector a, const SVector& b) { return a ^= b; });
+
+    /*            Reflection, Projection and Rejection            */
+    RegisterBinary<SVector>(Group, "Reflection", MakeNormal, [](const SVector& a, const SVector& n) { return a.Reflection(n); });
+    RegisterBinary<SVector>(Group, "ProjectionOnTo", MakeVector, [](const SVector& a, const SVector& b) { return a.ProjectionOnTo(b); });
+    RegisterBinary<SVector>(Group, "ProjectionOnToNormal", MakeNormal, [](const SVector& a, const SVector& n) { return a.ProjectionOnToNormal(n); });
+    RegisterBinary<SVector>(Group, "RejectionTo", MakeVector, [](const SVector& a, const SVector& b) { return a.RejectionTo(b); });
+    RegisterBinary<SVector>(Group, "RejectionToNormal", MakeNormal, [](const SVector& a, const SVector& n) { return a.RejectionToNormal(n); });
+
+    /*            Expressions            */
+    // the same operations through 'VectorExpression', one inlined kernel each, fused multiply-adds in builds with FMA
+    {
+        using namespace VectorExpression;
+        // divides by the squared length in place of 'NormalSafe', the same work for a normal of any nonzero length
+        RegisterBinary<SVector>(Group, "Reflection (expression)", MakeNormal, [](const SVector& a, const SVector& n) { return SVector(Lazy(a) - 2.f * Dot(a, n) / Dot(n, n) * Lazy(n)); });
+        RegisterBinary<SVector>(Group, "ProjectionOnTo (expression)", MakeVector, [](const SVector& a, const SVector& b) { return SVector(Dot(a, b) / Dot(b, b) * Lazy(b)); });
+        RegisterBinary<SVector>(Group, "ProjectionOnToNormal (expression)", MakeNormal, [](const SVector& a, const SVector& n) { return SVector(Dot(a, n) * Lazy(n)); });
+        RegisterBinary<SVector>(Group, "RejectionTo (expression)", MakeVector, [](const SVector& a, const SVector& b) { return SVector(Lazy(a) - Dot(a, b) / Dot(b, b) * Lazy(b)); });
+        RegisterBinary<SVector>(Group, "RejectionToNormal (expression)", MakeNormal, [](const SVector& a, const SVector& n) { return SVector(Lazy(a) - Dot(a, n) * Lazy(n)); });
+    }
+
+    /*            Reduction Paths            */
+    // the kernels behind '|' and the magnitudes, called through a pointer as 'SVector' does
+    for (const EReductionPath path : { EReductionPath::HorizontalAdd, EReductionPath::ShuffleAdd, EReductionPath::DotProduct, EReductionPath::FusedMultiplyAdd })
+    {
+        if (!SReductionKernels::IsSupported(path))
+        {
+            continue;
+        }
+
+        const SReductionKernels& kernels = SReductionKernels::Get(path);
+        const std::string dot = std::string("dot/") + SReductionKernels::GetName(path);
+        const std::string dot_xy = std::string("dot_xy/") + SReductionKernels::GetName(path);
+        RegisterBinary<SVector>("SReductionKernels", dot.c_str(), MakeVector,
+                                [&kernels](const SVector& a, const SVector& b) { return kernels.dot(a.GetStorage(), b.GetStorage()); });
+        RegisterBinary<SVector>("SReductionKernels", dot_xy.c_str(), MakeVector,
+                                [&kernels](const SVector& a, const SVector& b) { return kernels.dot_xy(a.GetStorage(), b.GetStorage()); });
+    }
+}